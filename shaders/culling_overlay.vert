@@ -0,0 +1,15 @@
+#version 330 core
+// Culling debug overlay: one instance per node, the 12 edges of a unit cube stretched over its box
+layout(location = 0) in vec3 aCorner;  // Unit cube corner (0 or 1 per axis)
+layout(location = 1) in vec3 aBoxMin;  // Node box (world space)
+layout(location = 2) in vec3 aBoxMax;
+layout(location = 3) in vec4 aColor;   // Node state
+
+uniform mat4 uViewProj;
+
+out vec4 vColor;
+
+void main() {
+	vColor = aColor;
+	gl_Position = uViewProj * vec4(mix(aBoxMin, aBoxMax, aCorner), 1.0);
+}
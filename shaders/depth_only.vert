@@ -10,7 +10,21 @@ layout(std140) uniform MatricesUBO {
 	vec4 camPos;
 };
 
+#ifndef INSTANCED
+#define INSTANCED 0  // Set for the instanced depth program (mesh runs)
+#endif
+
+#if INSTANCED
+#define MAX_INSTANCES 64  // InstancesUBO::kMaxInstances
+layout(std140) uniform InstancesUBO {
+	mat4 instanceModels[MAX_INSTANCES];
+};
+#endif
+
 void main() {
+#if INSTANCED
+	mat4 model = instanceModels[gl_InstanceID];
+#endif
 	// Transform position and output to clip space
 	vec4 worldPos = model * vec4(aPos, 1.0);
 	// Use cached viewProj for efficiency
@@ -0,0 +1,43 @@
+#version 330 core
+// Eye-dome lighting: darken pixels that lie behind their neighbours (in log depth), which outlines
+// silhouettes and depth discontinuities of an unlit point cloud. Background pixels next to geometry
+// get a dark halo. Depth is passed through so later passes still depth-test against the scene.
+out vec4 FragColor;
+
+uniform sampler2D uColor;
+uniform sampler2D uDepth;
+uniform float uProjA;       // proj[2][2]
+uniform float uProjB;       // proj[3][2]
+uniform float uStrength;
+uniform float uRadius;      // Neighbour distance (pixels)
+uniform int uRenderWidth;   // Rendered rectangle (the targets can be larger)
+uniform int uRenderHeight;
+
+// log2 of the eye distance; 0 marks the background
+float logDepth(ivec2 p) {
+	p = clamp(p, ivec2(0), ivec2(uRenderWidth - 1, uRenderHeight - 1));
+	float d = texelFetch(uDepth, p, 0).r;
+	if (d >= 1.0) return 0.0;
+	float dist = uProjB / ((2.0 * d - 1.0) + uProjA);
+	return log2(max(dist, 1e-6)) + 32.0;  // Offset keeps near distances positive (0 = background)
+}
+
+void main() {
+	ivec2 p = ivec2(gl_FragCoord.xy);
+	vec4 color = texelFetch(uColor, p, 0);
+	float depth = texelFetch(uDepth, p, 0).r;
+	float center = logDepth(p);
+
+	const vec2 dirs[8] = vec2[8](vec2(1, 0), vec2(0.7071, 0.7071), vec2(0, 1), vec2(-0.7071, 0.7071),
+	                             vec2(-1, 0), vec2(-0.7071, -0.7071), vec2(0, -1), vec2(0.7071, -0.7071));
+	float response = 0.0;
+	for (int i = 0; i < 8; ++i) {
+		float neighbour = logDepth(p + ivec2(round(dirs[i] * uRadius)));
+		if (neighbour == 0.0) continue;
+		response += center == 0.0 ? 100.0 : max(0.0, center - neighbour);
+	}
+	float shade = exp(-response / 8.0 * 300.0 * uStrength);
+
+	FragColor = vec4(color.rgb * shade, color.a);
+	gl_FragDepth = depth;
+}
@@ -7,6 +7,23 @@ in float vScalar;  // Scalar value for color mapping
 
 out vec4 FragColor;
 
+// Variant switches, injected by ShaderVariants (defaults when compiled as is):
+// COLOR_MODE 0 = uniform albedo, 1 = vertex RGB, 2 = scalar colormap (matches ColorMode)
+// WIREFRAME 1 = uWireframeColor edges over the shaded mesh; POINTS 1 = GL_POINTS, whose normals may be missing
+// INSTANCED 1 = model matrix per instance (InstancesUBO), only read by the wireframe lookup here
+#ifndef COLOR_MODE
+#define COLOR_MODE 0
+#endif
+#ifndef WIREFRAME
+#define WIREFRAME 0
+#endif
+#ifndef POINTS
+#define POINTS 0
+#endif
+#ifndef INSTANCED
+#define INSTANCED 0
+#endif
+
 // Uniform Buffer Objects (more efficient than individual uniforms)
 // Note: OpenGL 3.3 doesn't support 'binding' in layout, so we bind via glUniformBlockBinding
 layout(std140) uniform MatricesUBO {
@@ -19,7 +36,7 @@ layout(std140) uniform MatricesUBO {
 
 layout(std140) uniform MaterialUBO {
 	vec4 albedo;        // albedo.xyz + metallic in .w
-	vec4 params;        // roughness, ao, colorMode (as float), scalarMin
+	vec4 params;        // roughness, ao, colorMode (as float, unused: COLOR_MODE), scalarMin
 	vec4 scalars;       // scalarMax + padding
 	vec4 skyColor;
 	vec4 groundColor;
@@ -30,9 +47,54 @@ layout(std140) uniform LightingUBO {
 	vec4 lightColor;     // lightColor.xyz + padding
 };
 
-// Wireframe (not in UBO as it's mesh-specific)
-uniform float uWireframe;     // 0 or 1
+#if WIREFRAME
+// Wireframe overlay (not in UBO as it's mesh-specific). The triangle's corners are looked up by
+// gl_PrimitiveID in the mesh's own index buffer and positions, so it needs no geometry shader,
+// no de-indexed vertex stream and no GL_LINE pass.
 uniform vec3 uWireframeColor; // orange
+uniform float uWireframeWidth;         // Edge width in pixels
+uniform int uWireFirstIndex;           // First index of the draw in the EBO; < 0: no lookup, drawn solid
+uniform usamplerBuffer uWireIndices;   // The mesh's EBO
+uniform samplerBuffer uWirePositions;  // The mesh's VBO, one component per texel
+uniform int uWirePositionStride;       // Components per vertex (the position comes first)
+
+#if INSTANCED
+// gl_PrimitiveID restarts with every instance, so only the model matrix differs
+#define MAX_INSTANCES 64  // InstancesUBO::kMaxInstances
+layout(std140) uniform InstancesUBO {
+	mat4 instanceModels[MAX_INSTANCES];
+};
+flat in int vInstance;
+#define WIRE_MODEL instanceModels[vInstance]
+#else
+#define WIRE_MODEL model
+#endif
+
+vec3 wireCorner(int i) {
+	uint index = texelFetch(uWireIndices, uWireFirstIndex + 3 * gl_PrimitiveID + i).r;
+	int base = int(index) * uWirePositionStride;
+	vec3 p = vec3(texelFetch(uWirePositions, base).r, texelFetch(uWirePositions, base + 1).r, texelFetch(uWirePositions, base + 2).r);
+	return (WIRE_MODEL * vec4(p, 1.0)).xyz;
+}
+
+// 1 on the triangle's edges, 0 inside (antialiased over a pixel)
+float wireframeEdge() {
+	if (uWireFirstIndex < 0) return 0.0;
+	vec3 a = wireCorner(0);
+	vec3 v0 = wireCorner(1) - a;
+	vec3 v1 = wireCorner(2) - a;
+	vec3 v2 = vWorldPos - a;
+	float d00 = dot(v0, v0), d01 = dot(v0, v1), d11 = dot(v1, v1);
+	float d20 = dot(v2, v0), d21 = dot(v2, v1);
+	float denom = d00 * d11 - d01 * d01;
+	denom = abs(denom) > 1e-20 ? denom : 1e-20;  // Degenerate triangles: no branch, derivatives stay defined
+	float v = (d11 * d20 - d01 * d21) / denom;
+	float w = (d00 * d21 - d01 * d20) / denom;
+	vec3 bary = vec3(1.0 - v - w, v, w);
+	vec3 inside = smoothstep(vec3(0.0), fwidth(bary) * uWireframeWidth, bary);
+	return 1.0 - min(min(inside.x, inside.y), inside.z);
+}
+#endif
 
 const float PI = 3.14159265359;
 
@@ -79,12 +141,6 @@ float geometrySmith(vec3 N, vec3 V, vec3 L, float roughness) {
 }
 
 void main() {
-	// Wireframe mode: output orange color
-	if (uWireframe > 0.5) {
-		FragColor = vec4(uWireframeColor, 1.0);
-		return;
-	}
-
 	// Extract values from UBOs
 	vec3 camPos3 = camPos.xyz;
 	vec3 lightDir3 = normalize(lightDir.xyz);
@@ -93,26 +149,31 @@ void main() {
 	float metallicVal = albedo.w;
 	float roughnessVal = params.x;
 	float aoVal = params.y;
-	int colorModeVal = int(params.z);
 	float scalarMinVal = params.w;
 	float scalarMaxVal = scalars.x;
 	vec3 skyColor3 = skyColor.xyz;
 	vec3 groundColor3 = groundColor.xyz;
 
 	// Determine base color based on color mode
+#if COLOR_MODE == 1
+	// VertexRGB mode: use vertex color from PLY RGB
+	vec3 baseColor = vColor;
+#elif COLOR_MODE == 2
+	// Scalar mode: map scalar to colormap
+	float scalarT = (vScalar - scalarMinVal) / max(scalarMaxVal - scalarMinVal, 0.001);
+	vec3 baseColor = scalarToColor(scalarT);
+#else
+	// Uniform (use albedo3)
 	vec3 baseColor = albedo3;
-	if (colorModeVal == 1) {
-		// VertexRGB mode: use vertex color from PLY RGB
-		baseColor = vColor;
-	} else if (colorModeVal == 2) {
-		// Scalar mode: map scalar to colormap
-		float t = (vScalar - scalarMinVal) / max(scalarMaxVal - scalarMinVal, 0.001);
-		baseColor = scalarToColor(t);
-	}
-	// else colorModeVal == 0: Uniform (use albedo3)
+#endif
 
-	vec3 N = normalize(vNormal);
 	vec3 V = normalize(camPos3 - vWorldPos);
+#if POINTS
+	// Clouds without normals: light the point as if it faced the viewer instead of normalizing zero
+	vec3 N = dot(vNormal, vNormal) > 1e-12 ? normalize(vNormal) : V;
+#else
+	vec3 N = normalize(vNormal);
+#endif
 	vec3 L = lightDir3;
 	vec3 H = normalize(V + L);
 
@@ -143,5 +204,8 @@ void main() {
 
 	// Gamma correction
 	color = pow(color, vec3(1.0/2.2));
+#if WIREFRAME
+	color = mix(color, uWireframeColor, wireframeEdge());
+#endif
 	FragColor = vec4(color, 1.0);
 }
@@ -21,12 +21,38 @@ out vec2 vUV;
 out vec3 vColor;  // Pass vertex color to fragment shader
 out float vScalar;  // Pass scalar to fragment shader
 
+#ifndef POINTS
+#define POINTS 0  // Set by ShaderVariants for GL_POINTS
+#endif
+#ifndef INSTANCED
+#define INSTANCED 0  // Set by ShaderVariants for instanced mesh runs
+#endif
+
+#if INSTANCED
+// One model matrix per object of the run; view and projection still come from MatricesUBO
+#define MAX_INSTANCES 64  // InstancesUBO::kMaxInstances
+layout(std140) uniform InstancesUBO {
+	mat4 instanceModels[MAX_INSTANCES];
+};
+flat out int vInstance;  // For the wireframe lookup in pbr.frag
+#endif
+
 void main() {
+#if INSTANCED
+	mat4 model = instanceModels[gl_InstanceID];
+	vInstance = gl_InstanceID;
+#endif
 	vec4 worldPos = model * vec4(aPos, 1.0);
 	vWorldPos = worldPos.xyz;
+#if POINTS
+	// Point normals are optional (zero when absent): left unnormalized for the fragment stage to test.
+	// The model matrix only scales uniformly, so its upper 3x3 keeps directions without an inverse.
+	vNormal = mat3(model) * aNormal;
+#else
 	// Normal matrix = inverse transpose of upper-left 3x3
 	mat3 normalMat = mat3(transpose(inverse(model)));
 	vNormal = normalize(normalMat * aNormal);
+#endif
 	vUV = aUV;
 	vColor = aColor;
 	vScalar = aScalar;
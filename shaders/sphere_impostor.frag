@@ -1,13 +1,24 @@
 #version 330 core
-in vec3 gWorldPos;
-in vec3 gNormal;
-in vec2 gUV;
-in vec3 gColor;
-in float gScalar;
-in vec2 gSphereCoord;  // Coordinates on billboard quad (-1 to 1)
+#extension GL_ARB_conservative_depth : enable
+in vec3 vViewPos;       // Quad point in view space (ray direction from the eye)
+flat in vec3 vCenter;   // Sphere center in view space
+flat in float vRadius;
+flat in vec3 vColor;
+flat in float vScalar;
 
 out vec4 FragColor;
 
+// Injected by ShaderVariants: 0 = uniform albedo, 1 = vertex RGB, 2 = scalar colormap
+#ifndef COLOR_MODE
+#define COLOR_MODE 0
+#endif
+
+#ifdef GL_ARB_conservative_depth
+// The quad lies in front of the sphere, so the written depth only ever moves away:
+// early depth testing against the quad depth stays valid
+layout(depth_greater) out float gl_FragDepth;
+#endif
+
 // Uniform Buffer Objects
 // Note: OpenGL 3.3 doesn't support 'binding' in layout, so we bind via glUniformBlockBinding
 layout(std140) uniform MatricesUBO {
@@ -76,16 +87,23 @@ float geometrySmith(vec3 N, vec3 V, vec3 L, float roughness) {
 }
 
 void main() {
-	// Discard pixels outside the sphere circle
-	float dist2 = dot(gSphereCoord, gSphereCoord);
-	if (dist2 > 1.0) {
+	// Ray-cast the sphere along the eye ray through this pixel (view space, eye at the origin)
+	vec3 rayDir = normalize(vViewPos);
+	float b = dot(rayDir, vCenter);
+	float h = b * b - dot(vCenter, vCenter) + vRadius * vRadius;
+	if (h < 0.0) {
 		discard;
 	}
-	
-	// Compute sphere normal from sphereCoord
-	// This gives us a proper sphere normal for lighting
-	float z = sqrt(1.0 - dist2);
-	vec3 sphereNormal = normalize(vec3(gSphereCoord, z));
+	vec3 hitView = rayDir * (b - sqrt(h));
+
+	// Per-pixel sphere depth (default depth range)
+	vec4 hitClip = proj * vec4(hitView, 1.0);
+	gl_FragDepth = 0.5 * (hitClip.z / hitClip.w) + 0.5;
+
+	// Back to world space for shading (the view matrix is rigid: its inverse rotation is the transpose)
+	mat3 viewToWorld = transpose(mat3(view));
+	vec3 sphereNormal = viewToWorld * ((hitView - vCenter) / vRadius);
+	vec3 worldPos = camPos.xyz + viewToWorld * hitView;
 	
 	// Extract values from UBOs
 	vec3 camPos3 = camPos.xyz;
@@ -95,24 +113,24 @@ void main() {
 	float metallicVal = albedo.w;
 	float roughnessVal = params.x;
 	float aoVal = params.y;
-	int colorModeVal = int(params.z);
 	float scalarMinVal = params.w;
 	float scalarMaxVal = scalars.x;
 	vec3 skyColor3 = skyColor.xyz;
 	vec3 groundColor3 = groundColor.xyz;
 	
 	// Determine base color
+#if COLOR_MODE == 1
+	vec3 baseColor = vColor;
+#elif COLOR_MODE == 2
+	float scalarT = (vScalar - scalarMinVal) / max(scalarMaxVal - scalarMinVal, 0.001);
+	vec3 baseColor = scalarToColor(scalarT);
+#else
 	vec3 baseColor = albedo3;
-	if (colorModeVal == 1) {
-		baseColor = gColor;
-	} else if (colorModeVal == 2) {
-		float t = (gScalar - scalarMinVal) / max(scalarMaxVal - scalarMinVal, 0.001);
-		baseColor = scalarToColor(t);
-	}
+#endif
 	
 	// Use sphere normal for lighting calculations
 	vec3 N = sphereNormal;  // Sphere surface normal
-	vec3 V = normalize(camPos3 - gWorldPos);
+	vec3 V = normalize(camPos3 - worldPos);
 	vec3 L = lightDir3;
 	vec3 H = normalize(V + L);
 	
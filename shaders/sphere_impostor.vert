@@ -0,0 +1,54 @@
+#version 330 core
+// Instanced quad impostors: 4 triangle-strip vertices per instance, one instance per point.
+// The corner comes from gl_VertexID, the point from the instance attributes (no geometry shader).
+layout(location = 5) in vec3 aInstancePos;     // Point position (object space)
+layout(location = 6) in vec3 aInstanceColor;   // Point color
+layout(location = 7) in float aInstanceScalar; // Point scalar
+
+// Uniform Buffer Objects
+// Note: OpenGL 3.3 doesn't support 'binding' in layout, so we bind via glUniformBlockBinding
+layout(std140) uniform MatricesUBO {
+	mat4 model;
+	mat4 view;
+	mat4 proj;
+	mat4 viewProj;
+	vec4 camPos;
+};
+
+uniform float uSphereRadius;  // Sphere radius (object space)
+
+out vec3 vViewPos;            // Quad point in view space (ray direction from the eye)
+flat out vec3 vCenter;        // Sphere center in view space
+flat out float vRadius;       // Sphere radius in view space
+flat out vec3 vColor;
+flat out float vScalar;
+
+void main() {
+	vec3 center = (view * model * vec4(aInstancePos, 1.0)).xyz;
+	float radius = uSphereRadius * length(model[0].xyz);
+	float dist = length(center);
+
+	vCenter = center;
+	vRadius = radius;
+	vColor = aInstanceColor;
+	vScalar = aInstanceScalar;
+	if (dist <= radius) {
+		// Eye inside the sphere: nothing sensible to draw, emit a clipped vertex
+		vViewPos = vec3(0.0);
+		gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+		return;
+	}
+
+	// Square facing the eye at the sphere's front tangent point. Seen from the eye the sphere is a circle of
+	// angular radius asin(r/d), which covers (d - r) * r / sqrt(d^2 - r^2) <= r on that plane: a half-size r
+	// quad always contains the silhouette, and its depth is never behind the surface (depth_greater holds).
+	vec3 dir = center / dist;
+	vec3 up = abs(dir.y) < 0.999 ? vec3(0.0, 1.0, 0.0) : vec3(1.0, 0.0, 0.0);
+	vec3 right = normalize(cross(dir, up));
+	up = cross(right, dir);
+	vec2 corner = vec2(float(gl_VertexID & 1), float(gl_VertexID >> 1)) * 2.0 - 1.0;
+	vec3 pos = center - dir * radius + (right * corner.x + up * corner.y) * radius;
+
+	vViewPos = pos;
+	gl_Position = proj * vec4(pos, 1.0);
+}
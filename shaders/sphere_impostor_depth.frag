@@ -0,0 +1,37 @@
+#version 330 core
+#extension GL_ARB_conservative_depth : enable
+// Depth-only sphere impostors for the Early-Z prepass: the ray-cast of sphere_impostor.frag without
+// its shading. Same vertex shader and same depth expression, so the main pass matches with GL_LEQUAL.
+in vec3 vViewPos;       // Quad point in view space (ray direction from the eye)
+flat in vec3 vCenter;   // Sphere center in view space
+flat in float vRadius;
+
+#ifdef GL_ARB_conservative_depth
+// The quad lies in front of the sphere, so the written depth only ever moves away
+layout(depth_greater) out float gl_FragDepth;
+#endif
+
+// Uniform Buffer Objects
+// Note: OpenGL 3.3 doesn't support 'binding' in layout, so we bind via glUniformBlockBinding
+layout(std140) uniform MatricesUBO {
+	mat4 model;
+	mat4 view;
+	mat4 proj;
+	mat4 viewProj;
+	vec4 camPos;
+};
+
+void main() {
+	// Ray-cast the sphere along the eye ray through this pixel (view space, eye at the origin)
+	vec3 rayDir = normalize(vViewPos);
+	float b = dot(rayDir, vCenter);
+	float h = b * b - dot(vCenter, vCenter) + vRadius * vRadius;
+	if (h < 0.0) {
+		discard;
+	}
+	vec3 hitView = rayDir * (b - sqrt(h));
+
+	// Per-pixel sphere depth (default depth range)
+	vec4 hitClip = proj * vec4(hitView, 1.0);
+	gl_FragDepth = 0.5 * (hitClip.z / hitClip.w) + 0.5;
+}
@@ -31,6 +31,7 @@ public:
 	inline const glm::vec3& eye() const { return mEye; }
 	inline const glm::vec3& target() const { return mTarget; }
 	inline const glm::vec3& up() const { return mUp; }
+	inline float farZ() const { return mFarZ; }
 
 private:
 	glm::vec3 mEye = glm::vec3(0.0f, 0.0f, 3.0f);
@@ -0,0 +1,135 @@
+#include "Graphics/Culling/CullingOverlay.hpp"
+#include "Graphics/Scene.hpp"
+
+#include <algorithm>
+#include <cstddef>  // For offsetof
+#include <limits>
+#include <glad/glad.h>
+
+namespace Graphics {
+
+// Line color of a node: rejected states are dim, drawn nodes fade from green to blue with LOD steps
+static void nodeColor(const CullingNode& node, uint8_t out[4]) {
+	static constexpr unsigned int kMaxLodSteps = 6;
+	uint8_t r = 0, g = 0, b = 0;
+	switch (node.state) {
+		case CullingNode::FrustumCulled: r = 110; g = 40; b = 40; break;
+		case CullingNode::Occluded: r = 255; g = 140; b = 0; break;
+		case CullingNode::Hidden: r = 210; g = 0; b = 210; break;
+		default: {
+			float t = static_cast<float>(std::min<unsigned int>(node.lod, kMaxLodSteps)) / static_cast<float>(kMaxLodSteps);
+			g = static_cast<uint8_t>(255.0f * (1.0f - t));
+			b = static_cast<uint8_t>(255.0f * t);
+			break;
+		}
+	}
+	out[0] = r; out[1] = g; out[2] = b; out[3] = 255;
+}
+
+void CullingOverlay::begin() {
+	mInstances.clear();
+	mLeafPoints = 0;
+	mStats = Stats();
+}
+
+void CullingOverlay::addObject(const Scene& object) {
+	const std::vector<CullingNode>& nodes = object.cullingNodes();
+	if (nodes.empty()) return;
+	mStats.objects++;
+	for (size_t i = 0; i < nodes.size(); ++i) {
+		const CullingNode& node = nodes[i];
+		mStats.visited++;
+		switch (node.state) {
+			case CullingNode::FrustumCulled: mStats.frustumCulled++; break;
+			case CullingNode::Occluded: mStats.occluded++; break;
+			case CullingNode::Hidden: mStats.hidden++; break;
+			default: mStats.drawn++; break;
+		}
+		if (node.state == CullingNode::FrustumCulled && !settings.showFrustumCulled) continue;
+
+		// World-space box around the transformed node box
+		glm::vec3 lo, hi;
+		object.cullingNodeBounds(i, lo, hi);
+		Instance instance;
+		instance.boxMin = glm::vec3(std::numeric_limits<float>::max());
+		instance.boxMax = glm::vec3(std::numeric_limits<float>::lowest());
+		for (int corner = 0; corner < 8; ++corner) {
+			glm::vec3 p((corner & 1) ? hi.x : lo.x, (corner & 2) ? hi.y : lo.y, (corner & 4) ? hi.z : lo.z);
+			glm::vec3 w = glm::vec3(object.modelMatrix * glm::vec4(p, 1.0f));
+			instance.boxMin = glm::min(instance.boxMin, w);
+			instance.boxMax = glm::max(instance.boxMax, w);
+		}
+		nodeColor(node, instance.color);
+		mInstances.push_back(instance);
+	}
+
+	// Octree shape, for tuning the leaf size and depth limits
+	const Model& model = *object.model;
+	for (const PointCluster& cluster : model.pointClusters()) {
+		mLeafPoints += cluster.indexCount;
+		mStats.maxLeafPoints = std::max(mStats.maxLeafPoints, cluster.indexCount);
+	}
+	mStats.leaves += static_cast<unsigned int>(model.pointClusters().size());
+	if (model.hasSpatialIndex()) mStats.octreeDepth = std::max(mStats.octreeDepth, model.spatialIndex().maxDepth());
+	mStats.avgLeafPoints = mStats.leaves > 0 ? static_cast<double>(mLeafPoints) / mStats.leaves : 0.0;
+}
+
+void CullingOverlay::draw(Shader& shader, const glm::mat4& viewProj) {
+	if (mInstances.empty()) return;
+	if (!mVAO.valid()) {
+		// The 12 edges of the unit cube as line vertex pairs
+		float corners[24 * 3];
+		int n = 0;
+		for (int a = 0; a < 8; ++a) {
+			for (int axis = 0; axis < 3; ++axis) {
+				if (a & (1 << axis)) continue;
+				int b = a | (1 << axis);
+				for (int v : {a, b}) {
+					corners[n++] = (v & 1) ? 1.0f : 0.0f;
+					corners[n++] = (v & 2) ? 1.0f : 0.0f;
+					corners[n++] = (v & 4) ? 1.0f : 0.0f;
+				}
+			}
+		}
+		mVAO.create();
+		mCubeVBO.create();
+		mInstanceVBO.create();
+		mVAO.bind();
+		mCubeVBO.bind(GL_ARRAY_BUFFER);
+		mCubeVBO.setData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+		mInstanceVBO.bind(GL_ARRAY_BUFFER);
+		glEnableVertexAttribArray(1);
+		glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Instance), (void*)offsetof(Instance, boxMin));
+		glVertexAttribDivisor(1, 1);
+		glEnableVertexAttribArray(2);
+		glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(Instance), (void*)offsetof(Instance, boxMax));
+		glVertexAttribDivisor(2, 1);
+		glEnableVertexAttribArray(3);
+		glVertexAttribPointer(3, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Instance), (void*)offsetof(Instance, color));
+		glVertexAttribDivisor(3, 1);
+	}
+
+	mVAO.bind();
+	mInstanceVBO.bind(GL_ARRAY_BUFFER);
+	mInstanceVBO.setData(GL_ARRAY_BUFFER, (GLsizeiptr)(mInstances.size() * sizeof(Instance)), mInstances.data(), GL_STREAM_DRAW);
+
+	GLStateCache& cache = GLStateCache::instance();
+	cache.enableDepthTest(false);
+	shader.use();
+	shader.setMat4("uViewProj", viewProj);
+	glDrawArraysInstanced(GL_LINES, 0, 24, (GLsizei)mInstances.size());
+	cache.enableDepthTest(true);
+	cache.bindVertexArray(0);
+}
+
+void CullingOverlay::destroy() {
+	mInstanceVBO.destroy();
+	mCubeVBO.destroy();
+	mVAO.destroy();
+	mInstances.clear();
+	mInstances.shrink_to_fit();
+}
+
+} // namespace Graphics
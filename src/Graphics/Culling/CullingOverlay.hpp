@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "Graphics/Shader.h"
+#include "Graphics/Utils.hpp"
+
+namespace Graphics {
+
+class Scene;
+
+/// Debug overlay of what the culling did in the last frame.
+/// Every node of the drawn objects (octree leaf, or mesh of a mesh model) becomes one instance of a
+/// unit cube's 12 edges, stretched over its world-space box and colored by its state: outside the
+/// frustum, occluded on the CPU, hidden by its last occlusion query, or drawn (green at full detail,
+/// bluer with every LOD step). All boxes go out in a single instanced GL_LINES draw, and the per-frame
+/// counts are kept for the UI, for tuning Config::OctreePointsPerNode / OctreeMaxDepth on real data.
+class CullingOverlay {
+public:
+	struct Settings {
+		bool enabled = false;
+		bool showFrustumCulled = true;  // Also draw the boxes of nodes outside the frustum
+	};
+
+	struct Stats {
+		unsigned int objects = 0;        // Objects whose nodes were collected (drawn this frame)
+		unsigned int visited = 0;        // Their nodes
+		unsigned int frustumCulled = 0;  // Rejected: outside the frustum
+		unsigned int occluded = 0;       // Rejected: CPU Hi-Z
+		unsigned int hidden = 0;         // Submitted under conditional rendering
+		unsigned int drawn = 0;          // Accepted
+		unsigned int leaves = 0;         // Octree leaves of the visited point clouds
+		unsigned int maxLeafPoints = 0;  // Points of the fullest leaf
+		unsigned int octreeDepth = 0;    // Deepest octree
+		double avgLeafPoints = 0.0;
+	};
+
+	Settings settings;
+
+	CullingOverlay() = default;
+	~CullingOverlay() { destroy(); }
+	CullingOverlay(const CullingOverlay&) = delete;
+	CullingOverlay& operator=(const CullingOverlay&) = delete;
+
+	/// Drop the previous frame's boxes and counts.
+	void begin();
+
+	/// Add the nodes of an object drawn this frame (Scene::cullingNodes()).
+	void addObject(const Scene& object);
+
+	/// Draw the collected boxes on top of the frame (depth test off), in one instanced draw.
+	/// @param shader culling_overlay.vert/.frag
+	/// @param viewProj View-projection of the frame
+	void draw(Shader& shader, const glm::mat4& viewProj);
+
+	void destroy();
+
+	const Stats& stats() const { return mStats; }
+
+private:
+	struct Instance {
+		glm::vec3 boxMin;  // World space
+		glm::vec3 boxMax;
+		uint8_t color[4];
+	};
+
+	std::vector<Instance> mInstances;
+	size_t mLeafPoints = 0;
+	Stats mStats;
+
+	GlVertexArray mVAO;
+	GlBuffer mCubeVBO;      // 24 unit-cube corners (12 edges)
+	GlBuffer mInstanceVBO;  // Re-specified every frame
+};
+
+} // namespace Graphics
@@ -0,0 +1,38 @@
+#include "Graphics/Culling/ObjectBounds.hpp"
+#include "Graphics/RenderUtils.hpp"
+#include "Graphics/Utils.hpp"
+#include "Graphics/WorkerPool.hpp"
+#include "Graphics/Profiling/CpuProfiler.hpp"
+
+namespace Graphics {
+
+void ObjectBounds::resize(size_t count) {
+	mMinX.resize(count); mMinY.resize(count); mMinZ.resize(count);
+	mMaxX.resize(count); mMaxY.resize(count); mMaxZ.resize(count);
+}
+
+void ObjectBounds::set(size_t i, const glm::vec3& min, const glm::vec3& max) {
+	mMinX[i] = min.x; mMinY[i] = min.y; mMinZ[i] = min.z;
+	mMaxX[i] = max.x; mMaxY[i] = max.y; mMaxZ[i] = max.z;
+}
+
+void ObjectBounds::cull(const glm::mat4& viewProj, bool frustumCulling, std::vector<uint32_t>& outVisible) const {
+	PHV_CPU_SCOPE("ObjectBounds::cull");
+	// Each chunk writes its own range of inside
+	size_t count = size();
+	std::vector<uint8_t> inside(count, 1);
+	if (frustumCulling) {
+		Frustum frustum; frustum.extractFromMatrix(viewProj);
+		WorkerPool::instance().parallelFor(count, Config::CullMinObjectsPerThread, [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i) {
+				inside[i] = frustum.intersectsAABB(glm::vec3(mMinX[i], mMinY[i], mMinZ[i]), glm::vec3(mMaxX[i], mMaxY[i], mMaxZ[i])) ? 1 : 0;
+			}
+		});
+	}
+	outVisible.clear();
+	for (size_t i = 0; i < count; ++i) {
+		if (inside[i]) outVisible.push_back(static_cast<uint32_t>(i));
+	}
+}
+
+} // namespace Graphics
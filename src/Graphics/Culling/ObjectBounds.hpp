@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace Graphics {
+
+/// World-space boxes of many objects, one array per component (SoA) for the frustum culling loop.
+/// Culling only reads the arrays, so it may run off the GL thread while the objects are drawn.
+class ObjectBounds {
+public:
+	/// Resize to count boxes (new ones are empty at the origin).
+	void resize(size_t count);
+
+	/// Set box i.
+	void set(size_t i, const glm::vec3& min, const glm::vec3& max);
+
+	size_t size() const { return mMinX.size(); }
+
+	/// Frustum-cull every box, split across the shared worker pool for large sets.
+	/// @param viewProj View to cull for
+	/// @param frustumCulling False: every box is visible
+	/// @param outVisible Boxes inside the frustum, in index order
+	void cull(const glm::mat4& viewProj, bool frustumCulling, std::vector<uint32_t>& outVisible) const;
+
+private:
+	std::vector<float> mMinX, mMinY, mMinZ;
+	std::vector<float> mMaxX, mMaxY, mMaxZ;
+};
+
+} // namespace Graphics
@@ -1,43 +1,54 @@
 #include "Graphics/Culling/OcclusionCuller.hpp"
 #include "Graphics/Utils.hpp"
+#include "Graphics/RenderUtils.hpp"  // For Frustum class
+#include <algorithm>
 #include <cstdio>
-#include <glm/gtc/matrix_transform.hpp>
 
 namespace Graphics {
 
 OcclusionCuller::~OcclusionCuller() {
-	if (mOcclusionQuery != 0) {
-		glDeleteQueries(1, &mOcclusionQuery);
-		mOcclusionQuery = 0;
-	}
+	releaseQueries();
 }
 
 OcclusionCuller::OcclusionCuller(OcclusionCuller&& other) noexcept
-	: mOcclusionQuery(other.mOcclusionQuery),
-	  mOcclusionQuerySupported(other.mOcclusionQuerySupported),
-	  mLastOcclusionResult(other.mLastOcclusionResult),
+	: mOcclusionQuerySupported(other.mOcclusionQuerySupported),
+	  mNodes(std::move(other.mNodes)),
+	  mFrameNodes(std::move(other.mFrameNodes)),
+	  mNodeDistances(std::move(other.mNodeDistances)),
+	  mFrame(other.mFrame),
+	  mObjectCamPos(other.mObjectCamPos),
+	  mStats(other.mStats),
 	  mOcclusionVAO(std::move(other.mOcclusionVAO)),
 	  mOcclusionVBO(std::move(other.mOcclusionVBO)),
 	  mOcclusionEBO(std::move(other.mOcclusionEBO)) {
-	other.mOcclusionQuery = 0;
+	other.mNodes.clear();
 }
 
 OcclusionCuller& OcclusionCuller::operator=(OcclusionCuller&& other) noexcept {
 	if (this != &other) {
-		if (mOcclusionQuery != 0) {
-			glDeleteQueries(1, &mOcclusionQuery);
-		}
-		mOcclusionQuery = other.mOcclusionQuery;
+		releaseQueries();
 		mOcclusionQuerySupported = other.mOcclusionQuerySupported;
-		mLastOcclusionResult = other.mLastOcclusionResult;
+		mNodes = std::move(other.mNodes);
+		mFrameNodes = std::move(other.mFrameNodes);
+		mNodeDistances = std::move(other.mNodeDistances);
+		mFrame = other.mFrame;
+		mObjectCamPos = other.mObjectCamPos;
+		mStats = other.mStats;
 		mOcclusionVAO = std::move(other.mOcclusionVAO);
 		mOcclusionVBO = std::move(other.mOcclusionVBO);
 		mOcclusionEBO = std::move(other.mOcclusionEBO);
-		other.mOcclusionQuery = 0;
+		other.mNodes.clear();
 	}
 	return *this;
 }
 
+void OcclusionCuller::releaseQueries() {
+	for (Node& node : mNodes) {
+		if (node.query != 0) glDeleteQueries(1, &node.query);
+		node.query = 0;
+	}
+}
+
 void OcclusionCuller::initialize() {
 	// Check if occlusion queries are supported (OpenGL 3.3+)
 	const char* glVersion = reinterpret_cast<const char*>(glGetString(GL_VERSION));
@@ -46,119 +57,185 @@ void OcclusionCuller::initialize() {
 		sscanf(glVersion, "%d.%d", &major, &minor);
 		mOcclusionQuerySupported = (major > 3 || (major == 3 && minor >= 3));
 	}
-	
-	if (mOcclusionQuerySupported) {
-		// Generate query object for occlusion testing
-		if (mOcclusionQuery == 0) {
-			glGenQueries(1, &mOcclusionQuery);
+
+	if (mOcclusionQuerySupported && !mOcclusionVAO.valid()) {
+		// Shared filled-box index list (12 triangles); every node's 8 corners are addressed with a base vertex
+		const unsigned short indices[36] = {
+			// bottom (z=0)
+			0,1,2,  2,1,3,
+			// top (z=1)
+			4,6,5,  6,7,5,
+			// left (x=0)
+			0,2,4,  2,6,4,
+			// right (x=1)
+			1,5,3,  3,5,7,
+			// front (y=0)
+			0,4,1,  1,4,5,
+			// back (y=1)
+			2,3,6,  3,7,6
+		};
+		mOcclusionVAO.create();
+		mOcclusionVBO.create();
+		mOcclusionEBO.create();
+		mOcclusionVAO.bind();
+		mOcclusionVBO.bind(GL_ARRAY_BUFFER);
+		mOcclusionEBO.bind(GL_ELEMENT_ARRAY_BUFFER);
+		mOcclusionEBO.setData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+		GLStateCache::instance().bindVertexArray(0);
+	}
+}
+
+void OcclusionCuller::setNodes(const std::vector<NodeBounds>& nodes) {
+	releaseQueries();
+	mNodes.assign(nodes.size(), Node{});
+	mNodeDistances.assign(nodes.size(), 0.0f);
+	mFrameNodes.clear();
+	mStats = Stats{};
+	mStats.nodes = static_cast<unsigned int>(nodes.size());
+	if (!mOcclusionQuerySupported || nodes.empty()) return;
+
+	std::vector<glm::vec3> corners;
+	corners.reserve(nodes.size() * 8);
+	for (size_t i = 0; i < nodes.size(); ++i) {
+		mNodes[i].bounds = nodes[i];
+		glGenQueries(1, &mNodes[i].query);
+		// Same corner order as the unit cube the index list was written for
+		for (int c = 0; c < 8; ++c) {
+			corners.emplace_back((c & 1) ? nodes[i].max.x : nodes[i].min.x,
+			                     (c & 2) ? nodes[i].max.y : nodes[i].min.y,
+			                     (c & 4) ? nodes[i].max.z : nodes[i].min.z);
 		}
-		// Create persistent filled-box proxy (12 triangles)
-		if (!mOcclusionVAO.valid()) {
-			// 8 corners of unit cube in model AABB space will be transformed by model matrix; here store as AABB-relative
-			// We'll upload 8 unique vertices and 36 indices (12 triangles)
-			const float vertices[8 * 3] = {
-				0.0f, 0.0f, 0.0f, // 0 min
-				1.0f, 0.0f, 0.0f, // 1
-				0.0f, 1.0f, 0.0f, // 2
-				1.0f, 1.0f, 0.0f, // 3
-				0.0f, 0.0f, 1.0f, // 4
-				1.0f, 0.0f, 1.0f, // 5
-				0.0f, 1.0f, 1.0f, // 6
-				1.0f, 1.0f, 1.0f  // 7 max
-			};
-			const unsigned short indices[36] = {
-				// bottom (z=0)
-				0,1,2,  2,1,3,
-				// top (z=1)
-				4,6,5,  6,7,5,
-				// left (x=0)
-				0,2,4,  2,6,4,
-				// right (x=1)
-				1,5,3,  3,5,7,
-				// front (y=0)
-				0,4,1,  1,4,5,
-				// back (y=1)
-				2,3,6,  3,7,6
-			};
-			mOcclusionVAO.create();
-			mOcclusionVBO.create();
-			mOcclusionEBO.create();
-			mOcclusionVAO.bind();
-			mOcclusionVBO.bind(GL_ARRAY_BUFFER);
-			mOcclusionVBO.setData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-			mOcclusionEBO.bind(GL_ELEMENT_ARRAY_BUFFER);
-			mOcclusionEBO.setData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-			glEnableVertexAttribArray(0);
-			glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
-			glBindBuffer(GL_ARRAY_BUFFER, 0);
-			glBindVertexArray(0);
+	}
+	mOcclusionVBO.bind(GL_ARRAY_BUFFER);
+	mOcclusionVBO.setData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(corners.size() * sizeof(glm::vec3)), corners.data(), GL_STATIC_DRAW);
+}
+
+const std::vector<size_t>& OcclusionCuller::beginFrame(const glm::mat4& modelMatrix, const FrameState& frameState) {
+	++mFrame;
+	mFrameNodes.clear();
+	mStats.inFrustum = mStats.hidden = mStats.queriesIssued = 0;
+	mStats.resultsResolved = mStats.resultsDropped = 0;
+
+	// Read back whatever has finished; never wait for the rest
+	for (Node& node : mNodes) {
+		if (!node.pending) continue;
+		GLuint available = 0;
+		glGetQueryObjectuiv(node.query, GL_QUERY_RESULT_AVAILABLE, &available);
+		if (available) {
+			GLuint samplesPassed = 0;
+			glGetQueryObjectuiv(node.query, GL_QUERY_RESULT, &samplesPassed);
+			node.visible = (samplesPassed > 0);
+			node.pending = false;
+			node.queried = true;
+			mStats.resultsResolved++;
+			float latency = static_cast<float>(mFrame - node.issuedFrame);
+			mStats.avgLatencyFrames = mStats.avgLatencyFrames == 0.0f ? latency : mStats.avgLatencyFrames * 0.9f + latency * 0.1f;
+		} else if (mFrame - node.issuedFrame > Config::OcclusionMaxLatencyFrames) {
+			// Too stale to trust: draw it and let the next piggyback query start over
+			node.visible = true;
+			node.pending = false;
+			mStats.resultsDropped++;
 		}
 	}
+
+	// Per-node frustum culling, then front-to-back order so piggyback queries see the nearest occluders first
+	Frustum frustum;
+	frustum.extractFromMatrix(frameState.viewProj);
+	mObjectCamPos = glm::vec3(glm::inverse(modelMatrix) * glm::vec4(frameState.camPos, 1.0f));
+	for (size_t i = 0; i < mNodes.size(); ++i) {
+		const NodeBounds& b = mNodes[i].bounds;
+		if (!frustum.intersectsTransformedAABB(b.min, b.max, modelMatrix)) continue;
+		glm::vec3 d = 0.5f * (b.min + b.max) - mObjectCamPos;
+		mNodeDistances[i] = glm::dot(d, d);
+		mFrameNodes.push_back(i);
+	}
+	std::sort(mFrameNodes.begin(), mFrameNodes.end(), [this](size_t a, size_t b) { return mNodeDistances[a] < mNodeDistances[b]; });
+	mStats.inFrustum = static_cast<unsigned int>(mFrameNodes.size());
+	return mFrameNodes;
 }
 
-bool OcclusionCuller::testOcclusion(
-	const glm::mat4& modelMatrix,
-	const glm::vec3& modelMin,
-	const glm::vec3& modelMax,
-	const FrameState& frameState,
-	Shader& depthShader,
-	UniformBuffer& matricesUBO,
-	GLStateCache* stateCache) {
-	if (!mOcclusionQuerySupported || mOcclusionQuery == 0) return true;
-	
-	// Set up depth-only rendering state
-	if (stateCache) {
-		stateCache->colorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
-		stateCache->depthMask(GL_TRUE);
-		stateCache->depthFunc(GL_LESS);
-	} else {
-		glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
-		glDepthMask(GL_TRUE);
-		glDepthFunc(GL_LESS);
+void OcclusionCuller::beginNode(size_t index) {
+	if (index >= mNodes.size()) return;
+	Node& node = mNodes[index];
+	// A node returning to the frustum has a stale result: treat it as visible and re-test it right away
+	bool reentered = node.lastSeenFrame + 1 < mFrame;
+	node.lastSeenFrame = mFrame;
+	if (reentered) node.visible = true;
+
+	if (node.visible) {
+		bool due = reentered || (mFrame + index) % Config::OcclusionVisibleQueryInterval == 0;
+		if (due && !node.pending) {
+			glBeginQuery(GL_SAMPLES_PASSED, node.query);
+			node.pending = true;
+			node.issuedFrame = mFrame;
+			mQueryActive = true;
+			mStats.queriesIssued++;
+		}
+	} else if (node.queried) {
+		glBeginConditionalRender(node.query, GL_QUERY_NO_WAIT);
+		mConditionalActive = true;
+		mStats.hidden++;
 	}
-	
-	// Compute AABB transform: modelMatrix * translate(min) * scale(size)
-	glm::vec3 size = modelMax - modelMin;
-	glm::mat4 aabbXform = modelMatrix * glm::translate(glm::mat4(1.0f), modelMin) * glm::scale(glm::mat4(1.0f), size);
-	
-	// Update UBO with AABB transform (temporary update for occlusion test)
-	if (matricesUBO.valid()) {
-		struct MatricesUBO {
-			glm::mat4 model, view, proj, viewProj;
-			glm::vec4 camPos;
-		} matricesData;
-		matricesData.model = aabbXform;
-		matricesData.view = frameState.view;
-		matricesData.proj = frameState.proj;
-		matricesData.viewProj = frameState.viewProj;
-		matricesData.camPos = glm::vec4(frameState.camPos, 1.0f);
-		matricesUBO.updateData(0, sizeof(MatricesUBO), &matricesData);
+}
+
+void OcclusionCuller::endNode(size_t index) {
+	if (index >= mNodes.size()) return;
+	if (mQueryActive) {
+		glEndQuery(GL_SAMPLES_PASSED);
+		mQueryActive = false;
 	}
-	
-	depthShader.use();
-	glBeginQuery(GL_SAMPLES_PASSED, mOcclusionQuery);
-	mOcclusionVAO.bind();
-	glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_SHORT, 0);
-	glBindVertexArray(0);
-	glEndQuery(GL_SAMPLES_PASSED);
-	
-	// Restore color writes
-	if (stateCache) {
-		stateCache->colorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
-	} else {
-		glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+	if (mConditionalActive) {
+		glEndConditionalRender();
+		mConditionalActive = false;
 	}
-	
-	// Check if query result is available
-	GLuint available = 0;
-	glGetQueryObjectuiv(mOcclusionQuery, GL_QUERY_RESULT_AVAILABLE, &available);
-	if (available) {
-		GLuint samplesPassed = 0;
-		glGetQueryObjectuiv(mOcclusionQuery, GL_QUERY_RESULT, &samplesPassed);
-		mLastOcclusionResult = (samplesPassed > 0);
-		return mLastOcclusionResult;
+}
+
+void OcclusionCuller::queryHiddenNodes(Shader& depthShader, GLStateCache& cache) {
+	if (!mOcclusionQuerySupported || !mOcclusionVAO.valid() || mFrameNodes.empty()) return;
+
+	bool setUp = false;
+	bool cullFace = cache.cullFaceEnabled();
+	unsigned int polygonMode = cache.currentPolygonMode();
+	for (size_t index : mFrameNodes) {
+		Node& node = mNodes[index];
+		if (node.visible || node.pending) continue;
+
+		// Proxy faces would be clipped by the near plane with the camera inside: just draw the node
+		glm::vec3 margin = 0.1f * (node.bounds.max - node.bounds.min);
+		if (glm::all(glm::greaterThanEqual(mObjectCamPos, node.bounds.min - margin)) &&
+		    glm::all(glm::lessThanEqual(mObjectCamPos, node.bounds.max + margin))) {
+			node.visible = true;
+			continue;
+		}
+
+		if (!setUp) {
+			// Depth-tested, write-nothing filled boxes; both faces so a box is never tested by its far side only
+			cache.colorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+			cache.depthMask(GL_FALSE);
+			cache.depthFunc(GL_LESS);
+			cache.enableCullFace(false);
+			cache.polygonMode(GL_FILL);
+			depthShader.use();
+			mOcclusionVAO.bind();
+			setUp = true;
+		}
+		glBeginQuery(GL_SAMPLES_PASSED, node.query);
+		glDrawElementsBaseVertex(GL_TRIANGLES, 36, GL_UNSIGNED_SHORT, 0, static_cast<GLint>(index * 8));
+		glEndQuery(GL_SAMPLES_PASSED);
+		node.pending = true;
+		node.issuedFrame = mFrame;
+		mStats.queriesIssued++;
 	}
-	return mLastOcclusionResult;
+	mFrameNodes.clear();  // Frame done: if the next frame skips beginFrame() these must not be queried again
+	if (!setUp) return;
+
+	// Restore the state the rest of the frame expects
+	cache.colorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+	cache.depthMask(GL_TRUE);
+	cache.enableCullFace(cullFace);
+	if (polygonMode != GLStateCache::kUnknown) cache.polygonMode(polygonMode);
 }
 
 } // namespace Graphics
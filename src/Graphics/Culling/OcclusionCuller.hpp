@@ -1,54 +1,98 @@
 #pragma once
 
+#include <vector>
 #include <glm/glm.hpp>
 #include <glad/glad.h>
 #include "Graphics/Utils.hpp"
 #include "Graphics/Shader.h"
-#include "Graphics/UBO.hpp"
 
 namespace Graphics {
 
+/// Latency-tolerant per-node occlusion culling (CHC++ style) over octree leaves, meshes or whole models.
+/// Every node owns a GL_SAMPLES_PASSED query whose result is polled without ever blocking and accepted
+/// up to Config::OcclusionMaxLatencyFrames late:
+///  - nodes last seen visible are drawn normally; every few frames (staggered) the draw itself is wrapped
+///    in a query ("piggyback") to notice when they become hidden,
+///  - nodes last seen hidden are drawn inside glBeginConditionalRender(GL_QUERY_NO_WAIT) on their latest
+///    query, so the GPU skips them while the CPU never waits (an unfinished query simply draws),
+///  - after the main pass, hidden nodes get a bounding-box proxy query against the finished depth buffer.
 class OcclusionCuller {
 public:
+	struct NodeBounds {
+		glm::vec3 min;  // Object space
+		glm::vec3 max;
+	};
+
+	struct Stats {
+		unsigned int nodes = 0;            // Nodes tracked
+		unsigned int inFrustum = 0;        // Nodes submitted this frame
+		unsigned int hidden = 0;           // Submitted under conditional rendering
+		unsigned int queriesIssued = 0;    // Piggyback + proxy queries this frame
+		unsigned int resultsResolved = 0;  // Results read back this frame
+		unsigned int resultsDropped = 0;   // Results given up on after the latency limit
+		float avgLatencyFrames = 0.0f;     // Frames between issuing and reading back (smoothed)
+	};
+
 	OcclusionCuller() = default;
 	~OcclusionCuller();
-	
+
 	OcclusionCuller(const OcclusionCuller&) = delete;
 	OcclusionCuller& operator=(const OcclusionCuller&) = delete;
 	OcclusionCuller(OcclusionCuller&& other) noexcept;
 	OcclusionCuller& operator=(OcclusionCuller&& other) noexcept;
-	
+
 	// Initialize occlusion query support and create proxy geometry
 	void initialize();
-	
-	/// Test if object is occluded using hardware occlusion queries.
-	/// @param modelMatrix Transform matrix for the object
-	/// @param modelMin Minimum AABB corner (object space)
-	/// @param modelMax Maximum AABB corner (object space)
-	/// @param frameState Pre-computed frame state (view, proj, viewProj, camPos)
-	/// @param depthShader Depth-only shader for rendering the occlusion proxy
-	/// @param matricesUBO UBO containing matrices (will be temporarily updated)
-	/// @param stateCache Optional OpenGL state cache to minimize redundant state changes
-	/// @return true if visible (not occluded), false if occluded
-	bool testOcclusion(
-		const glm::mat4& modelMatrix,
-		const glm::vec3& modelMin,
-		const glm::vec3& modelMax,
-		const FrameState& frameState,
-		Shader& depthShader,
-		UniformBuffer& matricesUBO,
-		[[maybe_unused]] GLStateCache* stateCache = nullptr
-	);
-	
+
+	/// Replace the node set. Resets all visibility history and uploads one proxy box per node.
+	/// @param nodes Object-space node bounds (index = node id used by the other calls)
+	void setNodes(const std::vector<NodeBounds>& nodes);
+
+	/// Start a frame: read back every finished query (non-blocking) and frustum-cull the nodes.
+	/// @param modelMatrix Transform of the object the nodes belong to
+	/// @param frameState Pre-computed frame state (viewProj, camPos)
+	/// @return Node ids inside the frustum, sorted front to back
+	const std::vector<size_t>& beginFrame(const glm::mat4& modelMatrix, const FrameState& frameState);
+
+	/// Wrap the draw calls of one node returned by beginFrame() (exactly one begin/end pair per node).
+	void beginNode(size_t node);
+	void endNode(size_t node);
+
+	/// Issue bounding-box queries for the hidden nodes submitted this frame. Call after the main pass
+	/// with the object's model matrix already in the matrices UBO (the proxies are in object space).
+	/// @param depthShader Depth-only shader for the proxies
+	/// @param cache OpenGL state cache (color/depth writes are disabled around the proxies)
+	void queryHiddenNodes(Shader& depthShader, GLStateCache& cache);
+
 	bool isSupported() const { return mOcclusionQuerySupported; }
-	bool getLastResult() const { return mLastOcclusionResult; }
+	size_t nodeCount() const { return mNodes.size(); }
+	bool isVisible(size_t node) const { return node >= mNodes.size() || mNodes[node].visible; }
+	const Stats& stats() const { return mStats; }
 
 private:
-	unsigned int mOcclusionQuery = 0;
+	struct Node {
+		NodeBounds bounds;
+		GLuint query = 0;
+		unsigned int lastSeenFrame = 0;  // Last frame the node was inside the frustum
+		unsigned int issuedFrame = 0;    // Frame the pending query was issued
+		bool visible = true;
+		bool pending = false;            // Query issued, result not read back yet
+		bool queried = false;            // Query holds a result conditional rendering can use
+	};
+
+	void releaseQueries();
+
 	bool mOcclusionQuerySupported = false;
-	bool mLastOcclusionResult = true;
-	
-	// Persistent occlusion proxy (unit cube representing AABB)
+	std::vector<Node> mNodes;
+	std::vector<size_t> mFrameNodes;  // In-frustum nodes of the current frame (front to back)
+	std::vector<float> mNodeDistances;
+	unsigned int mFrame = 1;
+	glm::vec3 mObjectCamPos = glm::vec3(0.0f);
+	bool mQueryActive = false;
+	bool mConditionalActive = false;
+	Stats mStats;
+
+	// Proxy boxes: 8 object-space corners per node, drawn with a shared 36-index list and a base vertex
 	GlVertexArray mOcclusionVAO;
 	GlBuffer mOcclusionVBO;
 	GlBuffer mOcclusionEBO;
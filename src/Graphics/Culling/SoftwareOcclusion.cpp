@@ -0,0 +1,301 @@
+#include "Graphics/Culling/SoftwareOcclusion.hpp"
+#include "Graphics/Utils.hpp"
+#include "Graphics/WorkerPool.hpp"
+#include "Graphics/Profiling/CpuProfiler.hpp"
+#include "Graphics/Profiling/MemoryTracker.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <glad/glad.h>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define PHV_X86_DISPATCH 1
+#include <immintrin.h>
+#endif
+
+namespace Graphics {
+
+static_assert(SoftwareOcclusionBuffer::kWidth % SoftwareOcclusionBuffer::kTileSize == 0, "Width must be whole tiles");
+static_assert(SoftwareOcclusionBuffer::kBandRows % SoftwareOcclusionBuffer::kTileSize == 0, "Bands must be whole tile rows");
+static_assert(SoftwareOcclusionBuffer::kHeight % SoftwareOcclusionBuffer::kBandRows == 0, "Height must be whole bands");
+
+static constexpr int kTilesX = SoftwareOcclusionBuffer::kWidth / SoftwareOcclusionBuffer::kTileSize;
+static constexpr int kTilesY = SoftwareOcclusionBuffer::kHeight / SoftwareOcclusionBuffer::kTileSize;
+static constexpr int kBandCount = SoftwareOcclusionBuffer::kHeight / SoftwareOcclusionBuffer::kBandRows;
+static constexpr float kNearW = 1e-5f;  // Vertices with clip w below this are behind the camera
+
+using Triangle = SoftwareOcclusionBuffer::Triangle;
+using RasterFn = void (*)(const Triangle&, int, int, float*);
+
+// ----------------------------------------------------------------------------
+// Rasterizer kernels: rows [y0, y1] of one triangle, keeping the nearest depth
+// ----------------------------------------------------------------------------
+
+// Both kernels evaluate A*x + (B*y + C) in the same order, so they write identical bits
+static void rasterizeScalar(const Triangle& t, int y0, int y1, float* depth) {
+	for (int y = y0; y <= y1; ++y) {
+		float py = static_cast<float>(y) + 0.5f;
+		float r0 = t.edgeB[0] * py + t.edgeC[0];
+		float r1 = t.edgeB[1] * py + t.edgeC[1];
+		float r2 = t.edgeB[2] * py + t.edgeC[2];
+		float rz = t.depthB * py + t.depthC;
+		float* row = depth + y * SoftwareOcclusionBuffer::kWidth;
+		for (int x = t.minX; x <= t.maxX; ++x) {
+			float px = static_cast<float>(x) + 0.5f;
+			float e0 = t.edgeA[0] * px + r0;
+			float e1 = t.edgeA[1] * px + r1;
+			float e2 = t.edgeA[2] * px + r2;
+			if (e0 < 0.0f || e1 < 0.0f || e2 < 0.0f) continue;
+			float z = t.depthA * px + rz;
+			row[x] = std::min(row[x], z);
+		}
+	}
+}
+
+#if defined(PHV_X86_DISPATCH)
+
+// Eight pixels per step; the buffer width is a multiple of 8, so aligned-down spans stay inside the row
+__attribute__((target("avx2")))
+static void rasterizeAVX2(const Triangle& t, int y0, int y1, float* depth) {
+	const __m256 lane = _mm256_setr_ps(0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f);
+	const __m256 zero = _mm256_setzero_ps();
+	const __m256 a0 = _mm256_set1_ps(t.edgeA[0]), a1 = _mm256_set1_ps(t.edgeA[1]), a2 = _mm256_set1_ps(t.edgeA[2]);
+	const __m256 za = _mm256_set1_ps(t.depthA);
+	const int xStart = t.minX & ~7;
+	for (int y = y0; y <= y1; ++y) {
+		float py = static_cast<float>(y) + 0.5f;
+		const __m256 r0 = _mm256_set1_ps(t.edgeB[0] * py + t.edgeC[0]);
+		const __m256 r1 = _mm256_set1_ps(t.edgeB[1] * py + t.edgeC[1]);
+		const __m256 r2 = _mm256_set1_ps(t.edgeB[2] * py + t.edgeC[2]);
+		const __m256 rz = _mm256_set1_ps(t.depthB * py + t.depthC);
+		float* row = depth + y * SoftwareOcclusionBuffer::kWidth;
+		for (int x = xStart; x <= t.maxX; x += 8) {
+			__m256 px = _mm256_add_ps(_mm256_set1_ps(static_cast<float>(x)), lane);
+			__m256 inside = _mm256_and_ps(
+				_mm256_and_ps(_mm256_cmp_ps(_mm256_add_ps(_mm256_mul_ps(a0, px), r0), zero, _CMP_GE_OQ),
+				              _mm256_cmp_ps(_mm256_add_ps(_mm256_mul_ps(a1, px), r1), zero, _CMP_GE_OQ)),
+				_mm256_cmp_ps(_mm256_add_ps(_mm256_mul_ps(a2, px), r2), zero, _CMP_GE_OQ));
+			if (_mm256_movemask_ps(inside) == 0) continue;
+			__m256 z = _mm256_add_ps(_mm256_mul_ps(za, px), rz);
+			__m256 current = _mm256_loadu_ps(row + x);
+			_mm256_storeu_ps(row + x, _mm256_blendv_ps(current, _mm256_min_ps(current, z), inside));
+		}
+	}
+}
+
+static bool cpuHasAVX2() {
+	static const bool avx2 = []() { __builtin_cpu_init(); return __builtin_cpu_supports("avx2") != 0; }();
+	return avx2;
+}
+
+#endif // PHV_X86_DISPATCH
+
+static RasterFn rasterFn() {
+#if defined(PHV_X86_DISPATCH)
+	if (cpuHasAVX2()) return rasterizeAVX2;
+#endif
+	return rasterizeScalar;
+}
+
+const char* SoftwareOcclusionBuffer::simdPathName() {
+	return rasterFn() == rasterizeScalar ? "Scalar" : "AVX2";
+}
+
+// ----------------------------------------------------------------------------
+// SoftwareOcclusionBuffer
+// ----------------------------------------------------------------------------
+
+SoftwareOcclusionBuffer::SoftwareOcclusionBuffer(bool forceScalar)
+	: mDepth(static_cast<size_t>(kWidth * kHeight), 1.0f),
+	  mTileMax(static_cast<size_t>(kTilesX * kTilesY), 1.0f),
+	  mForceScalar(forceScalar) {}
+
+SoftwareOcclusionBuffer::~SoftwareOcclusionBuffer() {
+	if (mDebugTexture != 0) {
+		GLStateCache::instance().onTextureDeleted(mDebugTexture);
+		glDeleteTextures(1, &mDebugTexture);
+		MemoryTracker::instance().release(MemoryCategory::Other, static_cast<size_t>(kWidth * kHeight));
+	}
+}
+
+void SoftwareOcclusionBuffer::beginFrame(const glm::mat4& viewProj) {
+	mFrameStartNs = CpuProfiler::nowNs();
+	mViewProj = viewProj;
+	std::fill(mDepth.begin(), mDepth.end(), 1.0f);
+	std::fill(mTileMax.begin(), mTileMax.end(), 1.0f);
+	mTriangles.clear();
+	mStats = Stats{};
+}
+
+float SoftwareOcclusionBuffer::projectedArea(const glm::vec3& min, const glm::vec3& max, const glm::mat4& modelMatrix) const {
+	glm::mat4 mvp = mViewProj * modelMatrix;
+	float minX = std::numeric_limits<float>::max(), minY = minX;
+	float maxX = -minX, maxY = -minX;
+	for (int c = 0; c < 8; ++c) {
+		glm::vec4 clip = mvp * glm::vec4((c & 1) ? max.x : min.x, (c & 2) ? max.y : min.y, (c & 4) ? max.z : min.z, 1.0f);
+		if (clip.w <= kNearW) return static_cast<float>(kWidth * kHeight);
+		float x = (clip.x / clip.w * 0.5f + 0.5f) * kWidth;
+		float y = (clip.y / clip.w * 0.5f + 0.5f) * kHeight;
+		minX = std::min(minX, x); maxX = std::max(maxX, x);
+		minY = std::min(minY, y); maxY = std::max(maxY, y);
+	}
+	float w = std::min(maxX, static_cast<float>(kWidth)) - std::max(minX, 0.0f);
+	float h = std::min(maxY, static_cast<float>(kHeight)) - std::max(minY, 0.0f);
+	return (w > 0.0f && h > 0.0f) ? w * h : 0.0f;
+}
+
+bool SoftwareOcclusionBuffer::addOccluder(const std::vector<glm::vec3>& positions, const std::vector<unsigned int>& indices, const glm::mat4& modelMatrix) {
+	if (mTriangles.size() >= Config::SoftwareOcclusionMaxTriangles) return false;
+
+	// Project every vertex once
+	glm::mat4 mvp = mViewProj * modelMatrix;
+	mScreen.resize(positions.size());
+	for (size_t i = 0; i < positions.size(); ++i) {
+		glm::vec4 clip = mvp * glm::vec4(positions[i], 1.0f);
+		if (clip.w <= kNearW) { mScreen[i] = glm::vec4(0.0f, 0.0f, 0.0f, -1.0f); continue; }
+		mScreen[i] = glm::vec4((clip.x / clip.w * 0.5f + 0.5f) * kWidth,
+		                       (clip.y / clip.w * 0.5f + 0.5f) * kHeight,
+		                       clip.z / clip.w * 0.5f + 0.5f, clip.w);
+	}
+
+	for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+		const glm::vec4& v0 = mScreen[indices[i]];
+		const glm::vec4& v1 = mScreen[indices[i + 1]];
+		const glm::vec4& v2 = mScreen[indices[i + 2]];
+		// Triangles crossing the near plane are dropped: fewer occluders only means less culling
+		if (v0.w < 0.0f || v1.w < 0.0f || v2.w < 0.0f) continue;
+		// Back faces and degenerates (counter-clockwise front faces, as on the GPU)
+		float area = (v1.x - v0.x) * (v2.y - v0.y) - (v2.x - v0.x) * (v1.y - v0.y);
+		if (area <= 0.0f) continue;
+
+		Triangle t;
+		t.minX = std::max(0, static_cast<int>(std::floor(std::min(v0.x, std::min(v1.x, v2.x)))));
+		t.maxX = std::min(kWidth - 1, static_cast<int>(std::ceil(std::max(v0.x, std::max(v1.x, v2.x)))));
+		t.minY = std::max(0, static_cast<int>(std::floor(std::min(v0.y, std::min(v1.y, v2.y)))));
+		t.maxY = std::min(kHeight - 1, static_cast<int>(std::ceil(std::max(v0.y, std::max(v1.y, v2.y)))));
+		if (t.minX > t.maxX || t.minY > t.maxY) continue;
+
+		// Edge opposite each vertex: E = A*x + B*y + C, positive inside; E_i / area is vertex i's weight
+		const glm::vec4* v[3] = {&v0, &v1, &v2};
+		float invArea = 1.0f / area;
+		t.depthA = t.depthB = t.depthC = 0.0f;
+		for (int e = 0; e < 3; ++e) {
+			const glm::vec4& a = *v[(e + 1) % 3];
+			const glm::vec4& b = *v[(e + 2) % 3];
+			t.edgeA[e] = a.y - b.y;
+			t.edgeB[e] = b.x - a.x;
+			t.edgeC[e] = -(t.edgeA[e] * a.x + t.edgeB[e] * a.y);
+			// Screen-space depth is affine, so the plane is the weight-blend of the vertex depths
+			t.depthA += v[e]->z * t.edgeA[e] * invArea;
+			t.depthB += v[e]->z * t.edgeB[e] * invArea;
+			t.depthC += v[e]->z * t.edgeC[e] * invArea;
+		}
+		mTriangles.push_back(t);
+	}
+	mStats.occluders++;
+	mStats.triangles = static_cast<unsigned int>(mTriangles.size());
+	return true;
+}
+
+void SoftwareOcclusionBuffer::rasterizeBand(int band) {
+	const int y0 = band * kBandRows;
+	const int y1 = y0 + kBandRows - 1;
+	const RasterFn raster = mForceScalar ? rasterizeScalar : rasterFn();
+	for (const Triangle& t : mTriangles) {
+		if (t.maxY < y0 || t.minY > y1) continue;
+		raster(t, std::max(t.minY, y0), std::min(t.maxY, y1), mDepth.data());
+	}
+
+	// Hi-Z: farthest depth of each tile in this band
+	for (int ty = y0 / kTileSize; ty <= y1 / kTileSize; ++ty) {
+		for (int tx = 0; tx < kTilesX; ++tx) {
+			float farthest = 0.0f;
+			for (int y = ty * kTileSize; y < (ty + 1) * kTileSize; ++y) {
+				const float* row = mDepth.data() + y * kWidth + tx * kTileSize;
+				for (int x = 0; x < kTileSize; ++x) farthest = std::max(farthest, row[x]);
+			}
+			mTileMax[static_cast<size_t>(ty * kTilesX + tx)] = farthest;
+		}
+	}
+}
+
+void SoftwareOcclusionBuffer::rasterize() {
+	PHV_CPU_SCOPE("SoftwareOcclusion::rasterize");
+	if (!mTriangles.empty()) {
+		// Bands own disjoint rows and Hi-Z tiles, so they need no synchronization
+		WorkerPool::instance().parallelFor(static_cast<size_t>(kBandCount), 1, [this](size_t begin, size_t end) {
+			for (size_t band = begin; band < end; ++band) rasterizeBand(static_cast<int>(band));
+		});
+	}
+	mStats.rasterMs = static_cast<double>(CpuProfiler::nowNs() - mFrameStartNs) * 1e-6;
+}
+
+bool SoftwareOcclusionBuffer::isOccluded(const glm::vec3& min, const glm::vec3& max, const glm::mat4& modelMatrix) {
+	mStats.tested++;
+	if (!hasOccluders()) return false;
+
+	// Screen rectangle and nearest depth of the box
+	glm::mat4 mvp = mViewProj * modelMatrix;
+	float minX = std::numeric_limits<float>::max(), minY = minX, minZ = minX;
+	float maxX = -minX, maxY = -minX;
+	for (int c = 0; c < 8; ++c) {
+		glm::vec4 clip = mvp * glm::vec4((c & 1) ? max.x : min.x, (c & 2) ? max.y : min.y, (c & 4) ? max.z : min.z, 1.0f);
+		if (clip.w <= kNearW) return false;  // Reaches behind the camera: treat as visible
+		float x = (clip.x / clip.w * 0.5f + 0.5f) * kWidth;
+		float y = (clip.y / clip.w * 0.5f + 0.5f) * kHeight;
+		minX = std::min(minX, x); maxX = std::max(maxX, x);
+		minY = std::min(minY, y); maxY = std::max(maxY, y);
+		minZ = std::min(minZ, clip.z / clip.w * 0.5f + 0.5f);
+	}
+	int x0 = std::max(0, static_cast<int>(std::floor(minX)));
+	int x1 = std::min(kWidth - 1, static_cast<int>(std::floor(maxX)));
+	int y0 = std::max(0, static_cast<int>(std::floor(minY)));
+	int y1 = std::min(kHeight - 1, static_cast<int>(std::floor(maxY)));
+	if (x0 > x1 || y0 > y1) return false;  // Off screen: the frustum test's call, not ours
+
+	// Whole tiles nearer than the box are hidden outright; only straddling tiles look at pixels
+	for (int ty = y0 / kTileSize; ty <= y1 / kTileSize; ++ty) {
+		for (int tx = x0 / kTileSize; tx <= x1 / kTileSize; ++tx) {
+			if (mTileMax[static_cast<size_t>(ty * kTilesX + tx)] < minZ) continue;
+			int py0 = std::max(y0, ty * kTileSize), py1 = std::min(y1, ty * kTileSize + kTileSize - 1);
+			int px0 = std::max(x0, tx * kTileSize), px1 = std::min(x1, tx * kTileSize + kTileSize - 1);
+			for (int y = py0; y <= py1; ++y) {
+				const float* row = mDepth.data() + y * kWidth;
+				for (int x = px0; x <= px1; ++x) {
+					if (row[x] >= minZ) return false;
+				}
+			}
+		}
+	}
+	mStats.culled++;
+	return true;
+}
+
+unsigned int SoftwareOcclusionBuffer::debugTexture() {
+	if (mDebugTexture == 0) {
+		glGenTextures(1, &mDebugTexture);
+		GLStateCache::instance().bindTexture(0, GL_TEXTURE_2D, mDebugTexture);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_G, GL_RED);  // Grey instead of red
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_B, GL_RED);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, kWidth, kHeight, 0, GL_RED, GL_UNSIGNED_BYTE, nullptr);
+		MemoryTracker::instance().allocate(MemoryCategory::Other, static_cast<size_t>(kWidth * kHeight));
+	}
+
+	// Stretch the occupied depth range so near geometry is bright and empty pixels are black
+	float nearest = *std::min_element(mDepth.begin(), mDepth.end());
+	float scale = nearest < 1.0f ? 255.0f / (1.0f - nearest) : 0.0f;
+	std::vector<unsigned char> pixels(mDepth.size());
+	for (size_t i = 0; i < mDepth.size(); ++i) {
+		pixels[i] = static_cast<unsigned char>(std::clamp((1.0f - mDepth[i]) * scale, 0.0f, 255.0f));
+	}
+	GLStateCache::instance().bindTexture(0, GL_TEXTURE_2D, mDebugTexture);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, kWidth, kHeight, GL_RED, GL_UNSIGNED_BYTE, pixels.data());
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	return mDebugTexture;
+}
+
+} // namespace Graphics
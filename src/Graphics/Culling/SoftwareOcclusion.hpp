@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace Graphics {
+
+/// Low-resolution CPU depth buffer for same-frame occlusion culling (masked-occlusion style).
+/// Each frame the largest on-screen occluders (low-poly meshes kept on the CPU) are rasterized into a
+/// kWidth x kHeight buffer on the shared WorkerPool, in horizontal bands, with an AVX2 inner
+/// loop where the CPU has it. A max-depth tile per kTileSize^2 pixels (Hi-Z) then lets isOccluded()
+/// reject most bounding boxes without touching individual pixels, so a node can be skipped before any
+/// GPU submission and without the latency of hardware queries.
+/// Occluders only need to be roughly right: a coarse LOD that bulges slightly may hide a sliver behind it.
+class SoftwareOcclusionBuffer {
+public:
+	static constexpr int kWidth = 256;
+	static constexpr int kHeight = 128;
+	static constexpr int kTileSize = 8;   // Hi-Z tile edge (pixels); one AVX2 register per tile row
+	static constexpr int kBandRows = 16;  // Rows per band (a multiple of kTileSize)
+
+	struct Stats {
+		unsigned int occluders = 0;   // Occluders rasterized this frame
+		unsigned int triangles = 0;   // Front-facing triangles set up this frame
+		unsigned int tested = 0;      // isOccluded() calls this frame
+		unsigned int culled = 0;      // ...that returned true
+		double rasterMs = 0.0;        // Setup + rasterization + Hi-Z build (CPU)
+	};
+
+	/// @param forceScalar Rasterize with the scalar kernel whatever the CPU (reference for the SIMD path)
+	explicit SoftwareOcclusionBuffer(bool forceScalar = false);
+	~SoftwareOcclusionBuffer();
+	SoftwareOcclusionBuffer(const SoftwareOcclusionBuffer&) = delete;
+	SoftwareOcclusionBuffer& operator=(const SoftwareOcclusionBuffer&) = delete;
+
+	/// Clear the buffer and start collecting occluders for a new view.
+	void beginFrame(const glm::mat4& viewProj);
+
+	/// Screen area (buffer pixels) covered by a box's projection; the whole screen if it crosses the near plane.
+	float projectedArea(const glm::vec3& min, const glm::vec3& max, const glm::mat4& modelMatrix) const;
+
+	/// Transform and set up one occluder's triangles (object space, counter-clockwise front faces).
+	/// @return false if the triangle budget (Config::SoftwareOcclusionMaxTriangles) is already spent
+	bool addOccluder(const std::vector<glm::vec3>& positions, const std::vector<unsigned int>& indices, const glm::mat4& modelMatrix);
+
+	/// Rasterize the queued occluders on the worker pool and build the Hi-Z tiles. Blocks until done.
+	void rasterize();
+
+	/// Test a box against the rasterized occluders.
+	/// @return true if every pixel the box covers already holds something nearer than the box
+	bool isOccluded(const glm::vec3& min, const glm::vec3& max, const glm::mat4& modelMatrix);
+
+	bool hasOccluders() const { return mStats.occluders > 0; }
+	/// Rasterized depth, kWidth x kHeight, row 0 at the bottom (0 = near, 1 = empty).
+	const std::vector<float>& depth() const { return mDepth; }
+	const Stats& stats() const { return mStats; }
+
+	/// GL texture (R8, kWidth x kHeight) showing the current buffer, near = bright. Uploaded on each call.
+	unsigned int debugTexture();
+
+	/// Name of the rasterizer path selected for this CPU (for the UI).
+	static const char* simdPathName();
+
+	// Set-up triangle in buffer pixels (shared with the rasterizer kernels)
+	struct Triangle {
+		float edgeA[3], edgeB[3], edgeC[3];  // Edge functions E = A*x + B*y + C (>= 0 inside)
+		float depthA, depthB, depthC;        // Depth plane z = A*x + B*y + C
+		int minX, maxX, minY, maxY;          // Clamped pixel bounds
+	};
+
+private:
+	void rasterizeBand(int band);
+
+	glm::mat4 mViewProj = glm::mat4(1.0f);
+	std::vector<float> mDepth;     // kWidth * kHeight, 0 = near, 1 = far (cleared to 1)
+	std::vector<float> mTileMax;   // Farthest depth per Hi-Z tile
+	std::vector<Triangle> mTriangles;
+	std::vector<glm::vec4> mScreen;  // Per-vertex scratch: pixel x, y, depth, w (< 0 if behind the near plane)
+	uint64_t mFrameStartNs = 0;
+	Stats mStats;
+	bool mForceScalar = false;
+
+	unsigned int mDebugTexture = 0;
+};
+
+} // namespace Graphics
@@ -4,6 +4,9 @@
 #include <cstdint>
 #include <glad/glad.h>
 
+#include "Graphics/Profiling/MemoryTracker.hpp"
+#include "Graphics/Utils.hpp"
+
 namespace Graphics {
 
 class DynamicLines {
@@ -33,55 +36,55 @@ public:
 	void updatePositions(const float* positionsXYZ, std::size_t floatCount) {
 		if (mIndexed) return; // wrong mode
 		if (floatCount > mPosCapacity) ensureCapacity(floatCount, 0);
-		glBindVertexArray(mVao);
-		glBindBuffer(GL_ARRAY_BUFFER, mVbo);
+		// GL_ARRAY_BUFFER is not VAO state: no VAO bind or unbind needed (avoids redundant binds per frame)
+		GLStateCache::instance().bindBuffer(GL_ARRAY_BUFFER, mVbo);
 		glBufferData(GL_ARRAY_BUFFER, mPosCapacity * sizeof(float), nullptr, GL_DYNAMIC_DRAW); // orphan
+		trackVbo(mPosCapacity * sizeof(float));
 		glBufferSubData(GL_ARRAY_BUFFER, 0, floatCount * sizeof(float), positionsXYZ);
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
-		glBindVertexArray(0);
 		mPosCount = floatCount;
 	}
 
 	// Update indexed lines: positions and indices (any one can be nullptr to keep previous)
 	void updateIndexed(const float* positionsXYZ, std::size_t floatCount, const uint32_t* indices, std::size_t indexCount) {
 		if (!mIndexed) return;
-		glBindVertexArray(mVao);
+		GLStateCache::instance().bindVertexArray(mVao);
 		if (positionsXYZ) {
 			if (floatCount > mPosCapacity) ensureCapacity(floatCount, mIdxCapacity);
-			glBindBuffer(GL_ARRAY_BUFFER, mVbo);
+			GLStateCache::instance().bindBuffer(GL_ARRAY_BUFFER, mVbo);
 			glBufferData(GL_ARRAY_BUFFER, mPosCapacity * sizeof(float), nullptr, GL_DYNAMIC_DRAW);
+			trackVbo(mPosCapacity * sizeof(float));
 			glBufferSubData(GL_ARRAY_BUFFER, 0, floatCount * sizeof(float), positionsXYZ);
-			glBindBuffer(GL_ARRAY_BUFFER, 0);
 			mPosCount = floatCount;
 		}
 		if (indices) {
 			if (indexCount > mIdxCapacity) ensureCapacity(mPosCapacity, indexCount);
-			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mEbo);
+			GLStateCache::instance().bindBuffer(GL_ELEMENT_ARRAY_BUFFER, mEbo);
 			glBufferData(GL_ELEMENT_ARRAY_BUFFER, mIdxCapacity * sizeof(uint32_t), nullptr, GL_DYNAMIC_DRAW);
+			trackEbo(mIdxCapacity * sizeof(uint32_t));
 			glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, indexCount * sizeof(uint32_t), indices);
 			mIdxCount = indexCount;
 		}
-		glBindVertexArray(0);
 	}
 
 	void draw() const {
 		if (mVao == 0) return;
-		glBindVertexArray(mVao);
+		if (mIndexed ? mIdxCount == 0 : mPosCount == 0) return;
+		GLStateCache::instance().bindVertexArray(mVao);
 		if (mIndexed) {
-			if (mIdxCount == 0) { glBindVertexArray(0); return; }
 			glDrawElements(GL_LINES, (GLsizei)mIdxCount, GL_UNSIGNED_INT, 0);
 		} else {
-			if (mPosCount == 0) { glBindVertexArray(0); return; }
 			GLsizei verts = (GLsizei)(mPosCount / 3);
 			glDrawArrays(GL_LINES, 0, verts);
 		}
-		glBindVertexArray(0);
 	}
 
 	void destroy() {
-		if (mEbo) { glDeleteBuffers(1, &mEbo); mEbo = 0; }
-		if (mVbo) { glDeleteBuffers(1, &mVbo); mVbo = 0; }
-		if (mVao) { glDeleteVertexArrays(1, &mVao); mVao = 0; }
+		GLStateCache& cache = GLStateCache::instance();
+		if (mEbo) { cache.onBufferDeleted(mEbo); glDeleteBuffers(1, &mEbo); mEbo = 0; }
+		if (mVbo) { cache.onBufferDeleted(mVbo); glDeleteBuffers(1, &mVbo); mVbo = 0; }
+		if (mVao) { cache.onVertexArrayDeleted(mVao); glDeleteVertexArrays(1, &mVao); mVao = 0; MemoryTracker::instance().trackVertexArray(-1); }
+		trackVbo(0);
+		trackEbo(0);
 		mPosCapacity = mIdxCapacity = mPosCount = mIdxCount = 0;
 	}
 
@@ -95,10 +98,16 @@ private:
 		mPosCount = o.mPosCount; o.mPosCount = 0;
 		mIdxCount = o.mIdxCount; o.mIdxCount = 0;
 		mIndexed = o.mIndexed; o.mIndexed = false;
+		mVboBytes = o.mVboBytes; o.mVboBytes = 0;
+		mEboBytes = o.mEboBytes; o.mEboBytes = 0;
 	}
 
+	// Streaming buffers are re-specified on every update; report the allocated capacity
+	void trackVbo(std::size_t bytes) { MemoryTracker::instance().resize(MemoryCategory::Streaming, mVboBytes, bytes); mVboBytes = bytes; }
+	void trackEbo(std::size_t bytes) { MemoryTracker::instance().resize(MemoryCategory::Streaming, mEboBytes, bytes); mEboBytes = bytes; }
+
 	void ensureCapacity(std::size_t posFloats, std::size_t idxCount) {
-		if (mVao == 0) glGenVertexArrays(1, &mVao);
+		if (mVao == 0) { glGenVertexArrays(1, &mVao); MemoryTracker::instance().trackVertexArray(+1); }
 		if (mVbo == 0) glGenBuffers(1, &mVbo);
 		if (idxCount > 0 && mEbo == 0) glGenBuffers(1, &mEbo);
 		mPosCapacity = std::max(mPosCapacity, posFloats);
@@ -106,31 +115,35 @@ private:
 	}
 
 	void setupVAO_PosOnly() {
-		glBindVertexArray(mVao);
-		glBindBuffer(GL_ARRAY_BUFFER, mVbo);
+		GLStateCache::instance().bindVertexArray(mVao);
+		GLStateCache::instance().bindBuffer(GL_ARRAY_BUFFER, mVbo);
 		glBufferData(GL_ARRAY_BUFFER, mPosCapacity * sizeof(float), nullptr, GL_DYNAMIC_DRAW);
+		trackVbo(mPosCapacity * sizeof(float));
 		glEnableVertexAttribArray(0);
 		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
-		glBindVertexArray(0);
+		GLStateCache::instance().bindBuffer(GL_ARRAY_BUFFER, 0);
+		GLStateCache::instance().bindVertexArray(0);
 	}
 
 	void setupVAO_Indexed() {
-		glBindVertexArray(mVao);
-		glBindBuffer(GL_ARRAY_BUFFER, mVbo);
+		GLStateCache::instance().bindVertexArray(mVao);
+		GLStateCache::instance().bindBuffer(GL_ARRAY_BUFFER, mVbo);
 		glBufferData(GL_ARRAY_BUFFER, mPosCapacity * sizeof(float), nullptr, GL_DYNAMIC_DRAW);
+		trackVbo(mPosCapacity * sizeof(float));
 		glEnableVertexAttribArray(0);
 		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mEbo);
+		GLStateCache::instance().bindBuffer(GL_ELEMENT_ARRAY_BUFFER, mEbo);
 		glBufferData(GL_ELEMENT_ARRAY_BUFFER, mIdxCapacity * sizeof(uint32_t), nullptr, GL_DYNAMIC_DRAW);
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
-		glBindVertexArray(0);
+		trackEbo(mIdxCapacity * sizeof(uint32_t));
+		GLStateCache::instance().bindBuffer(GL_ARRAY_BUFFER, 0);
+		GLStateCache::instance().bindVertexArray(0);
 	}
 
 private:
 	GLuint mVao = 0, mVbo = 0, mEbo = 0;
 	std::size_t mPosCapacity = 0, mIdxCapacity = 0;
 	std::size_t mPosCount = 0, mIdxCount = 0;
+	std::size_t mVboBytes = 0, mEboBytes = 0;  // Bytes reported to MemoryTracker
 	bool mIndexed = false;
 };
 
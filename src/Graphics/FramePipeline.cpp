@@ -0,0 +1,96 @@
+#include "Graphics/FramePipeline.hpp"
+#include "Graphics/Profiling/CpuProfiler.hpp"
+
+#include <chrono>
+
+namespace Graphics {
+
+void FramePipeline::buildPacket(const FrameInput& input, FramePacket& out) {
+	PHV_CPU_SCOPE("FramePipeline::build");
+	using Clock = std::chrono::steady_clock;
+	Clock::time_point start = Clock::now();
+
+	out.frameState = input.frameState;
+	input.bounds.cull(input.frameState.viewProj, input.frustumCulling, out.visible);
+	out.queue.clear();
+	out.leaves.resize(input.objects.size());
+	for (LeafVisibility& leaves : out.leaves) leaves.valid = false;
+
+	for (uint32_t i : out.visible) {
+		const ObjectSnapshot& object = input.objects[i];
+		glm::vec3 center = glm::vec3(object.modelMatrix * glm::vec4(object.model->center(), 1.0f));
+		float depth = glm::length(center - input.frameState.camPos);
+		// Depth-only draws share one program and need no material
+		if (object.prepass) out.queue.push(RenderQueue::makeKey(RenderQueue::Pass::DepthPrepass, 0, object.geometry, 0, depth, input.farPlane), i);
+		out.queue.push(RenderQueue::makeKey(RenderQueue::Pass::Opaque, object.program, object.geometry, object.material, depth, input.farPlane), i);
+		if (object.leaves) Scene::cullLeaves(*object.model, object.modelMatrix, object.sphereRadius, input.frameState, out.leaves[i]);
+	}
+	out.queue.sort();
+	out.buildMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void FramePipeline::waitIdle(std::unique_lock<std::mutex>& lock) {
+	mDone.wait(lock, [this]() { return !mBusy; });
+}
+
+const FramePacket& FramePipeline::build(FrameInput input) {
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		waitIdle(lock);
+		mBackReady = false;  // Built for an older view: superseded by this one
+	}
+	buildPacket(input, mPackets[mFront]);
+	mLastPipelined = false;
+	return mPackets[mFront];
+}
+
+const FramePacket& FramePipeline::exchange(FrameInput input) {
+	std::unique_lock<std::mutex> lock(mMutex);
+	if (!mWorker.joinable()) mWorker = std::thread([this]() { workerLoop(); });
+	waitIdle(lock);
+	mLastPipelined = mBackReady;
+	if (mBackReady) {
+		mFront = 1 - mFront;
+		mBackReady = false;
+	} else {
+		lock.unlock();
+		buildPacket(input, mPackets[mFront]);
+		lock.lock();
+	}
+	mInput = std::move(input);
+	mBusy = true;
+	mWake.notify_one();
+	return mPackets[mFront];
+}
+
+void FramePipeline::stop() {
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		if (!mWorker.joinable()) return;
+		waitIdle(lock);
+		mQuit = true;
+		mBackReady = false;
+	}
+	mWake.notify_all();
+	mWorker.join();
+	mQuit = false;
+	mInput = FrameInput();  // Release the models the last snapshot kept alive
+}
+
+void FramePipeline::workerLoop() {
+	CpuProfiler::instance().setThreadName("Frame Pipeline");
+	std::unique_lock<std::mutex> lock(mMutex);
+	for (;;) {
+		mWake.wait(lock, [this]() { return mQuit || mBusy; });
+		if (mQuit) return;
+		FramePacket& back = mPackets[1 - mFront];
+		lock.unlock();
+		buildPacket(mInput, back);
+		lock.lock();
+		mBusy = false;
+		mBackReady = true;
+		mDone.notify_all();
+	}
+}
+
+} // namespace Graphics
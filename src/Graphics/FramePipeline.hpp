@@ -0,0 +1,104 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "Graphics/Model.h"
+#include "Graphics/RenderQueue.hpp"
+#include "Graphics/Scene.hpp"
+#include "Graphics/Utils.hpp"
+#include "Graphics/Culling/ObjectBounds.hpp"
+
+namespace Graphics {
+
+/// What the culling stage needs of one object, copied on the GL thread when a frame is handed over.
+/// The worker reads these values and the model's immutable geometry, never the Scene itself.
+struct ObjectSnapshot {
+	std::shared_ptr<const Model> model;
+	glm::mat4 modelMatrix = glm::mat4(1.0f);
+	float sphereRadius = 0.0f;
+	unsigned int program = 0;   // Scene::programKey()
+	unsigned int geometry = 0;  // World::modelIndex()
+	uint32_t material = 0;      // Scene::materialKey()
+	bool prepass = false;       // Gets an Early-Z depth draw
+	bool leaves = false;        // Point cloud drawn from its octree: cull its leaves ahead
+};
+
+/// Input of one frame: the camera and a snapshot of every object.
+struct FrameInput {
+	ObjectBounds bounds;           // World bounds for the object-level cull (a copy: the World may be laid out meanwhile)
+	FrameState frameState = FrameState(glm::mat4(1.0f), glm::mat4(1.0f), glm::vec3(0.0f));
+	float farPlane = 100.0f;       // Depth range of the sort keys
+	bool frustumCulling = true;
+	std::vector<ObjectSnapshot> objects;
+};
+
+/// Everything the GL thread needs to submit one frame. Not modified once handed out.
+struct FramePacket {
+	FrameState frameState = FrameState(glm::mat4(1.0f), glm::mat4(1.0f), glm::vec3(0.0f));  // Camera it was culled for
+	std::vector<uint32_t> visible;        // Objects inside the frustum
+	RenderQueue queue;                    // Sorted draws of the visible objects
+	std::vector<LeafVisibility> leaves;   // Per object; valid for visible point clouds drawn by leaves
+	double buildMs = 0.0;                 // CPU time spent building it
+};
+
+/// Object culling, render queue sorting and octree leaf culling, one frame ahead on a worker thread.
+/// Packets are double-buffered: while the GL thread submits the packet of frame N, the worker builds
+/// frame N+1's into the other one. Each exchange() waits for that build, hands the worker the next
+/// input and returns the finished packet, so the displayed view trails the camera by one frame and
+/// the culling cost is hidden behind submission. Still frames use build(), which culls the current
+/// view on the calling thread and drops whatever the worker had in flight.
+class FramePipeline {
+public:
+	struct Settings {
+		bool enabled = true;  // Interactive frames are built on the worker (one frame of latency)
+	};
+
+	Settings settings;
+
+	FramePipeline() = default;
+	~FramePipeline() { stop(); }
+	FramePipeline(const FramePipeline&) = delete;
+	FramePipeline& operator=(const FramePipeline&) = delete;
+
+	/// Build the packet for this input on the calling thread.
+	/// @return Packet valid until the next build() / exchange()
+	const FramePacket& build(FrameInput input);
+
+	/// Pipelined frame: collect the packet the worker built from the previous input and start
+	/// building this one. With nothing built ahead (first call, or after build()) this input is
+	/// also built on the calling thread.
+	/// @return Packet valid until the next build() / exchange()
+	const FramePacket& exchange(FrameInput input);
+
+	/// Finish the build in flight and stop the worker.
+	void stop();
+
+	/// Whether the last packet handed out was built on the worker.
+	bool lastPipelined() const { return mLastPipelined; }
+
+private:
+	static void buildPacket(const FrameInput& input, FramePacket& out);
+	void workerLoop();
+	void waitIdle(std::unique_lock<std::mutex>& lock);
+
+	FramePacket mPackets[2];
+	int mFront = 0;             // Packet the GL thread reads; the worker writes the other one
+	bool mBackReady = false;    // The worker finished a packet in the back buffer
+	bool mLastPipelined = false;
+
+	FrameInput mInput;          // Input of the build in flight (owned by the worker while mBusy)
+	std::thread mWorker;
+	std::mutex mMutex;
+	std::condition_variable mWake;
+	std::condition_variable mDone;
+	bool mBusy = false;
+	bool mQuit = false;
+};
+
+} // namespace Graphics
@@ -0,0 +1,234 @@
+#include "Graphics/MeshSimplifier.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+namespace Graphics {
+
+namespace {
+
+// Symmetric 4x4 error quadric plus accumulated weight (area), so errors can be
+// normalized to distances regardless of how many planes were merged.
+struct Quadric {
+	float a2 = 0, ab = 0, ac = 0, ad = 0;
+	float b2 = 0, bc = 0, bd = 0;
+	float c2 = 0, cd = 0;
+	float d2 = 0;
+	float w = 0;
+
+	void addPlane(const glm::vec3& n, float d, float weight) {
+		a2 += weight * n.x * n.x; ab += weight * n.x * n.y; ac += weight * n.x * n.z; ad += weight * n.x * d;
+		b2 += weight * n.y * n.y; bc += weight * n.y * n.z; bd += weight * n.y * d;
+		c2 += weight * n.z * n.z; cd += weight * n.z * d;
+		d2 += weight * d * d;
+		w += weight;
+	}
+
+	void add(const Quadric& q) {
+		a2 += q.a2; ab += q.ab; ac += q.ac; ad += q.ad;
+		b2 += q.b2; bc += q.bc; bd += q.bd;
+		c2 += q.c2; cd += q.cd;
+		d2 += q.d2;
+		w += q.w;
+	}
+
+	// Weighted squared distance of p to all accumulated planes
+	float evaluate(const glm::vec3& p) const {
+		float x = p.x, y = p.y, z = p.z;
+		float r = a2 * x * x + b2 * y * y + c2 * z * z
+		        + 2.0f * (ab * x * y + ac * x * z + bc * y * z)
+		        + 2.0f * (ad * x + bd * y + cd * z) + d2;
+		return r > 0.0f ? r : 0.0f;
+	}
+};
+
+struct Collapse {
+	float cost;         // Normalized squared error
+	unsigned int from;  // Vertex removed
+	unsigned int to;    // Vertex kept
+};
+
+// Border planes are weighted more heavily than surface planes so open edges stay in place
+constexpr float kBorderWeight = 10.0f;
+constexpr int kMaxPasses = 64;
+
+inline uint64_t directedKey(unsigned int a, unsigned int b) {
+	return (static_cast<uint64_t>(a) << 32) | b;
+}
+
+} // namespace
+
+std::vector<unsigned int> simplifyMesh(const std::vector<glm::vec3>& positions,
+                                       const std::vector<unsigned int>& indices,
+                                       size_t targetIndexCount,
+                                       float* outError,
+                                       const std::atomic<bool>* cancel) {
+	const size_t vertexCount = positions.size();
+	if (outError) *outError = 0.0f;
+
+	// Drop degenerate triangles up front
+	std::vector<unsigned int> tris;
+	tris.reserve(indices.size());
+	for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+		unsigned int a = indices[i], b = indices[i + 1], c = indices[i + 2];
+		if (a == b || b == c || a == c) continue;
+		if (a >= vertexCount || b >= vertexCount || c >= vertexCount) continue;
+		tris.push_back(a); tris.push_back(b); tris.push_back(c);
+	}
+	if (tris.size() <= targetIndexCount || vertexCount == 0) return tris;
+
+	// Work in a normalized unit box so float quadrics keep their precision
+	glm::vec3 bmin(std::numeric_limits<float>::max());
+	glm::vec3 bmax(-std::numeric_limits<float>::max());
+	for (const glm::vec3& p : positions) { bmin = glm::min(bmin, p); bmax = glm::max(bmax, p); }
+	glm::vec3 extent = bmax - bmin;
+	float maxExtent = std::max(extent.x, std::max(extent.y, extent.z));
+	float invExtent = (maxExtent > 0.0f) ? 1.0f / maxExtent : 1.0f;
+	std::vector<glm::vec3> pos(vertexCount);
+	for (size_t i = 0; i < vertexCount; ++i) pos[i] = (positions[i] - bmin) * invExtent;
+
+	// Face quadrics (area weighted)
+	std::vector<Quadric> quadrics(vertexCount);
+	for (size_t t = 0; t < tris.size(); t += 3) {
+		const glm::vec3& p0 = pos[tris[t]];
+		const glm::vec3& p1 = pos[tris[t + 1]];
+		const glm::vec3& p2 = pos[tris[t + 2]];
+		glm::vec3 n = glm::cross(p1 - p0, p2 - p0);
+		float len = glm::length(n);
+		if (len <= 0.0f) continue;
+		n /= len;
+		float d = -glm::dot(n, p0);
+		float area = 0.5f * len;
+		for (int k = 0; k < 3; ++k) quadrics[tris[t + k]].addPlane(n, d, area);
+	}
+
+	// Border quadrics: a directed edge without its reverse lies on an open boundary
+	{
+		std::vector<uint64_t> directed;
+		directed.reserve(tris.size());
+		for (size_t t = 0; t < tris.size(); t += 3) {
+			for (int k = 0; k < 3; ++k) directed.push_back(directedKey(tris[t + k], tris[t + (k + 1) % 3]));
+		}
+		std::sort(directed.begin(), directed.end());
+		for (size_t t = 0; t < tris.size(); t += 3) {
+			const glm::vec3& p0 = pos[tris[t]];
+			glm::vec3 faceN = glm::cross(pos[tris[t + 1]] - p0, pos[tris[t + 2]] - p0);
+			float faceLen = glm::length(faceN);
+			if (faceLen <= 0.0f) continue;
+			faceN /= faceLen;
+			for (int k = 0; k < 3; ++k) {
+				unsigned int a = tris[t + k], b = tris[t + (k + 1) % 3];
+				if (std::binary_search(directed.begin(), directed.end(), directedKey(b, a))) continue;
+				glm::vec3 edge = pos[b] - pos[a];
+				float edgeLen = glm::length(edge);
+				if (edgeLen <= 0.0f) continue;
+				glm::vec3 n = glm::cross(edge / edgeLen, faceN);
+				float d = -glm::dot(n, pos[a]);
+				float weight = kBorderWeight * edgeLen * edgeLen;
+				quadrics[a].addPlane(n, d, weight);
+				quadrics[b].addPlane(n, d, weight);
+			}
+		}
+	}
+
+	std::vector<Collapse> collapses;
+	std::vector<unsigned int> adjOffsets(vertexCount + 1);
+	std::vector<unsigned int> adjTris;
+	std::vector<unsigned char> locked(vertexCount);
+	std::vector<unsigned int> remap(vertexCount);
+	float maxCost = 0.0f;
+
+	for (int pass = 0; pass < kMaxPasses && tris.size() > targetIndexCount; ++pass) {
+		if (cancel && cancel->load(std::memory_order_relaxed)) break;
+
+		// Candidate edges: each interior edge is seen from both faces, keep the a < b direction only.
+		// Border edges whose only direction has a > b are skipped, which just keeps them longer.
+		collapses.clear();
+		collapses.reserve(tris.size() / 2);
+		for (size_t t = 0; t < tris.size(); t += 3) {
+			for (int k = 0; k < 3; ++k) {
+				unsigned int a = tris[t + k], b = tris[t + (k + 1) % 3];
+				if (a > b) continue;
+				Quadric q = quadrics[a];
+				q.add(quadrics[b]);
+				float invW = 1.0f / std::max(q.w, 1e-12f);
+				float costAB = q.evaluate(pos[b]) * invW;  // a collapses onto b
+				float costBA = q.evaluate(pos[a]) * invW;  // b collapses onto a
+				if (costAB <= costBA) collapses.push_back({costAB, a, b});
+				else collapses.push_back({costBA, b, a});
+			}
+		}
+		if (collapses.empty()) break;
+		std::sort(collapses.begin(), collapses.end(), [](const Collapse& l, const Collapse& r) { return l.cost < r.cost; });
+
+		// Vertex -> triangle adjacency (CSR) for flip checks and locking
+		std::fill(adjOffsets.begin(), adjOffsets.end(), 0u);
+		for (unsigned int v : tris) adjOffsets[v + 1]++;
+		for (size_t i = 0; i < vertexCount; ++i) adjOffsets[i + 1] += adjOffsets[i];
+		adjTris.resize(tris.size());
+		{
+			std::vector<unsigned int> fill(adjOffsets.begin(), adjOffsets.end() - 1);
+			for (size_t t = 0; t < tris.size(); t += 3) {
+				unsigned int triIndex = static_cast<unsigned int>(t / 3);
+				for (int k = 0; k < 3; ++k) adjTris[fill[tris[t + k]]++] = triIndex;
+			}
+		}
+
+		std::fill(locked.begin(), locked.end(), static_cast<unsigned char>(0));
+		for (size_t i = 0; i < vertexCount; ++i) remap[i] = static_cast<unsigned int>(i);
+
+		const size_t trianglesToRemove = (tris.size() - targetIndexCount) / 3 + 1;
+		size_t removed = 0;
+		size_t applied = 0;
+
+		for (const Collapse& c : collapses) {
+			if (removed >= trianglesToRemove) break;
+			if (locked[c.from] || locked[c.to]) continue;
+
+			// Reject collapses that flip any surviving triangle around 'from'
+			bool valid = true;
+			size_t shared = 0;
+			for (unsigned int k = adjOffsets[c.from]; k < adjOffsets[c.from + 1]; ++k) {
+				const unsigned int* tri = &tris[static_cast<size_t>(adjTris[k]) * 3];
+				if (tri[0] == c.to || tri[1] == c.to || tri[2] == c.to) { shared++; continue; }
+				glm::vec3 p[3], q[3];
+				for (int j = 0; j < 3; ++j) {
+					p[j] = pos[tri[j]];
+					q[j] = (tri[j] == c.from) ? pos[c.to] : p[j];
+				}
+				glm::vec3 before = glm::cross(p[1] - p[0], p[2] - p[0]);
+				glm::vec3 after = glm::cross(q[1] - q[0], q[2] - q[0]);
+				if (glm::dot(before, after) <= 0.0f) { valid = false; break; }
+			}
+			if (!valid) continue;
+
+			remap[c.from] = c.to;
+			quadrics[c.to].add(quadrics[c.from]);
+			for (unsigned int k = adjOffsets[c.from]; k < adjOffsets[c.from + 1]; ++k) {
+				const unsigned int* tri = &tris[static_cast<size_t>(adjTris[k]) * 3];
+				locked[tri[0]] = locked[tri[1]] = locked[tri[2]] = 1;
+			}
+			locked[c.to] = 1;
+			removed += shared;
+			applied++;
+			maxCost = std::max(maxCost, c.cost);
+		}
+		if (applied == 0) break;
+
+		// Rewrite the triangle list and drop triangles that became degenerate
+		size_t write = 0;
+		for (size_t t = 0; t < tris.size(); t += 3) {
+			unsigned int a = remap[tris[t]], b = remap[tris[t + 1]], c = remap[tris[t + 2]];
+			if (a == b || b == c || a == c) continue;
+			tris[write++] = a; tris[write++] = b; tris[write++] = c;
+		}
+		tris.resize(write);
+	}
+
+	if (outError) *outError = std::sqrt(maxCost) * maxExtent;
+	return tris;
+}
+
+} // namespace Graphics
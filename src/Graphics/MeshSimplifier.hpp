@@ -0,0 +1,30 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace Graphics {
+
+/// Index-count ratios (relative to full detail) of the LOD chain built for every mesh.
+/// Each level simplifies the previous one.
+static constexpr float kMeshLodRatios[] = {0.5f, 0.25f, 0.1f, 0.03f};
+
+/// Simplify an indexed triangle list with quadric-error edge collapse (Garland & Heckbert).
+/// Vertices are only ever collapsed onto other existing vertices, so the result indexes the
+/// original vertex buffer and every LOD level can share the mesh's VBO.
+/// Open borders are preserved with perpendicular penalty planes; collapses that would flip a
+/// triangle are rejected.
+/// @param positions Vertex positions
+/// @param indices Triangle list (3 indices per triangle)
+/// @param targetIndexCount Desired index count (the result may be larger if the mesh cannot be reduced further)
+/// @param outError Optional: largest collapse error, in the same units as positions
+/// @param cancel Optional flag polled between passes; returns the partial result when set
+/// @return Simplified triangle list
+std::vector<unsigned int> simplifyMesh(const std::vector<glm::vec3>& positions,
+                                       const std::vector<unsigned int>& indices,
+                                       size_t targetIndexCount,
+                                       float* outError = nullptr,
+                                       const std::atomic<bool>* cancel = nullptr);
+
+} // namespace Graphics
@@ -1,6 +1,11 @@
 #include "Model.h"
 #include "SpatialIndex.hpp"
 #include "Graphics/Utils.hpp"
+#include "Graphics/MeshSimplifier.hpp"
+#include "Graphics/VertexPacking.hpp"
+#include "Graphics/Shader.h"
+#include "Graphics/Profiling/GpuProfiler.hpp"
+#include "Graphics/Profiling/CpuProfiler.hpp"
 
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
@@ -19,8 +24,8 @@
 #include <thread>
 #include <mutex>
 #include <atomic>
-
-using Graphics::Half::floatToHalf;
+#include <chrono>
+#include <random>
 
 namespace Graphics {
 
@@ -49,11 +54,29 @@ static Vertex makeVertex(const aiMesh* mesh, unsigned int i) {
 	return v;
 }
 
+// Keep only the vertices a triangle list references
+static OccluderMesh compactOccluder(const std::vector<glm::vec3>& positions, const std::vector<unsigned int>& indices) {
+	OccluderMesh occluder;
+	std::vector<unsigned int> remap(positions.size(), std::numeric_limits<unsigned int>::max());
+	occluder.indices.reserve(indices.size());
+	for (unsigned int index : indices) {
+		if (index >= positions.size()) return OccluderMesh{};
+		if (remap[index] == std::numeric_limits<unsigned int>::max()) {
+			remap[index] = static_cast<unsigned int>(occluder.positions.size());
+			occluder.positions.push_back(positions[index]);
+		}
+		occluder.indices.push_back(remap[index]);
+	}
+	return occluder;
+}
+
 // Loads models from various formats supported by Assimp, including:
 // - .obj, .ply, .off (polygon formats - automatically triangulated)
 // - .stl, .fbx, .dae, .3ds, and many others
 // - Point clouds: files with vertices but no faces (detected automatically)
 bool Model::loadFromFile(const std::string& path, std::string& outError) {
+	PHV_CPU_SCOPE("Model::loadFromFile");
+	cancelLodBuild();
 	mMeshes.clear();
 	Assimp::Importer importer;
 	const aiScene* scene = importer.ReadFile(
@@ -137,6 +160,8 @@ bool Model::loadFromFile(const std::string& path, std::string& outError) {
 		}
 		
 		mesh.vertexCount = static_cast<unsigned int>(mesh.vertices.size());
+		mesh.boundsMin = meshMin;
+		mesh.boundsMax = meshMax;
 		
 		// Thread-safe merge of bounds
 		{
@@ -164,6 +189,8 @@ bool Model::loadFromFile(const std::string& path, std::string& outError) {
 		// Distribute meshes across threads
 		for (unsigned int t = 0; t < numThreads; ++t) {
 			threads.emplace_back([&, t, numThreads]() {
+				CpuProfiler::instance().setThreadName("Mesh Loader");
+				PHV_CPU_SCOPE("Model::processMeshes");
 				for (unsigned int m = t; m < scene->mNumMeshes; m += numThreads) {
 					processMesh(m);
 				}
@@ -215,16 +242,234 @@ bool Model::loadFromFile(const std::string& path, std::string& outError) {
 		}
 	}
 	
+	// Simplified LOD levels are generated in the background; update() uploads them when ready
+	startLodBuild();
+
+	// Meshes too small for a LOD chain are their own occluder (LOD meshes get their coarsest level later)
+	for (Mesh& mesh : mMeshes) {
+		if (mesh.isPointCloud || mesh.indexCount == 0 || mesh.indexCount / 3 >= Graphics::Config::MeshLodMinTriangles) continue;
+		std::vector<glm::vec3> positions;
+		positions.reserve(mesh.vertices.size());
+		for (const Vertex& v : mesh.vertices) positions.push_back(v.position);
+		mesh.occluder = compactOccluder(positions, mesh.indices);
+	}
+	
+	updateCpuMemoryAccounting();
 	return true;
 }
 
+// ============================================================================
+// Background LOD generation
+// ============================================================================
+
+// Shared between the model and its worker threads. Workers hold their own reference,
+// so a cancelled build can finish (or bail out) after the model has moved on.
+struct LodBuildState {
+	struct Level {
+		std::vector<unsigned int> indices;
+		float error = 0.0f;
+	};
+	struct Input {
+		std::vector<glm::vec3> positions;
+		std::vector<unsigned int> indices;
+	};
+	std::vector<Input> inputs;                 // Per mesh; empty input = no LODs for that mesh
+	std::vector<std::vector<Level>> levels;    // Per mesh results, written by exactly one worker
+	std::vector<OccluderMesh> occluders;       // Per mesh coarsest level, compacted (same writer as levels)
+	std::atomic<unsigned int> nextMesh{0};
+	std::atomic<unsigned int> pendingMeshes{0};
+	std::atomic<bool> cancel{false};
+};
+
+static void buildLodChain(LodBuildState& state, unsigned int meshIndex) {
+	LodBuildState::Input& input = state.inputs[meshIndex];
+	std::vector<LodBuildState::Level>& levels = state.levels[meshIndex];
+	const size_t baseCount = input.indices.size();
+	levels.reserve(sizeof(kMeshLodRatios) / sizeof(kMeshLodRatios[0]));  // 'source' points into levels
+	const std::vector<unsigned int>* source = &input.indices;
+	float error = 0.0f;
+
+	// Each level simplifies the previous one, so later levels are cheap
+	for (float ratio : kMeshLodRatios) {
+		if (state.cancel.load(std::memory_order_relaxed)) break;
+		size_t target = static_cast<size_t>(static_cast<float>(baseCount) * ratio) / 3 * 3;
+		float levelError = 0.0f;
+		std::vector<unsigned int> simplified = simplifyMesh(input.positions, *source, target, &levelError, &state.cancel);
+		// Stop once the simplifier can no longer make meaningful progress
+		if (simplified.empty() || simplified.size() * 10 > source->size() * 9) break;
+		error = std::max(error, levelError);
+		levels.push_back({std::move(simplified), error});
+		source = &levels.back().indices;
+	}
+	if (!levels.empty()) state.occluders[meshIndex] = compactOccluder(input.positions, levels.back().indices);
+
+	input.positions.clear(); input.positions.shrink_to_fit();
+	input.indices.clear(); input.indices.shrink_to_fit();
+}
+
+void Model::startLodBuild() {
+	std::vector<unsigned int> candidates;
+	for (unsigned int m = 0; m < mMeshes.size(); ++m) {
+		const Mesh& mesh = mMeshes[m];
+		if (!mesh.isPointCloud && mesh.indexCount / 3 >= Graphics::Config::MeshLodMinTriangles) candidates.push_back(m);
+	}
+	if (candidates.empty()) return;
+
+	auto state = std::make_shared<LodBuildState>();
+	state->inputs.resize(mMeshes.size());
+	state->levels.resize(mMeshes.size());
+	state->occluders.resize(mMeshes.size());
+	// Copy positions and indices: uploadToGPU() drops the CPU vectors before the build finishes
+	for (unsigned int m : candidates) {
+		const Mesh& mesh = mMeshes[m];
+		LodBuildState::Input& input = state->inputs[m];
+		input.positions.reserve(mesh.vertices.size());
+		for (const Vertex& v : mesh.vertices) input.positions.push_back(v.position);
+		input.indices = mesh.indices;
+	}
+	state->pendingMeshes.store(static_cast<unsigned int>(candidates.size()));
+
+	unsigned int numThreads = std::min(static_cast<unsigned int>(std::thread::hardware_concurrency()), static_cast<unsigned int>(candidates.size()));
+	numThreads = std::max(numThreads, 1u);
+	for (unsigned int t = 0; t < numThreads; ++t) {
+		mLodWorkers.emplace_back([state, candidates]() {
+			CpuProfiler::instance().setThreadName("LOD Worker");
+			for (;;) {
+				unsigned int slot = state->nextMesh.fetch_add(1);
+				if (slot >= candidates.size()) break;
+				PHV_CPU_SCOPE("buildLodChain");
+				buildLodChain(*state, candidates[slot]);
+				state->pendingMeshes.fetch_sub(1, std::memory_order_release);
+			}
+		});
+	}
+	mLodBuild = std::move(state);
+}
+
+void Model::cancelLodBuild() {
+	// The simplifier polls the flag, so the workers stop within one simplification pass
+	if (mLodBuild) mLodBuild->cancel.store(true);
+	joinLodWorkers();
+	mLodBuild.reset();
+}
+
+void Model::joinLodWorkers() {
+	for (std::thread& worker : mLodWorkers) worker.join();
+	mLodWorkers.clear();
+}
+
+Model::~Model() {
+	cancelLodBuild();
+}
+
+void Model::update() {
+	if (!mLodBuild || mLodBuild->pendingMeshes.load(std::memory_order_acquire) != 0) return;
+	for (const Mesh& mesh : mMeshes) {
+		if (!mesh.isPointCloud && !mesh.vao.valid()) return;  // Wait for uploadToGPU()
+	}
+
+	joinLodWorkers();  // Every mesh is done: the workers are on their way out
+	for (size_t m = 0; m < mMeshes.size(); ++m) {
+		Mesh& mesh = mMeshes[m];
+		if (!mLodBuild->occluders[m].empty()) mesh.occluder = std::move(mLodBuild->occluders[m]);
+		std::vector<LodBuildState::Level>& levels = mLodBuild->levels[m];
+		if (levels.empty() || !mesh.ebo.valid()) continue;
+
+		// Single EBO per mesh: full detail first, then each LOD range appended
+		const size_t indexSize = mesh.uses16BitIndices ? sizeof(uint16_t) : sizeof(unsigned int);
+		size_t totalIndices = mesh.indexCount;
+		for (const auto& level : levels) totalIndices += level.indices.size();
+
+		GlBuffer combined;
+		combined.create(MemoryCategory::Indices);
+		combined.bind(GL_COPY_WRITE_BUFFER);
+		combined.setData(GL_COPY_WRITE_BUFFER, (GLsizeiptr)(totalIndices * indexSize), nullptr, GL_STATIC_DRAW);
+		mesh.ebo.bind(GL_COPY_READ_BUFFER);
+		glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, (GLsizeiptr)(mesh.indexCount * indexSize));
+
+		mesh.lods.clear();
+		size_t offset = mesh.indexCount;
+		std::vector<uint16_t> indices16;
+		for (const auto& level : levels) {
+			const void* data = level.indices.data();
+			if (mesh.uses16BitIndices) {
+				indices16.assign(level.indices.begin(), level.indices.end());
+				data = indices16.data();
+			}
+			glBufferSubData(GL_COPY_WRITE_BUFFER, (GLintptr)(offset * indexSize), (GLsizeiptr)(level.indices.size() * indexSize), data);
+			mesh.lods.push_back({static_cast<unsigned int>(offset), static_cast<unsigned int>(level.indices.size()), level.error});
+			offset += level.indices.size();
+		}
+		// Point the VAO at the combined buffer, then release the old one
+		mesh.vao.bind();
+		combined.bind(GL_ELEMENT_ARRAY_BUFFER);
+		mesh.ebo = std::move(combined);
+	}
+	mLodBuild.reset();
+	updateCpuMemoryAccounting();  // Occluder copies moved in
+}
+
+size_t Model::lodLevelCount() const {
+	size_t count = 0;
+	for (const Mesh& mesh : mMeshes) count = std::max(count, mesh.lods.size());
+	return count;
+}
+
+int Model::selectLod(const Mesh& mesh, const glm::mat4& modelMatrix, float modelScale, const FrameState& frameState, float maxErrorPixels) const {
+	if (mesh.lods.empty() || maxErrorPixels <= 0.0f || frameState.viewportSize.y <= 0.0f) return -1;
+
+	// Distance from the camera to the mesh's bounding sphere (conservative: nearest point)
+	glm::vec3 center = glm::vec3(modelMatrix * glm::vec4(0.5f * (mesh.boundsMin + mesh.boundsMax), 1.0f));
+	float radius = 0.5f * glm::length(mesh.boundsMax - mesh.boundsMin) * modelScale;
+	float distance = std::max(glm::length(frameState.camPos - center) - radius, 1e-4f);
+
+	// Pixels covered by one object-space unit at that distance (perspective projection)
+	float pixelsPerUnit = 0.5f * frameState.viewportSize.y * frameState.proj[1][1] * modelScale / distance;
+
+	int level = -1;
+	for (size_t i = 0; i < mesh.lods.size(); ++i) {
+		if (mesh.lods[i].error * pixelsPerUnit > maxErrorPixels) break;
+		level = static_cast<int>(i);
+	}
+	return level;
+}
+
+void Model::updateCpuMemoryAccounting() {
+	size_t bytes = mMeshes.capacity() * sizeof(Mesh);
+	for (const Mesh& mesh : mMeshes) {
+		bytes += mesh.vertices.capacity() * sizeof(Vertex);
+		bytes += mesh.indices.capacity() * sizeof(unsigned int);
+		bytes += mesh.occluder.positions.capacity() * sizeof(glm::vec3);
+		bytes += mesh.occluder.indices.capacity() * sizeof(unsigned int);
+	}
+	mCpuBytes.set(bytes);
+}
+
+// Allocate the buffer and let fill() write straight into driver memory, skipping a
+// temporary CPU copy. Falls back to a staging vector if mapping fails or the
+// mapped contents are lost on unmap.
+template <typename Fill>
+static void uploadMapped(GlBuffer& buffer, GLenum target, size_t bytes, Fill&& fill) {
+	buffer.setData(target, (GLsizeiptr)bytes, nullptr, GL_STATIC_DRAW);
+	if (void* ptr = glMapBufferRange(target, 0, (GLsizeiptr)bytes, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT)) {
+		fill(ptr);
+		if (glUnmapBuffer(target) == GL_TRUE) return;
+	}
+	std::vector<unsigned char> staging(bytes);
+	fill(staging.data());
+	glBufferSubData(target, 0, (GLsizeiptr)bytes, staging.data());
+}
+
 void Model::uploadToGPU(bool dropCpu) {
+	PHV_CPU_SCOPE("Model::uploadToGPU");
+	auto uploadStart = std::chrono::steady_clock::now();
+	size_t uploadedVertices = 0;
 	for (Mesh& mesh : mMeshes) {
 		if (mesh.vao.valid()) continue;
 		mesh.vao.create();
-		mesh.vbo.create();
+		mesh.vbo.create(MemoryCategory::Vertices);
 		if (!mesh.isPointCloud) {
-			mesh.ebo.create();
+			mesh.ebo.create(MemoryCategory::Indices);
 		}
 
 		mesh.vao.bind();
@@ -240,33 +485,13 @@ void Model::uploadToGPU(bool dropCpu) {
 			// Pack vertices with half-floats for positions and UVs
 			// Layout: pos (6 bytes, half-float vec3), normal (12 bytes, float vec3), 
 			//         uv (4 bytes, half-float vec2), color (12 bytes, float vec3), scalar (4 bytes, float)
-			// Total: 38 bytes per vertex (vs 48 bytes)
-			
-            // Use shared optimized vertex format
+			// Packed straight into the mapped VBO with SIMD conversion on worker threads
             using Graphics::OptimizedVertex;
-			// Calculate actual size with compiler padding (typically 40-44 bytes due to alignment)
-			
-			std::vector<OptimizedVertex> optimizedVertices;
-			optimizedVertices.reserve(mesh.vertexCount);
-			
-			for (const Vertex& v : mesh.vertices) {
-				OptimizedVertex ov;
-				ov.pos[0] = floatToHalf(v.position.x);
-				ov.pos[1] = floatToHalf(v.position.y);
-				ov.pos[2] = floatToHalf(v.position.z);
-				ov.normal[0] = v.normal.x;
-				ov.normal[1] = v.normal.y;
-				ov.normal[2] = v.normal.z;
-				ov.uv[0] = floatToHalf(v.texcoord.x);
-				ov.uv[1] = floatToHalf(v.texcoord.y);
-				ov.color[0] = v.color.x;
-				ov.color[1] = v.color.y;
-				ov.color[2] = v.color.z;
-				ov.scalar = v.scalar;
-				optimizedVertices.push_back(ov);
-			}
-			
-			mesh.vbo.setData(GL_ARRAY_BUFFER, (GLsizeiptr)(mesh.vertexCount * sizeof(OptimizedVertex)), optimizedVertices.data(), GL_STATIC_DRAW);
+			const Vertex* src = mesh.vertices.data();
+			const size_t count = mesh.vertexCount;
+			uploadMapped(mesh.vbo, GL_ARRAY_BUFFER, count * sizeof(OptimizedVertex), [src, count](void* dst) {
+				VertexPacking::packOptimizedVertices(src, count, static_cast<OptimizedVertex*>(dst));
+			});
 		} else {
 			// Use standard full-float vertex format
 			mesh.vbo.setData(GL_ARRAY_BUFFER, (GLsizeiptr)(mesh.vertexCount * sizeof(Vertex)), mesh.vertices.data(), GL_STATIC_DRAW);
@@ -276,37 +501,20 @@ void Model::uploadToGPU(bool dropCpu) {
 			mesh.ebo.bind(GL_ELEMENT_ARRAY_BUFFER);
 			
 			// Index buffer optimization: use 16-bit indices if vertex count < 65k
-			// This reduces index buffer memory by 50% and improves cache performance
-			mesh.uses16BitIndices = (mesh.vertexCount < 65536);
+			// This reduces index buffer memory by 50% and improves cache performance.
+			// A single SIMD max-reduction validates that every index fits before narrowing.
+			mesh.uses16BitIndices = (mesh.vertexCount < 65536) &&
+				VertexPacking::maxIndex(mesh.indices.data(), mesh.indexCount) < 65536;
 			
 			if (mesh.uses16BitIndices) {
-				// Convert indices to uint16_t
-				std::vector<uint16_t> indices16;
-				indices16.reserve(mesh.indexCount);
-				
-				// Validate all indices fit in 16-bit range
-				bool allFit = true;
-				for (unsigned int idx : mesh.indices) {
-					if (idx >= 65536) {
-						allFit = false;
-						break;
-					}
-				}
-				
-				if (allFit) {
-					// All indices fit, convert to 16-bit
-					for (unsigned int idx : mesh.indices) {
-						indices16.push_back(static_cast<uint16_t>(idx));
-					}
-					// Upload as 16-bit indices (50% memory savings)
-					mesh.ebo.setData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)(mesh.indexCount * sizeof(uint16_t)), indices16.data(), GL_STATIC_DRAW);
-				} else {
-					// Some indices exceed 16-bit range, fall back to 32-bit
-					mesh.uses16BitIndices = false;
-					mesh.ebo.setData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)(mesh.indexCount * sizeof(unsigned int)), mesh.indices.data(), GL_STATIC_DRAW);
-				}
+				// Narrow into the mapped EBO (50% memory savings)
+				const unsigned int* src = mesh.indices.data();
+				const size_t count = mesh.indexCount;
+				uploadMapped(mesh.ebo, GL_ELEMENT_ARRAY_BUFFER, count * sizeof(uint16_t), [src, count](void* dst) {
+					VertexPacking::narrowIndices(src, count, static_cast<uint16_t*>(dst));
+				});
 			} else {
-				// Use 32-bit indices (vertex count >= 65k or already decided)
+				// Use 32-bit indices (vertex count >= 65k or an index exceeds 16-bit range)
 				mesh.ebo.setData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)(mesh.indexCount * sizeof(unsigned int)), mesh.indices.data(), GL_STATIC_DRAW);
 			}
 		}
@@ -351,9 +559,17 @@ void Model::uploadToGPU(bool dropCpu) {
 			glVertexAttribPointer(4, 1, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, scalar));
 		}
 
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		uploadedVertices += mesh.vertexCount;
+	}
+	if (mPointClusters.empty()) buildPointClusters();
+	if (!mPointInstanceVBO.valid() && isPointCloud()) buildPointInstances({});
+	GLStateCache::instance().bindVertexArray(0);  // Later element-buffer binds must not land in a mesh VAO
+
+	if (uploadedVertices > 0) {
+		auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - uploadStart).count();
+		std::cout << "GPU upload: " << uploadedVertices << " vertices in " << elapsed << " ms ("
+		          << VertexPacking::simdPathName() << ")\n";
 	}
-	glBindVertexArray(0);
 
 	if (dropCpu) {
 		for (Mesh& mesh : mMeshes) {
@@ -361,6 +577,7 @@ void Model::uploadToGPU(bool dropCpu) {
 			mesh.indices.clear(); mesh.indices.shrink_to_fit();
 		}
 	}
+	updateCpuMemoryAccounting();
 }
 
 void Model::draw() const {
@@ -370,7 +587,7 @@ void Model::draw() const {
 			if (!warned) { std::cerr << "Model draw: encountered mesh with no VAO (skip)\n"; warned = true; }
 			continue;
 		}
-		glBindVertexArray(mesh.vao.id());
+		mesh.vao.bind();
 		if (mesh.isPointCloud) {
 			// Point cloud - use GL_POINTS
 			glDrawArrays(GL_POINTS, 0, (GLsizei)mesh.vertexCount);
@@ -382,31 +599,125 @@ void Model::draw() const {
 			glDrawElements(GL_TRIANGLES, (GLsizei)mesh.indexCount, indexType, 0);
 		}
 	}
-	glBindVertexArray(0);
 }
 
-void Model::drawPoints(float pointSize) const {
-	static float sLastPointSize = 0.0f;
-	if (pointSize != sLastPointSize) {
-		glPointSize(pointSize);
-		sLastPointSize = pointSize;
+// Largest axis scale of the model matrix (errors are measured in object space)
+static float maxAxisScale(const glm::mat4& modelMatrix) {
+	return std::max(glm::length(glm::vec3(modelMatrix[0])),
+	       std::max(glm::length(glm::vec3(modelMatrix[1])), glm::length(glm::vec3(modelMatrix[2]))));
+}
+
+unsigned int Model::draw(const glm::mat4& modelMatrix, const FrameState& frameState, float maxErrorPixels) const {
+	float modelScale = maxAxisScale(modelMatrix);
+	unsigned int triangles = 0;
+	for (const Mesh& mesh : mMeshes) {
+		triangles += drawMeshLod(mesh, modelMatrix, modelScale, frameState, maxErrorPixels);
+	}
+	return triangles;
+}
+
+unsigned int Model::drawMesh(size_t meshIndex, const glm::mat4& modelMatrix, const FrameState& frameState, float maxErrorPixels) const {
+	if (meshIndex >= mMeshes.size()) return 0;
+	return drawMeshLod(mMeshes[meshIndex], modelMatrix, maxAxisScale(modelMatrix), frameState, maxErrorPixels);
+}
+
+int Model::lodLevel(size_t meshIndex, const glm::mat4& modelMatrix, const FrameState& frameState, float maxErrorPixels) const {
+	if (meshIndex >= mMeshes.size()) return -1;
+	return selectLod(mMeshes[meshIndex], modelMatrix, maxAxisScale(modelMatrix), frameState, maxErrorPixels);
+}
+
+unsigned int Model::drawMeshLod(const Mesh& mesh, const glm::mat4& modelMatrix, float modelScale, const FrameState& frameState, float maxErrorPixels) const {
+	if (!mesh.vao.valid()) return 0;
+	mesh.vao.bind();
+	if (mesh.isPointCloud) {
+		glDrawArrays(GL_POINTS, 0, (GLsizei)mesh.vertexCount);
+		return 0;
+	}
+	if (mesh.indexCount == 0) return 0;
+	PHV_GPU_SCOPE("Mesh Batch");  // One scope per mesh node (capped by GpuProfiler::kMaxScopesPerFrame)
+	GLenum indexType = mesh.uses16BitIndices ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+	size_t indexSize = mesh.uses16BitIndices ? sizeof(uint16_t) : sizeof(unsigned int);
+	unsigned int offset = 0, count = mesh.indexCount;
+	int level = selectLod(mesh, modelMatrix, modelScale, frameState, maxErrorPixels);
+	if (level >= 0) {
+		offset = mesh.lods[static_cast<size_t>(level)].indexOffset;
+		count = mesh.lods[static_cast<size_t>(level)].indexCount;
 	}
+	if (mWireframeShader) bindWireframeLookup(mesh, offset);
+	glDrawElements(GL_TRIANGLES, (GLsizei)count, indexType, (void*)(offset * indexSize));
+	return count / 3;
+}
+
+unsigned int Model::drawMeshInstanced(size_t meshIndex, int level, unsigned int instances) const {
+	if (meshIndex >= mMeshes.size() || instances == 0) return 0;
+	const Mesh& mesh = mMeshes[meshIndex];
+	if (!mesh.vao.valid() || mesh.isPointCloud || mesh.indexCount == 0) return 0;
+	mesh.vao.bind();
+	PHV_GPU_SCOPE("Mesh Instances");
+	GLenum indexType = mesh.uses16BitIndices ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+	size_t indexSize = mesh.uses16BitIndices ? sizeof(uint16_t) : sizeof(unsigned int);
+	unsigned int offset = 0, count = mesh.indexCount;
+	if (level >= 0 && static_cast<size_t>(level) < mesh.lods.size()) {
+		offset = mesh.lods[static_cast<size_t>(level)].indexOffset;
+		count = mesh.lods[static_cast<size_t>(level)].indexCount;
+	}
+	if (mWireframeShader) bindWireframeLookup(mesh, offset);
+	glDrawElementsInstanced(GL_TRIANGLES, (GLsizei)count, indexType, (void*)(offset * indexSize), (GLsizei)instances);
+	return count / 3 * instances;
+}
+
+void Model::bindWireframeLookup(const Mesh& mesh, unsigned int firstIndex) const {
+	if (mWireframeLookups.size() != mMeshes.size()) mWireframeLookups.resize(mMeshes.size());
+	WireframeLookup& lookup = mWireframeLookups[static_cast<size_t>(&mesh - mMeshes.data())];
+	// Both lookups view the mesh's own buffers: nothing is copied or read back. Positions are the first
+	// field of the interleaved vertex, fetched one component per texel at the vertex stride.
+	const bool half = mesh.usesOptimizedVertices;
+	const size_t componentSize = half ? sizeof(uint16_t) : sizeof(float);
+	const size_t stride = (half ? sizeof(OptimizedVertex) : sizeof(Vertex)) / componentSize;
+	if (lookup.supported && lookup.positionTexture == 0) {
+		GLint maxTexels = 0;
+		glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &maxTexels);
+		size_t indexCount = mesh.indexCount;
+		for (const MeshLod& lod : mesh.lods) indexCount = std::max<size_t>(indexCount, lod.indexOffset + lod.indexCount);
+		if (mesh.vertexCount * stride > static_cast<size_t>(maxTexels) || indexCount > static_cast<size_t>(maxTexels)) {
+			std::cerr << "Wireframe: mesh exceeds GL_MAX_TEXTURE_BUFFER_SIZE (" << maxTexels << "), drawn solid\n";
+			lookup.supported = false;
+		} else {
+			glGenTextures(1, &lookup.positionTexture);
+			glGenTextures(1, &lookup.indexTexture);
+			GLStateCache::instance().bindTexture(kWireframeTextureUnit + 1, GL_TEXTURE_BUFFER, lookup.positionTexture);
+			glTexBuffer(GL_TEXTURE_BUFFER, half ? GL_R16F : GL_R32F, mesh.vbo.id());
+		}
+	}
+	if (!lookup.supported) {
+		mWireframeShader->setInt("uWireFirstIndex", -1);
+		return;
+	}
+
+	GLStateCache& cache = GLStateCache::instance();
+	cache.bindTexture(kWireframeTextureUnit, GL_TEXTURE_BUFFER, lookup.indexTexture);
+	if (lookup.indexSource != mesh.ebo.id()) {
+		glTexBuffer(GL_TEXTURE_BUFFER, mesh.uses16BitIndices ? GL_R16UI : GL_R32UI, mesh.ebo.id());
+		lookup.indexSource = mesh.ebo.id();
+	}
+	cache.bindTexture(kWireframeTextureUnit + 1, GL_TEXTURE_BUFFER, lookup.positionTexture);
+	mWireframeShader->setInt("uWirePositionStride", static_cast<int>(stride));
+	mWireframeShader->setInt("uWireFirstIndex", static_cast<int>(firstIndex));
+}
+
+void Model::drawPoints(float pointSize) const {
+	GLStateCache::instance().pointSize(pointSize);
 	for (const Mesh& mesh : mMeshes) {
 		if (!mesh.vao.valid() || mesh.vertexCount == 0) continue;
-		glBindVertexArray(mesh.vao.id());
+		mesh.vao.bind();
 		glDrawArrays(GL_POINTS, 0, (GLsizei)mesh.vertexCount);
 	}
-	glBindVertexArray(0);
 }
 
 void Model::drawPointsSubset(const std::vector<unsigned int>& indices, float pointSize) const {
 	if (indices.empty()) return;
 	
-	static float sLastPointSize = 0.0f;
-	if (pointSize != sLastPointSize) {
-		glPointSize(pointSize);
-		sLastPointSize = pointSize;
-	}
+	GLStateCache::instance().pointSize(pointSize);
 	
 	// For spatial indexing, we need to render only a subset of points
 	// We'll use glDrawElements with a temporary index buffer or use instanced rendering
@@ -418,13 +729,17 @@ void Model::drawPointsSubset(const std::vector<unsigned int>& indices, float poi
 	if (!mMeshes.empty() && mMeshes[0].isPointCloud && mMeshes[0].vao.valid()) {
 		const Mesh& mesh = mMeshes[0];
 		
-		// Create temporary index buffer for visible points
+		// Create temporary index buffer for visible points, attached to the point cloud's VAO
+		// (element array bindings are VAO state; the VAO has no EBO of its own)
+		GLStateCache& cache = GLStateCache::instance();
+		mesh.vao.bind();
 		GLuint tempEBO = 0;
 		glGenBuffers(1, &tempEBO);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, tempEBO);
+		cache.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, tempEBO);
 		glBufferData(GL_ELEMENT_ARRAY_BUFFER, 
 		             static_cast<GLsizeiptr>(indices.size() * sizeof(unsigned int)),
 		             indices.data(), GL_DYNAMIC_DRAW);
+		size_t tempBytes = indices.size() * sizeof(unsigned int);
 		
 		// Use 16-bit or 32-bit indices based on max index
 		unsigned int maxIdx = 0;
@@ -443,36 +758,236 @@ void Model::drawPointsSubset(const std::vector<unsigned int>& indices, float poi
 			glBufferData(GL_ELEMENT_ARRAY_BUFFER,
 			             static_cast<GLsizeiptr>(indices16.size() * sizeof(uint16_t)),
 			             indices16.data(), GL_DYNAMIC_DRAW);
+			tempBytes = indices16.size() * sizeof(uint16_t);
 		}
+		// Transient, but it still counts towards the frame's peak usage
+		MemoryTracker::instance().allocate(MemoryCategory::Octree, tempBytes);
 		
-		glBindVertexArray(mesh.vao.id());
 		glDrawElements(GL_POINTS, static_cast<GLsizei>(indices.size()), indexType, 0);
-		glBindVertexArray(0);
 		
-		// Clean up temporary buffer
+		// Clean up temporary buffer (deleting it also detaches it from the bound VAO)
+		cache.onBufferDeleted(tempEBO);
 		glDeleteBuffers(1, &tempEBO);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+		MemoryTracker::instance().release(MemoryCategory::Octree, tempBytes);
 	}
 }
 
-void Model::drawSphereImpostors(float pointSize) const {
-	// Sphere impostors: expand points into billboard quads via geometry shader
-	// For now, use GL_POINTS (geometry shader will be added in shader)
-	// The shader needs to handle the sphere impostor rendering
-	static float sLastPointSize = 0.0f;
-	if (pointSize != sLastPointSize) {
-		glPointSize(pointSize);
-		sLastPointSize = pointSize;
+void Model::buildPointClusters() {
+	// Leaf ranges index the first mesh's VBO (octree indices are global across meshes)
+	if (!mSpatialIndex.valid() || mMeshes.size() != 1 || !mMeshes[0].isPointCloud || !mMeshes[0].vao.valid()) return;
+
+	// Depth-first leaf order keeps spatially close leaves close in the buffer
+	std::vector<unsigned int> indices;
+	indices.reserve(mMeshes[0].vertexCount);
+	std::mt19937 rng(0x5eed);  // Fixed seed: the same cloud always gets the same subsamples
+	std::vector<const Octree::Node*> stack{mSpatialIndex.root()};
+	while (!stack.empty()) {
+		const Octree::Node* node = stack.back();
+		stack.pop_back();
+		if (node->isLeaf) {
+			if (node->pointIndices.empty()) continue;
+			PointCluster cluster;
+			cluster.boundsMin = node->min;
+			cluster.boundsMax = node->max;
+			cluster.indexOffset = static_cast<unsigned int>(indices.size());
+			cluster.indexCount = static_cast<unsigned int>(node->pointIndices.size());
+			indices.insert(indices.end(), node->pointIndices.begin(), node->pointIndices.end());
+			std::shuffle(indices.begin() + cluster.indexOffset, indices.end(), rng);
+			mPointClusters.push_back(cluster);
+			continue;
+		}
+		for (int i = 7; i >= 0; --i) {
+			if (node->children[i]) stack.push_back(node->children[i].get());
+		}
 	}
-	for (const Mesh& mesh : mMeshes) {
-		if (!mesh.vao.valid() || mesh.vertexCount == 0) continue;
-		glBindVertexArray(mesh.vao.id());
-		glDrawArrays(GL_POINTS, 0, (GLsizei)mesh.vertexCount);
+
+	// Attached to the point cloud VAO (it has no EBO of its own)
+	mMeshes[0].vao.bind();
+	mClusterEBO.create(MemoryCategory::Octree);
+	mClusterEBO.bind(GL_ELEMENT_ARRAY_BUFFER);
+	mClusterEBO.setData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(indices.size() * sizeof(unsigned int)), indices.data(), GL_STATIC_DRAW);
+	buildPointInstances(indices);
+}
+
+void Model::drawPointCluster(size_t cluster, float pointSize) const {
+	if (cluster >= mPointClusters.size() || !mClusterEBO.valid()) return;
+	GLStateCache::instance().pointSize(pointSize);
+	mMeshes[0].vao.bind();
+	mClusterEBO.bind(GL_ELEMENT_ARRAY_BUFFER);  // drawPointsSubset() may have replaced it with a temporary EBO
+	const PointCluster& c = mPointClusters[cluster];
+	glDrawElements(GL_POINTS, (GLsizei)c.indexCount, GL_UNSIGNED_INT, (void*)(c.indexOffset * sizeof(unsigned int)));
+}
+
+namespace {
+struct PointInstance {
+	glm::vec3 position;
+	glm::vec3 color;
+	float scalar;
+};
+static_assert(sizeof(PointInstance) == sizeof(float) * 7, "Unexpected PointInstance size; check packing.");
+} // namespace
+
+void Model::buildPointInstances(const std::vector<unsigned int>& order) {
+	// Needs the CPU vertices, so this runs inside uploadToGPU() before they are dropped
+	std::vector<PointInstance> instances;
+	auto append = [&instances](const Vertex& v) { instances.push_back({v.position, v.color, v.scalar}); };
+	if (!order.empty()) {
+		const std::vector<Vertex>& vertices = mMeshes[0].vertices;
+		if (vertices.empty()) return;
+		instances.reserve(order.size());
+		for (unsigned int index : order) append(vertices[index]);
+	} else {
+		for (const Mesh& mesh : mMeshes) {
+			if (!mesh.isPointCloud) continue;
+			for (const Vertex& v : mesh.vertices) append(v);
+		}
+	}
+	if (instances.empty()) return;
+
+	mImpostorVAO.destroy();
+	mPointInstanceVBO.destroy();
+	mImpostorVAO.create();
+	mPointInstanceVBO.create(MemoryCategory::Vertices);
+	mImpostorVAO.bind();
+	mPointInstanceVBO.bind(GL_ARRAY_BUFFER);
+	mPointInstanceVBO.setData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(instances.size() * sizeof(PointInstance)), instances.data(), GL_STATIC_DRAW);
+	// Instance attributes (same locations as instanced_sphere.vert); the quad corner comes from gl_VertexID
+	for (GLuint location = 5; location <= 7; ++location) {
+		glEnableVertexAttribArray(location);
+		glVertexAttribDivisor(location, 1);
 	}
-	glBindVertexArray(0);
+	mPointInstanceCount = static_cast<unsigned int>(instances.size());
+	bindImpostorInstances(0);
+	GLStateCache::instance().bindVertexArray(0);
+}
+
+// Point the instance attributes (5 = position, 6 = color, 7 = scalar) of the bound VAO at the bound
+// GL_ARRAY_BUFFER, starting at firstInstance. GL 3.3 has no base instance, so this is how ranges are drawn.
+static void setPointInstanceAttributes(size_t firstInstance) {
+	const size_t base = firstInstance * sizeof(PointInstance);
+	glVertexAttribPointer(5, 3, GL_FLOAT, GL_FALSE, sizeof(PointInstance), (void*)(base + offsetof(PointInstance, position)));
+	glVertexAttribPointer(6, 3, GL_FLOAT, GL_FALSE, sizeof(PointInstance), (void*)(base + offsetof(PointInstance, color)));
+	glVertexAttribPointer(7, 1, GL_FLOAT, GL_FALSE, sizeof(PointInstance), (void*)(base + offsetof(PointInstance, scalar)));
+}
+
+namespace {
+// Copies ranges of the point instances (bound to GL_COPY_READ_BUFFER) into the instance stream (bound to
+// GL_COPY_WRITE_BUFFER) back to back; ranges adjacent in the source share one copy
+class InstanceGather {
+public:
+	explicit InstanceGather(size_t dst) : mDst(dst) {}
+	~InstanceGather() { flush(); }
+	void add(size_t first, size_t count) {
+		if (mCount > 0 && mFirst + mCount == first) { mCount += count; return; }
+		flush();
+		mFirst = first;
+		mCount = count;
+	}
+
+private:
+	void flush() {
+		if (mCount == 0) return;
+		glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, (GLintptr)(mFirst * sizeof(PointInstance)),
+		                    (GLintptr)(mDst * sizeof(PointInstance)), (GLsizeiptr)(mCount * sizeof(PointInstance)));
+		mDst += mCount;
+		mCount = 0;
+	}
+
+	size_t mDst;
+	size_t mFirst = 0;
+	size_t mCount = 0;
+};
+} // namespace
+
+void Model::beginInstanceStream(size_t instances) const {
+	// Orphan: the driver hands out fresh storage while earlier draws still read the old one
+	mInstanceStream.create(MemoryCategory::Vertices);
+	mInstanceStream.bind(GL_COPY_WRITE_BUFFER);
+	size_t capacity = std::max(mInstanceStream.sizeBytes(), instances * sizeof(PointInstance));
+	mInstanceStream.setData(GL_COPY_WRITE_BUFFER, (GLsizeiptr)capacity, nullptr, GL_STREAM_DRAW);
+	mPointInstanceVBO.bind(GL_COPY_READ_BUFFER);
+}
+
+void Model::bindImpostorInstances(unsigned int firstInstance) const {
+	mImpostorVAO.bind();
+	mPointInstanceVBO.bind(GL_ARRAY_BUFFER);
+	setPointInstanceAttributes(firstInstance);
+}
+
+void Model::drawSphereImpostors() const {
+	if (!mImpostorVAO.valid() || mPointInstanceCount == 0) return;
+	bindImpostorInstances(0);
+	glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, (GLsizei)mPointInstanceCount);
+}
+
+void Model::drawPointClusterBatch(const std::vector<size_t>& clusters, float pointSize) const {
+	if (clusters.empty() || !mClusterEBO.valid()) return;
+	std::vector<GLsizei> counts;
+	std::vector<const void*> offsets;
+	counts.reserve(clusters.size());
+	offsets.reserve(clusters.size());
+	for (size_t cluster : clusters) {
+		if (cluster >= mPointClusters.size()) continue;
+		counts.push_back((GLsizei)mPointClusters[cluster].indexCount);
+		offsets.push_back((const void*)(mPointClusters[cluster].indexOffset * sizeof(unsigned int)));
+	}
+	GLStateCache::instance().pointSize(pointSize);
+	mMeshes[0].vao.bind();
+	mClusterEBO.bind(GL_ELEMENT_ARRAY_BUFFER);
+	glMultiDrawElements(GL_POINTS, counts.data(), GL_UNSIGNED_INT, offsets.data(), (GLsizei)counts.size());
+}
+
+unsigned int Model::drawImpostorClusterBatch(const std::vector<std::pair<size_t, unsigned int>>& clusters) const {
+	if (clusters.empty() || !mImpostorVAO.valid()) return 0;
+	size_t total = 0;
+	for (const auto& c : clusters) total += std::min(c.second, mPointClusters[c.first].indexCount);
+	if (total == 0) return 0;
+	beginInstanceStream(total);
+	{
+		InstanceGather gather(0);
+		for (const auto& c : clusters) gather.add(mPointClusters[c.first].indexOffset, std::min(c.second, mPointClusters[c.first].indexCount));
+	}
+	mImpostorVAO.bind();
+	mInstanceStream.bind(GL_ARRAY_BUFFER);
+	setPointInstanceAttributes(0);
+	glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, (GLsizei)total);
+	return static_cast<unsigned int>(total);
+}
+
+unsigned int Model::drawImpostorClusterRanges(const std::vector<PointClusterRange>& ranges) const {
+	if (ranges.empty() || !mImpostorVAO.valid()) return 0;
+	auto clamped = [this](const PointClusterRange& r) {
+		unsigned int size = mPointClusters[r.cluster].indexCount;
+		return r.first >= size ? 0u : std::min(r.count, size - r.first);
+	};
+	size_t total = 0;
+	for (const PointClusterRange& r : ranges) total += clamped(r);
+	if (total == 0) return 0;
+	beginInstanceStream(total);
+	{
+		InstanceGather gather(0);
+		for (const PointClusterRange& r : ranges) {
+			unsigned int count = clamped(r);
+			if (count > 0) gather.add(mPointClusters[r.cluster].indexOffset + r.first, count);
+		}
+	}
+	mImpostorVAO.bind();
+	mInstanceStream.bind(GL_ARRAY_BUFFER);
+	setPointInstanceAttributes(0);
+	glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, (GLsizei)total);
+	return static_cast<unsigned int>(total);
+}
+
+void Model::drawImpostorCluster(size_t cluster, unsigned int instanceCount) const {
+	if (cluster >= mPointClusters.size() || !mImpostorVAO.valid()) return;
+	const PointCluster& c = mPointClusters[cluster];
+	instanceCount = std::min(instanceCount, c.indexCount);
+	if (instanceCount == 0) return;
+	bindImpostorInstances(c.indexOffset);
+	glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, (GLsizei)instanceCount);
 }
 
-void Model::generateSphereMesh(unsigned int subdivisions) const {
+void Model::generateSphereMesh() const {
 	if (mSphereMesh.initialized) return;
 	
 	// Generate icosphere
@@ -506,40 +1021,44 @@ void Model::generateSphereMesh(unsigned int subdivisions) const {
 		4, 9, 5,  2, 4, 11,  6, 2, 10,  8, 6, 7,  9, 8, 1
 	};
 	
-	// Subdivide for smoother sphere (simple midpoint subdivision)
-	for (unsigned int sub = 0; sub < subdivisions; ++sub) {
-		std::vector<unsigned int> newIndices;
-		std::unordered_map<unsigned long long, unsigned int> edgeToVertex;
-		
-		// Helper to get/create midpoint vertex for edge
-		auto getMidpoint = [&](unsigned int a, unsigned int b) -> unsigned int {
-			unsigned long long key = (static_cast<unsigned long long>(std::min(a, b)) << 32) | std::max(a, b);
-			auto it = edgeToVertex.find(key);
-			if (it != edgeToVertex.end()) return it->second;
-			
-			unsigned int newIdx = static_cast<unsigned int>(vertices.size());
-			vertices.push_back(glm::normalize((vertices[a] + vertices[b]) * 0.5f));
-			edgeToVertex[key] = newIdx;
-			return newIdx;
-		};
-		
-		// Subdivide each triangle into 4
-		for (size_t i = 0; i < indices.size(); i += 3) {
-			unsigned int v0 = indices[i];
-			unsigned int v1 = indices[i + 1];
-			unsigned int v2 = indices[i + 2];
+	// Level 0 is the icosahedron; each subdivision splits every triangle into 4 and appends the edge midpoints
+	std::vector<uint16_t> allIndices;
+	for (int level = 0; level < kSphereLodCount; ++level) {
+		if (level > 0) {
+			std::vector<unsigned int> newIndices;
+			std::unordered_map<unsigned long long, unsigned int> edgeToVertex;
 			
-			unsigned int m01 = getMidpoint(v0, v1);
-			unsigned int m12 = getMidpoint(v1, v2);
-			unsigned int m20 = getMidpoint(v2, v0);
+			// Helper to get/create midpoint vertex for edge
+			auto getMidpoint = [&](unsigned int a, unsigned int b) -> unsigned int {
+				unsigned long long key = (static_cast<unsigned long long>(std::min(a, b)) << 32) | std::max(a, b);
+				auto it = edgeToVertex.find(key);
+				if (it != edgeToVertex.end()) return it->second;
+				
+				unsigned int newIdx = static_cast<unsigned int>(vertices.size());
+				vertices.push_back(glm::normalize((vertices[a] + vertices[b]) * 0.5f));
+				edgeToVertex[key] = newIdx;
+				return newIdx;
+			};
 			
-			// Add 4 triangles
-			newIndices.insert(newIndices.end(), {v0, m01, m20});
-			newIndices.insert(newIndices.end(), {v1, m12, m01});
-			newIndices.insert(newIndices.end(), {v2, m20, m12});
-			newIndices.insert(newIndices.end(), {m01, m12, m20});
+			for (size_t i = 0; i < indices.size(); i += 3) {
+				unsigned int v0 = indices[i];
+				unsigned int v1 = indices[i + 1];
+				unsigned int v2 = indices[i + 2];
+				
+				unsigned int m01 = getMidpoint(v0, v1);
+				unsigned int m12 = getMidpoint(v1, v2);
+				unsigned int m20 = getMidpoint(v2, v0);
+				
+				newIndices.insert(newIndices.end(), {v0, m01, m20});
+				newIndices.insert(newIndices.end(), {v1, m12, m01});
+				newIndices.insert(newIndices.end(), {v2, m20, m12});
+				newIndices.insert(newIndices.end(), {m01, m12, m20});
+			}
+			indices = std::move(newIndices);
 		}
-		indices = newIndices;
+		mSphereMesh.indexOffset[level] = static_cast<unsigned int>(allIndices.size());
+		mSphereMesh.indexCount[level] = static_cast<unsigned int>(indices.size());
+		for (unsigned int idx : indices) allIndices.push_back(static_cast<uint16_t>(idx));  // 642 vertices at most
 	}
 	
 	// Build Vertex array for sphere mesh
@@ -557,45 +1076,14 @@ void Model::generateSphereMesh(unsigned int subdivisions) const {
 	
 	// Upload to GPU
 	mSphereMesh.vao.create();
-	mSphereMesh.vbo.create();
-	mSphereMesh.ebo.create();
+	mSphereMesh.vbo.create(MemoryCategory::Vertices);
+	mSphereMesh.ebo.create(MemoryCategory::Indices);
 	
 	mSphereMesh.vao.bind();
 	mSphereMesh.vbo.bind(GL_ARRAY_BUFFER);
 	mSphereMesh.vbo.setData(GL_ARRAY_BUFFER, (GLsizeiptr)(sphereVertices.size() * sizeof(Vertex)), sphereVertices.data(), GL_STATIC_DRAW);
-	
-	// Index buffer optimization: use 16-bit indices if vertex count < 65k
-	unsigned int sphereVertexCount = static_cast<unsigned int>(sphereVertices.size());
-	mSphereMesh.uses16BitIndices = (sphereVertexCount < 65536);
-	
-	if (mSphereMesh.uses16BitIndices) {
-		// Convert indices to uint16_t
-		std::vector<uint16_t> indices16;
-		indices16.reserve(indices.size());
-		
-		bool allFit = true;
-		for (unsigned int idx : indices) {
-			if (idx >= 65536) {
-				allFit = false;
-				break;
-			}
-		}
-		
-		if (allFit) {
-			for (unsigned int idx : indices) {
-				indices16.push_back(static_cast<uint16_t>(idx));
-			}
-			mSphereMesh.ebo.bind(GL_ELEMENT_ARRAY_BUFFER);
-			mSphereMesh.ebo.setData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)(indices.size() * sizeof(uint16_t)), indices16.data(), GL_STATIC_DRAW);
-		} else {
-			mSphereMesh.uses16BitIndices = false;
-			mSphereMesh.ebo.bind(GL_ELEMENT_ARRAY_BUFFER);
-			mSphereMesh.ebo.setData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)(indices.size() * sizeof(unsigned int)), indices.data(), GL_STATIC_DRAW);
-		}
-	} else {
-		mSphereMesh.ebo.bind(GL_ELEMENT_ARRAY_BUFFER);
-		mSphereMesh.ebo.setData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)(indices.size() * sizeof(unsigned int)), indices.data(), GL_STATIC_DRAW);
-	}
+	mSphereMesh.ebo.bind(GL_ELEMENT_ARRAY_BUFFER);
+	mSphereMesh.ebo.setData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)(allIndices.size() * sizeof(uint16_t)), allIndices.data(), GL_STATIC_DRAW);
 	
 	// Vertex attributes (same layout as regular mesh)
 	glEnableVertexAttribArray(0);
@@ -609,71 +1097,74 @@ void Model::generateSphereMesh(unsigned int subdivisions) const {
 	glEnableVertexAttribArray(4);
 	glVertexAttribPointer(4, 1, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, scalar));
 	
-	// Instance attribute: position offset (layout 5)
-	// This will be set up when rendering
-	
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	mSphereMesh.vao.bind();
+	// Instance attributes (layout 5-7), pointed at an instance buffer before each draw
+	for (GLuint location = 5; location <= 7; ++location) {
+		glEnableVertexAttribArray(location);
+		glVertexAttribDivisor(location, 1);
+	}
 	
-	mSphereMesh.indexCount = static_cast<unsigned int>(indices.size());
+	GLStateCache::instance().bindVertexArray(0);
 	mSphereMesh.initialized = true;
 }
 
-void Model::drawInstancedSpheres(float /* radius */) const {
-	// Generate sphere mesh if not already created
-	if (!mSphereMesh.initialized) {
-		generateSphereMesh(2);  // 2 subdivisions = ~320 triangles per sphere
-	}
-	
-	if (!mSphereMesh.vao.valid()) return;
+void Model::drawInstancedSpheres() const {
+	if (!mSphereMesh.initialized) generateSphereMesh();
+	if (!mSphereMesh.vao.valid() || !mPointInstanceVBO.valid()) return;
 	
-	// Set up instanced rendering
-	// For each point cloud mesh, render instanced spheres
-	for (const Mesh& mesh : mMeshes) {
-		if (!mesh.isPointCloud || mesh.vertexCount == 0) continue;
-		
-		// Bind sphere mesh VAO
-		mSphereMesh.vao.bind();
-		
-		// Set up instance data (positions from point cloud)
-		// Use the point cloud's VBO as instance attribute
-		glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo.id());
-		
-		// Instance attribute: position (layout 5)
-		glEnableVertexAttribArray(5);
-		glVertexAttribPointer(5, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
-		glVertexAttribDivisor(5, 1);  // One per instance
-		
-		// Instance attribute: color (layout 6)
-		glEnableVertexAttribArray(6);
-		glVertexAttribPointer(6, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, color));
-		glVertexAttribDivisor(6, 1);  // One per instance
-		
-		// Instance attribute: scalar (layout 7)
-		glEnableVertexAttribArray(7);
-		glVertexAttribPointer(7, 1, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, scalar));
-		glVertexAttribDivisor(7, 1);  // One per instance
-		
-		// Draw instanced spheres
-		// Each sphere is scaled by radius in the shader
-		// Use 16-bit or 32-bit indices based on optimization
-		GLenum indexType = mSphereMesh.uses16BitIndices ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
-		glDrawElementsInstanced(GL_TRIANGLES, (GLsizei)mSphereMesh.indexCount, indexType, 0, (GLsizei)mesh.vertexCount);
-		
-		// Disable instance attributes
-		glVertexAttribDivisor(5, 0);
-		glVertexAttribDivisor(6, 0);
-		glVertexAttribDivisor(7, 0);
-		glDisableVertexAttribArray(5);
-		glDisableVertexAttribArray(6);
-		glDisableVertexAttribArray(7);
+	const int level = 2;  // 320 triangles
+	mSphereMesh.vao.bind();
+	mPointInstanceVBO.bind(GL_ARRAY_BUFFER);
+	setPointInstanceAttributes(0);
+	glDrawElementsInstanced(GL_TRIANGLES, (GLsizei)mSphereMesh.indexCount[level], GL_UNSIGNED_SHORT,
+	                        (void*)(mSphereMesh.indexOffset[level] * sizeof(uint16_t)), (GLsizei)mPointInstanceCount);
+}
+
+unsigned int Model::drawInstancedSphereLods(const std::vector<std::pair<size_t, int>>& leaves, unsigned int* outSpheres) const {
+	if (outSpheres) std::fill(outSpheres, outSpheres + kSphereLodCount, 0u);
+	if (!mSphereMesh.initialized) generateSphereMesh();
+	if (!mSphereMesh.vao.valid() || !mPointInstanceVBO.valid() || leaves.empty()) return 0;
+
+	// Bucket sizes, then each level's first instance in the stream
+	size_t levelCount[kSphereLodCount] = {};
+	for (const auto& leaf : leaves) levelCount[leaf.second] += mPointClusters[leaf.first].indexCount;
+	size_t levelStart[kSphereLodCount] = {};
+	size_t total = 0;
+	for (int level = 0; level < kSphereLodCount; ++level) { levelStart[level] = total; total += levelCount[level]; }
+	if (total == 0) return 0;
+
+	// Gather each level's leaves into the stream
+	beginInstanceStream(total);
+	for (int level = 0; level < kSphereLodCount; ++level) {
+		InstanceGather gather(levelStart[level]);
+		for (const auto& leaf : leaves) {
+			if (leaf.second == level) gather.add(mPointClusters[leaf.first].indexOffset, mPointClusters[leaf.first].indexCount);
+		}
 	}
-	
-	glBindVertexArray(0);
+
+	// One instanced draw per level
+	unsigned int triangles = 0;
+	mSphereMesh.vao.bind();
+	mInstanceStream.bind(GL_ARRAY_BUFFER);
+	for (int level = 0; level < kSphereLodCount; ++level) {
+		if (levelCount[level] == 0) continue;
+		setPointInstanceAttributes(levelStart[level]);
+		glDrawElementsInstanced(GL_TRIANGLES, (GLsizei)mSphereMesh.indexCount[level], GL_UNSIGNED_SHORT,
+		                        (void*)(mSphereMesh.indexOffset[level] * sizeof(uint16_t)), (GLsizei)levelCount[level]);
+		triangles += static_cast<unsigned int>(levelCount[level]) * (mSphereMesh.indexCount[level] / 3);
+		if (outSpheres) outSpheres[level] = static_cast<unsigned int>(levelCount[level]);
+	}
+	return triangles;
 }
 
 void Model::destroyGPU() {
+	cancelLodBuild();
+	mPointClusters.clear();
+	mClusterEBO.destroy();
+	mImpostorVAO.destroy();
+	mPointInstanceVBO.destroy();
+	mPointInstanceCount = 0;
 	for (Mesh& mesh : mMeshes) {
+		mesh.lods.clear();
 		if (!mesh.isPointCloud && mesh.ebo.valid()) {
 			mesh.ebo.destroy();
 		}
@@ -683,13 +1174,21 @@ void Model::destroyGPU() {
 	
 	// Destroy sphere mesh
 	if (mSphereMesh.initialized) {
-		if (mSphereMesh.ebo.valid()) {
-			mSphereMesh.ebo.destroy();
-		}
+		mSphereMesh.ebo.destroy();
 		mSphereMesh.vbo.destroy();
 		mSphereMesh.vao.destroy();
 		mSphereMesh.initialized = false;
 	}
+	mInstanceStream.destroy();
+
+	for (WireframeLookup& lookup : mWireframeLookups) {
+		for (GlId* texture : {&lookup.positionTexture, &lookup.indexTexture}) {
+			if (*texture == 0) continue;
+			GLStateCache::instance().onTextureDeleted(*texture);
+			glDeleteTextures(1, texture);
+		}
+	}
+	mWireframeLookups.clear();
 }
 
 glm::mat4 Model::scaleToUnitBox() const {
@@ -2,6 +2,9 @@
 
 #include <vector>
 #include <string>
+#include <memory>
+#include <thread>
+#include <utility>
 #include <glm/glm.hpp>
 
 #include "Graphics/Utils.hpp"
@@ -19,6 +22,36 @@ struct Vertex {
 
 static_assert(sizeof(Vertex) == sizeof(float) * 12, "Unexpected Vertex size; check packing.");
 
+// Simplified index range inside a mesh's EBO (levels share the mesh's VBO)
+struct MeshLod {
+	unsigned int indexOffset = 0;  // First index in the EBO (in indices, not bytes)
+	unsigned int indexCount = 0;
+	float error = 0.0f;            // Max geometric deviation from full detail (object space)
+};
+
+// Octree leaf as a contiguous range of the point cloud's leaf-ordered index buffer (one draw per leaf).
+// Points inside a leaf are shuffled, so any prefix of the range is an even subsample of the leaf.
+struct PointCluster {
+	glm::vec3 boundsMin = glm::vec3(0.0f);  // Object-space AABB of the leaf
+	glm::vec3 boundsMax = glm::vec3(0.0f);
+	unsigned int indexOffset = 0;  // In indices, not bytes
+	unsigned int indexCount = 0;
+};
+
+// Points [first, first + count) of one octree leaf, counted from the start of the leaf
+struct PointClusterRange {
+	size_t cluster = 0;
+	unsigned int first = 0;
+	unsigned int count = 0;
+};
+
+// Low-poly copy of a mesh kept on the CPU as a software-occlusion occluder (compacted positions)
+struct OccluderMesh {
+	std::vector<glm::vec3> positions;
+	std::vector<unsigned int> indices;
+	bool empty() const { return indices.empty(); }
+};
+
 struct Mesh {
 	std::vector<Vertex> vertices;
 	std::vector<unsigned int> indices;
@@ -32,13 +65,26 @@ struct Mesh {
 	bool isPointCloud = false;  // True if no faces, just points
 	bool uses16BitIndices = false;  // True if using uint16_t indices (< 65k vertices)
 	bool usesOptimizedVertices = false;  // True if using half-floats for positions/UVs (reduces memory bandwidth)
+
+	glm::vec3 boundsMin = glm::vec3(0.0f);  // Object-space AABB (for LOD selection)
+	glm::vec3 boundsMax = glm::vec3(0.0f);
+	std::vector<MeshLod> lods;  // Simplified levels, finest first (empty until the background build finishes)
+	OccluderMesh occluder;      // Coarsest level (or the full mesh if it is small); survives uploadToGPU(dropCpu)
 };
 
+struct LodBuildState;
+class Shader;
+
 /// 3D model loader and renderer. Supports .obj, .ply, and .off file formats.
 /// Handles CPU-side loading with Assimp, GPU upload with optimizations (half-floats, 16-bit indices),
 /// and various rendering modes (regular meshes, point clouds, sphere impostors, instanced spheres).
 class Model {
 public:
+	Model() = default;
+	~Model();  // Stops the background LOD build
+	Model(const Model&) = delete;
+	Model& operator=(const Model&) = delete;
+
 	/// Load model from file. Supports .obj, .ply, and .off formats.
 	/// Extracts vertices, normals, UVs, colors, and scalar values.
 	/// Computes AABB, scalar range, and builds spatial index for large point clouds.
@@ -47,6 +93,9 @@ public:
 	/// @return true if successful, false on error
 	bool loadFromFile(const std::string& path, std::string& outError);
 	
+	/// CPU-side bytes held by mesh vertex/index vectors (excludes the octree, see spatialIndex()).
+	size_t cpuMemoryBytes() const { return mCpuBytes.bytes(); }
+
 	/// Get all meshes in the model.
 	/// @return Const reference to mesh vector
 	const std::vector<Mesh>& meshes() const { return mMeshes; }
@@ -59,6 +108,50 @@ public:
 	/// Draw all meshes with full vertex attributes (position, normal, UV, color, scalar).
 	/// Uses indexed rendering with proper shader state.
 	void draw() const;
+
+	/// Draw all meshes, choosing per mesh the coarsest LOD whose projected error stays below maxErrorPixels.
+	/// @param modelMatrix Model transform (used for mesh bounds and scale)
+	/// @param frameState Pre-computed frame state (needs viewportSize for projection)
+	/// @param maxErrorPixels Allowed screen-space deviation in pixels (<= 0 always draws full detail)
+	/// @return Number of triangles submitted
+	unsigned int draw(const glm::mat4& modelMatrix, const FrameState& frameState, float maxErrorPixels) const;
+
+	/// Draw a single mesh with the same LOD selection as draw(). Used to cull meshes individually.
+	/// @param meshIndex Index into meshes()
+	/// @return Number of triangles submitted
+	unsigned int drawMesh(size_t meshIndex, const glm::mat4& modelMatrix, const FrameState& frameState, float maxErrorPixels) const;
+
+	/// Draw one LOD level of a mesh for several objects in one instanced draw. The bound program
+	/// takes each instance's model matrix from gl_InstanceID (INSTANCED permutations).
+	/// @param meshIndex Index into meshes()
+	/// @param level LOD level from lodLevel() (-1 = full detail)
+	/// @param instances Objects to draw
+	/// @return Number of triangles submitted (all instances)
+	unsigned int drawMeshInstanced(size_t meshIndex, int level, unsigned int instances) const;
+
+	/// Texture units of the wireframe overlay's triangle lookups (indices, then positions).
+	static constexpr int kWireframeTextureUnit = 2;
+
+	/// Feed the solid + wire overlay (WIREFRAME permutation of pbr.frag) while set: every mesh draw
+	/// binds the mesh's index buffer and vertex buffer as buffer textures and writes the draw's first
+	/// index to uWireFirstIndex, so the fragment shader finds its triangle from gl_PrimitiveID.
+	/// The textures view the mesh's EBO and VBO directly (no copies, no read-back).
+	/// @param shader Bound wireframe permutation, or nullptr to stop
+	void setWireframeShader(const Shader* shader) const { mWireframeShader = shader; }
+
+	/// LOD level drawMesh() picks for a mesh.
+	/// @return -1 for full detail, else an index into the mesh's lods
+	int lodLevel(size_t meshIndex, const glm::mat4& modelMatrix, const FrameState& frameState, float maxErrorPixels) const;
+
+	/// Upload LOD levels produced by the background simplifier once they are ready.
+	/// Cheap no-op otherwise; call once per frame on the GL thread after uploadToGPU().
+	void update();
+
+	/// True while simplified LOD levels are still being generated.
+	bool lodBuildPending() const { return mLodBuild != nullptr; }
+
+	/// Largest number of LOD levels of any mesh (0 until the build has been uploaded).
+	size_t lodLevelCount() const;
 	
 	/// Draw point cloud using GL_POINTS primitive.
 	/// @param pointSize Size of points in pixels (set via glPointSize)
@@ -69,16 +162,55 @@ public:
 	/// @param indices Point indices to render
 	/// @param pointSize Size of points in pixels
 	void drawPointsSubset(const std::vector<unsigned int>& indices, float pointSize = 1.0f) const;
+
+	/// Octree leaves of the point cloud, built by uploadToGPU() for single-mesh clouds with a spatial index.
+	const std::vector<PointCluster>& pointClusters() const { return mPointClusters; }
+
+	/// Draw one octree leaf as GL_POINTS from the persistent leaf-ordered index buffer (no per-frame upload).
+	/// @param cluster Index into pointClusters()
+	/// @param pointSize Size of points in pixels
+	void drawPointCluster(size_t cluster, float pointSize = 1.0f) const;
 	
-	/// Draw point cloud as sphere impostors using a geometry shader.
-	/// Expands each point into a billboard quad that's shaded as a sphere.
-	/// @param pointSize Radius of sphere impostors in world space
-	void drawSphereImpostors(float pointSize = 1.0f) const;
+	/// Draw point cloud as sphere impostors: one instanced 4-vertex quad per point (no geometry shader).
+	/// Instances come from a compact copy of the points, leaf-ordered when pointClusters() exist; the
+	/// shader ray-casts each quad against its sphere (sphere_impostor.vert/.frag). Radius is a shader uniform.
+	void drawSphereImpostors() const;
+
+	/// Draw several octree leaves as GL_POINTS in one glMultiDrawElements call.
+	/// @param clusters Indices into pointClusters()
+	/// @param pointSize Size of points in pixels
+	void drawPointClusterBatch(const std::vector<size_t>& clusters, float pointSize = 1.0f) const;
+
+	/// Draw several octree leaves as sphere impostors in one instanced draw (gathered into the instance stream).
+	/// @param clusters (index into pointClusters(), instances to draw) per leaf; counts are clamped to the leaf
+	/// @return Number of impostors submitted
+	unsigned int drawImpostorClusterBatch(const std::vector<std::pair<size_t, unsigned int>>& clusters) const;
+
+	/// Draw arbitrary point ranges of octree leaves as sphere impostors in one instanced draw. Used by
+	/// progressive refinement to add the points after a leaf's LOD prefix.
+	/// @param ranges Leaf ranges; clamped to their leaves
+	/// @return Number of impostors submitted
+	unsigned int drawImpostorClusterRanges(const std::vector<PointClusterRange>& ranges) const;
+
+	/// Draw the first instanceCount points of one octree leaf as sphere impostors.
+	/// @param cluster Index into pointClusters()
+	/// @param instanceCount Points to draw (clamped to the leaf); a prefix is an even subsample (LOD)
+	void drawImpostorCluster(size_t cluster, unsigned int instanceCount) const;
 	
-	/// Draw point cloud as instanced low-poly spheres.
-	/// Uses hardware instancing to render many spheres efficiently.
-	/// @param radius Radius of each sphere in world space
-	void drawInstancedSpheres(float radius = 0.01f) const;
+	/// Icosphere levels for instanced spheres: 20, 80, 320 and 1280 triangles.
+	static constexpr int kSphereLodCount = 4;
+
+	/// Draw the whole point cloud as instanced low-poly spheres (320-triangle level, no culling).
+	/// Used when the cloud has no octree; radius is the uSphereRadius shader uniform.
+	void drawInstancedSpheres() const;
+
+	/// Draw octree leaves as instanced spheres, each leaf at its own icosphere level.
+	/// The leaves' points are gathered per level into the streaming instance buffer (GPU-side copies from the
+	/// leaf-ordered point instances), then every non-empty level is a single glDrawElementsInstanced.
+	/// @param leaves (index into pointClusters(), level 0..kSphereLodCount-1) per visible leaf
+	/// @param outSpheres Spheres submitted per level (optional, kSphereLodCount entries)
+	/// @return Number of triangles submitted
+	unsigned int drawInstancedSphereLods(const std::vector<std::pair<size_t, int>>& leaves, unsigned int* outSpheres = nullptr) const;
 	
 	/// Destroy all GPU resources (VAOs, VBOs, EBOs). Call before destroying Model.
 	void destroyGPU();
@@ -111,18 +243,56 @@ private:
 	
 	// Spatial index for point clouds (octree)
 	Octree mSpatialIndex;
+	std::vector<PointCluster> mPointClusters;
+	GlBuffer mClusterEBO;  // Point indices grouped by octree leaf
+	void buildPointClusters();
+
+	// Point instances for impostors and instanced spheres: position, color, scalar (28 bytes instead of a full Vertex)
+	GlVertexArray mImpostorVAO;
+	GlBuffer mPointInstanceVBO;
+	unsigned int mPointInstanceCount = 0;
+	void buildPointInstances(const std::vector<unsigned int>& order);
+	void bindImpostorInstances(unsigned int firstInstance) const;
 	
-	// Sphere mesh for instanced rendering
+	// Background LOD generation (shared with worker threads, see startLodBuild()). The workers are
+	// joined before the state is dropped, so none outlives the Model.
+	std::shared_ptr<LodBuildState> mLodBuild;
+	std::vector<std::thread> mLodWorkers;
+	void joinLodWorkers();
+	void startLodBuild();
+	void cancelLodBuild();
+	int selectLod(const Mesh& mesh, const glm::mat4& modelMatrix, float modelScale, const FrameState& frameState, float maxErrorPixels) const;
+	unsigned int drawMeshLod(const Mesh& mesh, const glm::mat4& modelMatrix, float modelScale, const FrameState& frameState, float maxErrorPixels) const;
+	
+	// CPU memory accounting (reported to MemoryTracker)
+	TrackedCpuBytes mCpuBytes{CpuMemoryCategory::Model};
+	void updateCpuMemoryAccounting();
+	
+	// Icosphere levels for instanced rendering. Subdivision only appends vertices, so every level indexes
+	// a prefix of the finest level's vertices: one VBO, one 16-bit EBO with a range per level.
 	mutable struct {
 		GlVertexArray vao;
 		GlBuffer vbo;
 		GlBuffer ebo;
-		unsigned int indexCount = 0;
-		bool uses16BitIndices = false;  // True if using uint16_t indices
+		unsigned int indexOffset[kSphereLodCount] = {};  // In indices, not bytes
+		unsigned int indexCount[kSphereLodCount] = {};
 		bool initialized = false;
 	} mSphereMesh;
-	
-	void generateSphereMesh(unsigned int subdivisions = 2) const;
+	mutable GlBuffer mInstanceStream;  // Per-frame gathered point instances (orphaned on every use)
+	void beginInstanceStream(size_t instances) const;
+
+	// Triangle lookups of the wireframe overlay, one per mesh (built on first use)
+	struct WireframeLookup {
+		GlId positionTexture = 0;   // Views the mesh's VBO, one component per texel (R16F for half-float meshes, R32F otherwise)
+		GlId indexTexture = 0;      // Views the mesh's EBO
+		GlId indexSource = 0;       // EBO the index texture views (the LOD build replaces it)
+		bool supported = true;      // Fits GL_MAX_TEXTURE_BUFFER_SIZE
+	};
+	mutable std::vector<WireframeLookup> mWireframeLookups;
+	mutable const Shader* mWireframeShader = nullptr;
+	void bindWireframeLookup(const Mesh& mesh, unsigned int firstIndex) const;
+
+	void generateSphereMesh() const;
 };
 
 } // namespace Graphics
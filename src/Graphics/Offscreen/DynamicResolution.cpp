@@ -0,0 +1,40 @@
+#include "Graphics/Offscreen/DynamicResolution.hpp"
+#include "Graphics/Utils.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Graphics {
+
+void DynamicResolution::update(double gpuFrameMs) {
+	if (!settings.enabled || gpuFrameMs <= 0.0 || settings.targetMs <= 0.0f) return;
+	float ratio = settings.targetMs / static_cast<float>(gpuFrameMs);
+	if (std::abs(ratio - 1.0f) < kDeadBand) return;
+	float desired = mScale * std::sqrt(ratio);  // Cost ~ pixels ~ scale^2
+	mScale += std::clamp(desired - mScale, -kMaxStepDown, kMaxStepUp);
+	mScale = std::clamp(mScale, settings.minScale, std::max(settings.minScale, settings.maxScale));
+}
+
+bool DynamicResolution::begin(int outputWidth, int outputHeight, std::string& outError) {
+	if (outputWidth <= 0 || outputHeight <= 0) return false;
+	if (!mTarget.valid() || mTarget.width() != outputWidth || mTarget.height() != outputHeight) {
+		if (!mTarget.create(outputWidth, outputHeight, outError)) return false;
+	}
+	mRenderWidth = std::max(1, static_cast<int>(std::lround(static_cast<float>(outputWidth) * mScale)));
+	mRenderHeight = std::max(1, static_cast<int>(std::lround(static_cast<float>(outputHeight) * mScale)));
+	GLStateCache& cache = GLStateCache::instance();
+	cache.bindFramebuffer(GL_FRAMEBUFFER, mTarget.id());
+	cache.viewport(0, 0, mRenderWidth, mRenderHeight);
+	return true;
+}
+
+void DynamicResolution::resolve(GLuint outputFbo) {
+	GLStateCache& cache = GLStateCache::instance();
+	cache.bindFramebuffer(GL_READ_FRAMEBUFFER, mTarget.id());
+	cache.bindFramebuffer(GL_DRAW_FRAMEBUFFER, outputFbo);
+	glBlitFramebuffer(0, 0, mRenderWidth, mRenderHeight, 0, 0, mTarget.width(), mTarget.height(), GL_COLOR_BUFFER_BIT, GL_LINEAR);
+	cache.bindFramebuffer(GL_FRAMEBUFFER, outputFbo);
+	cache.viewport(0, 0, mTarget.width(), mTarget.height());
+}
+
+} // namespace Graphics
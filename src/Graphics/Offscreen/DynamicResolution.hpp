@@ -0,0 +1,59 @@
+#pragma once
+
+#include <string>
+#include <glad/glad.h>
+
+#include "Graphics/Offscreen/OffscreenTarget.hpp"
+
+namespace Graphics {
+
+/// Internal render target whose resolution follows a GPU frame-time target.
+/// The target is allocated at the output size; frames are drawn into a scaled sub-rectangle of it and
+/// upscaled to the output with a bilinear blit, so changing the scale never reallocates anything.
+/// The controller assumes GPU cost grows with the pixel count (scale squared), which holds for
+/// fill-bound views such as large impostor clouds.
+class DynamicResolution {
+public:
+	struct Settings {
+		bool enabled = false;
+		float targetMs = 16.0f;  // GPU frame time to hold
+		float minScale = 0.5f;   // Per-axis render scale limits
+		float maxScale = 1.0f;
+	};
+
+	Settings settings;
+
+	/// Feed a newly resolved GPU frame time (ms) and adjust the scale for the coming frames.
+	void update(double gpuFrameMs);
+
+	/// Bind the internal target and set the viewport to the scaled rectangle. (Re)allocates the target
+	/// when the output size changed.
+	/// @param outputWidth Output (window or headless target) width in pixels
+	/// @param outputHeight Output height in pixels
+	/// @param outError Framebuffer status if the target is incomplete
+	/// @return false if the target could not be created (render at full resolution instead)
+	bool begin(int outputWidth, int outputHeight, std::string& outError);
+
+	/// Upscale the rendered rectangle to the output framebuffer, then bind it with a full-size viewport.
+	/// @param outputFbo Destination framebuffer (0 = window)
+	void resolve(GLuint outputFbo);
+
+	/// Free the internal target (while disabled).
+	void release() { mTarget.destroy(); mScale = 1.0f; }
+
+	float scale() const { return mScale; }
+	int renderWidth() const { return mRenderWidth; }
+	int renderHeight() const { return mRenderHeight; }
+
+private:
+	static constexpr float kDeadBand = 0.05f;   // Ignore frame-time errors within +-5% (no oscillation)
+	static constexpr float kMaxStepDown = 0.1f; // Scale change per GPU sample: drop quickly...
+	static constexpr float kMaxStepUp = 0.02f;  // ...recover slowly
+
+	OffscreenTarget mTarget;
+	float mScale = 1.0f;
+	int mRenderWidth = 0;
+	int mRenderHeight = 0;
+};
+
+} // namespace Graphics
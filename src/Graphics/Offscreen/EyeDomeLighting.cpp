@@ -0,0 +1,99 @@
+#include "Graphics/Offscreen/EyeDomeLighting.hpp"
+#include "Graphics/Profiling/MemoryTracker.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace Graphics {
+
+bool EyeDomeLighting::begin(int targetWidth, int targetHeight, std::string& outError) {
+	if (targetWidth <= 0 || targetHeight <= 0) return false;
+	// The viewport set up by the caller (full output, or the dynamic-resolution rectangle) carries over.
+	// Both come from the state cache; GL is only asked after invalidate() left them unknown.
+	GLStateCache& cache = GLStateCache::instance();
+	mOutputFbo = cache.currentDrawFramebuffer();
+	if (mOutputFbo == GLStateCache::kUnknown) {
+		GLint fbo = 0;
+		glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &fbo);
+		cache.bindFramebuffer(GL_DRAW_FRAMEBUFFER, static_cast<GLuint>(fbo));
+		mOutputFbo = static_cast<GLuint>(fbo);
+	}
+	const int* viewport = cache.currentViewport();
+	if (viewport[2] < 0) {
+		GLint current[4] = {0, 0, 0, 0};
+		glGetIntegerv(GL_VIEWPORT, current);
+		cache.viewport(current[0], current[1], current[2], current[3]);
+	}
+	std::copy(viewport, viewport + 4, mViewport);
+
+	if (!mFbo || mWidth != targetWidth || mHeight != targetHeight) {
+		destroy();
+		mWidth = targetWidth; mHeight = targetHeight;
+		glGenTextures(1, &mColor);
+		cache.bindTexture(0, GL_TEXTURE_2D, mColor);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_SRGB8_ALPHA8, mWidth, mHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glGenTextures(1, &mDepth);
+		cache.bindTexture(0, GL_TEXTURE_2D, mDepth);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, mWidth, mHeight, 0, GL_DEPTH_COMPONENT, GL_UNSIGNED_INT, nullptr);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+		glGenFramebuffers(1, &mFbo);
+		cache.bindFramebuffer(GL_FRAMEBUFFER, mFbo);
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, mColor, 0);
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, mDepth, 0);
+		GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+		if (status != GL_FRAMEBUFFER_COMPLETE) {
+			char buf[16];
+			snprintf(buf, sizeof(buf), "%04X", static_cast<unsigned int>(status));
+			outError = std::string("Eye-dome lighting framebuffer incomplete (status 0x") + buf + ")";
+			cache.bindFramebuffer(GL_FRAMEBUFFER, mOutputFbo);
+			destroy();
+			return false;
+		}
+		mBytes = static_cast<size_t>(mWidth) * static_cast<size_t>(mHeight) * 8;  // RGBA8 + D24 (padded to 32 bits)
+		MemoryTracker::instance().allocate(MemoryCategory::Targets, mBytes);
+	}
+	if (!mFullscreenVAO.valid()) mFullscreenVAO.create();
+	cache.bindFramebuffer(GL_FRAMEBUFFER, mFbo);
+	return true;
+}
+
+void EyeDomeLighting::resolve(Shader& shader, const glm::mat4& proj) {
+	GLStateCache& cache = GLStateCache::instance();
+	cache.bindFramebuffer(GL_FRAMEBUFFER, mOutputFbo);
+	cache.viewport(mViewport[0], mViewport[1], mViewport[2], mViewport[3]);
+	cache.bindTexture(0, GL_TEXTURE_2D, mColor);
+	cache.bindTexture(1, GL_TEXTURE_2D, mDepth);
+
+	shader.use();
+	shader.setInt("uColor", 0);
+	shader.setInt("uDepth", 1);
+	shader.setFloat("uProjA", proj[2][2]);
+	shader.setFloat("uProjB", proj[3][2]);
+	shader.setFloat("uStrength", settings.strength);
+	shader.setFloat("uRadius", settings.radius);
+	shader.setInt("uRenderWidth", mViewport[2]);
+	shader.setInt("uRenderHeight", mViewport[3]);
+
+	// Every pixel is rewritten, depth included
+	cache.colorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+	cache.depthMask(GL_TRUE);
+	cache.depthFunc(GL_ALWAYS);
+	mFullscreenVAO.bind();
+	glDrawArrays(GL_TRIANGLES, 0, 3);
+	cache.depthFunc(GL_LESS);
+}
+
+void EyeDomeLighting::destroy() {
+	GLStateCache& cache = GLStateCache::instance();
+	if (mFbo) { cache.onFramebufferDeleted(mFbo); glDeleteFramebuffers(1, &mFbo); mFbo = 0; }
+	if (mColor) { cache.onTextureDeleted(mColor); glDeleteTextures(1, &mColor); mColor = 0; }
+	if (mDepth) { cache.onTextureDeleted(mDepth); glDeleteTextures(1, &mDepth); mDepth = 0; }
+	if (mBytes) { MemoryTracker::instance().release(MemoryCategory::Targets, mBytes); mBytes = 0; }
+	mWidth = mHeight = 0;
+}
+
+} // namespace Graphics
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <string>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "Graphics/Shader.h"
+#include "Graphics/Utils.hpp"
+
+namespace Graphics {
+
+/// Eye-dome lighting (EDL) post-process for point clouds.
+/// The scene passes draw into an internal target with a sampleable color and depth texture; resolve()
+/// then shades every pixel of the output in one fullscreen pass by how far it lies behind its neighbours
+/// in log depth. Silhouettes and depth steps get dark outlines, which gives unlit GL_POINTS a sense of
+/// shape at a fraction of the cost of impostors or instanced spheres. Depth is copied through, so passes
+/// after resolve() (bounding box, refinement) still depth-test against the scene.
+class EyeDomeLighting {
+public:
+	struct Settings {
+		bool enabled = false;
+		float strength = 1.0f;  // Shading strength (Potree/CloudCompare scale)
+		float radius = 1.5f;    // Neighbour distance in pixels
+	};
+
+	Settings settings;
+
+	EyeDomeLighting() = default;
+	~EyeDomeLighting() { destroy(); }
+	EyeDomeLighting(const EyeDomeLighting&) = delete;
+	EyeDomeLighting& operator=(const EyeDomeLighting&) = delete;
+
+	/// Redirect drawing into the internal target, remembering the framebuffer and viewport it replaces.
+	/// (Re)allocates the target when the output size changed; the caller clears it.
+	/// @param targetWidth Size to allocate (the output size; the viewport may use a smaller rectangle)
+	/// @param targetHeight
+	/// @param outError Framebuffer status if the target is incomplete
+	/// @return false if the target could not be created (draw without EDL)
+	bool begin(int targetWidth, int targetHeight, std::string& outError);
+
+	/// Shade the internal target into the framebuffer bound at begin(), over the same viewport.
+	/// @param shader fullscreen.vert + eye_dome.frag
+	/// @param proj Projection of the frame (to linearize depth)
+	void resolve(Shader& shader, const glm::mat4& proj);
+
+	/// Free the target (while disabled).
+	void destroy();
+
+private:
+	GLuint mFbo = 0;
+	GLuint mColor = 0;
+	GLuint mDepth = 0;
+	int mWidth = 0;
+	int mHeight = 0;
+	size_t mBytes = 0;
+	GLuint mOutputFbo = 0;
+	int mViewport[4] = {0, 0, 0, 0};
+	GlVertexArray mFullscreenVAO;  // Empty: the triangle comes from gl_VertexID
+};
+
+} // namespace Graphics
@@ -0,0 +1,161 @@
+#include "Graphics/Offscreen/FrameReadback.hpp"
+#include "Graphics/Profiling/MemoryTracker.hpp"
+#include "Graphics/Profiling/CpuProfiler.hpp"
+#include "Graphics/Utils.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+namespace Graphics {
+
+bool FrameReadback::initialize(int width, int height, const std::string& outputDir, std::string& outError) {
+	shutdown();
+	std::error_code ec;
+	std::filesystem::create_directories(outputDir, ec);
+	if (ec) { outError = "Cannot create output directory '" + outputDir + "': " + ec.message(); return false; }
+
+	mWidth = width;
+	mHeight = height;
+	mOutputDir = outputDir;
+	mBytesPerFrame = static_cast<size_t>(width) * static_cast<size_t>(height) * 4;
+
+	for (Slot& slot : mSlots) {
+		glGenBuffers(1, &slot.pbo);
+		GLStateCache::instance().bindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+		glBufferData(GL_PIXEL_PACK_BUFFER, (GLsizeiptr)mBytesPerFrame, nullptr, GL_STREAM_READ);
+		MemoryTracker::instance().allocate(MemoryCategory::Targets, mBytesPerFrame);
+	}
+	GLStateCache::instance().bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+	mStop = false;
+	mWriter = std::thread(&FrameReadback::writerLoop, this);
+	mInitialized = true;
+	return true;
+}
+
+void FrameReadback::capture(const std::string& fileName) {
+	if (!mInitialized) return;
+	Slot& slot = mSlots[mNextSlot];
+	mNextSlot = (mNextSlot + 1) % kRingSize;
+	if (slot.fence) resolve(slot);  // Oldest frame in the ring; normally already complete
+
+	GLStateCache::instance().bindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	glReadPixels(0, 0, mWidth, mHeight, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);  // Async: writes into the PBO
+	GLStateCache::instance().bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	slot.fileName = fileName;
+}
+
+void FrameReadback::resolve(Slot& slot) {
+	// Flush on the first wait so the fence is guaranteed to signal
+	GLenum result = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+	while (result == GL_TIMEOUT_EXPIRED) result = glClientWaitSync(slot.fence, 0, 1000000);  // 1 ms
+	glDeleteSync(slot.fence);
+	slot.fence = nullptr;
+	if (result == GL_WAIT_FAILED) { std::cerr << "FrameReadback: fence wait failed for " << slot.fileName << "\n"; return; }
+
+	Image image;
+	image.path = (std::filesystem::path(mOutputDir) / slot.fileName).string();
+	image.rgba.resize(mBytesPerFrame);
+	GLStateCache::instance().bindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+	if (const void* data = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, (GLsizeiptr)mBytesPerFrame, GL_MAP_READ_BIT)) {
+		std::memcpy(image.rgba.data(), data, mBytesPerFrame);
+		glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+	} else {
+		std::cerr << "FrameReadback: failed to map PBO for " << slot.fileName << "\n";
+		GLStateCache::instance().bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+		return;
+	}
+	GLStateCache::instance().bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+	// Hand off to the writer; block only if it is far behind (bounds memory use)
+	std::unique_lock<std::mutex> lock(mMutex);
+	mSpaceCv.wait(lock, [this]() { return mQueue.size() < kMaxQueuedImages; });
+	mQueue.push_back(std::move(image));
+	mInFlight++;
+	mQueueCv.notify_one();
+}
+
+void FrameReadback::finish() {
+	if (!mInitialized) return;
+	// Resolve in capture order, starting with the oldest slot
+	for (int i = 0; i < kRingSize; ++i) {
+		Slot& slot = mSlots[(mNextSlot + i) % kRingSize];
+		if (slot.fence) resolve(slot);
+	}
+	std::unique_lock<std::mutex> lock(mMutex);
+	mSpaceCv.wait(lock, [this]() { return mInFlight == 0; });
+}
+
+void FrameReadback::shutdown() {
+	if (!mInitialized) return;
+	finish();
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mStop = true;
+	}
+	mQueueCv.notify_all();
+	if (mWriter.joinable()) mWriter.join();
+
+	for (Slot& slot : mSlots) {
+		if (slot.pbo) {
+			GLStateCache::instance().onBufferDeleted(slot.pbo);
+			glDeleteBuffers(1, &slot.pbo);
+			slot.pbo = 0;
+			MemoryTracker::instance().release(MemoryCategory::Targets, mBytesPerFrame);
+		}
+	}
+	mInitialized = false;
+}
+
+void FrameReadback::writerLoop() {
+	CpuProfiler::instance().setThreadName("Readback Writer");
+	for (;;) {
+		Image image;
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			mQueueCv.wait(lock, [this]() { return mStop || !mQueue.empty(); });
+			if (mQueue.empty()) return;  // Stop requested and nothing left
+			image = std::move(mQueue.front());
+			mQueue.pop_front();
+		}
+		mSpaceCv.notify_all();
+
+		bool written;
+		{
+			PHV_CPU_SCOPE("FrameReadback::writePPM");
+			written = writePPM(image.path, image.rgba.data(), mWidth, mHeight);
+		}
+		if (written) mWritten.fetch_add(1);
+		else std::cerr << "FrameReadback: failed to write " << image.path << "\n";
+
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mInFlight--;
+		}
+		mSpaceCv.notify_all();
+	}
+}
+
+bool FrameReadback::writePPM(const std::string& path, const unsigned char* rgba, int width, int height) {
+	std::ofstream out(path, std::ios::binary);
+	if (!out) return false;
+	out << "P6\n" << width << " " << height << "\n255\n";
+	// GL rows are bottom-up; PPM is top-down. Drop alpha.
+	std::vector<unsigned char> row(static_cast<size_t>(width) * 3);
+	for (int y = height - 1; y >= 0; --y) {
+		const unsigned char* src = rgba + static_cast<size_t>(y) * static_cast<size_t>(width) * 4;
+		for (int x = 0; x < width; ++x) {
+			row[static_cast<size_t>(x) * 3 + 0] = src[x * 4 + 0];
+			row[static_cast<size_t>(x) * 3 + 1] = src[x * 4 + 1];
+			row[static_cast<size_t>(x) * 3 + 2] = src[x * 4 + 2];
+		}
+		out.write(reinterpret_cast<const char*>(row.data()), static_cast<std::streamsize>(row.size()));
+	}
+	return static_cast<bool>(out);
+}
+
+} // namespace Graphics
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <glad/glad.h>
+
+namespace Graphics {
+
+/// Asynchronous framebuffer readback through a ring of pixel-pack buffers.
+/// capture() only issues glReadPixels into a PBO plus a fence; the pixels are mapped when the
+/// slot comes around again (by then the GPU has normally finished) and handed to a writer
+/// thread that encodes and saves them. The render thread only stalls when the ring is full
+/// of unfinished frames or the writer falls behind.
+class FrameReadback {
+public:
+	static constexpr int kRingSize = 3;            // Frames in flight between capture and map
+	static constexpr size_t kMaxQueuedImages = 8;  // Images buffered for the writer thread
+
+	FrameReadback() = default;
+	~FrameReadback() { shutdown(); }
+	FrameReadback(const FrameReadback&) = delete;
+	FrameReadback& operator=(const FrameReadback&) = delete;
+
+	/// Allocate PBOs and start the writer thread.
+	/// @param width Image width in pixels
+	/// @param height Image height in pixels
+	/// @param outputDir Directory for written images (created if missing)
+	/// @param outError Error message on failure
+	/// @return true if successful
+	bool initialize(int width, int height, const std::string& outputDir, std::string& outError);
+
+	/// Queue a readback of the current read framebuffer. The image is written as outputDir/fileName (binary PPM).
+	void capture(const std::string& fileName);
+
+	/// Resolve all pending readbacks and wait until every image is on disk.
+	void finish();
+
+	/// Release GL objects and stop the writer thread (finishes pending work first).
+	void shutdown();
+
+	size_t framesWritten() const { return mWritten.load(); }
+
+private:
+	struct Slot {
+		GLuint pbo = 0;
+		GLsync fence = nullptr;
+		std::string fileName;
+	};
+	struct Image {
+		std::string path;
+		std::vector<unsigned char> rgba;
+	};
+
+	void resolve(Slot& slot);
+	void writerLoop();
+	static bool writePPM(const std::string& path, const unsigned char* rgba, int width, int height);
+
+	Slot mSlots[kRingSize];
+	int mNextSlot = 0;
+	int mWidth = 0;
+	int mHeight = 0;
+	size_t mBytesPerFrame = 0;
+	std::string mOutputDir;
+	bool mInitialized = false;
+
+	// Writer thread
+	std::thread mWriter;
+	std::mutex mMutex;
+	std::condition_variable mQueueCv;   // Signals writer: new image or stop
+	std::condition_variable mSpaceCv;   // Signals producer: queue drained
+	std::deque<Image> mQueue;
+	size_t mInFlight = 0;  // Images queued or being written
+	bool mStop = false;
+	std::atomic<size_t> mWritten{0};
+};
+
+} // namespace Graphics
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstdio>
+#include <string>
+#include <glad/glad.h>
+
+#include "Graphics/Profiling/MemoryTracker.hpp"
+#include "Graphics/Utils.hpp"
+
+namespace Graphics {
+
+/// Framebuffer object with an sRGB color and a depth renderbuffer.
+/// Used as the render target for headless rendering, where no default framebuffer exists.
+class OffscreenTarget {
+public:
+	OffscreenTarget() = default;
+	~OffscreenTarget() { destroy(); }
+	OffscreenTarget(const OffscreenTarget&) = delete;
+	OffscreenTarget& operator=(const OffscreenTarget&) = delete;
+
+	/// Create (or recreate) the target.
+	/// @param width Width in pixels
+	/// @param height Height in pixels
+	/// @param outError Framebuffer status if incomplete
+	/// @return true if the framebuffer is complete
+	bool create(int width, int height, std::string& outError) {
+		destroy();
+		mWidth = width; mHeight = height;
+
+		glGenRenderbuffers(1, &mColor);
+		glBindRenderbuffer(GL_RENDERBUFFER, mColor);
+		glRenderbufferStorage(GL_RENDERBUFFER, GL_SRGB8_ALPHA8, width, height);  // Matches GL_FRAMEBUFFER_SRGB output
+		glGenRenderbuffers(1, &mDepth);
+		glBindRenderbuffer(GL_RENDERBUFFER, mDepth);
+		glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+		glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+		glGenFramebuffers(1, &mFbo);
+		GLStateCache& cache = GLStateCache::instance();
+		cache.bindFramebuffer(GL_FRAMEBUFFER, mFbo);
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, mColor);
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, mDepth);
+		GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+		cache.bindFramebuffer(GL_FRAMEBUFFER, 0);
+		if (status != GL_FRAMEBUFFER_COMPLETE) {
+			outError = "Offscreen framebuffer incomplete (status 0x" + toHex(status) + ")";
+			destroy();
+			return false;
+		}
+
+		mBytes = static_cast<size_t>(width) * static_cast<size_t>(height) * 8;  // RGBA8 + D24 (padded to 32 bits)
+		MemoryTracker::instance().allocate(MemoryCategory::Targets, mBytes);
+		return true;
+	}
+
+	void destroy() {
+		if (mFbo) { GLStateCache::instance().onFramebufferDeleted(mFbo); glDeleteFramebuffers(1, &mFbo); mFbo = 0; }
+		if (mColor) { glDeleteRenderbuffers(1, &mColor); mColor = 0; }
+		if (mDepth) { glDeleteRenderbuffers(1, &mDepth); mDepth = 0; }
+		if (mBytes) { MemoryTracker::instance().release(MemoryCategory::Targets, mBytes); mBytes = 0; }
+	}
+
+	/// Bind for drawing and set the viewport to the full target.
+	void bind() const {
+		GLStateCache& cache = GLStateCache::instance();
+		cache.bindFramebuffer(GL_FRAMEBUFFER, mFbo);
+		cache.viewport(0, 0, mWidth, mHeight);
+	}
+
+	bool valid() const { return mFbo != 0; }
+	GLuint id() const { return mFbo; }
+	int width() const { return mWidth; }
+	int height() const { return mHeight; }
+
+private:
+	static std::string toHex(GLenum value) {
+		char buf[16];
+		snprintf(buf, sizeof(buf), "%04X", static_cast<unsigned int>(value));
+		return buf;
+	}
+
+	GLuint mFbo = 0;
+	GLuint mColor = 0;
+	GLuint mDepth = 0;
+	int mWidth = 0;
+	int mHeight = 0;
+	size_t mBytes = 0;
+};
+
+} // namespace Graphics
@@ -0,0 +1,56 @@
+#include "Graphics/Offscreen/ProgressiveRefinement.hpp"
+#include "Graphics/Utils.hpp"
+
+namespace Graphics {
+
+ProgressiveRefinement::Pass ProgressiveRefinement::beginFrame(uint64_t signature) {
+	bool changed = signature != mSignature;
+	mSignature = signature;
+	if (changed) {
+		mState = State::Moving;
+		return Pass::Interactive;
+	}
+	if (!settings.refine) {
+		// Nothing to refine: one frame of the still view is all there is
+		mState = State::Complete;
+		return Pass::Interactive;
+	}
+	switch (mState) {
+		case State::Moving:
+			mState = State::Refining;
+			mPasses = 0;
+			mRefinedPoints = 0;
+			return Pass::Base;
+		case State::Refining:
+			return Pass::Refine;
+		case State::Complete:
+			break;
+	}
+	return Pass::Present;
+}
+
+bool ProgressiveRefinement::beginBase(int outputWidth, int outputHeight, std::string& outError) {
+	if (outputWidth <= 0 || outputHeight <= 0) return false;
+	if (!mTarget.valid() || mTarget.width() != outputWidth || mTarget.height() != outputHeight) {
+		if (!mTarget.create(outputWidth, outputHeight, outError)) return false;
+	}
+	mTarget.bind();
+	return true;
+}
+
+void ProgressiveRefinement::endRefine(unsigned int points) {
+	mPasses++;
+	mRefinedPoints += points;
+	if (points == 0) mState = State::Complete;
+}
+
+void ProgressiveRefinement::present(GLuint outputFbo) const {
+	GLStateCache& cache = GLStateCache::instance();
+	cache.bindFramebuffer(GL_READ_FRAMEBUFFER, mTarget.id());
+	cache.bindFramebuffer(GL_DRAW_FRAMEBUFFER, outputFbo);
+	glBlitFramebuffer(0, 0, mTarget.width(), mTarget.height(), 0, 0, mTarget.width(), mTarget.height(), GL_COLOR_BUFFER_BIT, GL_NEAREST);
+	cache.bindFramebuffer(GL_FRAMEBUFFER, outputFbo);
+	cache.viewport(0, 0, mTarget.width(), mTarget.height());
+}
+
+} // namespace Graphics
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <glad/glad.h>
+
+#include "Graphics/Offscreen/OffscreenTarget.hpp"
+
+namespace Graphics {
+
+/// On-demand rendering and idle refinement for the interactive window.
+/// Each frame is classified by a signature of everything that affects the image (camera, scene settings,
+/// output size). While it changes, frames render normally. The first frame it holds still is redrawn at
+/// full resolution and full detail into a persistent target; the following frames add the points the LOD
+/// left out on top of it (Scene::refine) until nothing is missing. After that, frames only present the
+/// finished image under the UI, and busy() tells the main loop it can sleep until the next input.
+class ProgressiveRefinement {
+public:
+	struct Settings {
+		bool onDemand = true;  // Render only when the view, scene or UI changes
+		bool refine = true;    // Refine still frames into the persistent target
+	};
+
+	enum class Pass {
+		Interactive,  // The view changed: normal frame to the output
+		Base,         // First still frame: exact render into the persistent target
+		Refine,       // Add the next slice of omitted points to the target
+		Present       // Refinement complete: show the target as is
+	};
+
+	Settings settings;
+
+	/// Pick this frame's pass.
+	/// @param signature Hash of the state that affects the image
+	Pass beginFrame(uint64_t signature);
+
+	/// Bind the persistent target for the Base pass and set a full viewport. (Re)allocates it when the output
+	/// size changed; the caller clears it.
+	/// @param outputWidth Output width in pixels
+	/// @param outputHeight Output height in pixels
+	/// @param outError Framebuffer status if the target is incomplete
+	/// @return false if the target could not be created (refinement should be turned off)
+	bool beginBase(int outputWidth, int outputHeight, std::string& outError);
+
+	/// Bind the persistent target for a Refine pass (contents kept).
+	void bind() const { mTarget.bind(); }
+
+	/// Record what a Refine pass added; refinement is complete once a pass adds nothing.
+	/// @param points Points drawn by the pass
+	void endRefine(unsigned int points);
+
+	/// Copy the target to the output framebuffer, then bind it with a full-size viewport.
+	/// @param outputFbo Destination framebuffer (0 = window)
+	void present(GLuint outputFbo) const;
+
+	/// True while frames can still change the image: the signature moved since the last frame, or
+	/// refinement is not finished yet.
+	bool busy(uint64_t signature) const { return signature != mSignature || mState != State::Complete; }
+
+	/// Free the persistent target (while refinement is disabled).
+	void release() { mTarget.destroy(); }
+
+	bool refining() const { return mState == State::Refining; }
+	bool complete() const { return mState == State::Complete; }
+	unsigned int passes() const { return mPasses; }
+	unsigned long long refinedPoints() const { return mRefinedPoints; }
+
+private:
+	enum class State { Moving, Refining, Complete };
+
+	OffscreenTarget mTarget;
+	uint64_t mSignature = 0;
+	State mState = State::Moving;
+	unsigned int mPasses = 0;                 // Refine passes since the view stopped
+	unsigned long long mRefinedPoints = 0;    // Points they added
+};
+
+} // namespace Graphics
@@ -0,0 +1,262 @@
+#include "Graphics/Profiling/Benchmark.hpp"
+#include "Graphics/Renderer.h"
+#include "Graphics/Profiling/MemoryTracker.hpp"
+#include "Graphics/Profiling/SampleStats.hpp"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+namespace Graphics {
+
+namespace {
+
+void writeStatsJson(std::ostream& out, const char* name, const SampleStats& s, bool last = false) {
+	out << "    \"" << name << "\": { \"samples\": " << s.count
+	    << ", \"mean\": " << s.mean << ", \"min\": " << s.min << ", \"max\": " << s.max
+	    << ", \"p50\": " << s.p50 << ", \"p95\": " << s.p95 << ", \"p99\": " << s.p99 << " }"
+	    << (last ? "\n" : ",\n");
+}
+
+template <typename Getter>
+std::vector<double> collect(const std::vector<BenchmarkSample>& samples, Getter get) {
+	std::vector<double> values;
+	values.reserve(samples.size());
+	for (const BenchmarkSample& s : samples) {
+		double v = get(s);
+		if (v >= 0.0) values.push_back(v);
+	}
+	return values;
+}
+
+} // namespace
+
+bool Benchmark::loadConfig(const std::string& path, std::string& outError) {
+	JsonValue root;
+	if (!parseJsonFile(path, root, outError)) return false;
+	if (!root.isObject()) { outError = path + ": expected a JSON object"; return false; }
+
+	mConfig = BenchmarkConfig();
+	mConfig.name = root.stringOr("name", std::filesystem::path(path).stem().string());
+	mConfig.modelPath = root.stringOr("model", "");
+	mConfig.frames = static_cast<int>(root.numberOr("frames", mConfig.frames));
+	mConfig.warmupFrames = static_cast<int>(root.numberOr("warmupFrames", mConfig.warmupFrames));
+	mConfig.width = static_cast<int>(root.numberOr("width", 0));
+	mConfig.height = static_cast<int>(root.numberOr("height", 0));
+	mConfig.reportPrefix = root.stringOr("report", mConfig.reportPrefix);
+	if (const JsonValue* settings = root.find("settings")) mConfig.settings = *settings;
+	if (mConfig.frames <= 0) { outError = path + ": \"frames\" must be positive"; return false; }
+	mConfig.warmupFrames = std::max(0, mConfig.warmupFrames);
+
+	const JsonValue* camera = root.find("camera");
+	std::string type = camera ? camera->stringOr("type", "orbit") : "orbit";
+	if (type == "orbit") {
+		mConfig.cameraPath = CameraPath::orbit(
+			static_cast<float>(camera ? camera->numberOr("radius", 2.0) : 2.0),
+			static_cast<float>(camera ? camera->numberOr("elevation", 0.4) : 0.4),
+			static_cast<float>(camera ? camera->numberOr("revolutions", 1.0) : 1.0));
+	} else if (type == "path") {
+		std::string file = camera->stringOr("file", "");
+		if (!file.empty()) {
+			// Relative to the script so suites can be moved as a directory
+			std::filesystem::path filePath(file);
+			if (filePath.is_relative()) filePath = std::filesystem::path(path).parent_path() / filePath;
+			JsonValue pathJson;
+			if (!parseJsonFile(filePath.string(), pathJson, outError)) return false;
+			if (!mConfig.cameraPath.loadFromJson(pathJson, outError)) return false;
+		} else if (!mConfig.cameraPath.loadFromJson(*camera, outError)) {
+			return false;
+		}
+	} else {
+		outError = path + ": unknown camera type '" + type + "'";
+		return false;
+	}
+	return true;
+}
+
+void Benchmark::applySettings(Scene& scene) const {
+	const JsonValue& s = mConfig.settings;
+	if (!s.isObject()) return;
+	scene.enableFrustumCulling = s.boolOr("frustumCulling", scene.enableFrustumCulling);
+	scene.enableOcclusionCulling = s.boolOr("occlusionCulling", scene.enableOcclusionCulling);
+	scene.enableEarlyZPrepass = s.boolOr("earlyZ", scene.enableEarlyZPrepass);
+	scene.enableSpatialIndexing = s.boolOr("spatialIndexing", scene.enableSpatialIndexing);
+	scene.enableMeshLOD = s.boolOr("meshLOD", scene.enableMeshLOD);
+	scene.meshLODErrorPixels = static_cast<float>(s.numberOr("lodErrorPixels", scene.meshLODErrorPixels));
+	scene.autoLOD = s.boolOr("autoLOD", scene.autoLOD);
+	scene.pointSize = static_cast<float>(s.numberOr("pointSize", scene.pointSize));
+	scene.sphereRadius = static_cast<float>(s.numberOr("sphereRadius", scene.sphereRadius));
+	std::string mode = s.stringOr("pointMode", "");
+	if (mode == "points") scene.pointCloudMode = PointCloudRenderMode::Points;
+	else if (mode == "impostors") scene.pointCloudMode = PointCloudRenderMode::SphereImpostors;
+	else if (mode == "instanced") scene.pointCloudMode = PointCloudRenderMode::InstancedSpheres;
+	else if (!mode.empty()) std::cerr << "Benchmark: unknown pointMode '" << mode << "' (ignored)\n";
+}
+
+void Benchmark::run(Renderer& renderer, const std::function<void()>& present, const std::function<bool()>& shouldStop) {
+	const char* glRenderer = reinterpret_cast<const char*>(glGetString(GL_RENDERER));
+	const char* glVersion = reinterpret_cast<const char*>(glGetString(GL_VERSION));
+	mGLRenderer = glRenderer ? glRenderer : "Unknown";
+	mGLVersion = glVersion ? glVersion : "Unknown";
+
+	applySettings(renderer.scene());
+	renderer.world().syncSettings();
+
+	// Modes that change the work of a frame with the timings of earlier ones: pinned for the run
+	const JsonValue& s = mConfig.settings;
+	mModes.dynamicResolution = s.boolOr("dynamicResolution", false);
+	mModes.progressiveRefinement = s.boolOr("progressiveRefinement", false);
+	mModes.framePipeline = s.boolOr("framePipeline", false);
+	DynamicResolution::Settings dynamicResolution = renderer.dynamicResolution().settings;
+	ProgressiveRefinement::Settings refinement = renderer.refinement().settings;
+	FramePipeline::Settings framePipeline = renderer.framePipeline().settings;
+	renderer.dynamicResolution().settings.enabled = mModes.dynamicResolution;
+	renderer.refinement().settings.refine = mModes.progressiveRefinement;
+	renderer.framePipeline().settings.enabled = mModes.framePipeline;
+
+	runFrames(renderer, present, shouldStop);
+
+	renderer.dynamicResolution().settings = dynamicResolution;
+	renderer.refinement().settings = refinement;
+	renderer.framePipeline().settings = framePipeline;
+}
+
+void Benchmark::runFrames(Renderer& renderer, const std::function<void()>& present, const std::function<bool()>& shouldStop) {
+	// Wait for background mesh LOD generation so every run measures the same geometry
+	while (renderer.world().lodBuildPending()) {
+		renderer.world().update();
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+
+	auto placeCamera = [&](int frame) {
+		float u = (mConfig.frames > 1) ? static_cast<float>(frame) / static_cast<float>(mConfig.frames - 1) : 0.0f;
+		glm::vec3 eye(0.0f, 0.0f, 2.0f), target(0.0f);
+		mConfig.cameraPath.sample(u, eye, target);
+		renderer.setCamera(eye, target);
+	};
+
+	// Warmup at the first path position: shader compilation, driver uploads, query pipeline fill
+	for (int i = 0; i < mConfig.warmupFrames; ++i) {
+		if (shouldStop && shouldStop()) return;
+		placeCamera(0);
+		renderer.render();
+		if (present) present();
+	}
+
+	mSamples.clear();
+	mSamples.reserve(static_cast<size_t>(mConfig.frames));
+	unsigned long long lastGpuSample = renderer.profilingData().gpuSampleCount;
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < mConfig.frames; ++i) {
+		if (shouldStop && shouldStop()) break;
+		placeCamera(i);
+		renderer.render();
+		if (present) present();
+
+		const ProfilingData& prof = renderer.profilingData();
+		BenchmarkSample sample;
+		sample.cpuMs = prof.cpuFrameTime;
+		if (prof.gpuSampleCount != lastGpuSample) {  // Only count freshly resolved GPU timings
+			sample.gpuMs = prof.gpuFrameTime;
+			lastGpuSample = prof.gpuSampleCount;
+		}
+		sample.drawCalls = prof.drawCalls;
+		sample.triangles = prof.triangles;
+		sample.points = prof.points;
+		sample.gpuMemory = prof.gpuMemoryUsed;
+		sample.cpuMemory = prof.cpuMemoryUsed;
+		mSamples.push_back(sample);
+	}
+	mWallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+bool Benchmark::writeReport(const std::string& prefix, std::string& outError) const {
+	std::filesystem::path base(prefix);
+	if (base.has_parent_path()) {
+		std::error_code ec;
+		std::filesystem::create_directories(base.parent_path(), ec);
+	}
+
+	SampleStats cpu = computeSampleStats(collect(mSamples, [](const BenchmarkSample& s) { return s.cpuMs; }));
+	SampleStats gpu = computeSampleStats(collect(mSamples, [](const BenchmarkSample& s) { return s.gpuMs; }));
+	SampleStats draws = computeSampleStats(collect(mSamples, [](const BenchmarkSample& s) { return static_cast<double>(s.drawCalls); }));
+	SampleStats tris = computeSampleStats(collect(mSamples, [](const BenchmarkSample& s) { return static_cast<double>(s.triangles); }));
+	SampleStats points = computeSampleStats(collect(mSamples, [](const BenchmarkSample& s) { return static_cast<double>(s.points); }));
+	const MemoryTracker& tracker = MemoryTracker::instance();
+
+	{
+		std::ofstream out(prefix + ".json");
+		if (!out) { outError = "Cannot write " + prefix + ".json"; return false; }
+		out << std::setprecision(6);
+		out << "{\n";
+		out << "  \"name\": \"" << jsonEscape(mConfig.name) << "\",\n";
+		out << "  \"glRenderer\": \"" << jsonEscape(mGLRenderer) << "\",\n";
+		out << "  \"glVersion\": \"" << jsonEscape(mGLVersion) << "\",\n";
+		out << "  \"frames\": " << mSamples.size() << ",\n";
+		out << "  \"warmupFrames\": " << mConfig.warmupFrames << ",\n";
+		out << "  \"wallSeconds\": " << mWallSeconds << ",\n";
+		out << "  \"cameraKeyframes\": " << mConfig.cameraPath.size() << ",\n";
+		out << "  \"renderModes\": { \"dynamicResolution\": " << (mModes.dynamicResolution ? "true" : "false")
+		    << ", \"progressiveRefinement\": " << (mModes.progressiveRefinement ? "true" : "false")
+		    << ", \"framePipeline\": " << (mModes.framePipeline ? "true" : "false") << " },\n";
+		out << "  \"stats\": {\n";
+		writeStatsJson(out, "cpuFrameMs", cpu);
+		writeStatsJson(out, "gpuFrameMs", gpu);
+		writeStatsJson(out, "drawCalls", draws);
+		writeStatsJson(out, "triangles", tris);
+		writeStatsJson(out, "points", points, true);
+		out << "  },\n";
+		out << "  \"memory\": {\n";
+		out << "    \"gpuLiveBytes\": " << tracker.totalLiveBytes() << ",\n";
+		out << "    \"gpuPeakBytes\": " << tracker.totalPeakBytes() << ",\n";
+		out << "    \"cpuBytes\": " << tracker.totalCpuBytes() << ",\n";
+		out << "    \"gpuByCategory\": {";
+		for (size_t c = 0; c < static_cast<size_t>(MemoryCategory::Count); ++c) {
+			MemoryCategory category = static_cast<MemoryCategory>(c);
+			out << (c ? ", " : " ") << "\"" << MemoryTracker::categoryName(category) << "\": " << tracker.liveBytes(category);
+		}
+		out << " }\n";
+		out << "  }\n";
+		out << "}\n";
+		if (!out) { outError = "Failed writing " + prefix + ".json"; return false; }
+	}
+
+	{
+		std::ofstream out(prefix + ".csv");
+		if (!out) { outError = "Cannot write " + prefix + ".csv"; return false; }
+		out << "frame,cpu_ms,gpu_ms,draw_calls,triangles,points,gpu_memory_bytes,cpu_memory_bytes\n";
+		for (size_t i = 0; i < mSamples.size(); ++i) {
+			const BenchmarkSample& s = mSamples[i];
+			out << i << ',' << s.cpuMs << ',';
+			if (s.gpuMs >= 0.0) out << s.gpuMs;  // Empty cell: no fresh GPU sample
+			out << ',' << s.drawCalls << ',' << s.triangles << ',' << s.points << ','
+			    << s.gpuMemory << ',' << s.cpuMemory << '\n';
+		}
+		if (!out) { outError = "Failed writing " + prefix + ".csv"; return false; }
+	}
+	return true;
+}
+
+void Benchmark::printSummary() const {
+	SampleStats cpu = computeSampleStats(collect(mSamples, [](const BenchmarkSample& s) { return s.cpuMs; }));
+	SampleStats gpu = computeSampleStats(collect(mSamples, [](const BenchmarkSample& s) { return s.gpuMs; }));
+	std::cout << std::fixed << std::setprecision(3)
+	          << "\n=== Benchmark: " << mConfig.name << " (" << mSamples.size() << " frames, " << mWallSeconds << " s) ===\n"
+	          << "CPU frame ms  p50 " << cpu.p50 << "  p95 " << cpu.p95 << "  p99 " << cpu.p99 << "  mean " << cpu.mean << "\n";
+	if (gpu.count > 0) {
+		std::cout << "GPU frame ms  p50 " << gpu.p50 << "  p95 " << gpu.p95 << "  p99 " << gpu.p99 << "  mean " << gpu.mean
+		          << "  (" << gpu.count << " samples)\n";
+	} else {
+		std::cout << "GPU frame ms  N/A (timer queries unavailable)\n";
+	}
+	std::cout.unsetf(std::ios::floatfield);
+}
+
+} // namespace Graphics
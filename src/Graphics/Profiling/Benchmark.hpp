@@ -0,0 +1,100 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "Graphics/Profiling/CameraPath.hpp"
+#include "Graphics/Profiling/Json.hpp"
+
+namespace Graphics {
+
+class Renderer;
+class Scene;
+
+/// Benchmark script (JSON). All members are optional:
+/// {
+///   "name": "bunny-orbit",
+///   "model": "assets/bunny.ply",          // overrides the model given on the command line
+///   "frames": 600, "warmupFrames": 60,
+///   "width": 1280, "height": 720,
+///   "report": "bench/bunny",               // writes bench/bunny.json and bench/bunny.csv
+///   "settings": { "frustumCulling": true, "occlusionCulling": false, "earlyZ": false,
+///                 "spatialIndexing": true, "meshLOD": true, "lodErrorPixels": 1.0,
+///                 "autoLOD": false, "pointMode": "points|impostors|instanced", "pointSize": 2.0,
+///                 "sphereRadius": 0.01,
+///                 "dynamicResolution": false, "progressiveRefinement": false, "framePipeline": false },
+///   "camera": { "type": "orbit", "radius": 2.0, "elevation": 0.4, "revolutions": 1 }
+///          or { "type": "path", "file": "camera_path.json" }
+///          or { "type": "path", "keyframes": [ ... ] }
+/// }
+struct BenchmarkConfig {
+	std::string name = "benchmark";
+	std::string modelPath;  // Empty: use the command-line model
+	int frames = 600;
+	int warmupFrames = 60;
+	int width = 0;   // 0: keep the current window / --size
+	int height = 0;
+	std::string reportPrefix = "benchmark_report";
+	JsonValue settings;
+	CameraPath cameraPath;
+};
+
+/// Per-frame measurements collected during a benchmark run.
+struct BenchmarkSample {
+	double cpuMs = 0.0;
+	double gpuMs = -1.0;  // < 0: no new GPU timestamp resolved this frame
+	unsigned int drawCalls = 0;
+	unsigned int triangles = 0;
+	unsigned int points = 0;
+	size_t gpuMemory = 0;
+	size_t cpuMemory = 0;
+};
+
+/// Deterministic benchmark: replays a camera path for a fixed number of frames (vsync off) and
+/// reports CPU/GPU frame time percentiles, draw counters and memory as JSON and CSV.
+class Benchmark {
+public:
+	/// Load and validate a benchmark script.
+	bool loadConfig(const std::string& path, std::string& outError);
+	const BenchmarkConfig& config() const { return mConfig; }
+	BenchmarkConfig& config() { return mConfig; }
+
+	/// Apply the script's "settings" block to the scene (culling, LOD, point modes).
+	void applySettings(Scene& scene) const;
+
+	/// Run warmup + measured frames. The script's settings go to every object; dynamic resolution,
+	/// progressive refinement and the one-frame-latency pipeline are off unless the script turns them
+	/// on (the report records which ran). The renderer's own modes are restored afterwards.
+	/// @param renderer Initialized renderer (window or headless)
+	/// @param present Called after every frame (swap buffers, poll events); may be empty
+	/// @param shouldStop Optional early-out (e.g. window closed)
+	void run(Renderer& renderer, const std::function<void()>& present, const std::function<bool()>& shouldStop = {});
+
+	/// Write <prefix>.json (summary) and <prefix>.csv (per-frame samples).
+	bool writeReport(const std::string& prefix, std::string& outError) const;
+
+	/// Print a one-screen summary to stdout.
+	void printSummary() const;
+
+	const std::vector<BenchmarkSample>& samples() const { return mSamples; }
+
+private:
+	// Frame-to-frame adaptive modes of the renderer for one run
+	struct RenderModes {
+		bool dynamicResolution = false;
+		bool progressiveRefinement = false;
+		bool framePipeline = false;
+	};
+
+	void runFrames(Renderer& renderer, const std::function<void()>& present, const std::function<bool()>& shouldStop);
+
+	BenchmarkConfig mConfig;
+	RenderModes mModes;
+	std::vector<BenchmarkSample> mSamples;
+	double mWallSeconds = 0.0;
+	std::string mGLRenderer;
+	std::string mGLVersion;
+};
+
+} // namespace Graphics
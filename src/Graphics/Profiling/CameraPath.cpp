@@ -0,0 +1,81 @@
+#include "Graphics/Profiling/CameraPath.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+namespace Graphics {
+
+void CameraPath::sample(float u, glm::vec3& outEye, glm::vec3& outTarget) const {
+	if (mKeyframes.empty()) return;
+	if (mKeyframes.size() == 1) { outEye = mKeyframes[0].eye; outTarget = mKeyframes[0].target; return; }
+
+	float t = mKeyframes.front().time + std::clamp(u, 0.0f, 1.0f) * duration();
+	auto it = std::upper_bound(mKeyframes.begin(), mKeyframes.end(), t,
+		[](float value, const CameraKeyframe& k) { return value < k.time; });
+	if (it == mKeyframes.begin()) { outEye = it->eye; outTarget = it->target; return; }
+	if (it == mKeyframes.end()) { outEye = mKeyframes.back().eye; outTarget = mKeyframes.back().target; return; }
+
+	const CameraKeyframe& a = *(it - 1);
+	const CameraKeyframe& b = *it;
+	float span = b.time - a.time;
+	float f = (span > 0.0f) ? (t - a.time) / span : 0.0f;
+	outEye = a.eye + (b.eye - a.eye) * f;
+	outTarget = a.target + (b.target - a.target) * f;
+}
+
+static bool readVec3(const JsonValue* v, glm::vec3& out) {
+	if (!v || !v->isArray() || v->array.size() != 3) return false;
+	for (int i = 0; i < 3; ++i) {
+		if (v->array[static_cast<size_t>(i)].type != JsonValue::Type::Number) return false;
+		out[i] = static_cast<float>(v->array[static_cast<size_t>(i)].number);
+	}
+	return true;
+}
+
+bool CameraPath::loadFromJson(const JsonValue& value, std::string& outError) {
+	const JsonValue* keyframes = value.find("keyframes");
+	if (!keyframes || !keyframes->isArray()) { outError = "camera path: missing \"keyframes\" array"; return false; }
+	mKeyframes.clear();
+	for (size_t i = 0; i < keyframes->array.size(); ++i) {
+		const JsonValue& k = keyframes->array[i];
+		CameraKeyframe frame;
+		frame.time = static_cast<float>(k.numberOr("t", static_cast<double>(i)));
+		if (!readVec3(k.find("eye"), frame.eye) || !readVec3(k.find("target"), frame.target)) {
+			outError = "camera path: keyframe " + std::to_string(i) + " needs \"eye\" and \"target\" [x, y, z]";
+			return false;
+		}
+		mKeyframes.push_back(frame);
+	}
+	std::stable_sort(mKeyframes.begin(), mKeyframes.end(), [](const CameraKeyframe& a, const CameraKeyframe& b) { return a.time < b.time; });
+	if (mKeyframes.empty()) { outError = "camera path: no keyframes"; return false; }
+	return true;
+}
+
+bool CameraPath::save(const std::string& path, std::string& outError) const {
+	std::ofstream out(path);
+	if (!out) { outError = "Cannot write " + path; return false; }
+	out << "{\n  \"keyframes\": [\n";
+	for (size_t i = 0; i < mKeyframes.size(); ++i) {
+		const CameraKeyframe& k = mKeyframes[i];
+		out << "    { \"t\": " << k.time
+		    << ", \"eye\": [" << k.eye.x << ", " << k.eye.y << ", " << k.eye.z << "]"
+		    << ", \"target\": [" << k.target.x << ", " << k.target.y << ", " << k.target.z << "] }"
+		    << (i + 1 < mKeyframes.size() ? ",\n" : "\n");
+	}
+	out << "  ]\n}\n";
+	return static_cast<bool>(out);
+}
+
+CameraPath CameraPath::orbit(float radius, float elevation, float revolutions) {
+	CameraPath path;
+	const int segments = std::max(4, static_cast<int>(std::ceil(64.0f * std::max(revolutions, 0.0625f))));
+	for (int i = 0; i <= segments; ++i) {
+		float f = static_cast<float>(i) / static_cast<float>(segments);
+		float angle = 6.2831853f * revolutions * f;
+		path.addKeyframe(f, glm::vec3(radius * std::sin(angle), elevation, radius * std::cos(angle)), glm::vec3(0.0f));
+	}
+	return path;
+}
+
+} // namespace Graphics
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "Graphics/Profiling/Json.hpp"
+
+namespace Graphics {
+
+struct CameraKeyframe {
+	float time = 0.0f;  // Seconds since the start of the path
+	glm::vec3 eye = glm::vec3(0.0f);
+	glm::vec3 target = glm::vec3(0.0f);
+};
+
+/// Keyframed camera path for reproducible benchmarks. Recorded interactively (F7) or scripted in JSON:
+/// { "keyframes": [ { "t": 0.0, "eye": [x, y, z], "target": [x, y, z] }, ... ] }
+class CameraPath {
+public:
+	void clear() { mKeyframes.clear(); }
+	void addKeyframe(float time, const glm::vec3& eye, const glm::vec3& target) { mKeyframes.push_back({time, eye, target}); }
+	bool empty() const { return mKeyframes.empty(); }
+	size_t size() const { return mKeyframes.size(); }
+	float duration() const { return mKeyframes.empty() ? 0.0f : mKeyframes.back().time - mKeyframes.front().time; }
+
+	/// Camera at normalized path position u in [0, 1] (linear interpolation between keyframes).
+	/// Benchmarks sample by frame index, never by wall-clock time, so runs are deterministic.
+	void sample(float u, glm::vec3& outEye, glm::vec3& outTarget) const;
+
+	/// Load keyframes from a parsed JSON object with a "keyframes" array.
+	bool loadFromJson(const JsonValue& value, std::string& outError);
+
+	/// Save keyframes as JSON (same format loadFromJson() reads).
+	bool save(const std::string& path, std::string& outError) const;
+
+	/// Circular orbit around the origin (models are normalized to a unit box).
+	/// @param radius Orbit radius
+	/// @param elevation Camera height above the orbit plane
+	/// @param revolutions Number of full turns
+	static CameraPath orbit(float radius, float elevation, float revolutions);
+
+private:
+	std::vector<CameraKeyframe> mKeyframes;
+};
+
+} // namespace Graphics
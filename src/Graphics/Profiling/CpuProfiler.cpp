@@ -0,0 +1,131 @@
+#include "Graphics/Profiling/CpuProfiler.hpp"
+#include "Graphics/Profiling/GpuProfiler.hpp"
+#include "Graphics/Profiling/Json.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+
+namespace Graphics {
+
+thread_local uint32_t CpuProfiler::Scope::sDepth = 0;
+
+CpuProfiler& CpuProfiler::instance() {
+	static CpuProfiler sProfiler;
+	return sProfiler;
+}
+
+uint64_t CpuProfiler::nowNs() {
+	static const std::chrono::steady_clock::time_point sEpoch = std::chrono::steady_clock::now();
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - sEpoch).count());
+}
+
+// Releases the thread's buffer on thread exit so short-lived workers don't grow the registry
+struct CpuProfiler::ThreadSlot {
+	ThreadBuffer* buffer = nullptr;
+	~ThreadSlot() { if (buffer) CpuProfiler::instance().releaseBuffer(*buffer); }
+};
+
+CpuProfiler::ThreadBuffer& CpuProfiler::localBuffer() {
+	thread_local ThreadSlot tSlot;
+	if (!tSlot.buffer) {
+		std::lock_guard<std::mutex> lock(mRegistryMutex);
+		for (const auto& buffer : mBuffers) {
+			if (!buffer->inUse) { tSlot.buffer = buffer.get(); break; }
+		}
+		if (!tSlot.buffer) {
+			mBuffers.push_back(std::make_shared<ThreadBuffer>());
+			mBuffers.back()->tid = static_cast<uint32_t>(mBuffers.size());
+			tSlot.buffer = mBuffers.back().get();
+		}
+		tSlot.buffer->inUse = true;
+		tSlot.buffer->name = "Thread " + std::to_string(tSlot.buffer->tid);
+	}
+	return *tSlot.buffer;
+}
+
+void CpuProfiler::releaseBuffer(ThreadBuffer& buffer) {
+	std::lock_guard<std::mutex> lock(mRegistryMutex);
+	buffer.inUse = false;
+}
+
+void CpuProfiler::setThreadName(const char* name) {
+	ThreadBuffer& buffer = localBuffer();
+	std::lock_guard<std::mutex> lock(mRegistryMutex);
+	buffer.name = name;
+}
+
+void CpuProfiler::record(const char* name, uint64_t beginNs, uint64_t endNs, uint32_t depth) {
+	ThreadBuffer& buffer = localBuffer();
+	uint64_t head = buffer.head.load(std::memory_order_relaxed);
+	buffer.events[head & (kEventsPerThread - 1)] = {name, beginNs, endNs, depth};
+	buffer.head.store(head + 1, std::memory_order_release);
+}
+
+static void writeEvent(std::ofstream& out, bool& first, const char* name, int pid, uint32_t tid, double tsUs, double durUs) {
+	out << (first ? "\n" : ",\n");
+	first = false;
+	out << "{\"name\":\"" << jsonEscape(name) << "\",\"ph\":\"X\",\"pid\":" << pid << ",\"tid\":" << tid
+	    << ",\"ts\":" << tsUs << ",\"dur\":" << durUs << "}";
+}
+
+static void writeName(std::ofstream& out, bool& first, const char* kind, int pid, uint32_t tid, const std::string& name) {
+	out << (first ? "\n" : ",\n");
+	first = false;
+	out << "{\"name\":\"" << kind << "\",\"ph\":\"M\",\"pid\":" << pid << ",\"tid\":" << tid
+	    << ",\"args\":{\"name\":\"" << jsonEscape(name) << "\"}}";
+}
+
+bool CpuProfiler::writeChromeTrace(const std::string& path, std::string& outError) const {
+	std::filesystem::path file(path);
+	if (file.has_parent_path()) {
+		std::error_code ec;
+		std::filesystem::create_directories(file.parent_path(), ec);
+	}
+	std::ofstream out(path);
+	if (!out) { outError = "Cannot write " + path; return false; }
+	out << std::fixed << std::setprecision(3);
+	out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+	constexpr int kCpuPid = 1, kGpuPid = 2;
+	bool first = true;
+	writeName(out, first, "process_name", kCpuPid, 0, "CPU");
+
+	std::vector<Event> events;
+	std::lock_guard<std::mutex> lock(mRegistryMutex);
+	for (const auto& buffer : mBuffers) {
+		writeName(out, first, "thread_name", kCpuPid, buffer->tid, buffer->name);
+		// Copy the live part of the ring, then drop entries the writer may have overwritten meanwhile
+		uint64_t head = buffer->head.load(std::memory_order_acquire);
+		uint64_t begin = head > kEventsPerThread ? head - kEventsPerThread : 0;
+		events.clear();
+		for (uint64_t i = begin; i < head; ++i) events.push_back(buffer->events[i & (kEventsPerThread - 1)]);
+		uint64_t headAfter = buffer->head.load(std::memory_order_acquire);
+		uint64_t validBegin = headAfter > kEventsPerThread ? headAfter - kEventsPerThread : 0;
+		size_t overwritten = static_cast<size_t>(std::min<uint64_t>(validBegin > begin ? validBegin - begin : 0, events.size()));
+		for (size_t i = overwritten; i < events.size(); ++i) {
+			const Event& e = events[i];
+			writeEvent(out, first, e.name, kCpuPid, buffer->tid, static_cast<double>(e.beginNs) * 1e-3, static_cast<double>(e.endNs - e.beginNs) * 1e-3);
+		}
+	}
+
+	// GPU scopes on their own track, shifted onto the CPU clock (see GpuProfiler::calibrate())
+	const GpuProfiler& gpu = GpuProfiler::instance();
+	std::vector<GpuProfiler::ScopeResult> gpuScopes = gpu.history();
+	if (!gpuScopes.empty()) {
+		writeName(out, first, "process_name", kGpuPid, 0, "GPU");
+		writeName(out, first, "thread_name", kGpuPid, 1, "GL Queue");
+		for (const auto& scope : gpuScopes) {
+			double tsUs = static_cast<double>(gpu.toCpuNs(scope.beginNs)) * 1e-3;
+			writeEvent(out, first, scope.name, kGpuPid, 1, tsUs, scope.ms() * 1e3);
+		}
+	}
+
+	out << "\n]}\n";
+	if (!out) { outError = "Failed writing " + path; return false; }
+	return true;
+}
+
+} // namespace Graphics
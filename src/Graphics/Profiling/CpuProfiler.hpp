@@ -0,0 +1,100 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Graphics {
+
+/// Lightweight CPU scope profiler.
+/// Every thread records completed scopes into its own fixed-size ring buffer (single writer,
+/// no locks on the hot path); the rings are only walked when a trace is exported.
+/// Output is Chrome Trace Event JSON (chrome://tracing, ui.perfetto.dev), with the GPU scopes
+/// from GpuProfiler placed on the same timeline.
+///
+/// Scope names must be string literals (only the pointer is stored):
+///     PHV_CPU_SCOPE("Octree::getVisiblePoints");
+class CpuProfiler {
+public:
+	static constexpr uint32_t kEventsPerThread = 1u << 14;  // Ring size per thread (power of two)
+
+	struct Event {
+		const char* name;
+		uint64_t beginNs;  // Since the profiler epoch (see nowNs())
+		uint64_t endNs;
+		uint32_t depth;
+	};
+
+	/// RAII scope; records nothing while the profiler is disabled.
+	class Scope {
+	public:
+		explicit Scope(const char* name) {
+			if (CpuProfiler::instance().enabled()) {
+				mName = name;
+				mBeginNs = nowNs();
+				sDepth++;
+			}
+		}
+		~Scope() {
+			if (mName) {
+				sDepth--;
+				CpuProfiler::instance().record(mName, mBeginNs, nowNs(), sDepth);
+			}
+		}
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+	private:
+		const char* mName = nullptr;
+		uint64_t mBeginNs = 0;
+		static thread_local uint32_t sDepth;
+	};
+
+	static CpuProfiler& instance();
+
+	/// Monotonic nanoseconds since the profiler epoch (steady clock).
+	static uint64_t nowNs();
+
+	bool enabled() const { return mEnabled.load(std::memory_order_relaxed); }
+	void setEnabled(bool enabled) { mEnabled.store(enabled, std::memory_order_relaxed); }
+
+	/// Name the calling thread in exported traces (e.g. "Main", "LOD Worker").
+	void setThreadName(const char* name);
+
+	/// Append a completed scope to the calling thread's ring. Prefer PHV_CPU_SCOPE.
+	void record(const char* name, uint64_t beginNs, uint64_t endNs, uint32_t depth);
+
+	/// Write everything still held in the rings (plus GpuProfiler history) as Chrome Trace Event JSON.
+	/// @param path Output file
+	/// @param outError Error message on failure
+	/// @return true if the file was written
+	bool writeChromeTrace(const std::string& path, std::string& outError) const;
+
+private:
+	CpuProfiler() = default;
+
+	struct ThreadBuffer {
+		std::unique_ptr<Event[]> events{new Event[kEventsPerThread]};
+		std::atomic<uint64_t> head{0};  // Total events written; only the owning thread stores
+		uint32_t tid = 0;
+		std::string name;
+		bool inUse = false;  // False once the owning thread exited; reused by the next new thread
+	};
+	struct ThreadSlot;
+
+	ThreadBuffer& localBuffer();
+	void releaseBuffer(ThreadBuffer& buffer);
+
+	std::atomic<bool> mEnabled{true};
+	mutable std::mutex mRegistryMutex;  // Guards mBuffers (thread registration and export only)
+	std::vector<std::shared_ptr<ThreadBuffer>> mBuffers;  // Kept after thread exit so traces survive; recycled for new threads
+};
+
+} // namespace Graphics
+
+#define PHV_CPU_CONCAT_INNER(a, b) a##b
+#define PHV_CPU_CONCAT(a, b) PHV_CPU_CONCAT_INNER(a, b)
+/// Time the enclosing block on the CPU under the given (string literal) name.
+#define PHV_CPU_SCOPE(name) ::Graphics::CpuProfiler::Scope PHV_CPU_CONCAT(phvCpuScope_, __LINE__)(name)
@@ -0,0 +1,156 @@
+#include "Graphics/Profiling/GpuProfiler.hpp"
+#include "Graphics/Profiling/CpuProfiler.hpp"
+
+namespace Graphics {
+
+// Weight of the newest sample in the smoothed per-scope averages
+static constexpr double kSmoothing = 0.1;
+
+GpuProfiler& GpuProfiler::instance() {
+	static GpuProfiler sProfiler;
+	return sProfiler;
+}
+
+bool GpuProfiler::initialize() {
+	shutdown();
+	mSupported = (glQueryCounter != nullptr && glGetQueryObjectui64v != nullptr);
+	if (!mSupported) return false;
+	for (FramePool& pool : mPools) {
+		glGenQueries(kMaxScopesPerFrame * 2, pool.queries);
+		pool.scopeCount = 0;
+		pool.lastQuery = -1;
+		pool.pending = false;
+	}
+	mCurrent = 0;
+	calibrate();
+	return true;
+}
+
+void GpuProfiler::calibrate() {
+	if (!mSupported) return;
+	// glGetInteger64v(GL_TIMESTAMP) returns the GPU clock "now" without waiting for queued work;
+	// bracketing it with two CPU reads bounds the error by the call latency
+	uint64_t cpuBefore = CpuProfiler::nowNs();
+	GLint64 gpuNow = 0;
+	glGetInteger64v(GL_TIMESTAMP, &gpuNow);
+	uint64_t cpuAfter = CpuProfiler::nowNs();
+	int64_t cpuMid = static_cast<int64_t>(cpuBefore + (cpuAfter - cpuBefore) / 2);
+	mGpuToCpuOffsetNs = static_cast<int64_t>(gpuNow) - cpuMid;
+}
+
+void GpuProfiler::shutdown() {
+	if (!mSupported) return;
+	for (FramePool& pool : mPools) {
+		if (pool.queries[0]) glDeleteQueries(kMaxScopesPerFrame * 2, pool.queries);
+		for (GLuint& q : pool.queries) q = 0;
+		pool.pending = false;
+	}
+	mSupported = false;
+	mInFrame = false;
+	mLastResults.clear();
+	mSmoothed.clear();
+	mHistory.clear();
+	mHistoryHead = 0;
+}
+
+bool GpuProfiler::tryResolve(FramePool& pool) {
+	if (!pool.pending) return false;
+	GLuint available = 0;
+	glGetQueryObjectuiv(pool.queries[pool.lastQuery], GL_QUERY_RESULT_AVAILABLE, &available);
+	if (!available) return false;
+
+	mLastResults.resize(static_cast<size_t>(pool.scopeCount));
+	for (int i = 0; i < pool.scopeCount; ++i) {
+		ScopeResult& r = mLastResults[static_cast<size_t>(i)];
+		r.name = pool.scopes[i].name;
+		r.depth = pool.scopes[i].depth;
+		GLuint64 begin = 0, end = 0;
+		glGetQueryObjectui64v(pool.queries[2 * i], GL_QUERY_RESULT, &begin);
+		glGetQueryObjectui64v(pool.queries[2 * i + 1], GL_QUERY_RESULT, &end);
+		r.beginNs = begin;
+		r.endNs = end;
+
+		auto it = mSmoothed.find(r.name);
+		if (it == mSmoothed.end()) mSmoothed.emplace(r.name, r.ms());
+		else it->second += kSmoothing * (r.ms() - it->second);
+
+		if (mHistory.size() < kHistorySize) mHistory.push_back(r);
+		else { mHistory[mHistoryHead] = r; mHistoryHead = (mHistoryHead + 1) % kHistorySize; }
+	}
+	pool.pending = false;
+	mResolvedFrames++;
+	return true;
+}
+
+void GpuProfiler::beginFrame() {
+	if (!mSupported || !mEnabled) return;
+
+	// Resolve completed frames oldest first; timestamps finish in submission order
+	for (int i = 1; i <= kFrameLatency; ++i) {
+		FramePool& pool = mPools[(mCurrent + i) % kFrameLatency];
+		if (!tryResolve(pool)) {
+			if (pool.pending) break;  // Later frames cannot be ready either
+		}
+	}
+
+	mCurrent = (mCurrent + 1) % kFrameLatency;
+	FramePool& pool = mPools[mCurrent];
+	if (pool.pending) {
+		// Still in flight after kFrameLatency frames: drop it instead of stalling
+		pool.pending = false;
+		mDroppedFrames++;
+	}
+	pool.scopeCount = 0;
+	pool.lastQuery = -1;
+	mDepth = 0;
+	mSkippedPushes = 0;
+	mInFrame = true;
+	pushScope("Frame");
+}
+
+void GpuProfiler::endFrame() {
+	if (!mInFrame) return;
+	while (mDepth > 0) popScope();  // Close the root (and anything left open)
+	FramePool& pool = mPools[mCurrent];
+	pool.pending = pool.lastQuery >= 0;
+	mInFrame = false;
+}
+
+bool GpuProfiler::pushScope(const char* name) {
+	if (!mInFrame) return false;
+	FramePool& pool = mPools[mCurrent];
+	if (pool.scopeCount >= kMaxScopesPerFrame || mDepth >= kMaxScopesPerFrame) {
+		mSkippedPushes++;
+		return true;  // popScope() balances the skip
+	}
+	int index = pool.scopeCount++;
+	pool.scopes[index] = {name, mDepth};
+	mOpenScopes[mDepth++] = index;
+	glQueryCounter(pool.queries[2 * index], GL_TIMESTAMP);
+	pool.lastQuery = 2 * index;
+	return true;
+}
+
+void GpuProfiler::popScope() {
+	if (mSkippedPushes > 0) { mSkippedPushes--; return; }
+	if (mDepth == 0) return;
+	FramePool& pool = mPools[mCurrent];
+	int index = mOpenScopes[--mDepth];
+	glQueryCounter(pool.queries[2 * index + 1], GL_TIMESTAMP);
+	pool.lastQuery = 2 * index + 1;
+}
+
+std::vector<GpuProfiler::ScopeResult> GpuProfiler::history() const {
+	std::vector<ScopeResult> ordered;
+	ordered.reserve(mHistory.size());
+	ordered.insert(ordered.end(), mHistory.begin() + static_cast<std::ptrdiff_t>(mHistoryHead), mHistory.end());
+	ordered.insert(ordered.end(), mHistory.begin(), mHistory.begin() + static_cast<std::ptrdiff_t>(mHistoryHead));
+	return ordered;
+}
+
+double GpuProfiler::smoothedMs(const char* name) const {
+	auto it = mSmoothed.find(name);
+	return it != mSmoothed.end() ? it->second : 0.0;
+}
+
+} // namespace Graphics
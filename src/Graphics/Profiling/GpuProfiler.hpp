@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <glad/glad.h>
+
+namespace Graphics {
+
+/// Hierarchical GPU timer built on GL_TIMESTAMP queries.
+/// Each frame records into its own query pool; pools form a ring kFrameLatency frames deep,
+/// so results are read back several frames later when they are already available and
+/// resolution never stalls the pipeline. A pool whose results are still pending when
+/// the ring wraps around is dropped rather than waited on.
+///
+/// Scopes nest (begin order and depth are preserved) and are named with string literals:
+///     PHV_GPU_SCOPE("Main Pass");
+class GpuProfiler {
+public:
+	static constexpr int kFrameLatency = 4;        // Query pools in flight
+	static constexpr int kMaxScopesPerFrame = 64;  // Extra scopes in a frame are ignored
+	static constexpr size_t kHistorySize = 8192;   // Resolved scopes kept for trace export
+
+	struct ScopeResult {
+		const char* name = "";
+		int depth = 0;
+		uint64_t beginNs = 0;  // GPU timestamps (GL_TIMESTAMP clock)
+		uint64_t endNs = 0;
+		double ms() const { return endNs > beginNs ? static_cast<double>(endNs - beginNs) * 1e-6 : 0.0; }
+	};
+
+	/// RAII scope; no-op while the profiler is disabled or unsupported.
+	class Scope {
+	public:
+		explicit Scope(const char* name) : mActive(instance().pushScope(name)) {}
+		~Scope() { if (mActive) instance().popScope(); }
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+	private:
+		bool mActive;
+	};
+
+	static GpuProfiler& instance();
+
+	/// Create the query pools. Requires GL 3.3 / ARB_timer_query (glQueryCounter).
+	/// @return true if GPU timing is available
+	bool initialize();
+	void shutdown();
+
+	/// Resolve every pool whose results are ready (non-blocking), then open the frame's root scope.
+	void beginFrame();
+	/// Close the root scope.
+	void endFrame();
+
+	/// Open a nested scope. Prefer PHV_GPU_SCOPE / GpuProfiler::Scope.
+	/// @return false if nothing was recorded (disabled, unsupported, pool full)
+	bool pushScope(const char* name);
+	void popScope();
+
+	bool supported() const { return mSupported; }
+	bool enabled() const { return mEnabled; }
+	void setEnabled(bool enabled) { mEnabled = enabled; }
+
+	/// Scopes of the most recently resolved frame, in begin order. Entry 0 is the whole frame.
+	const std::vector<ScopeResult>& lastResults() const { return mLastResults; }
+	/// Whole-frame GPU time of the most recently resolved frame (ms).
+	double lastFrameMs() const { return mLastResults.empty() ? 0.0 : mLastResults[0].ms(); }
+	/// Incremented each time a frame is resolved (lets callers detect fresh samples).
+	uint64_t resolvedFrames() const { return mResolvedFrames; }
+	/// Frames whose results were still pending when their pool was reused.
+	uint64_t droppedFrames() const { return mDroppedFrames; }
+	/// Exponentially smoothed time for a scope name (ms), for stable UI display.
+	double smoothedMs(const char* name) const;
+
+	/// Recently resolved scopes (oldest first, up to kHistorySize), for trace export.
+	std::vector<ScopeResult> history() const;
+
+	/// Re-measure the GL_TIMESTAMP clock against CpuProfiler::nowNs(). Call on the GL thread.
+	void calibrate();
+	/// Convert a GPU timestamp to the CpuProfiler clock (ns since its epoch, may be negative).
+	int64_t toCpuNs(uint64_t gpuNs) const { return static_cast<int64_t>(gpuNs) - mGpuToCpuOffsetNs; }
+
+private:
+	GpuProfiler() = default;
+
+	struct ScopeRecord {
+		const char* name;
+		int depth;
+	};
+	struct FramePool {
+		GLuint queries[kMaxScopesPerFrame * 2] = {};  // [2i] begin, [2i + 1] end
+		ScopeRecord scopes[kMaxScopesPerFrame] = {};
+		int scopeCount = 0;
+		int lastQuery = -1;  // Last timestamp issued (completes last)
+		bool pending = false;
+	};
+
+	bool tryResolve(FramePool& pool);
+
+	FramePool mPools[kFrameLatency];
+	int mCurrent = 0;
+	int mOpenScopes[kMaxScopesPerFrame] = {};
+	int mDepth = 0;
+	int mSkippedPushes = 0;  // Scopes ignored because the pool was full (matched by popScope)
+	bool mSupported = false;
+	bool mEnabled = true;
+	bool mInFrame = false;
+	uint64_t mResolvedFrames = 0;
+	uint64_t mDroppedFrames = 0;
+	std::vector<ScopeResult> mLastResults;
+	std::vector<ScopeResult> mHistory;  // Ring of resolved scopes
+	size_t mHistoryHead = 0;            // Next slot to overwrite once the ring is full
+	int64_t mGpuToCpuOffsetNs = 0;
+	std::unordered_map<std::string, double> mSmoothed;
+};
+
+} // namespace Graphics
+
+#define PHV_GPU_CONCAT_INNER(a, b) a##b
+#define PHV_GPU_CONCAT(a, b) PHV_GPU_CONCAT_INNER(a, b)
+/// Time the enclosing block on the GPU under the given (string literal) name.
+#define PHV_GPU_SCOPE(name) ::Graphics::GpuProfiler::Scope PHV_GPU_CONCAT(phvGpuScope_, __LINE__)(name)
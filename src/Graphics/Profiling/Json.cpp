@@ -0,0 +1,242 @@
+#include "Graphics/Profiling/Json.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <locale>
+#include <sstream>
+
+namespace Graphics {
+
+const JsonValue* JsonValue::find(const std::string& key) const {
+	if (type != Type::Object) return nullptr;
+	for (const auto& member : object) {
+		if (member.first == key) return &member.second;
+	}
+	return nullptr;
+}
+
+double JsonValue::numberOr(const std::string& key, double fallback) const {
+	const JsonValue* v = find(key);
+	return (v && v->type == Type::Number) ? v->number : fallback;
+}
+
+bool JsonValue::boolOr(const std::string& key, bool fallback) const {
+	const JsonValue* v = find(key);
+	return (v && v->type == Type::Bool) ? v->boolean : fallback;
+}
+
+std::string JsonValue::stringOr(const std::string& key, const std::string& fallback) const {
+	const JsonValue* v = find(key);
+	return (v && v->type == Type::String) ? v->string : fallback;
+}
+
+namespace {
+
+// Recursive-descent parser over the whole document
+class JsonParser {
+public:
+	explicit JsonParser(const std::string& text) : mText(text) {}
+
+	bool parseDocument(JsonValue& out, std::string& outError) {
+		skipWhitespace();
+		if (!parseValue(out, 0)) { outError = mError; return false; }
+		skipWhitespace();
+		if (mPos != mText.size()) { outError = error("trailing characters"); return false; }
+		return true;
+	}
+
+private:
+	static constexpr int kMaxDepth = 64;
+
+	std::string error(const char* what) const {
+		return std::string("JSON: ") + what + " at offset " + std::to_string(mPos);
+	}
+	bool fail(const char* what) { mError = error(what); return false; }
+
+	void skipWhitespace() {
+		while (mPos < mText.size() && (mText[mPos] == ' ' || mText[mPos] == '\t' || mText[mPos] == '\n' || mText[mPos] == '\r')) mPos++;
+	}
+
+	bool consume(const char* literal) {
+		size_t len = std::char_traits<char>::length(literal);
+		if (mText.compare(mPos, len, literal) != 0) return false;
+		mPos += len;
+		return true;
+	}
+
+	bool parseValue(JsonValue& out, int depth) {
+		if (depth > kMaxDepth) return fail("nesting too deep");
+		if (mPos >= mText.size()) return fail("unexpected end of input");
+		char c = mText[mPos];
+		if (c == '{') return parseObject(out, depth);
+		if (c == '[') return parseArray(out, depth);
+		if (c == '"') { out.type = JsonValue::Type::String; return parseString(out.string); }
+		if (consume("true")) { out.type = JsonValue::Type::Bool; out.boolean = true; return true; }
+		if (consume("false")) { out.type = JsonValue::Type::Bool; out.boolean = false; return true; }
+		if (consume("null")) { out.type = JsonValue::Type::Null; return true; }
+		if (c == '-' || (c >= '0' && c <= '9')) return parseNumber(out);
+		return fail("unexpected character");
+	}
+
+	bool isDigit(size_t pos) const { return pos < mText.size() && mText[pos] >= '0' && mText[pos] <= '9'; }
+
+	bool parseNumber(JsonValue& out) {
+		// JSON grammar only: no hex, inf / nan, leading zeros, "1." or ".5"
+		size_t end = mPos;
+		if (mText[end] == '-') end++;
+		if (!isDigit(end)) return fail("invalid number");
+		if (mText[end] == '0') end++;
+		else while (isDigit(end)) end++;
+		if (end < mText.size() && mText[end] == '.') {
+			end++;
+			if (!isDigit(end)) return fail("invalid number");
+			while (isDigit(end)) end++;
+		}
+		if (end < mText.size() && (mText[end] == 'e' || mText[end] == 'E')) {
+			end++;
+			if (end < mText.size() && (mText[end] == '+' || mText[end] == '-')) end++;
+			if (!isDigit(end)) return fail("invalid number");
+			while (isDigit(end)) end++;
+		}
+		std::istringstream in(mText.substr(mPos, end - mPos));
+		in.imbue(std::locale::classic());  // '.' whatever the global locale
+		double value = 0.0;
+		in >> value;
+		if (in.fail()) return fail("number out of range");
+		mPos = end;
+		out.type = JsonValue::Type::Number;
+		out.number = value;
+		return true;
+	}
+
+	bool parseString(std::string& out) {
+		mPos++;  // Opening quote
+		out.clear();
+		while (mPos < mText.size()) {
+			char c = mText[mPos++];
+			if (c == '"') return true;
+			if (static_cast<unsigned char>(c) < 0x20) { mPos--; return fail("control character in string"); }
+			if (c != '\\') { out.push_back(c); continue; }
+			if (mPos >= mText.size()) break;
+			char e = mText[mPos++];
+			switch (e) {
+				case '"': out.push_back('"'); break;
+				case '\\': out.push_back('\\'); break;
+				case '/': out.push_back('/'); break;
+				case 'b': out.push_back('\b'); break;
+				case 'f': out.push_back('\f'); break;
+				case 'n': out.push_back('\n'); break;
+				case 'r': out.push_back('\r'); break;
+				case 't': out.push_back('\t'); break;
+				case 'u': {
+					unsigned int code = 0;
+					for (int i = 0; i < 4; ++i, ++mPos) {
+						char h = mPos < mText.size() ? mText[mPos] : '\0';
+						unsigned int digit = (h >= '0' && h <= '9') ? static_cast<unsigned int>(h - '0')
+						                   : (h >= 'a' && h <= 'f') ? static_cast<unsigned int>(h - 'a' + 10)
+						                   : (h >= 'A' && h <= 'F') ? static_cast<unsigned int>(h - 'A' + 10) : 16u;
+						if (digit > 15) return fail("invalid \\u escape");
+						code = code * 16 + digit;
+					}
+					// UTF-8 encode (surrogate pairs are not combined; config files are ASCII in practice)
+					if (code < 0x80) out.push_back(static_cast<char>(code));
+					else if (code < 0x800) {
+						out.push_back(static_cast<char>(0xC0 | (code >> 6)));
+						out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+					} else {
+						out.push_back(static_cast<char>(0xE0 | (code >> 12)));
+						out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+						out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+					}
+					break;
+				}
+				default: return fail("invalid escape");
+			}
+		}
+		return fail("unterminated string");
+	}
+
+	bool parseArray(JsonValue& out, int depth) {
+		mPos++;  // '['
+		out.type = JsonValue::Type::Array;
+		skipWhitespace();
+		if (mPos < mText.size() && mText[mPos] == ']') { mPos++; return true; }
+		for (;;) {
+			skipWhitespace();
+			out.array.emplace_back();
+			if (!parseValue(out.array.back(), depth + 1)) return false;
+			skipWhitespace();
+			if (mPos < mText.size() && mText[mPos] == ',') { mPos++; continue; }
+			if (mPos < mText.size() && mText[mPos] == ']') { mPos++; return true; }
+			return fail("expected ',' or ']'");
+		}
+	}
+
+	bool parseObject(JsonValue& out, int depth) {
+		mPos++;  // '{'
+		out.type = JsonValue::Type::Object;
+		skipWhitespace();
+		if (mPos < mText.size() && mText[mPos] == '}') { mPos++; return true; }
+		for (;;) {
+			skipWhitespace();
+			if (mPos >= mText.size() || mText[mPos] != '"') return fail("expected member name");
+			std::string key;
+			if (!parseString(key)) return false;
+			skipWhitespace();
+			if (mPos >= mText.size() || mText[mPos] != ':') return fail("expected ':'");
+			mPos++;
+			skipWhitespace();
+			out.object.emplace_back(std::move(key), JsonValue());
+			if (!parseValue(out.object.back().second, depth + 1)) return false;
+			skipWhitespace();
+			if (mPos < mText.size() && mText[mPos] == ',') { mPos++; continue; }
+			if (mPos < mText.size() && mText[mPos] == '}') { mPos++; return true; }
+			return fail("expected ',' or '}'");
+		}
+	}
+
+	const std::string& mText;
+	size_t mPos = 0;
+	std::string mError;
+};
+
+} // namespace
+
+bool parseJson(const std::string& text, JsonValue& outValue, std::string& outError) {
+	outValue = JsonValue();
+	JsonParser parser(text);
+	return parser.parseDocument(outValue, outError);
+}
+
+bool parseJsonFile(const std::string& path, JsonValue& outValue, std::string& outError) {
+	std::ifstream f(path);
+	if (!f.is_open()) { outError = "Cannot open " + path; return false; }
+	std::ostringstream ss; ss << f.rdbuf();
+	if (!parseJson(ss.str(), outValue, outError)) { outError = path + ": " + outError; return false; }
+	return true;
+}
+
+std::string jsonEscape(const std::string& s) {
+	std::string out;
+	out.reserve(s.size());
+	for (char c : s) {
+		switch (c) {
+			case '"': out += "\\\""; break;
+			case '\\': out += "\\\\"; break;
+			case '\n': out += "\\n"; break;
+			case '\r': out += "\\r"; break;
+			case '\t': out += "\\t"; break;
+			default:
+				if (static_cast<unsigned char>(c) < 0x20) {
+					char buf[8];
+					std::snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned int>(static_cast<unsigned char>(c)));
+					out += buf;
+				} else {
+					out.push_back(c);
+				}
+		}
+	}
+	return out;
+}
+
+} // namespace Graphics
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Graphics {
+
+/// Minimal JSON document model for config files (benchmark scripts, camera paths).
+/// Numbers are stored as double; object members keep their file order.
+struct JsonValue {
+	enum class Type { Null, Bool, Number, String, Array, Object };
+
+	Type type = Type::Null;
+	bool boolean = false;
+	double number = 0.0;
+	std::string string;
+	std::vector<JsonValue> array;
+	std::vector<std::pair<std::string, JsonValue>> object;
+
+	bool isNull() const { return type == Type::Null; }
+	bool isObject() const { return type == Type::Object; }
+	bool isArray() const { return type == Type::Array; }
+
+	/// Object member lookup. Returns nullptr if missing or not an object.
+	const JsonValue* find(const std::string& key) const;
+
+	// Typed accessors with defaults (used when the member is missing or has another type)
+	double numberOr(const std::string& key, double fallback) const;
+	bool boolOr(const std::string& key, bool fallback) const;
+	std::string stringOr(const std::string& key, const std::string& fallback) const;
+};
+
+/// Parse a JSON document.
+/// @param text JSON source
+/// @param outValue Parsed document
+/// @param outError Error message with byte offset on failure
+/// @return true if successful
+bool parseJson(const std::string& text, JsonValue& outValue, std::string& outError);
+
+/// Parse a JSON file.
+bool parseJsonFile(const std::string& path, JsonValue& outValue, std::string& outError);
+
+/// Escape a string for embedding in JSON output (without surrounding quotes).
+std::string jsonEscape(const std::string& s);
+
+} // namespace Graphics
@@ -0,0 +1,109 @@
+#include "Graphics/Profiling/MemoryTracker.hpp"
+#include "Graphics/Utils.hpp"
+
+#include <glad/glad.h>
+
+namespace Graphics {
+
+// Vendor memory query tokens (not part of the generated GLAD header)
+static constexpr GLenum kGpuMemoryInfoDedicatedVidmemNVX       = 0x9047;
+static constexpr GLenum kGpuMemoryInfoCurrentAvailableVidmemNVX = 0x9049;
+static constexpr GLenum kVboFreeMemoryATI                       = 0x87FB;
+
+MemoryTracker& MemoryTracker::instance() {
+	static MemoryTracker sTracker;
+	return sTracker;
+}
+
+void MemoryTracker::raisePeak(std::atomic<size_t>& peak, size_t value) {
+	size_t prev = peak.load(std::memory_order_relaxed);
+	while (value > prev && !peak.compare_exchange_weak(prev, value, std::memory_order_relaxed)) {}
+}
+
+void MemoryTracker::allocate(MemoryCategory category, size_t bytes) {
+	if (bytes == 0) return;
+	size_t live = mLive[index(category)].fetch_add(bytes, std::memory_order_relaxed) + bytes;
+	raisePeak(mPeak[index(category)], live);
+	size_t total = mTotalLive.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+	raisePeak(mTotalPeak, total);
+}
+
+void MemoryTracker::release(MemoryCategory category, size_t bytes) {
+	if (bytes == 0) return;
+	mLive[index(category)].fetch_sub(bytes, std::memory_order_relaxed);
+	mTotalLive.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+void MemoryTracker::resize(MemoryCategory category, size_t oldBytes, size_t newBytes) {
+	if (newBytes > oldBytes) allocate(category, newBytes - oldBytes);
+	else release(category, oldBytes - newBytes);
+}
+
+void MemoryTracker::allocateCpu(CpuMemoryCategory category, size_t bytes) {
+	size_t live = mCpuLive[index(category)].fetch_add(bytes, std::memory_order_relaxed) + bytes;
+	raisePeak(mCpuPeak[index(category)], live);
+}
+
+void MemoryTracker::releaseCpu(CpuMemoryCategory category, size_t bytes) {
+	mCpuLive[index(category)].fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+size_t MemoryTracker::totalLiveBytes() const {
+	return mTotalLive.load(std::memory_order_relaxed);
+}
+
+size_t MemoryTracker::totalCpuBytes() const {
+	size_t total = 0;
+	for (size_t i = 0; i < kCpuCount; ++i) total += mCpuLive[i].load(std::memory_order_relaxed);
+	return total;
+}
+
+const char* MemoryTracker::categoryName(MemoryCategory category) {
+	switch (category) {
+		case MemoryCategory::Vertices:  return "Vertices";
+		case MemoryCategory::Indices:   return "Indices";
+		case MemoryCategory::Octree:    return "Octree";
+		case MemoryCategory::Streaming: return "Streaming";
+		case MemoryCategory::UBO:       return "UBO";
+		case MemoryCategory::Targets:   return "Targets";
+		case MemoryCategory::Other:     return "Other";
+		default:                        return "?";
+	}
+}
+
+const char* MemoryTracker::categoryName(CpuMemoryCategory category) {
+	switch (category) {
+		case CpuMemoryCategory::Model:  return "Model";
+		case CpuMemoryCategory::Octree: return "Octree";
+		default:                        return "?";
+	}
+}
+
+void MemoryTracker::initializeVendorQueries() {
+	mHasNVXMemoryInfo = hasGLExtension("GL_NVX_gpu_memory_info");
+	mHasATIMemInfo = hasGLExtension("GL_ATI_meminfo");
+}
+
+MemoryTracker::VendorMemoryInfo MemoryTracker::queryVendorMemory() const {
+	VendorMemoryInfo info;
+	if (mHasNVXMemoryInfo) {
+		// Values are reported in KiB
+		GLint dedicatedKb = 0, availableKb = 0;
+		glGetIntegerv(kGpuMemoryInfoDedicatedVidmemNVX, &dedicatedKb);
+		glGetIntegerv(kGpuMemoryInfoCurrentAvailableVidmemNVX, &availableKb);
+		info.available = true;
+		info.source = "GL_NVX_gpu_memory_info";
+		info.totalBytes = static_cast<size_t>(dedicatedKb) * 1024;
+		info.availableBytes = static_cast<size_t>(availableKb) * 1024;
+	} else if (mHasATIMemInfo) {
+		// [0] = total free KiB in pool, [1] = largest block, [2..3] = auxiliary memory
+		GLint freeKb[4] = {0, 0, 0, 0};
+		glGetIntegerv(kVboFreeMemoryATI, freeKb);
+		info.available = true;
+		info.source = "GL_ATI_meminfo";
+		info.availableBytes = static_cast<size_t>(freeKb[0]) * 1024;
+	}
+	return info;
+}
+
+} // namespace Graphics
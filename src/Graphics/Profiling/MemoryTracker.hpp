@@ -0,0 +1,125 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace Graphics {
+
+// GPU allocation categories (reported separately in the profiling UI)
+enum class MemoryCategory : uint8_t {
+	Vertices,   // Vertex buffers (mesh / point cloud VBOs)
+	Indices,    // Element buffers (EBOs)
+	Octree,     // Index data produced from the spatial index
+	Streaming,  // Per-frame orphaned / streamed buffers (DynamicLines, instance streams)
+	UBO,        // Uniform buffers
+	Targets,    // Offscreen render targets and readback PBOs
+	Other,      // Debug geometry, proxies, etc.
+	Count
+};
+
+// CPU-side owners of large allocations
+enum class CpuMemoryCategory : uint8_t {
+	Model,   // Vertex/index vectors kept by Model
+	Octree,  // Octree nodes and point index lists
+	Count
+};
+
+/// Central tracker for GPU and CPU memory held by the viewer.
+/// GL wrappers (GlBuffer, UniformBuffer, DynamicLines, ...) register every (re)allocation here,
+/// so live and peak bytes per category are exact rather than estimated.
+/// All counters are atomic: allocations may be reported from worker threads.
+class MemoryTracker {
+public:
+	struct VendorMemoryInfo {
+		bool available = false;     // True if a vendor extension answered the query
+		const char* source = "";    // Extension that provided the numbers
+		size_t totalBytes = 0;      // Dedicated video memory (0 if unknown)
+		size_t availableBytes = 0;  // Currently free video memory
+	};
+
+	static MemoryTracker& instance();
+
+	// GPU allocations
+	void allocate(MemoryCategory category, size_t bytes);
+	void release(MemoryCategory category, size_t bytes);
+	void resize(MemoryCategory category, size_t oldBytes, size_t newBytes);
+	void trackVertexArray(int delta) { mVertexArrays.fetch_add(delta, std::memory_order_relaxed); }
+
+	// CPU allocations
+	void allocateCpu(CpuMemoryCategory category, size_t bytes);
+	void releaseCpu(CpuMemoryCategory category, size_t bytes);
+
+	size_t liveBytes(MemoryCategory category) const { return mLive[index(category)].load(std::memory_order_relaxed); }
+	size_t peakBytes(MemoryCategory category) const { return mPeak[index(category)].load(std::memory_order_relaxed); }
+	size_t totalLiveBytes() const;
+	size_t totalPeakBytes() const { return mTotalPeak.load(std::memory_order_relaxed); }
+	size_t cpuBytes(CpuMemoryCategory category) const { return mCpuLive[index(category)].load(std::memory_order_relaxed); }
+	size_t cpuPeakBytes(CpuMemoryCategory category) const { return mCpuPeak[index(category)].load(std::memory_order_relaxed); }
+	size_t totalCpuBytes() const;
+	int vertexArrayCount() const { return mVertexArrays.load(std::memory_order_relaxed); }
+
+	static const char* categoryName(MemoryCategory category);
+	static const char* categoryName(CpuMemoryCategory category);
+
+	/// Detect vendor memory extensions (GL_NVX_gpu_memory_info, GL_ATI_meminfo). Requires a current GL context.
+	void initializeVendorQueries();
+
+	/// Query driver-reported video memory. Cheap, but must be called on the GL thread.
+	VendorMemoryInfo queryVendorMemory() const;
+
+private:
+	MemoryTracker() = default;
+	template <typename E> static size_t index(E e) { return static_cast<size_t>(e); }
+	static void raisePeak(std::atomic<size_t>& peak, size_t value);
+
+	static constexpr size_t kGpuCount = static_cast<size_t>(MemoryCategory::Count);
+	static constexpr size_t kCpuCount = static_cast<size_t>(CpuMemoryCategory::Count);
+
+	std::atomic<size_t> mLive[kGpuCount] = {};
+	std::atomic<size_t> mPeak[kGpuCount] = {};
+	std::atomic<size_t> mTotalLive{0};
+	std::atomic<size_t> mTotalPeak{0};
+	std::atomic<size_t> mCpuLive[kCpuCount] = {};
+	std::atomic<size_t> mCpuPeak[kCpuCount] = {};
+	std::atomic<int> mVertexArrays{0};
+
+	bool mHasNVXMemoryInfo = false;
+	bool mHasATIMemInfo = false;
+};
+
+/// Movable RAII handle reporting a CPU-side byte count for its owner.
+/// Owners (Model, Octree) call set() whenever their containers change size; the bytes
+/// are released automatically when the owner is destroyed.
+class TrackedCpuBytes {
+public:
+	explicit TrackedCpuBytes(CpuMemoryCategory category) : mCategory(category) {}
+	~TrackedCpuBytes() { set(0); }
+	TrackedCpuBytes(const TrackedCpuBytes&) = delete;
+	TrackedCpuBytes& operator=(const TrackedCpuBytes&) = delete;
+	TrackedCpuBytes(TrackedCpuBytes&& other) noexcept : mCategory(other.mCategory), mBytes(other.mBytes) { other.mBytes = 0; }
+	TrackedCpuBytes& operator=(TrackedCpuBytes&& other) noexcept {
+		if (this != &other) {
+			set(0);
+			mCategory = other.mCategory;
+			mBytes = other.mBytes;
+			other.mBytes = 0;
+		}
+		return *this;
+	}
+
+	void set(size_t bytes) {
+		if (bytes == mBytes) return;
+		MemoryTracker& tracker = MemoryTracker::instance();
+		if (bytes > mBytes) tracker.allocateCpu(mCategory, bytes - mBytes);
+		else tracker.releaseCpu(mCategory, mBytes - bytes);
+		mBytes = bytes;
+	}
+	size_t bytes() const { return mBytes; }
+
+private:
+	CpuMemoryCategory mCategory;
+	size_t mBytes = 0;
+};
+
+} // namespace Graphics
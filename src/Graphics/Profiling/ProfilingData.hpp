@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+
+namespace Graphics {
+
+/// Per-frame performance counters filled by Renderer/Scene and displayed by the Inspector.
+struct ProfilingData {
+	double cpuFrameTime = 0.0;      // CPU frame time (ms)
+	double gpuFrameTime = 0.0;      // GPU frame time (ms)
+	unsigned int drawCalls = 0;     // Number of draw calls per frame
+	unsigned int triangles = 0;    // Number of triangles rendered
+	unsigned int points = 0;       // Number of points rendered (for point clouds)
+	unsigned int objects = 0;      // Objects in the world
+	unsigned int objectsVisible = 0; // ...of which inside the frustum
+	unsigned int renderBatches = 0;  // Render queue runs sharing pass, program, geometry and material
+	unsigned int instancedObjects = 0;  // Objects drawn in instanced same-model runs
+	double cullMs = 0.0;           // CPU time of culling and draw sorting (see FramePipeline)
+	bool framePipelined = false;   // ...spent on the worker, one frame ahead
+	unsigned long long stateCallsRequested = 0; // GLStateCache requests per frame
+	unsigned long long stateCallsSkipped = 0;   // ...of which redundant (never reached the driver)
+	size_t gpuMemoryUsed = 0;      // GPU memory held by tracked GL resources (bytes)
+	bool gpuTimingAvailable = false; // Whether GPU timing queries are available
+	unsigned long long gpuSampleCount = 0; // Incremented whenever a new gpuFrameTime is resolved
+
+	// Dynamic resolution (see DynamicResolution)
+	bool dynamicResolution = false;    // Scene passes rendered into the scaled internal target
+	float renderScale = 1.0f;          // Per-axis scale of the scene passes
+	int renderWidth = 0;               // Scene pass resolution (pixels)
+	int renderHeight = 0;
+
+	// Memory accounting (see MemoryTracker)
+	size_t gpuMemoryPeak = 0;          // Peak tracked GPU memory (bytes)
+	size_t cpuMemoryUsed = 0;          // CPU memory held by Model + Octree (bytes)
+	bool driverMemoryAvailable = false; // Whether a vendor memory extension is present
+	const char* driverMemorySource = "";
+	size_t driverMemoryTotal = 0;      // Dedicated video memory reported by the driver (bytes, 0 if unknown)
+	size_t driverMemoryFree = 0;       // Free video memory reported by the driver (bytes)
+};
+
+} // namespace Graphics
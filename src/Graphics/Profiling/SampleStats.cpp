@@ -0,0 +1,29 @@
+#include "Graphics/Profiling/SampleStats.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Graphics {
+
+double nearestRankPercentile(const std::vector<double>& sorted, double p) {
+	size_t rank = static_cast<size_t>(std::ceil(p * static_cast<double>(sorted.size())));
+	return sorted[std::min(sorted.size() - 1, rank > 0 ? rank - 1 : 0)];
+}
+
+SampleStats computeSampleStats(std::vector<double> values) {
+	SampleStats s;
+	if (values.empty()) return s;
+	std::sort(values.begin(), values.end());
+	s.count = values.size();
+	double sum = 0.0;
+	for (double v : values) sum += v;
+	s.mean = sum / static_cast<double>(values.size());
+	s.min = values.front();
+	s.max = values.back();
+	s.p50 = nearestRankPercentile(values, 0.50);
+	s.p95 = nearestRankPercentile(values, 0.95);
+	s.p99 = nearestRankPercentile(values, 0.99);
+	return s;
+}
+
+} // namespace Graphics
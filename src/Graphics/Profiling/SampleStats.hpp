@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace Graphics {
+
+/// Summary of a series of measurements (benchmark frame times and counters).
+struct SampleStats {
+	size_t count = 0;
+	double mean = 0.0, min = 0.0, max = 0.0;
+	double p50 = 0.0, p95 = 0.0, p99 = 0.0;
+};
+
+/// Nearest-rank percentile: the smallest sample with at least a fraction p of the samples at or below it.
+/// @param sorted Samples in ascending order (not empty)
+/// @param p Fraction in [0, 1]
+double nearestRankPercentile(const std::vector<double>& sorted, double p);
+
+/// Count, mean, range and nearest-rank p50 / p95 / p99 of the samples (all zero when empty).
+SampleStats computeSampleStats(std::vector<double> values);
+
+} // namespace Graphics
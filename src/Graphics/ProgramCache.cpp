@@ -0,0 +1,141 @@
+#include "Graphics/ProgramCache.hpp"
+#include "Graphics/Utils.hpp"
+
+#include <glad/glad.h>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+namespace Graphics {
+
+namespace {
+constexpr uint32_t kMagic = 0x42564850u;  // "PHVB"
+constexpr uint32_t kFileVersion = 1;
+
+// Entry file header; the key is repeated so a renamed or truncated file is never trusted
+struct EntryHeader {
+	uint32_t magic = kMagic;
+	uint32_t version = kFileVersion;
+	uint64_t key = 0;
+	uint32_t format = 0;
+	uint32_t size = 0;
+};
+
+uint64_t hashString(const std::string& s, uint64_t seed) {
+	// Length first so ("ab", "c") and ("a", "bc") differ
+	uint64_t length = s.size();
+	return hashBytes(s.data(), s.size(), hashBytes(&length, sizeof(length), seed));
+}
+
+double msSince(std::chrono::steady_clock::time_point start) {
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+} // namespace
+
+ProgramCache& ProgramCache::instance() {
+	static ProgramCache sCache;
+	return sCache;
+}
+
+void ProgramCache::initialize(const std::string& directory) {
+	mDirectory = directory;
+	mSupported = Shader::binariesSupported();
+	mDriverHash = hashBytes(nullptr, 0);
+	for (GLenum name : {GL_VENDOR, GL_RENDERER, GL_VERSION}) {
+		const char* value = reinterpret_cast<const char*>(glGetString(name));
+		mDriverHash = hashString(value ? value : "", mDriverHash);
+	}
+	mStats = Stats{};
+}
+
+std::string ProgramCache::injectDefines(const std::string& source, const std::string& defines) {
+	if (defines.empty()) return source;
+	size_t version = source.find("#version");
+	if (version == std::string::npos) return defines + source;
+	size_t lineEnd = source.find('\n', version);
+	if (lineEnd == std::string::npos) return source + "\n" + defines;
+	// Extensions must precede other declarations, so skip any that follow #version as well
+	size_t insertAt = lineEnd + 1;
+	while (source.compare(insertAt, 10, "#extension") == 0) {
+		size_t next = source.find('\n', insertAt);
+		if (next == std::string::npos) break;
+		insertAt = next + 1;
+	}
+	return source.substr(0, insertAt) + defines + source.substr(insertAt);
+}
+
+std::string ProgramCache::entryPath(uint64_t key) const {
+	char name[32];
+	snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+	return (std::filesystem::path(mDirectory) / name).string();
+}
+
+bool ProgramCache::load(Shader& shader, uint64_t key) {
+	std::ifstream in(entryPath(key), std::ios::binary);
+	if (!in.is_open()) return false;
+	EntryHeader header;
+	if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))) return false;
+	if (header.magic != kMagic || header.version != kFileVersion || header.key != key || header.size == 0) return false;
+	std::vector<unsigned char> data(header.size);
+	if (!in.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()))) return false;
+	in.close();
+	if (shader.loadBinary(header.format, data.data(), data.size())) return true;
+
+	mStats.rejected++;
+	std::error_code ec;
+	std::filesystem::remove(entryPath(key), ec);
+	return false;
+}
+
+void ProgramCache::store(const Shader& shader, uint64_t key) {
+	unsigned int format = 0;
+	std::vector<unsigned char> data;
+	if (!shader.getBinary(format, data)) return;
+	std::error_code ec;
+	std::filesystem::create_directories(mDirectory, ec);
+	if (ec) return;
+
+	// Write to a temporary name and rename, so a concurrent launch never reads half a file
+	std::string path = entryPath(key);
+	std::string tmpPath = path + ".tmp";
+	{
+		std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+		if (!out.is_open()) return;
+		EntryHeader header;
+		header.key = key;
+		header.format = format;
+		header.size = static_cast<uint32_t>(data.size());
+		out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		out.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+		if (!out) { out.close(); std::filesystem::remove(tmpPath, ec); return; }
+	}
+	std::filesystem::rename(tmpPath, path, ec);
+	if (ec) { std::filesystem::remove(tmpPath, ec); return; }
+	mStats.stored++;
+}
+
+bool ProgramCache::build(Shader& shader, const std::string& vertexSrc, const std::string& fragmentSrc, const std::string& defines, std::string& outError) {
+	uint64_t key = hashString(defines, hashString(fragmentSrc, hashString(vertexSrc, mDriverHash)));
+	if (enabled()) {
+		auto start = std::chrono::steady_clock::now();
+		if (load(shader, key)) {
+			mStats.hits++;
+			mStats.loadMs += msSince(start);
+			return true;
+		}
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	std::string vs = injectDefines(vertexSrc, defines);
+	std::string fs = injectDefines(fragmentSrc, defines);
+	if (!shader.compileFromSource(vs.c_str(), fs.c_str(), outError)) return false;
+	mStats.misses++;
+	mStats.compileMs += msSince(start);
+	if (enabled()) store(shader, key);
+	return true;
+}
+
+} // namespace Graphics
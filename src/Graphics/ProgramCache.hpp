@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "Graphics/Shader.h"
+
+namespace Graphics {
+
+/// On-disk cache of linked shader programs (glGetProgramBinary, GL 4.1 / ARB_get_program_binary).
+/// An entry is keyed by a hash of the stage sources, the #defines injected into them and the driver
+/// identity (GL_VENDOR, GL_RENDERER, GL_VERSION), so a driver update or another GPU simply misses.
+/// A binary the driver still rejects is deleted and the program is compiled from source and stored again.
+/// Without binary support every build() compiles from source, exactly as before.
+class ProgramCache {
+public:
+	struct Stats {
+		unsigned int hits = 0;      // Programs loaded from a binary
+		unsigned int misses = 0;    // Programs compiled from source
+		unsigned int rejected = 0;  // Binaries found but refused by the driver
+		unsigned int stored = 0;    // Binaries written
+		double loadMs = 0.0;        // Time spent in cache hits
+		double compileMs = 0.0;     // Time spent compiling and linking
+	};
+
+	static ProgramCache& instance();
+
+	/// Read the driver identity and binary support of the current context.
+	/// @param directory Where binaries are kept (created on the first store); empty disables the cache
+	void initialize(const std::string& directory);
+
+	/// Build a vertex/fragment program, from the cache when a matching binary loads, else from source
+	/// (and then store its binary).
+	/// @param shader Program to (re)build
+	/// @param vertexSrc Vertex shader source
+	/// @param fragmentSrc Fragment shader source
+	/// @param defines Lines such as "#define FOO 1\n", inserted after the #version line of both stages
+	/// @param outError Compile/link log if compiling from source fails
+	/// @return true if the program is ready
+	bool build(Shader& shader, const std::string& vertexSrc, const std::string& fragmentSrc, const std::string& defines, std::string& outError);
+
+	/// Insert lines after the #version directive (or at the top if there is none).
+	static std::string injectDefines(const std::string& source, const std::string& defines);
+
+	bool enabled() const { return mSupported && !mDirectory.empty(); }
+	const Stats& stats() const { return mStats; }
+
+private:
+	ProgramCache() = default;
+	std::string entryPath(uint64_t key) const;
+	bool load(Shader& shader, uint64_t key);
+	void store(const Shader& shader, uint64_t key);
+
+	std::string mDirectory;
+	uint64_t mDriverHash = 0;
+	bool mSupported = false;
+	Stats mStats;
+};
+
+} // namespace Graphics
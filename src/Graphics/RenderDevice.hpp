@@ -1,9 +1,23 @@
 #pragma once
 
 #include <string>
+#include <cstdio>
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
+#include "Graphics/Utils.hpp"
+
+#ifdef PH_VIZ_HAS_EGL
+#ifndef EGL_NO_X11
+#define EGL_NO_X11  // Keep Xlib out of the include graph; we only need surfaceless contexts
+#endif
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#ifndef EGL_PLATFORM_SURFACELESS_MESA
+#define EGL_PLATFORM_SURFACELESS_MESA 0x31DD
+#endif
+#endif
+
 namespace Graphics {
 
 class RenderDevice {
@@ -27,10 +41,81 @@ public:
 		if (!mWindow) { outError = "Failed to create GLFW window"; glfwTerminate(); return false; }
 		glfwMakeContextCurrent(mWindow);
 		glfwSwapInterval(1);
-		glfwSetFramebufferSizeCallback(mWindow, [](GLFWwindow* /*w*/, int width, int height){ glViewport(0, 0, width, height); });
+		glfwSetFramebufferSizeCallback(mWindow, [](GLFWwindow* /*w*/, int width, int height){ GLStateCache::instance().viewport(0, 0, width, height); });
 		glfwGetFramebufferSize(mWindow, &mFbW, &mFbH);
 
 		if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) { outError = "Failed to initialize GLAD"; return false; }
+		initializeGLState();
+		return true;
+	}
+
+	/// Create an OpenGL context without a visible window, for batch rendering on machines without a display.
+	/// Uses EGL surfaceless contexts when built with EGL (works with Mesa llvmpipe); otherwise falls back to
+	/// a hidden GLFW window. There is no usable default framebuffer: render into an OffscreenTarget.
+	/// @param width Render width in pixels
+	/// @param height Render height in pixels
+	/// @param outError Error message if no context could be created
+	/// @return true if successful, false on error
+	bool initializeHeadless(int width, int height, std::string& outError) {
+		mFbW = width; mFbH = height;
+		mHeadless = true;
+#ifdef PH_VIZ_HAS_EGL
+		if (initializeEGL(outError)) {
+			initializeGLState();
+			return true;
+		}
+		fprintf(stderr, "Headless: EGL unavailable (%s), trying hidden GLFW window\n", outError.c_str());
+		outError.clear();
+#endif
+		glfwSetErrorCallback([](int code, const char* desc){ (void)code; fprintf(stderr, "GLFW Error: %s\n", desc); });
+		if (!glfwInit()) { outError = "Failed to initialize GLFW (no display and no EGL support)"; return false; }
+		glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+		glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+		glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+		glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+#ifdef __APPLE__
+		glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+#endif
+		mWindow = glfwCreateWindow(64, 64, "PH_Viz (headless)", nullptr, nullptr);
+		if (!mWindow) { outError = "Failed to create hidden GLFW window"; glfwTerminate(); return false; }
+		glfwMakeContextCurrent(mWindow);
+		glfwSwapInterval(0);
+		if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) { outError = "Failed to initialize GLAD"; return false; }
+		initializeGLState();
+		return true;
+	}
+
+	void shutdown() {
+		if (mWindow) { glfwDestroyWindow(mWindow); mWindow = nullptr; glfwTerminate(); }
+#ifdef PH_VIZ_HAS_EGL
+		if (mEglDisplay != EGL_NO_DISPLAY) {
+			eglMakeCurrent(mEglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+			if (mEglContext != EGL_NO_CONTEXT) eglDestroyContext(mEglDisplay, mEglContext);
+			eglTerminate(mEglDisplay);
+			mEglDisplay = EGL_NO_DISPLAY;
+			mEglContext = EGL_NO_CONTEXT;
+		}
+#endif
+	}
+
+	/// Enable or disable vsync (benchmarks run uncapped). No-op in headless mode.
+	void setVsync(bool enabled) { if (mWindow && !mHeadless) glfwSwapInterval(enabled ? 1 : 0); }
+
+	/// Resize the window (framebuffer size follows on the next poll()).
+	void setWindowSize(int width, int height) { if (mWindow && !mHeadless) glfwSetWindowSize(mWindow, width, height); }
+
+	GLFWwindow* window() const { return mWindow; }
+	bool headless() const { return mHeadless; }
+	int fbWidth() const { return mFbW; }
+	int fbHeight() const { return mFbH; }
+	bool shouldClose() const { return mWindow ? glfwWindowShouldClose(mWindow) : false; }
+	void swap() { if (mWindow && !mHeadless) glfwSwapBuffers(mWindow); }
+	void poll() { if (mWindow && !mHeadless) { glfwPollEvents(); glfwGetFramebufferSize(mWindow, &mFbW, &mFbH); } }
+	/// Sleep until an event arrives or the timeout passes (on-demand rendering), then process events like poll().
+	void waitEvents(double timeoutSec) { if (mWindow && !mHeadless) { glfwWaitEventsTimeout(timeoutSec); glfwGetFramebufferSize(mWindow, &mFbW, &mFbH); } }
+
+private:
+	void initializeGLState() {
 		glEnable(GL_DEPTH_TEST);
 		glClearDepth(1.0);
 		glDepthFunc(GL_LESS);
@@ -39,22 +124,50 @@ public:
 		glFrontFace(GL_CCW);
 		glEnable(GL_FRAMEBUFFER_SRGB);
 		glClearColor(0.08f, 0.09f, 0.11f, 1.0f);  // Set once during init, not every frame
-		return true;
 	}
 
-	void shutdown() {
-		if (mWindow) { glfwDestroyWindow(mWindow); mWindow = nullptr; glfwTerminate(); }
+#ifdef PH_VIZ_HAS_EGL
+	bool initializeEGL(std::string& outError) {
+		// Prefer Mesa's surfaceless platform (no GPU or display needed), then the default display
+		auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+		if (getPlatformDisplay) mEglDisplay = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+		if (mEglDisplay == EGL_NO_DISPLAY) mEglDisplay = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+		if (mEglDisplay == EGL_NO_DISPLAY) { outError = "eglGetDisplay failed"; return false; }
+
+		EGLint major = 0, minor = 0;
+		if (!eglInitialize(mEglDisplay, &major, &minor)) { outError = "eglInitialize failed"; mEglDisplay = EGL_NO_DISPLAY; return false; }
+		if (!eglBindAPI(EGL_OPENGL_API)) { outError = "eglBindAPI(EGL_OPENGL_API) failed"; shutdown(); return false; }
+
+		const EGLint configAttribs[] = { EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_NONE };
+		EGLConfig config = nullptr;
+		EGLint numConfigs = 0;
+		if (!eglChooseConfig(mEglDisplay, configAttribs, &config, 1, &numConfigs) || numConfigs == 0) {
+			outError = "eglChooseConfig found no OpenGL config"; shutdown(); return false;
+		}
+
+		const EGLint contextAttribs[] = {
+			EGL_CONTEXT_MAJOR_VERSION, 3,
+			EGL_CONTEXT_MINOR_VERSION, 3,
+			EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+			EGL_NONE
+		};
+		mEglContext = eglCreateContext(mEglDisplay, config, EGL_NO_CONTEXT, contextAttribs);
+		if (mEglContext == EGL_NO_CONTEXT) { outError = "eglCreateContext failed"; shutdown(); return false; }
+		// Surfaceless: requires EGL_KHR_surfaceless_context; all rendering goes to FBOs
+		if (!eglMakeCurrent(mEglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, mEglContext)) {
+			outError = "eglMakeCurrent without surface failed (EGL_KHR_surfaceless_context missing?)"; shutdown(); return false;
+		}
+		if (!gladLoadGLLoader((GLADloadproc)eglGetProcAddress)) { outError = "Failed to initialize GLAD via EGL"; shutdown(); return false; }
+		printf("Headless: EGL %d.%d surfaceless context\n", major, minor);
+		return true;
 	}
 
-	GLFWwindow* window() const { return mWindow; }
-	int fbWidth() const { return mFbW; }
-	int fbHeight() const { return mFbH; }
-	bool shouldClose() const { return glfwWindowShouldClose(mWindow); }
-	void swap() { glfwSwapBuffers(mWindow); }
-	void poll() { glfwPollEvents(); glfwGetFramebufferSize(mWindow, &mFbW, &mFbH); }
+	EGLDisplay mEglDisplay = EGL_NO_DISPLAY;
+	EGLContext mEglContext = EGL_NO_CONTEXT;
+#endif
 
-private:
 	GLFWwindow* mWindow = nullptr;
+	bool mHeadless = false;
 	int mFbW = 0, mFbH = 0;
 };
 
@@ -0,0 +1,49 @@
+#include "Graphics/RenderQueue.hpp"
+
+#include <algorithm>
+
+namespace Graphics {
+
+static constexpr unsigned int kDepthBits = 24;
+static constexpr unsigned int kMaterialBits = 20;
+static constexpr unsigned int kFormatBits = 8;
+static constexpr unsigned int kProgramBits = 8;
+static constexpr uint64_t kDepthMask = (uint64_t(1) << kDepthBits) - 1;
+
+uint64_t RenderQueue::makeKey(Pass pass, unsigned int program, unsigned int vertexFormat, uint32_t material, float depth, float farPlane) {
+	// Depth quantized linearly over [0, farPlane]; everything beyond sorts last
+	float t = farPlane > 0.0f ? std::clamp(depth / farPlane, 0.0f, 1.0f) : 0.0f;
+	uint64_t quantized = static_cast<uint64_t>(t * static_cast<float>(kDepthMask));
+
+	uint64_t key = static_cast<uint64_t>(pass) & 0xF;
+	key = (key << kProgramBits) | (program & ((1u << kProgramBits) - 1));
+	key = (key << kFormatBits) | (vertexFormat & ((1u << kFormatBits) - 1));
+	key = (key << kMaterialBits) | (material & ((1u << kMaterialBits) - 1));
+	key = (key << kDepthBits) | std::min(quantized, kDepthMask);
+	return key;
+}
+
+void RenderQueue::sort() {
+	std::stable_sort(mItems.begin(), mItems.end(), [](const Item& a, const Item& b) { return a.key < b.key; });
+}
+
+// True if two keys differ in nothing but depth
+static bool sameBatch(uint64_t a, uint64_t b) { return (a >> kDepthBits) == (b >> kDepthBits); }
+
+size_t RenderQueue::batchCount() const {
+	size_t batches = 0;
+	for (size_t i = 0; i < mItems.size(); ++i) {
+		if (i == 0 || !sameBatch(mItems[i].key, mItems[i - 1].key)) batches++;
+	}
+	return batches;
+}
+
+void RenderQueue::batches(std::vector<Batch>& out) const {
+	out.clear();
+	for (size_t i = 0; i < mItems.size(); ++i) {
+		if (i == 0 || !sameBatch(mItems[i].key, mItems[i - 1].key)) out.push_back({i, i});
+		out.back().end = i + 1;
+	}
+}
+
+} // namespace Graphics
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Graphics {
+
+/// Submission order for the objects of one frame.
+/// Every item carries a 64-bit sort key, most significant field first:
+///   pass (4 bits) | program (8) | vertex format (8) | material (20) | depth (24)
+/// Sorting by key groups the draws that share a pass, program, vertex layout and material, so the
+/// state cache skips the rebinds between them, and orders each group front to back for early-Z.
+/// Adjacent items that differ only in depth form a batch (compatible draws submitted back to back).
+class RenderQueue {
+public:
+	/// Passes in submission order
+	enum class Pass : uint8_t { DepthPrepass = 0, Opaque = 1 };
+
+	struct Item {
+		uint64_t key = 0;
+		uint32_t object = 0;  // Index of the object in the World
+	};
+
+	/// Items [first, end) of the sorted queue.
+	struct Batch {
+		size_t first = 0;
+		size_t end = 0;
+	};
+
+	/// Build a sort key. Fields wider than their bits are truncated.
+	/// @param pass Pass the draw belongs to
+	/// @param program Program (shader family) the object is drawn with
+	/// @param vertexFormat Vertex layout / geometry the object is drawn from
+	/// @param material Hash of the object's material block
+	/// @param depth View-space distance of the object
+	/// @param farPlane Distance mapped to the largest depth value (farther ones are clamped)
+	static uint64_t makeKey(Pass pass, unsigned int program, unsigned int vertexFormat, uint32_t material, float depth, float farPlane);
+
+	/// Pass of a key.
+	static Pass pass(uint64_t key) { return static_cast<Pass>(key >> 60); }
+
+	void clear() { mItems.clear(); }
+	void push(uint64_t key, uint32_t object) { mItems.push_back({key, object}); }
+
+	/// Sort by key (stable: equal keys keep their push order).
+	void sort();
+
+	const std::vector<Item>& items() const { return mItems; }
+	size_t size() const { return mItems.size(); }
+
+	/// Batches of the sorted queue: runs of items whose keys match in everything but depth.
+	size_t batchCount() const;
+
+	/// The batches counted by batchCount(), in queue order.
+	void batches(std::vector<Batch>& out) const;
+
+private:
+	std::vector<Item> mItems;
+};
+
+} // namespace Graphics
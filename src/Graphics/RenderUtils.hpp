@@ -96,8 +96,6 @@ public:
 			mBoxVBO.setData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
 			glEnableVertexAttribArray(0);
 			glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
-			glBindBuffer(GL_ARRAY_BUFFER, 0);
-			mBoxVAO.bind(); // Keep VAO bound
 		}
 		
 		if (!mAxesVAO.valid()) {
@@ -108,22 +106,18 @@ public:
 			mAxesVBO.setData(GL_ARRAY_BUFFER, sizeof(axes), axes, GL_STATIC_DRAW);
 			glEnableVertexAttribArray(0);
 			glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
-			glBindBuffer(GL_ARRAY_BUFFER, 0);
-			mAxesVAO.bind(); // Keep VAO bound
 		}
-		glBindVertexArray(0);
+		GLStateCache::instance().bindVertexArray(0);
 	}
 
 	void draw(unsigned int shaderProgram, const glm::mat4& model, const glm::mat4& view, const glm::mat4& proj) const {
 		if (!mBoxVAO.valid()) return;
 		
-		// Save current state
-		GLint prevProgram = 0;
-		glGetIntegerv(GL_CURRENT_PROGRAM, &prevProgram);
+		// Save current state (the program is tracked by GLStateCache, only line width needs restoring)
 		GLfloat prevLineWidth = 1.0f;
 		glGetFloatv(GL_LINE_WIDTH, &prevLineWidth);
 		
-		glUseProgram(shaderProgram);
+		GLStateCache::instance().useProgram(shaderProgram);
 		glLineWidth(2.0f);  // Make bounding box lines slightly thicker
 		
 		// Set uniforms (assuming standard names)
@@ -158,13 +152,9 @@ public:
 				glDrawArrays(GL_LINES, 0, 6);  // 3 axes * 2 vertices each
 			}
 		}
-		glBindVertexArray(0);
 		
 		// Restore previous state
 		glLineWidth(prevLineWidth);
-		if (prevProgram >= 0) {
-			glUseProgram(static_cast<unsigned int>(prevProgram));
-		}
 	}
 
 	void destroy() {
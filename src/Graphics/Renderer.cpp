@@ -4,20 +4,24 @@
 #include <GLFW/glfw3.h>
 
 #include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
 #include <iostream>
-#include <fstream>
-#include <sstream>
-#include <filesystem>
 #include <cfloat>
 #include <cstring>  // For strstr, sscanf
+#include <chrono>
+#include <unordered_map>
 
 #include <imgui.h>
 #include <imgui_impl_glfw.h>
 #include <imgui_impl_opengl3.h>
 
+#include "Graphics/ProgramCache.hpp"
 #include "Graphics/RenderUtils.hpp"
 #include "Graphics/UI/Inspector.hpp"
 #include "Graphics/Utils.hpp"
+#include "Graphics/Profiling/MemoryTracker.hpp"
+#include "Graphics/Profiling/GpuProfiler.hpp"
+#include "Graphics/Profiling/CpuProfiler.hpp"
 
 namespace Graphics {
 
@@ -26,26 +30,26 @@ void Renderer::framebufferSizeCallbackForwarder(GLFWwindow* window, int w, int h
 	if (self) self->onResize(w, h);
 }
 
-static bool readTextFile(const std::string& path, std::string& out) {
-	std::ifstream f(path);
-	if (!f.is_open()) return false;
-	std::ostringstream ss; ss << f.rdbuf();
-	out = ss.str();
-	return true;
-}
-
-static unsigned long long fileStamp(const std::string& path) {
-	std::error_code ec;
-	auto ft = std::filesystem::last_write_time(path, ec);
-	if (ec) return 0ULL;
-	return static_cast<unsigned long long>(ft.time_since_epoch().count());
+void Renderer::inputEventForwarder(GLFWwindow* window) {
+	Renderer* self = static_cast<Renderer*>(glfwGetWindowUserPointer(window));
+	if (self) self->mInputFrames = Config::InputRedrawFrames;
 }
 
-bool Renderer::initializeWithContext(GLFWwindow* window, const std::string& modelPath, std::string& outError) {
+bool Renderer::initializeWithContext(GLFWwindow* window, const std::vector<std::string>& modelPaths, std::string& outError) {
 	if (!window) { outError = "Renderer: window is null"; return false; }
 	mWindow = window;
 	glfwSetWindowUserPointer(mWindow, this);
 	glfwSetFramebufferSizeCallback(mWindow, framebufferSizeCallbackForwarder);
+	// Any input wakes on-demand rendering for a few frames. Installed before ImGui, whose GLFW backend
+	// chains to the callbacks it finds.
+	glfwSetCursorPosCallback(mWindow, [](GLFWwindow* w, double, double) { inputEventForwarder(w); });
+	glfwSetCursorEnterCallback(mWindow, [](GLFWwindow* w, int) { inputEventForwarder(w); });
+	glfwSetMouseButtonCallback(mWindow, [](GLFWwindow* w, int, int, int) { inputEventForwarder(w); });
+	glfwSetScrollCallback(mWindow, [](GLFWwindow* w, double, double) { inputEventForwarder(w); });
+	glfwSetKeyCallback(mWindow, [](GLFWwindow* w, int, int, int, int) { inputEventForwarder(w); });
+	glfwSetCharCallback(mWindow, [](GLFWwindow* w, unsigned int) { inputEventForwarder(w); });
+	glfwSetWindowFocusCallback(mWindow, [](GLFWwindow* w, int) { inputEventForwarder(w); });
+	glfwSetWindowRefreshCallback(mWindow, [](GLFWwindow* w) { inputEventForwarder(w); });
 	glfwGetFramebufferSize(mWindow, &mWidth, &mHeight);
 	mAspect = (mHeight > 0) ? (float)mWidth / (float)mHeight : 1.0f;
 
@@ -63,7 +67,7 @@ bool Renderer::initializeWithContext(GLFWwindow* window, const std::string& mode
 	ImGui_ImplOpenGL3_Init(glsl_version);
 	mImGuiInitialized = true;
 
-	if (!initializeScene(modelPath, outError)) {
+	if (!initializeScene(modelPaths, outError)) {
 		// Cleanup ImGui if scene init fails
 		ImGui_ImplOpenGL3_Shutdown();
 		ImGui_ImplGlfw_Shutdown();
@@ -72,15 +76,53 @@ bool Renderer::initializeWithContext(GLFWwindow* window, const std::string& mode
 		return false;
 	}
 
+	std::string watchError;
+	if (!mShaderReload.start(kShaderDir, watchError)) std::cerr << "Shader hot reload disabled: " << watchError << "\n";
+
+	return true;
+}
+
+std::vector<ShaderHotReload::Program> Renderer::programs() {
+	std::vector<ShaderHotReload::Program> list = {
+		{nullptr, &mShaders, "shaders/pbr.vert", "shaders/pbr.frag", "Shader"},
+		{&mLineShader, nullptr, "shaders/line.vert", "shaders/line.frag", "Line shader"},  // Bounding box
+		{nullptr, &mSphereImpostorShaders, "shaders/sphere_impostor.vert", "shaders/sphere_impostor.frag", "Sphere impostor shader"},  // Instanced quads, ray-cast
+		{nullptr, &mInstancedSphereShaders, "shaders/instanced_sphere.vert", "shaders/pbr.frag", "Instanced sphere shader"},
+		{&mDepthOnlyShader, nullptr, "shaders/depth_only.vert", "shaders/depth_only.frag", "Depth-only shader"},  // Early-Z prepass
+		{&mImpostorDepthShader, nullptr, "shaders/sphere_impostor.vert", "shaders/sphere_impostor_depth.frag", "Sphere impostor depth shader"},  // Early-Z prepass, point clouds
+		{&mInstancedSphereDepthShader, nullptr, "shaders/instanced_sphere.vert", "shaders/depth_only.frag", "Instanced sphere depth shader"},
+		{&mInstancedDepthShader, nullptr, "shaders/depth_only.vert", "shaders/depth_only.frag", "Instanced depth shader", "#define INSTANCED 1\n"},  // Early-Z prepass, mesh runs
+		{&mEyeDomeShader, nullptr, "shaders/fullscreen.vert", "shaders/eye_dome.frag", "Eye-dome lighting shader"},  // Point cloud post-process
+		{&mCullingOverlayShader, nullptr, "shaders/culling_overlay.vert", "shaders/culling_overlay.frag", "Culling overlay shader"},  // Debug node boxes
+	};
+	return list;
+}
+
+bool Renderer::initializeHeadless(int width, int height, const std::vector<std::string>& modelPaths, std::string& outError) {
+	mWindow = nullptr;
+	mWidth = width; mHeight = height;
+	mAspect = (height > 0) ? (float)width / (float)height : 1.0f;
+	if (!mOffscreenTarget.create(width, height, outError)) return false;
+	if (!initializeScene(modelPaths, outError)) {
+		mOffscreenTarget.destroy();
+		return false;
+	}
 	return true;
 }
 
+void Renderer::setCamera(const glm::vec3& eye, const glm::vec3& target) {
+	mView.setLookAt(eye, target);
+	glm::vec3 front = glm::normalize(target - eye);
+	mView.yaw = glm::degrees(std::atan2(front.z, front.x));
+	mView.pitch = glm::degrees(std::asin(front.y));
+}
+
 void APIENTRY glDebugCallback(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, const GLchar* message, const void* userParam) {
 	(void)source; (void)type; (void)id; (void)severity; (void)length; (void)userParam;
 	std::cerr << "GL DEBUG: " << message << '\n';
 }
 
-bool Renderer::initializeScene(const std::string& modelPath, std::string& outError) {
+bool Renderer::initializeScene(const std::vector<std::string>& modelPaths, std::string& outError) {
 	// Log OpenGL information
 	const char* glVendor = reinterpret_cast<const char*>(glGetString(GL_VENDOR));
 	const char* glRenderer = reinterpret_cast<const char*>(glGetString(GL_RENDERER));
@@ -107,76 +149,69 @@ bool Renderer::initializeScene(const std::string& modelPath, std::string& outErr
 		std::cout << "GL Debug output enabled" << std::endl;
 	}
 
-	mVertPath = "shaders/pbr.vert";
-	mFragPath = "shaders/pbr.frag";
-	mVertStamp = fileStamp(mVertPath);
-	mFragStamp = fileStamp(mFragPath);
-
-	std::string vertSrc, fragSrc;
-	if (!readTextFile(mVertPath, vertSrc)) { outError = "Failed to read shaders/pbr.vert"; return false; }
-	if (!readTextFile(mFragPath, fragSrc)) { outError = "Failed to read shaders/pbr.frag"; return false; }
+	// Startup phases are timed and printed after the configuration dump
+	using Clock = std::chrono::steady_clock;
+	auto phaseStart = Clock::now();
+	auto phaseMs = [&phaseStart]() {
+		Clock::time_point now = Clock::now();
+		double ms = std::chrono::duration<double, std::milli>(now - phaseStart).count();
+		phaseStart = now;
+		return ms;
+	};
+
+	// Programs are built through the binary cache; each source file is read once even when shared.
+	// Scene shaders are specialized per color mode / wireframe / points; only their default permutation is built now
+	ProgramCache& programCache = ProgramCache::instance();
+	programCache.initialize(kShaderCacheDir);
+	std::unordered_map<std::string, std::string> sources;
+	auto source = [&sources, &outError](const char* path) -> const std::string* {
+		auto it = sources.find(path);
+		if (it != sources.end()) return &it->second;
+		std::string text;
+		if (!readTextFile(path, text)) { outError = std::string("Failed to read ") + path; return nullptr; }
+		return &sources.emplace(path, std::move(text)).first->second;
+	};
 	std::string err;
-	if (!mShader.compileFromSource(vertSrc.c_str(), fragSrc.c_str(), err)) { outError = "Shader error: " + err; return false; }
-	
-	// Load line shader for bounding box
-	std::string lineVertSrc, lineFragSrc;
-	if (!readTextFile("shaders/line.vert", lineVertSrc)) { outError = "Failed to read shaders/line.vert"; return false; }
-	if (!readTextFile("shaders/line.frag", lineFragSrc)) { outError = "Failed to read shaders/line.frag"; return false; }
-	if (!mLineShader.compileFromSource(lineVertSrc.c_str(), lineFragSrc.c_str(), err)) { outError = "Line shader error: " + err; return false; }
-	
-	// Load sphere impostor shader (with geometry shader)
-	std::string sphereImpVertSrc, sphereImpGeomSrc, sphereImpFragSrc;
-	if (!readTextFile("shaders/pbr.vert", sphereImpVertSrc)) { outError = "Failed to read shaders/pbr.vert"; return false; }
-	if (!readTextFile("shaders/sphere_impostor.geom", sphereImpGeomSrc)) { outError = "Failed to read shaders/sphere_impostor.geom"; return false; }
-	if (!readTextFile("shaders/sphere_impostor.frag", sphereImpFragSrc)) { outError = "Failed to read shaders/sphere_impostor.frag"; return false; }
-	if (!mSphereImpostorShader.compileFromSource(sphereImpVertSrc.c_str(), sphereImpGeomSrc.c_str(), sphereImpFragSrc.c_str(), err)) { outError = "Sphere impostor shader error: " + err; return false; }
-	
-	// Load instanced sphere shader
-	std::string instSphereVertSrc, instSphereFragSrc;
-	if (!readTextFile("shaders/instanced_sphere.vert", instSphereVertSrc)) { outError = "Failed to read shaders/instanced_sphere.vert"; return false; }
-	if (!readTextFile("shaders/pbr.frag", instSphereFragSrc)) { outError = "Failed to read shaders/pbr.frag"; return false; }
-	if (!mInstancedSphereShader.compileFromSource(instSphereVertSrc.c_str(), instSphereFragSrc.c_str(), err)) { outError = "Instanced sphere shader error: " + err; return false; }
-	
-	// Load depth-only shader for Early-Z prepass
-	std::string depthVertSrc, depthFragSrc;
-	if (!readTextFile("shaders/depth_only.vert", depthVertSrc)) { outError = "Failed to read shaders/depth_only.vert"; return false; }
-	if (!readTextFile("shaders/depth_only.frag", depthFragSrc)) { outError = "Failed to read shaders/depth_only.frag"; return false; }
-	if (!mDepthOnlyShader.compileFromSource(depthVertSrc.c_str(), depthFragSrc.c_str(), err)) { outError = "Depth-only shader error: " + err; return false; }
-	if (!mScene.model.loadFromFile(modelPath, err)) { outError = "Failed to load model: " + err; return false; }
-	mScene.model.uploadToGPU();
-	
-	// Initialize UBOs
-	mScene.initializeUBOs();
+	for (const ShaderHotReload::Program& program : programs()) {
+		const std::string* vertSrc = source(program.vert);
+		const std::string* fragSrc = vertSrc ? source(program.frag) : nullptr;
+		if (!vertSrc || !fragSrc) return false;
+		bool built = program.variants ? program.variants->setSources(*vertSrc, *fragSrc, err)
+		                              : programCache.build(*program.shader, *vertSrc, *fragSrc, program.defines, err);
+		if (!built) { outError = std::string(program.name) + " error: " + err; return false; }
+	}
+	double shaderMs = phaseMs();
+
+	if (!mWorld.load(modelPaths, err)) { outError = "Failed to load model: " + err; return false; }
+	double loadMs = phaseMs();
+	mWorld.uploadToGPU();
+	double uploadMs = phaseMs();
 	
-	// Initialize occlusion query
-	mScene.initializeOcclusionQuery();
+	// Per-object UBOs and occlusion queries, the shared matrices ring, and the grid layout
+	// (each model centered and scaled into a unit box, in its original orientation)
+	mWorld.initializeGL();
 	
 	// Initialize OpenGL state cache
 	mGLStateCache.initialize();
 
-	// Center and scale the model, oriented facing up (+Y) and towards camera (+Z)
-	glm::vec3 c = mScene.model.center();
-	glm::vec3 size = mScene.model.max() - mScene.model.min();
-	float maxAxis = std::max(size.x, std::max(size.y, size.z));
-	float s = (maxAxis > 0.0f) ? (1.0f / maxAxis) : 1.0f;
-	glm::mat4 T = glm::translate(glm::mat4(1.0f), -c);
-	glm::mat4 S = glm::scale(glm::mat4(1.0f), glm::vec3(s));
-	// No rotation - model keeps its original orientation, centered at origin
-	mScene.modelMatrix = S * T;
-
-	mScene.updateBoundingBox();  // Initialize bounding box renderer
-
 	mView.setPerspectiveForAspect(mAspect);
-	glm::vec3 startEye = glm::vec3(0.0f, 0.0f, 2.0f);
-	glm::vec3 target = glm::vec3(0.0f);
-	mView.setLookAt(startEye, target);
-	glm::vec3 front = glm::normalize(target - startEye);
-	mView.yaw = glm::degrees(std::atan2(front.z, front.x));
-	mView.pitch = glm::degrees(std::asin(front.y));
+	// Far enough back to frame the whole grid (a single model keeps the usual distance of 2)
+	glm::vec3 extent = mWorld.max() - mWorld.min();
+	setCamera(glm::vec3(0.0f, 0.0f, std::max(2.0f, 1.2f * std::max(extent.x, extent.y))), glm::vec3(0.0f));
 	mView.mouseInitialized = false;
 	
 	// Initialize profiling
 	initializeProfiling();
+	double setupMs = phaseMs();
+
+	const ProgramCache::Stats& cacheStats = programCache.stats();
+	std::cout << "\n=== Startup Timing ===" << std::endl;
+	std::cout << "Shader programs: " << shaderMs << " ms (" << cacheStats.hits << " from cache, " << cacheStats.misses << " compiled"
+	          << (programCache.enabled() ? "" : ", program binaries unsupported") << ")" << std::endl;
+	std::cout << "Model load: " << loadMs << " ms (" << mWorld.modelCount() << " models, " << mWorld.size() << " objects)" << std::endl;
+	std::cout << "GPU upload: " << uploadMs << " ms" << std::endl;
+	std::cout << "GL setup: " << setupMs << " ms" << std::endl;
+	std::cout << std::endl;
 	
 	return true;
 }
@@ -184,16 +219,20 @@ bool Renderer::initializeScene(const std::string& modelPath, std::string& outErr
 void Renderer::onResize(int w, int h) {
 	mWidth = w; mHeight = h; mAspect = (h > 0) ? (float)w / (float)h : 1.0f;
 	mView.camera.setAspect(mAspect);
-	glViewport(0, 0, w, h);
+	mGLStateCache.viewport(0, 0, w, h);
+	mInputFrames = Config::InputRedrawFrames;
 }
 
 void Renderer::shutdown() {
 	// Clean up profiling queries
-	if (mGPUTimingSupported) {
-		if (mGPUTimestampQuery[0] != 0) glDeleteQueries(2, mGPUTimestampQuery);
-	}
+	GpuProfiler::instance().shutdown();
 	
-	mScene.model.destroyGPU();
+	mFramePipeline.stop();  // The worker reads model geometry
+	mWorld.destroyGPU();
+	mOffscreenTarget.destroy();
+	mRefinement.release();
+	mEyeDome.destroy();
+	mCullingOverlay.destroy();
 	if (mImGuiInitialized) {
 		ImGui_ImplOpenGL3_Shutdown();
 		ImGui_ImplGlfw_Shutdown();
@@ -203,31 +242,15 @@ void Renderer::shutdown() {
 }
 
 void Renderer::checkShaderHotReload() {
-	const double now = glfwGetTime();
-	const double minInterval = 0.2; // 200ms debounce
 	bool f5Down = glfwGetKey(mWindow, GLFW_KEY_F5) == GLFW_PRESS;
-	bool trigger = false;
-	if (f5Down && !mPrevF5Down && (now - mLastReloadSec) > minInterval) trigger = true;
+	bool reloadAll = f5Down && !mPrevF5Down;
 	mPrevF5Down = f5Down;
 
-	unsigned long long v = fileStamp(mVertPath);
-	unsigned long long f = fileStamp(mFragPath);
-	if ((now - mLastReloadSec) > minInterval && v && f && (v != mVertStamp || f != mFragStamp)) trigger = true;
-
-	if (!trigger) return;
-
-	std::string vs, fs, err;
-	if (!readTextFile(mVertPath, vs)) return;
-	if (!readTextFile(mFragPath, fs)) return;
-	Shader newShader;
-	if (newShader.compileFromSource(vs.c_str(), fs.c_str(), err)) {
-		mShader = std::move(newShader);
-		mShader.use();
-		mVertStamp = v; mFragStamp = f;
-		mLastReloadSec = now;
-		std::cout << "Shaders reloaded\n";
-	} else {
-		std::cerr << "Shader reload error: " << err << "\n";
+	// Rebuilds link in the background and are swapped in only once they linked
+	unsigned int swapped = mShaderReload.update(programs(), glfwGetTime(), reloadAll);
+	if (swapped > 0) {
+		mShaderGeneration++;
+		std::cout << "Shaders reloaded (" << swapped << (swapped == 1 ? " program)\n" : " programs)\n");
 	}
 }
 
@@ -248,13 +271,19 @@ void Renderer::handleInput(float deltaTime) {
 	if (!imguiWantsInput) {
 		bool f2Down = glfwGetKey(mWindow, GLFW_KEY_F2) == GLFW_PRESS;
 		if (f2Down && !mPrevF2Down) {
-			mWireframe = !mWireframe;
-			// Only apply polygon mode for regular meshes (point clouds ignore wireframe)
-			if (!mScene.model.isPointCloud()) {
-				glPolygonMode(GL_FRONT_AND_BACK, mWireframe ? GL_LINE : GL_FILL);
-			}
+			mWireframe = !mWireframe;  // Meshes switch to their wireframe overlay permutation (point clouds ignore it)
 		}
 		mPrevF2Down = f2Down;
+
+		// Camera path recording on F7 (start/stop); saved for --benchmark replay
+		bool f7Down = glfwGetKey(mWindow, GLFW_KEY_F7) == GLFW_PRESS;
+		if (f7Down && !mPrevF7Down) toggleCameraRecording();
+		mPrevF7Down = f7Down;
+
+		// Chrome trace export of the CPU/GPU scope rings on F8
+		bool f8Down = glfwGetKey(mWindow, GLFW_KEY_F8) == GLFW_PRESS;
+		if (f8Down && !mPrevF8Down) exportTrace();
+		mPrevF8Down = f8Down;
 		
 		// Camera presets: Ctrl+1-9,0 to save, 1-9,0 to restore
 		bool ctrlPressed = (glfwGetKey(mWindow, GLFW_KEY_LEFT_CONTROL) == GLFW_PRESS || 
@@ -271,29 +300,85 @@ void Renderer::handleInput(float deltaTime) {
 		}
 		
 		// Point size controls: +/- or Page Up/Down
-		if (mScene.model.isPointCloud()) {
+		if (mWorld.hasPointClouds()) {
+			Scene& scene = mWorld.primary();
 			float pointSizeStep = 0.5f;
 			if (glfwGetKey(mWindow, GLFW_KEY_EQUAL) == GLFW_PRESS || 
 			    glfwGetKey(mWindow, GLFW_KEY_PAGE_UP) == GLFW_PRESS) {
-				mScene.pointSize = std::min(mScene.pointSize + pointSizeStep, 20.0f);
+				scene.pointSize = std::min(scene.pointSize + pointSizeStep, 20.0f);
 			}
 			if (glfwGetKey(mWindow, GLFW_KEY_MINUS) == GLFW_PRESS || 
 			    glfwGetKey(mWindow, GLFW_KEY_PAGE_DOWN) == GLFW_PRESS) {
-				mScene.pointSize = std::max(mScene.pointSize - pointSizeStep, 0.5f);
+				scene.pointSize = std::max(scene.pointSize - pointSizeStep, 0.5f);
 			}
 		}
 	}
 
+	if (mRecordingCamera) {
+		// Sample at ~20 Hz; playback interpolates between keyframes
+		float t = static_cast<float>(glfwGetTime() - mRecordStartSec);
+		if (mCameraRecording.empty() || t - mLastRecordedSec >= 0.05f) {
+			mCameraRecording.addKeyframe(t, mView.camera.eye(), mView.camera.target());
+			mLastRecordedSec = t;
+		}
+	}
+
 	checkShaderHotReload();
 }
 
+void Renderer::toggleCameraRecording() {
+	if (!mRecordingCamera) {
+		mCameraRecording.clear();
+		mRecordStartSec = glfwGetTime();
+		mLastRecordedSec = 0.0f;
+		mRecordingCamera = true;
+		std::cout << "Camera path recording started (F7 to stop)\n";
+		return;
+	}
+	mRecordingCamera = false;
+	std::string err;
+	if (mCameraRecording.size() < 2) {
+		std::cout << "Camera path recording discarded (too short)\n";
+	} else if (mCameraRecording.save(kCameraPathFile, err)) {
+		std::cout << "Camera path saved to " << kCameraPathFile << " (" << mCameraRecording.size() << " keyframes, "
+		          << mCameraRecording.duration() << " s)\n";
+	} else {
+		std::cerr << "Camera path save failed: " << err << "\n";
+	}
+}
+
+void Renderer::exportTrace() {
+	GpuProfiler::instance().calibrate();  // Refresh the GPU/CPU clock offset before placing GPU scopes
+	std::string err;
+	if (CpuProfiler::instance().writeChromeTrace(kTraceFile, err)) {
+		std::cout << "Trace written to " << kTraceFile << " (open in chrome://tracing or ui.perfetto.dev)\n";
+	} else {
+		std::cerr << "Trace export failed: " << err << "\n";
+	}
+}
+
+// Objects with Early-Z on get a depth-only draw before the main pass
+// Hardware occlusion culling rules the prepass out: the main pass may leave out queried meshes or
+// leaves whose depth the prepass already wrote (holes instead of missing geometry)
+static bool hasDepthPrepass(const Scene& object) {
+	return object.enableEarlyZPrepass && !object.enableOcclusionCulling;
+}
+
 void Renderer::render() {
-	// Track CPU frame time
-	static double lastFrameTime = glfwGetTime();
-	double frameStartTime = glfwGetTime();
-	double cpuFrameTime = (frameStartTime - lastFrameTime) * 1000.0;  // Convert to ms
+	PHV_CPU_SCOPE("Renderer::render");
+	// Track CPU frame time (steady clock: also valid in headless mode without GLFW)
+	using Clock = std::chrono::steady_clock;
+	static Clock::time_point lastFrameTime = Clock::now();
+	Clock::time_point frameStartTime = Clock::now();
+	double cpuFrameTime = std::chrono::duration<double, std::milli>(frameStartTime - lastFrameTime).count();
 	lastFrameTime = frameStartTime;
 	
+	// Pick up mesh LOD levels finished by the background simplifier
+	{
+		PHV_CPU_SCOPE("Model::update");
+		mWorld.update();
+	}
+	
 	// Reset profiling data
 	mProfilingData.drawCalls = 0;
 	mProfilingData.triangles = 0;
@@ -309,79 +394,261 @@ void Renderer::render() {
 	glm::mat4 view = mView.camera.getView();
 	glm::mat4 proj = mView.camera.getProjection();
 	
-	// Start GPU timing query (if supported)
-	// Use double-buffered queries: one for start, one for end
-	if (mGPUTimingSupported && mGPUTimestampQuery[0] != 0 && mGPUTimestampQuery[1] != 0) {
-		// Check if previous frame's query result is available
-		GLuint available = 0;
-		glGetQueryObjectuiv(mGPUTimestampQuery[1], GL_QUERY_RESULT_AVAILABLE, &available);
-		if (available) {
-			GLuint64 startTime = 0, endTime = 0;
-			glGetQueryObjectui64v(mGPUTimestampQuery[0], GL_QUERY_RESULT, &startTime);
-			glGetQueryObjectui64v(mGPUTimestampQuery[1], GL_QUERY_RESULT, &endTime);
-			if (endTime > startTime) {
-				// Convert nanoseconds to milliseconds
-				mProfilingData.gpuFrameTime = (endTime - startTime) / 1e6;
-			}
+	// On-demand rendering: a still view is finished in the persistent refinement target (windowed only)
+	using Pass = ProgressiveRefinement::Pass;
+	Pass pass = mWindow ? mRefinement.beginFrame(frameSignature()) : Pass::Interactive;
+	if (mInputFrames > 0) mInputFrames--;
+	if (!mRefinement.settings.refine) mRefinement.release();
+
+	// GPU timing: resolve finished frames from the query ring (never blocks), then open this frame's scopes
+	GpuProfiler& gpuProfiler = GpuProfiler::instance();
+	gpuProfiler.beginFrame();
+	if (gpuProfiler.resolvedFrames() != mLastGpuResolvedFrame) {
+		mLastGpuResolvedFrame = gpuProfiler.resolvedFrames();
+		mProfilingData.gpuFrameTime = gpuProfiler.lastFrameMs();
+		mProfilingData.gpuSampleCount++;
+		// Still frames run at full resolution and detail: their cost says nothing about interactive ones
+		if (pass == Pass::Interactive) mDynamicResolution.update(mProfilingData.gpuFrameTime);
+	}
+
+	if (pass == Pass::Base) {
+		std::string err;
+		if (!mRefinement.beginBase(mWidth, mHeight, err)) {
+			std::cerr << "Progressive refinement disabled: " << err << "\n";
+			mRefinement.settings.refine = false;
+			pass = Pass::Interactive;
 		}
-		// Start new frame timing: query at start
-		glQueryCounter(mGPUTimestampQuery[0], GL_TIMESTAMP);
 	}
 	
-	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);  // glClearColor set once in RenderDevice init
-	
-	// Compute frame state once (view, proj, viewProj, camPos)
-	FrameState frameState(view, proj, mView.camera.eye());
-	
-	// Occlusion culling: test if model is occluded (before main rendering)
-	// This should ideally be done in a separate pass before Early-Z prepass
-	// For now, we'll test after Early-Z prepass but before main render
-	if (mScene.enableOcclusionCulling && !mScene.model.isPointCloud()) {
-		mScene.testOcclusion(frameState, mDepthOnlyShader, &mGLStateCache);
+	// Scene passes go to the scaled internal target when dynamic resolution is on, else straight to the output
+	bool dynamicResolution = false;
+	if (pass == Pass::Interactive && mDynamicResolution.settings.enabled) {
+		std::string err;
+		dynamicResolution = mDynamicResolution.begin(mWidth, mHeight, err);
+		if (!dynamicResolution) {
+			std::cerr << "Dynamic resolution disabled: " << err << "\n";
+			mDynamicResolution.settings.enabled = false;
+		}
 	}
+	if (!mDynamicResolution.settings.enabled) mDynamicResolution.release();
+	if (pass == Pass::Interactive && !dynamicResolution && mOffscreenTarget.valid()) mOffscreenTarget.bind();  // Headless: draw into the FBO
+	int renderWidth = dynamicResolution ? mDynamicResolution.renderWidth() : mWidth;
+	int renderHeight = dynamicResolution ? mDynamicResolution.renderHeight() : mHeight;
+	mProfilingData.dynamicResolution = dynamicResolution;
+	mProfilingData.renderScale = dynamicResolution ? mDynamicResolution.scale() : 1.0f;
+	mProfilingData.renderWidth = renderWidth;
+	mProfilingData.renderHeight = renderHeight;
 	
-	// Early-Z depth prepass: render depth buffer first (if enabled)
-	// This allows the main pass to skip expensive fragment shader work on occluded fragments
-	if (mScene.enableEarlyZPrepass && !mScene.model.isPointCloud()) {
-		// Depth-only pass: render only depth buffer, no color writes
-		mGLStateCache.colorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);  // Disable color writes
-		mGLStateCache.depthMask(GL_TRUE);   // Enable depth writes (write to depth buffer)
-		mGLStateCache.depthFunc(GL_LESS);  // Standard depth test
+	// Compute frame state once (view, proj, viewProj, camPos); screen-space LOD uses the actual render size
+	FrameState frameState(view, proj, mView.camera.eye(), glm::vec2(static_cast<float>(renderWidth), static_cast<float>(renderHeight)));
+	mWorld.primary().fullDetail = (pass == Pass::Base);
+	mWorld.primary().recordCullingNodes = mCullingOverlay.settings.enabled;
+	mWorld.syncSettings();
+
+	// Culling and draw sorting: interactive frames submit the packet the worker built during the
+	// previous frame (the image trails the camera by one frame); still frames cull the current view
+	const FramePacket* packet = nullptr;
+	if (pass != Pass::Present) {
+		bool pipelined = pass == Pass::Interactive && mWindow && mFramePipeline.settings.enabled;
+		packet = pipelined ? &mFramePipeline.exchange(captureFrame(frameState)) : &mFramePipeline.build(captureFrame(frameState));
+		mWorld.beginFrame(packet->frameState, packet->visible, packet->queue);  // Stage uniforms once for every pass of the frame
+		mProfilingData.cullMs = packet->buildMs;
+		mProfilingData.framePipelined = mFramePipeline.lastPipelined();
+		mProfilingData.renderBatches = static_cast<unsigned int>(packet->queue.batchCount());
+		mProfilingData.instancedObjects = mWorld.instancedObjects();
+	}
+	if (!mFramePipeline.settings.enabled) mFramePipeline.stop();
+	const FrameState& drawState = packet ? packet->frameState : frameState;  // View the packet was culled for
+	mProfilingData.objects = static_cast<unsigned int>(mWorld.size());
+	mProfilingData.objectsVisible = static_cast<unsigned int>(mWorld.visible().size());
+
+	if (pass == Pass::Refine) {
+		// Add the next slice of omitted impostors on top of the previous passes (same view, same depth buffer)
+		mRefinement.bind();
+		mGLStateCache.depthMask(GL_TRUE);
+		mGLStateCache.depthFunc(GL_LESS);
+		unsigned int refined = 0;
+		for (uint32_t object : mWorld.visible()) refined += mWorld.object(object).refine(mSphereImpostorShaders, &mProfilingData);
+		mRefinement.endRefine(refined);
+	} else if (pass != Pass::Present) {
+		// Eye-dome lighting: the scene passes draw into its target, shaded into the current one before the overlays
+		bool eyeDome = false;
+		if (mEyeDome.settings.enabled && mWorld.hasPointClouds()) {
+			std::string err;
+			eyeDome = mEyeDome.begin(mWidth, mHeight, err);
+			if (!eyeDome) {
+				std::cerr << "Eye-dome lighting disabled: " << err << "\n";
+				mEyeDome.settings.enabled = false;
+			}
+		}
+		if (!mEyeDome.settings.enabled) mEyeDome.destroy();
+
+		mGLStateCache.depthMask(GL_TRUE);  // glClear honours the depth mask (the Early-Z main pass leaves it off)
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);  // glClearColor set once in RenderDevice init
 		
-		mScene.drawDepthOnly(mDepthOnlyShader, frameState, &mGLStateCache);
+		// Draws of the visible objects in key order: prepass items first, then the main pass grouped by
+		// program, geometry and material, front to back within each group
+		const std::vector<RenderQueue::Item>& items = packet->queue.items();
+		size_t firstMain = 0;
+		while (firstMain < items.size() && RenderQueue::pass(items[firstMain].key) == RenderQueue::Pass::DepthPrepass) firstMain++;
+
+		// Early-Z depth prepass: render depth buffer first (if enabled)
+		// This allows the main pass to skip expensive fragment shader work on occluded fragments
+		if (firstMain > 0) {
+			PHV_GPU_SCOPE("Early-Z Prepass");
+			// Depth-only pass: render only depth buffer, no color writes
+			mGLStateCache.colorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);  // Disable color writes
+			mGLStateCache.depthMask(GL_TRUE);   // Enable depth writes (write to depth buffer)
+			mGLStateCache.depthFunc(GL_LESS);  // Standard depth test
+			
+			for (size_t i = 0; i < firstMain; ++i) {
+				// Objects of one model in a row: one instanced draw per mesh and LOD level
+				size_t runEnd = mWorld.instancedRunEnd(i);
+				if (runEnd > i && mInstancedDepthShader.id() != 0) {
+					mWorld.drawInstancedRun(i, mInstancedDepthShader, false);
+					i = runEnd - 1;
+					continue;
+				}
+				uint32_t object = items[i].object;
+				mWorld.object(object).drawDepthOnly(mDepthOnlyShader, &mImpostorDepthShader, &mInstancedSphereDepthShader, drawState, &packet->leaves[object]);
+			}
+			
+			// Re-enable color writes for main pass
+			mGLStateCache.colorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+		}
 		
-		// Re-enable color writes for main pass
-		mGLStateCache.colorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
-		// Keep depth test enabled for main pass (Early-Z will skip occluded fragments)
-		// Use GL_LEQUAL to allow fragments at same depth as prepass (exact matches)
-		mGLStateCache.depthFunc(GL_LEQUAL);  // Same or closer passes depth test
-		mGLStateCache.depthMask(GL_FALSE);  // Don't write depth in main pass (already written in prepass)
-	} else {
-		// Normal single-pass rendering: restore default depth state
-		mGLStateCache.depthMask(GL_TRUE);   // Enable depth writes
-		mGLStateCache.depthFunc(GL_LESS);  // Standard depth test
+		// Main pass: render with full shading
+		// Early-Z will automatically skip fragments that failed depth test in prepass
+		{
+			PHV_GPU_SCOPE("Main Pass");
+			for (size_t i = firstMain; i < items.size(); ++i) {
+				Scene& object = mWorld.object(items[i].object);
+				if (hasDepthPrepass(object)) {
+					// Use GL_LEQUAL to allow fragments at same depth as prepass (exact matches)
+					mGLStateCache.depthFunc(GL_LEQUAL);  // Same or closer passes depth test
+					mGLStateCache.depthMask(GL_FALSE);  // Don't write depth in main pass (already written in prepass)
+				} else {
+					// Normal single-pass rendering: default depth state
+					mGLStateCache.depthMask(GL_TRUE);
+					mGLStateCache.depthFunc(GL_LESS);
+				}
+				size_t runEnd = mWorld.instancedRunEnd(i);
+				if (runEnd > i) {
+					ShaderVariants::Key key;
+					key.colorMode = object.colorMode;
+					key.wireframe = mWireframe;
+					key.instanced = true;
+					if (Shader* shader = mShaders.get(key)) {
+						mWorld.drawInstancedRun(i, *shader, mWireframe, &mProfilingData);
+						i = runEnd - 1;
+						continue;
+					}
+				}
+				object.draw(mShaders, &mSphereImpostorShaders, &mInstancedSphereShaders, drawState, mWireframe, &mProfilingData, &packet->leaves[items[i].object]);
+			}
+		}
+		// Occlusion culling: bounding-box queries for hidden nodes against the finished depth buffer.
+		// Their results drive next frame's conditional rendering; nothing here waits on them.
+		if (mWorld.primary().enableOcclusionCulling) {
+			PHV_GPU_SCOPE("Occlusion");
+			for (uint32_t object : mWorld.visible()) mWorld.object(object).testOcclusion(mDepthOnlyShader, &mGLStateCache);
+		}
+		if (eyeDome) {
+			PHV_GPU_SCOPE("Eye-Dome Lighting");
+			mEyeDome.resolve(mEyeDomeShader, drawState.proj);
+		}
+		{
+			PHV_GPU_SCOPE("BBox");
+			for (uint32_t object : mWorld.visible()) mWorld.object(object).drawBoundingBox(mLineShader.id(), drawState.view, drawState.proj);
+		}
+		if (mCullingOverlay.settings.enabled) {
+			PHV_GPU_SCOPE("Culling Overlay");
+			mCullingOverlay.begin();
+			for (uint32_t object : mWorld.visible()) mCullingOverlay.addObject(mWorld.object(object));
+			mCullingOverlay.draw(mCullingOverlayShader, drawState.viewProj);
+		}
+		if (dynamicResolution) {
+			PHV_GPU_SCOPE("Upscale");
+			mDynamicResolution.resolve(mOffscreenTarget.valid() ? mOffscreenTarget.id() : 0);
+		}
 	}
-	
-	// Main pass: render with full shading
-	// Early-Z will automatically skip fragments that failed depth test in prepass
-	mScene.draw(mShader, &mSphereImpostorShader, &mInstancedSphereShader, frameState, mWireframe, &mProfilingData, &mGLStateCache);
-	mScene.drawBoundingBox(mLineShader.id(), view, proj);
-	
-	// End GPU timing query: query at end of frame
-	if (mGPUTimingSupported && mGPUTimestampQuery[1] != 0) {
-		glQueryCounter(mGPUTimestampQuery[1], GL_TIMESTAMP);
+	if (pass != Pass::Interactive) {
+		PHV_GPU_SCOPE("Present");
+		mRefinement.present(0);
 	}
 
     // Render ImGui UI
     if (mImGuiInitialized) {
+        PHV_CPU_SCOPE("ImGui");
         Graphics::UI::drawSceneUI(*this);
         Graphics::UI::drawProfilingUI(*this);
         ImGui::Render();
+        PHV_GPU_SCOPE("ImGui");
         ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
     }
+	gpuProfiler.endFrame();
 	
-	// Update profiling data with CPU frame time
-	mProfilingData.cpuFrameTime = cpuFrameTime;
+	// Update profiling data with CPU frame time and memory usage
+	updateProfiling(cpuFrameTime);
+}
+
+bool Renderer::needsRedraw() {
+	if (!mWindow || !mRefinement.settings.onDemand) return true;
+	if (mInputFrames > 0) return true;
+	mWorld.update();  // A finished mesh LOD level changes the image (and the signature)
+	return mRefinement.busy(frameSignature());
+}
+
+FrameInput Renderer::captureFrame(const FrameState& frameState) const {
+	FrameInput input;
+	input.bounds = mWorld.bounds();
+	input.frameState = frameState;
+	input.farPlane = mView.camera.farZ();
+	input.frustumCulling = mWorld.primary().enableFrustumCulling;
+	input.objects.resize(mWorld.size());
+	for (size_t i = 0; i < mWorld.size(); ++i) {
+		const Scene& object = mWorld.object(i);
+		ObjectSnapshot& snapshot = input.objects[i];
+		snapshot.model = object.model;
+		snapshot.modelMatrix = object.modelMatrix;
+		snapshot.sphereRadius = object.sphereRadius;
+		snapshot.program = object.programKey();
+		snapshot.geometry = mWorld.modelIndex(i);
+		snapshot.material = object.materialKey();
+		snapshot.prepass = hasDepthPrepass(object);
+		snapshot.leaves = object.model->isPointCloud() && object.enableSpatialIndexing && !object.model->pointClusters().empty();
+	}
+	return input;
+}
+
+// Fold a trivially copyable value into a running hash
+template <typename T>
+static void hashValue(uint64_t& h, const T& value) { h = hashBytes(&value, sizeof(T), h); }
+
+uint64_t Renderer::frameSignature() const {
+	uint64_t h = hashBytes(nullptr, 0);
+	hashValue(h, mView.camera.getView());
+	hashValue(h, mView.camera.getProjection());
+	hashValue(h, mWidth); hashValue(h, mHeight);
+	hashValue(h, mWireframe);
+	hashValue(h, mShaderGeneration);
+	hashValue(h, mDynamicResolution.settings.enabled);
+	hashValue(h, mRefinement.settings.refine);
+	hashValue(h, mEyeDome.settings.enabled); hashValue(h, mEyeDome.settings.strength); hashValue(h, mEyeDome.settings.radius);
+	hashValue(h, mCullingOverlay.settings.enabled); hashValue(h, mCullingOverlay.settings.showFrustumCulled);
+	const Scene& s = mWorld.primary();  // Settings of every object
+	hashValue(h, s.material); hashValue(h, s.light);
+	hashValue(h, s.pointSize); hashValue(h, s.sphereRadius);
+	hashValue(h, s.colorMode); hashValue(h, s.pointCloudMode); hashValue(h, s.autoLOD);
+	hashValue(h, s.showBoundingBox);
+	hashValue(h, s.enableFrustumCulling); hashValue(h, s.enableEarlyZPrepass); hashValue(h, s.enableSpatialIndexing);
+	hashValue(h, s.enableOcclusionCulling); hashValue(h, s.enableSoftwareOcclusion);
+	hashValue(h, s.enableMeshLOD); hashValue(h, s.meshLODErrorPixels);
+	for (size_t i = 0; i < mWorld.size(); ++i) {
+		hashValue(h, mWorld.object(i).modelMatrix);
+		hashValue(h, mWorld.object(i).model->lodLevelCount());
+	}
+	return h;
 }
 
 void Renderer::initializeProfiling() {
@@ -399,34 +666,45 @@ void Renderer::initializeProfiling() {
 		}
 	}
 	
-	if (mGPUTimingSupported && glQueryCounter) {
-		glGenQueries(2, mGPUTimestampQuery);
-		if (mGPUTimestampQuery[0] != 0 && mGPUTimestampQuery[1] != 0) {
-			mProfilingData.gpuTimingAvailable = true;
-			// Queries will be started in render() loop
-		}
+	if (mGPUTimingSupported) {
+		// Per-pass timestamp queries, resolved a few frames late (see GpuProfiler)
+		mProfilingData.gpuTimingAvailable = GpuProfiler::instance().initialize();
 	}
 	
-	// Try to get GPU memory info (vendor-specific extensions)
-	// NVIDIA: GL_NVX_gpu_memory_info
-	// AMD: GL_ATI_meminfo
-	// Intel: No standard extension
-	const char* vendor = reinterpret_cast<const char*>(glGetString(GL_VENDOR));
-	const char* extensions = reinterpret_cast<const char*>(glGetString(GL_EXTENSIONS));
-	if (extensions) {
-		if (strstr(extensions, "GL_NVX_gpu_memory_info") && vendor && strstr(vendor, "NVIDIA")) {
-			// NVIDIA GPU memory tracking available
-			// We can query it later if needed
-		}
+	// GPU memory: tracked allocations are always available; vendor extensions
+	// (GL_NVX_gpu_memory_info on NVIDIA, GL_ATI_meminfo on AMD) add driver-wide numbers
+	MemoryTracker& tracker = MemoryTracker::instance();
+	tracker.initializeVendorQueries();
+	MemoryTracker::VendorMemoryInfo vendorInfo = tracker.queryVendorMemory();
+	if (vendorInfo.available) {
+		std::cout << "GPU memory info: " << vendorInfo.source << std::endl;
+	} else {
+		std::cout << "GPU memory info: no vendor extension (tracked allocations only)" << std::endl;
 	}
 }
 
 void Renderer::updateProfiling(double cpuFrameTime) {
 	mProfilingData.cpuFrameTime = cpuFrameTime;
+
+	// Requests that reached the state cache this frame, and how many were dropped as redundant
+	mProfilingData.stateCallsRequested = mGLStateCache.requestedCalls();
+	mProfilingData.stateCallsSkipped = mGLStateCache.skippedCalls();
+	mGLStateCache.resetCounters();
+
+	const MemoryTracker& tracker = MemoryTracker::instance();
+	mProfilingData.gpuMemoryUsed = tracker.totalLiveBytes();
+	mProfilingData.gpuMemoryPeak = tracker.totalPeakBytes();
+	mProfilingData.cpuMemoryUsed = tracker.totalCpuBytes();
+
+	MemoryTracker::VendorMemoryInfo vendorInfo = tracker.queryVendorMemory();
+	mProfilingData.driverMemoryAvailable = vendorInfo.available;
+	mProfilingData.driverMemorySource = vendorInfo.source;
+	mProfilingData.driverMemoryTotal = vendorInfo.totalBytes;
+	mProfilingData.driverMemoryFree = vendorInfo.availableBytes;
 }
 
 // UI moved to Graphics/UI/Inspector
 
-bool Renderer::shouldClose() const { return glfwWindowShouldClose(mWindow); }
+bool Renderer::shouldClose() const { return mWindow ? glfwWindowShouldClose(mWindow) : false; }
 
 } // namespace Graphics
@@ -1,12 +1,25 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
+#include <vector>
 #include <glm/glm.hpp>
 
 #include "Graphics/Shader.h"
+#include "Graphics/ShaderVariants.hpp"
+#include "Graphics/ShaderHotReload.hpp"
+#include "Graphics/FramePipeline.hpp"
 #include "Graphics/Scene.hpp"
 #include "Graphics/View.hpp"
+#include "Graphics/World.hpp"
 #include "Graphics/Utils.hpp"
+#include "Graphics/Culling/CullingOverlay.hpp"
+#include "Graphics/Profiling/ProfilingData.hpp"
+#include "Graphics/Offscreen/OffscreenTarget.hpp"
+#include "Graphics/Offscreen/DynamicResolution.hpp"
+#include "Graphics/Offscreen/EyeDomeLighting.hpp"
+#include "Graphics/Offscreen/ProgressiveRefinement.hpp"
+#include "Graphics/Profiling/CameraPath.hpp"
 
 struct GLFWwindow;
 
@@ -18,53 +31,26 @@ public:
 	Renderer() = default;
 	Renderer(const Renderer&) = delete;
 	Renderer& operator=(const Renderer&) = delete;
-	Renderer(Renderer&& other) noexcept {
-		mWindow = other.mWindow; other.mWindow = nullptr;
-		mShader = std::move(other.mShader);
-		mLineShader = std::move(other.mLineShader);
-		mSphereImpostorShader = std::move(other.mSphereImpostorShader);
-		mInstancedSphereShader = std::move(other.mInstancedSphereShader);
-		mDepthOnlyShader = std::move(other.mDepthOnlyShader);
-		mScene = std::move(other.mScene);
-		mView = std::move(other.mView);
-		mWidth = other.mWidth; mHeight = other.mHeight; mAspect = other.mAspect;
-		mPrevF5Down = other.mPrevF5Down; other.mPrevF5Down = false;
-		mVertPath = std::move(other.mVertPath); mFragPath = std::move(other.mFragPath);
-		mVertStamp = other.mVertStamp; mFragStamp = other.mFragStamp;
-		mLastReloadSec = other.mLastReloadSec; other.mLastReloadSec = 0.0;
-		mWireframe = other.mWireframe; other.mWireframe = false;
-		mPrevF2Down = other.mPrevF2Down; other.mPrevF2Down = false;
-		mImGuiInitialized = other.mImGuiInitialized; other.mImGuiInitialized = false;
-	}
-	Renderer& operator=(Renderer&& other) noexcept {
-		if (this != &other) {
-			shutdown();
-			mWindow = other.mWindow; other.mWindow = nullptr;
-			mShader = std::move(other.mShader);
-			mLineShader = std::move(other.mLineShader);
-			mSphereImpostorShader = std::move(other.mSphereImpostorShader);
-			mInstancedSphereShader = std::move(other.mInstancedSphereShader);
-			mScene = std::move(other.mScene);
-			mView = std::move(other.mView);
-			mWidth = other.mWidth; mHeight = other.mHeight; mAspect = other.mAspect;
-			mPrevF5Down = other.mPrevF5Down; other.mPrevF5Down = false;
-			mVertPath = std::move(other.mVertPath); mFragPath = std::move(other.mFragPath);
-			mVertStamp = other.mVertStamp; mFragStamp = other.mFragStamp;
-			mLastReloadSec = other.mLastReloadSec; other.mLastReloadSec = 0.0;
-			mWireframe = other.mWireframe; other.mWireframe = false;
-			mPrevF2Down = other.mPrevF2Down; other.mPrevF2Down = false;
-			mImGuiInitialized = other.mImGuiInitialized; other.mImGuiInitialized = false;
-		}
-		return *this;
-	}
+	// Owns the window's GL objects, the frame pipeline worker and the shader watcher: not movable
+	Renderer(Renderer&&) = delete;
+	Renderer& operator=(Renderer&&) = delete;
 
 	/// Initialize the renderer with an existing GLFW window and OpenGL context.
-	/// Loads the specified model file and sets up shaders, ImGui, and OpenGL state.
+	/// Loads the specified model files and sets up shaders, ImGui, and OpenGL state.
 	/// @param window GLFW window with valid OpenGL context
-	/// @param modelPath Path to 3D model file (.obj, .ply, .off)
+	/// @param modelPaths 3D model files (.obj, .ply, .off), one object each, laid out side by side
 	/// @param outError Error message if initialization fails
 	/// @return true if successful, false on error
-	bool initializeWithContext(GLFWwindow* window, const std::string& modelPath, std::string& outError);
+	bool initializeWithContext(GLFWwindow* window, const std::vector<std::string>& modelPaths, std::string& outError);
+
+	/// Initialize for headless rendering on the current context (see RenderDevice::initializeHeadless).
+	/// Frames are rendered into an internal offscreen target of the given size; no ImGui, no input handling.
+	/// @param width Render width in pixels
+	/// @param height Render height in pixels
+	/// @param modelPaths 3D model files (.obj, .ply, .off), one object each, laid out side by side
+	/// @param outError Error message if initialization fails
+	/// @return true if successful, false on error
+	bool initializeHeadless(int width, int height, const std::vector<std::string>& modelPaths, std::string& outError);
 	
 	/// Clean up all resources (shaders, models, ImGui, OpenGL objects).
 	/// Called automatically by destructor.
@@ -79,29 +65,53 @@ public:
 	/// Updates profiling data and handles GPU timing queries.
 	void render();
 
+	/// On-demand rendering: whether the next render() would change what is on screen (input arrived, the
+	/// view or scene changed, or idle refinement is still adding points). When false the caller can
+	/// sleep until the next event instead of rendering. Always true headless or with on-demand off.
+	bool needsRedraw();
+
 	/// Check if the window should close (user clicked X button).
 	/// @return true if window should close
 	bool shouldClose() const;
 	
+	/// Place the camera (used by scripted/headless rendering instead of handleInput()).
+	/// @param eye Camera position in world space
+	/// @param target Point to look at
+	void setCamera(const glm::vec3& eye, const glm::vec3& target);
+
+	/// Offscreen target used in headless mode (invalid when rendering to a window).
+	const OffscreenTarget& offscreenTarget() const { return mOffscreenTarget; }
+
+	/// Dynamic resolution controller (settings are edited by the Inspector).
+	DynamicResolution& dynamicResolution() { return mDynamicResolution; }
+
+	/// On-demand rendering and idle refinement state (settings are edited by the Inspector).
+	ProgressiveRefinement& refinement() { return mRefinement; }
+
+	/// Culling one frame ahead on a worker thread (settings are edited by the Inspector).
+	FramePipeline& framePipeline() { return mFramePipeline; }
+
+	/// Eye-dome lighting post-process for point clouds (settings are edited by the Inspector).
+	EyeDomeLighting& eyeDomeLighting() { return mEyeDome; }
+
+	/// Culling debug overlay and its per-frame node counts (settings are edited by the Inspector).
+	CullingOverlay& cullingOverlay() { return mCullingOverlay; }
+
 	/// Get the GLFW window handle.
 	/// @return GLFW window pointer
 	GLFWwindow* getWindow() const { return mWindow; }
 	
-	/// Performance profiling data structure
-	struct ProfilingData {
-		double cpuFrameTime = 0.0;      // CPU frame time (ms)
-		double gpuFrameTime = 0.0;      // GPU frame time (ms)
-		unsigned int drawCalls = 0;     // Number of draw calls per frame
-		unsigned int triangles = 0;    // Number of triangles rendered
-		unsigned int points = 0;       // Number of points rendered (for point clouds)
-		size_t gpuMemoryUsed = 0;      // GPU memory used (bytes) - if available
-		bool gpuTimingAvailable = false; // Whether GPU timing queries are available
-	};
+	/// Performance profiling data structure (shared with Scene and the Inspector)
+	using ProfilingData = Graphics::ProfilingData;
 	
-	/// Get the scene (for UI access).
+	/// Get the primary object, whose settings apply to every object (for UI access).
 	/// @return Reference to scene
-	Scene& scene() { return mScene; }
-	const Scene& scene() const { return mScene; }
+	Scene& scene() { return mWorld.primary(); }
+	const Scene& scene() const { return mWorld.primary(); }
+
+	/// Every object drawn (for UI access).
+	World& world() { return mWorld; }
+	const World& world() const { return mWorld; }
 	
 	/// Get profiling data (for UI access).
 	/// @return Reference to profiling data
@@ -112,20 +122,36 @@ public:
 	/// @return Reference to wireframe flag
 	bool& wireframe() { return mWireframe; }
 
+	/// Export recent CPU and GPU scopes as a Chrome trace (F8). Open in chrome://tracing or ui.perfetto.dev.
+	void exportTrace();
+
 private:
 	static void framebufferSizeCallbackForwarder(GLFWwindow* window, int w, int h);
-	bool initializeScene(const std::string& modelPath, std::string& outError);
+	static void inputEventForwarder(GLFWwindow* window);
+	// Hash of everything that affects the rendered image (camera, scene settings, output size)
+	uint64_t frameSignature() const;
+	bool initializeScene(const std::vector<std::string>& modelPaths, std::string& outError);
+	// Camera and per-object snapshot handed to the frame pipeline
+	FrameInput captureFrame(const FrameState& frameState) const;
+	// Every program with its source files (initial build and hot reload)
+	std::vector<ShaderHotReload::Program> programs();
     void onResize(int w, int h);
     void checkShaderHotReload();
+	void toggleCameraRecording();
 
 private:
 	GLFWwindow* mWindow = nullptr;
-	Shader mShader;
+	ShaderVariants mShaders;  // PBR permutations (meshes and GL_POINTS)
 	Shader mLineShader;  // Simple shader for bounding box/axes
-	Shader mSphereImpostorShader;  // Shader for sphere impostors (with geometry shader)
-	Shader mInstancedSphereShader;  // Shader for instanced spheres
+	ShaderVariants mSphereImpostorShaders;  // Shader for sphere impostors (instanced quads)
+	ShaderVariants mInstancedSphereShaders;  // Shader for instanced spheres
 	Shader mDepthOnlyShader;  // Depth-only shader for Early-Z prepass
-	Scene mScene;
+	Shader mImpostorDepthShader;  // Early-Z prepass: sphere impostors, ray-cast only
+	Shader mInstancedSphereDepthShader;  // Early-Z prepass: instanced spheres
+	Shader mInstancedDepthShader;  // Early-Z prepass: instanced mesh runs
+	Shader mEyeDomeShader;  // Fullscreen eye-dome lighting pass
+	Shader mCullingOverlayShader;  // Culling debug overlay (instanced node boxes)
+	World mWorld;
 	View mView;
 
 	int mWidth = 0;
@@ -133,27 +159,59 @@ private:
 	float mAspect = 1.0f;
 
 	bool mPrevF5Down = false;
-	double mLastReloadSec = 0.0;
 	bool mWireframe = false;
 	bool mPrevF2Down = false;
 	bool mImGuiInitialized = false;
 
-	// Shader hot-reload
-	std::string mVertPath;
-	std::string mFragPath;
-	unsigned long long mVertStamp = 0;
-	unsigned long long mFragStamp = 0;
+	// Camera path recording (F7), replayed by --benchmark
+	static constexpr const char* kCameraPathFile = "camera_path.json";
+	CameraPath mCameraRecording;
+	bool mRecordingCamera = false;
+	bool mPrevF7Down = false;
+	double mRecordStartSec = 0.0;
+	float mLastRecordedSec = 0.0f;
+
+	// Linked program binaries, keyed by source and driver (see ProgramCache)
+	static constexpr const char* kShaderCacheDir = "shader_cache";
+
+	// Scope trace export (F8)
+	static constexpr const char* kTraceFile = "trace.json";
+	bool mPrevF8Down = false;
+
+	// Shader hot-reload (every program under shaders/, rebuilt off the render path)
+	static constexpr const char* kShaderDir = "shaders";
+	ShaderHotReload mShaderReload;
 	
 	// Performance profiling
 	ProfilingData mProfilingData;
 	
 	
 	// GPU timing queries
-	unsigned int mGPUTimestampQuery[2] = {0, 0};  // Double-buffered queries [0]=start, [1]=end
+	unsigned long long mLastGpuResolvedFrame = 0;  // GpuProfiler::resolvedFrames() at the last gpuFrameTime update
 	bool mGPUTimingSupported = false;
 	
-	// OpenGL state cache (reduces redundant state changes)
-	GLStateCache mGLStateCache;
+	// OpenGL state cache (reduces redundant state changes; shared by every GL wrapper)
+	GLStateCache& mGLStateCache = GLStateCache::instance();
+
+	// Headless rendering target (no default framebuffer exists)
+	OffscreenTarget mOffscreenTarget;
+
+	// Scaled internal target for the scene passes, upscaled before the UI (off by default)
+	DynamicResolution mDynamicResolution;
+
+	// On-demand rendering: frames still owed to recent input, and idle refinement of still views
+	ProgressiveRefinement mRefinement;
+
+	// Object/leaf culling and draw sorting, built one frame ahead on a worker for interactive frames
+	FramePipeline mFramePipeline;
+
+	// Screen-space depth shading of point clouds (off by default)
+	EyeDomeLighting mEyeDome;
+
+	// Boxes of the culled / drawn nodes of the last frame (off by default)
+	CullingOverlay mCullingOverlay;
+	unsigned int mInputFrames = Config::InputRedrawFrames;
+	unsigned int mShaderGeneration = 0;  // Bumped by shader hot reload (part of the frame signature)
 	
 	void initializeProfiling();
 	void updateProfiling(double cpuFrameTime);
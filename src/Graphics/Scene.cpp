@@ -1,87 +1,565 @@
 #include "Graphics/Scene.hpp"
+#include "Graphics/Profiling/GpuProfiler.hpp"
+#include "Graphics/Profiling/CpuProfiler.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+#include <limits>
 
 namespace Graphics {
 
-void Scene::draw(Shader& shader, Shader* sphereImpostorShader, Shader* instancedSphereShader, const FrameState& frameState, bool wireframe, void* profilingData, GLStateCache* /*stateCache*/) {
-	struct ProfilingData {
-		double cpuFrameTime;
-		double gpuFrameTime;
-		unsigned int drawCalls;
-		unsigned int triangles;
-		unsigned int points;
-		size_t gpuMemoryUsed;
-		bool gpuTimingAvailable;
-	};
-	ProfilingData* profData = static_cast<ProfilingData*>(profilingData);
+void Scene::updateUBOs(const FrameState& frameState, UniformRing& matricesRing) {
+	PHV_CPU_SCOPE("Scene::updateUBOs");
+	if (!matricesRing.valid()) return;
+
+	MatricesUBO matricesData;
+	matricesData.model = modelMatrix;
+	matricesData.view = frameState.view;
+	matricesData.proj = frameState.proj;
+	matricesData.viewProj = frameState.viewProj;
+	matricesData.camPos = glm::vec4(frameState.camPos, 1.0f);
+	mMatricesRing = &matricesRing;
+	mMatricesBlock = matricesRing.push(&matricesData);
+
+	MaterialUBO materialData;
+	materialData.albedo = glm::vec4(material.albedo, material.metallic);
+	// Pack params: roughness, ao, colorMode (as float bits; the shaders take it from COLOR_MODE), scalarMin
+	materialData.params = glm::vec4(material.roughness, material.ao, static_cast<float>(static_cast<int>(colorMode)), model->scalarMin());
+	materialData.scalars = glm::vec4(model->scalarMax(), 0.0f, 0.0f, 0.0f);
+	materialData.skyColor = glm::vec4(material.skyColor, 0.0f);
+	materialData.groundColor = glm::vec4(material.groundColor, 0.0f);
+
+	LightingUBO lightingData;
+	lightingData.lightDir = glm::vec4(light.dir, 0.0f);
+	lightingData.lightColor = glm::vec4(light.color, 0.0f);
+
+	// Material and lighting change only from the UI: a block is dirty when it differs from its last upload
+	if (!mBlocksUploaded || std::memcmp(&materialData, &mUploadedMaterial, sizeof(MaterialUBO)) != 0) {
+		mMaterialUBO.updateData(0, sizeof(MaterialUBO), &materialData);
+		mUploadedMaterial = materialData;
+	}
+	if (!mBlocksUploaded || std::memcmp(&lightingData, &mUploadedLighting, sizeof(LightingUBO)) != 0) {
+		mLightingUBO.updateData(0, sizeof(LightingUBO), &lightingData);
+		mUploadedLighting = lightingData;
+	}
+	mBlocksUploaded = true;
+}
+
+void Scene::copySettingsFrom(const Scene& other) {
+	material = other.material;
+	light = other.light;
+	pointSize = other.pointSize;
+	colorMode = other.colorMode;
+	pointCloudMode = other.pointCloudMode;
+	autoLOD = other.autoLOD;
+	sphereRadius = other.sphereRadius;
+	showBoundingBox = other.showBoundingBox;
+	enableFrustumCulling = other.enableFrustumCulling;
+	enableEarlyZPrepass = other.enableEarlyZPrepass;
+	enableSpatialIndexing = other.enableSpatialIndexing;
+	enableOcclusionCulling = other.enableOcclusionCulling;
+	enableSoftwareOcclusion = other.enableSoftwareOcclusion;
+	showSoftwareOcclusionBuffer = other.showSoftwareOcclusionBuffer;
+	enableMeshLOD = other.enableMeshLOD;
+	meshLODErrorPixels = other.meshLODErrorPixels;
+	fullDetail = other.fullDetail;
+	recordCullingNodes = other.recordCullingNodes;
+}
+
+unsigned int Scene::programKey() const {
+	if (!model->isPointCloud()) return 0;
+	if (autoLOD) return 4;
+	return 1 + static_cast<unsigned int>(pointCloudMode);
+}
+
+uint32_t Scene::materialKey() const {
+	return static_cast<uint32_t>(hashBytes(&mUploadedMaterial, sizeof(MaterialUBO)));
+}
+
+void Scene::draw(ShaderVariants& shaders, ShaderVariants* sphereImpostorShaders, ShaderVariants* instancedSphereShaders, const FrameState& frameState, bool wireframe, ProfilingData* profData, const LeafVisibility* leaves) {
+	PHV_CPU_SCOPE("Scene::draw");
+	mImpostorsDrawn.assign(model->pointClusters().size(), 0u);
+	resetCullingNodes();
 
 	if (enableFrustumCulling) {
 		Frustum frustum; frustum.extractFromMatrix(frameState.viewProj);
-		if (!frustum.intersectsTransformedAABB(model.min(), model.max(), modelMatrix)) return;
+		if (!frustum.intersectsTransformedAABB(model->min(), model->max(), modelMatrix)) return;
 	}
 
-	if (enableOcclusionCulling && !model.isPointCloud()) {
-		if (!mOcclusionCuller.isSupported() || !mOcclusionCuller.getLastResult()) return;
-	}
+	bindUniforms();
 
-	if (mMatricesUBO.valid()) updateUBOs(modelMatrix, frameState.view, frameState.proj, frameState.camPos);
+	// Pick the permutations for this frame's color mode; each is compiled the first time it is needed
+	ShaderVariants::Key key;
+	key.colorMode = colorMode;
+	Shader* sphereImpostorShader = sphereImpostorShaders ? sphereImpostorShaders->get(key) : nullptr;
+	Shader* instancedSphereShader = instancedSphereShaders ? instancedSphereShaders->get(key) : nullptr;
+	key.points = model->isPointCloud();
+	key.wireframe = wireframe && !model->isPointCloud();
+	Shader* shader = shaders.get(key);
+	if (!shader) return;
 
-	Shader* activeShader = &shader;
-	if (model.isPointCloud()) {
-		PointCloudRenderMode actualMode = pointCloudMode;
-		if (autoLOD) {
-			glm::vec3 modelCenter = glm::vec3(modelMatrix * glm::vec4(model.center(), 1.0f));
-			float distance = glm::length(frameState.camPos - modelCenter);
-			if (distance > LOD_FAR_THRESHOLD) actualMode = PointCloudRenderMode::Points;
-			else if (distance < LOD_NEAR_THRESHOLD) actualMode = PointCloudRenderMode::InstancedSpheres;
-			else actualMode = PointCloudRenderMode::SphereImpostors;
+	if (model->isPointCloud()) {
+		drawPointCloud({shader, sphereImpostorShader, instancedSphereShader}, frameState, false, leaves, profData);
+		return;
+	}
+	shader->use();
+	if (key.wireframe) beginWireframe(*shader);
+	float maxErrorPixels = meshLodError();
+	bool cpuOcclusion = mSoftwareOcclusion != nullptr;
+	if (prepareOcclusionNodes(OcclusionNodes::Meshes)) {
+		// Each mesh is a cluster with its own query, drawn front to back
+		for (size_t node : mOcclusionCuller.beginFrame(modelMatrix, frameState)) {
+			if (cpuOcclusion && cpuOccluded(node)) { recordNode(node, CullingNode::Occluded); continue; }
+			recordNode(node, mOcclusionCuller.isVisible(node) ? CullingNode::Drawn : CullingNode::Hidden, meshLodStep(node, frameState, maxErrorPixels));
+			mOcclusionCuller.beginNode(node);
+			unsigned int triangles = model->drawMesh(node, modelMatrix, frameState, maxErrorPixels);
+			mOcclusionCuller.endNode(node);
+			if (profData) { profData->drawCalls++; profData->triangles += triangles; }
+		}
+	} else if (cpuOcclusion) {
+		for (size_t mesh = 0; mesh < model->meshes().size(); ++mesh) {
+			if (cpuOccluded(mesh)) { recordNode(mesh, CullingNode::Occluded); continue; }
+			recordNode(mesh, CullingNode::Drawn, meshLodStep(mesh, frameState, maxErrorPixels));
+			unsigned int triangles = model->drawMesh(mesh, modelMatrix, frameState, maxErrorPixels);
+			if (profData) { profData->drawCalls++; profData->triangles += triangles; }
 		}
+	} else {
+		unsigned int triangles = model->draw(modelMatrix, frameState, maxErrorPixels);
+		if (profData) {
+			profData->drawCalls++;
+			profData->triangles += triangles;
+		}
+		for (size_t mesh = 0; mesh < mCullingNodes.size(); ++mesh) recordNode(mesh, CullingNode::Drawn, meshLodStep(mesh, frameState, maxErrorPixels));
+	}
+	model->setWireframeShader(nullptr);
+}
 
-		switch (actualMode) {
-			case PointCloudRenderMode::Points:
-				activeShader = &shader; activeShader->use();
-				if (enableSpatialIndexing && model.hasSpatialIndex()) {
-					auto visibleIndices = model.spatialIndex().getVisiblePoints(frameState.viewProj, frameState.camPos);
-					if (!visibleIndices.empty()) {
-						model.drawPointsSubset(visibleIndices, pointSize);
-						if (profData) { profData->drawCalls++; profData->points += static_cast<unsigned int>(visibleIndices.size()); }
-					}
-				} else {
-					model.drawPoints(pointSize);
-					if (profData) { profData->drawCalls++; profData->points += model.meshes()[0].vertexCount; }
+void Scene::beginWireframe(Shader& shader) const {
+	// Solid shading with the triangle edges blended in, in the same fill-mode draws
+	shader.setVec3("uWireframeColor", glm::vec3(1.0f, 0.5f, 0.0f));
+	shader.setFloat("uWireframeWidth", Config::WireframeWidthPixels);
+	shader.setInt("uWireIndices", Model::kWireframeTextureUnit);
+	shader.setInt("uWirePositions", Model::kWireframeTextureUnit + 1);
+	model->setWireframeShader(&shader);
+}
+
+int Scene::instanceLod(size_t mesh, const FrameState& frameState) {
+	if (cpuOccluded(mesh)) return kMeshOccluded;
+	return model->lodLevel(mesh, modelMatrix, frameState, meshLodError());
+}
+
+void Scene::drawInstances(Shader& shader, const UniformRing& instances, const MeshInstances* draws, size_t count, bool wireframe, ProfilingData* profData) {
+	PHV_CPU_SCOPE("Scene::drawInstances");
+	bindUniforms();  // View and projection are the same for every object; material and lighting are synced
+	shader.use();
+	if (wireframe) beginWireframe(shader);
+	for (size_t i = 0; i < count; ++i) {
+		instances.bind(3, draws[i].block);
+		unsigned int triangles = model->drawMeshInstanced(draws[i].mesh, draws[i].lod, draws[i].count);
+		if (profData) { profData->drawCalls++; profData->triangles += triangles; }
+	}
+	model->setWireframeShader(nullptr);
+}
+
+void Scene::drawPointCloud(const PointPrograms& programs, const FrameState& frameState, bool depthOnly, const LeafVisibility* leaves, ProfilingData* profData) {
+	PointCloudRenderMode actualMode = pointCloudMode;
+	if (autoLOD) {
+		glm::vec3 modelCenter = glm::vec3(modelMatrix * glm::vec4(model->center(), 1.0f));
+		float distance = glm::length(frameState.camPos - modelCenter);
+		if (distance > LOD_FAR_THRESHOLD) actualMode = PointCloudRenderMode::Points;
+		else if (distance < LOD_NEAR_THRESHOLD) actualMode = PointCloudRenderMode::InstancedSpheres;
+		else actualMode = PointCloudRenderMode::SphereImpostors;
+	}
+
+	// Auto LOD with an octree: every visible leaf picks its own mode, each mode drawn as one batch.
+	// The batches mix leaves, so hardware occlusion can only treat the whole cloud as one node.
+	if (autoLOD && enableSpatialIndexing && !model->pointClusters().empty() && programs.impostors && programs.spheres) {
+		bool occlusion = !depthOnly && prepareOcclusionNodes(OcclusionNodes::Model);
+		bool cpuOcclusion = mSoftwareOcclusion != nullptr;
+		if (occlusion && mOcclusionCuller.beginFrame(modelMatrix, frameState).empty()) return;
+		if (occlusion) mOcclusionCuller.beginNode(0);
+		drawMixedPointModes(frameState, *programs.points, *programs.impostors, *programs.spheres, cpuOcclusion, leaves, profData);
+		if (occlusion) mOcclusionCuller.endNode(0);
+		if (occlusion && !mOcclusionCuller.isVisible(0)) hideDrawnCullingNodes();
+		return;
+	}
+
+	// Octree leaves are occlusion-culled individually; instancing draws the whole cloud as one node.
+	// Impostors always go leaf by leaf so the octree can cull them and thin out distant leaves.
+	// With the Early-Z prepass, points go leaf by leaf too: both passes draw the frame's culled leaves
+	// from the static leaf EBO instead of each gathering and uploading a visible-point index list.
+	bool perLeaf = enableSpatialIndexing && !model->pointClusters().empty() && actualMode != PointCloudRenderMode::InstancedSpheres;
+	bool occlusion = !depthOnly && prepareOcclusionNodes(perLeaf ? OcclusionNodes::PointClusters : OcclusionNodes::Model);
+	bool cpuOcclusion = mSoftwareOcclusion != nullptr;
+	bool clustered = perLeaf && (occlusion || cpuOcclusion || enableEarlyZPrepass || actualMode == PointCloudRenderMode::SphereImpostors);
+
+	switch (actualMode) {
+		case PointCloudRenderMode::Points: {
+			PHV_GPU_SCOPE("Points");
+			programs.points->use();
+			if (clustered) {
+				drawPointClusters(frameState, occlusion, cpuOcclusion, false, leaves, profData);
+			} else if (enableSpatialIndexing && model->hasSpatialIndex()) {
+				auto visibleIndices = model->spatialIndex().getVisiblePoints(frameState.viewProj, frameState.camPos);
+				if (!mCullingNodes.empty()) {
+					for (size_t leaf : visibleLeaves(frameState, leaves).leaves) recordNode(leaf, CullingNode::Drawn);
+				}
+				if (!visibleIndices.empty()) {
+					model->drawPointsSubset(visibleIndices, pointSize);
+					if (profData) { profData->drawCalls++; profData->points += static_cast<unsigned int>(visibleIndices.size()); }
 				}
-				break;
-			case PointCloudRenderMode::SphereImpostors:
-				if (sphereImpostorShader) { activeShader = sphereImpostorShader; activeShader->use(); setupShaderUniforms(*activeShader, pointSize); model.drawSphereImpostors(pointSize); if (profData) { profData->drawCalls++; profData->points += model.meshes()[0].vertexCount; } }
-				break;
-			case PointCloudRenderMode::InstancedSpheres:
-				if (instancedSphereShader) { activeShader = instancedSphereShader; activeShader->use(); setupShaderUniforms(*activeShader); activeShader->setFloat("uSphereRadius", sphereRadius); model.drawInstancedSpheres(sphereRadius); if (profData) { profData->drawCalls++; profData->points += model.meshes()[0].vertexCount; } }
-				break;
+			} else if (!occlusion || !mOcclusionCuller.beginFrame(modelMatrix, frameState).empty()) {
+				if (occlusion) mOcclusionCuller.beginNode(0);
+				model->drawPoints(pointSize);
+				if (occlusion) mOcclusionCuller.endNode(0);
+				recordWholeCloud(occlusion);
+				if (profData) { profData->drawCalls++; profData->points += model->meshes()[0].vertexCount; }
+			}
+			break;
 		}
+		case PointCloudRenderMode::SphereImpostors: {
+			PHV_GPU_SCOPE("Sphere Impostors");
+			if (!programs.impostors) break;
+			programs.impostors->use(); setupShaderUniforms(*programs.impostors); programs.impostors->setFloat("uSphereRadius", sphereRadius);
+			if (clustered) {
+				drawPointClusters(frameState, occlusion, cpuOcclusion, true, leaves, profData);
+			} else if (!occlusion || !mOcclusionCuller.beginFrame(modelMatrix, frameState).empty()) {
+				if (occlusion) mOcclusionCuller.beginNode(0);
+				model->drawSphereImpostors();
+				if (occlusion) mOcclusionCuller.endNode(0);
+				recordWholeCloud(occlusion);
+				if (profData) { profData->drawCalls++; profData->points += model->meshes()[0].vertexCount; }
+			}
+			break;
+		}
+		case PointCloudRenderMode::InstancedSpheres: {
+			PHV_GPU_SCOPE("Instanced Spheres");
+			if (!programs.spheres) break;
+			if (occlusion && mOcclusionCuller.beginFrame(modelMatrix, frameState).empty()) break;
+			programs.spheres->use(); setupShaderUniforms(*programs.spheres); programs.spheres->setFloat("uSphereRadius", sphereRadius);
+			if (occlusion) mOcclusionCuller.beginNode(0);
+			if (enableSpatialIndexing && !model->pointClusters().empty()) {
+				drawInstancedSphereLods(frameState, cpuOcclusion, leaves, profData);
+			} else {
+				model->drawInstancedSpheres();
+				if (profData) { profData->drawCalls++; profData->points += model->meshes()[0].vertexCount; }
+				recordWholeCloud(false);
+			}
+			if (occlusion) mOcclusionCuller.endNode(0);
+			if (occlusion && !mOcclusionCuller.isVisible(0)) hideDrawnCullingNodes();
+			break;
+		}
+	}
+}
+
+size_t Scene::cullingNodeCount() const {
+	if (model->isPointCloud()) return std::max<size_t>(1, model->pointClusters().size());
+	return model->meshes().size();
+}
+
+void Scene::cullingNodeBounds(size_t node, glm::vec3& outMin, glm::vec3& outMax) const {
+	if (!model->isPointCloud() && node < model->meshes().size()) {
+		outMin = model->meshes()[node].boundsMin; outMax = model->meshes()[node].boundsMax;
+	} else if (node < model->pointClusters().size()) {
+		outMin = model->pointClusters()[node].boundsMin; outMax = model->pointClusters()[node].boundsMax;
 	} else {
-		activeShader = &shader; activeShader->use();
-		activeShader->setFloat("uWireframe", wireframe ? 1.0f : 0.0f);
-		activeShader->setVec3("uWireframeColor", glm::vec3(1.0f, 0.5f, 0.0f));
-		model.draw();
+		outMin = model->min(); outMax = model->max();
+	}
+}
+
+void Scene::resetCullingNodes() {
+	if (recordCullingNodes) mCullingNodes.assign(cullingNodeCount(), CullingNode{});
+	else mCullingNodes.clear();
+}
+
+void Scene::recordNode(size_t node, CullingNode::State state, unsigned int lod) {
+	if (node >= mCullingNodes.size()) return;
+	mCullingNodes[node].state = state;
+	mCullingNodes[node].lod = static_cast<uint8_t>(std::min(lod, 255u));
+}
+
+void Scene::recordWholeCloud(bool occlusion) {
+	// One draw for the whole cloud: every leaf is submitted (the GPU clips what is off-screen)
+	CullingNode::State state = occlusion && !mOcclusionCuller.isVisible(0) ? CullingNode::Hidden : CullingNode::Drawn;
+	for (size_t node = 0; node < mCullingNodes.size(); ++node) recordNode(node, state);
+}
+
+void Scene::hideDrawnCullingNodes() {
+	for (CullingNode& node : mCullingNodes) {
+		if (node.state == CullingNode::Drawn) node.state = CullingNode::Hidden;
+	}
+}
+
+unsigned int Scene::meshLodStep(size_t mesh, const FrameState& frameState, float maxErrorPixels) const {
+	if (mCullingNodes.empty()) return 0;
+	return static_cast<unsigned int>(model->lodLevel(mesh, modelMatrix, frameState, maxErrorPixels) + 1);
+}
+
+unsigned int Scene::halvings(unsigned int count, unsigned int full) {
+	unsigned int steps = 0;
+	while (count > 0 && count * 2 <= full) { count *= 2; steps++; }
+	return steps;
+}
+
+void Scene::cullLeaves(const Model& geometry, const glm::mat4& transform, float radius, const FrameState& frameState, LeafVisibility& out) {
+	const std::vector<PointCluster>& clusters = geometry.pointClusters();
+	Frustum frustum; frustum.extractFromMatrix(frameState.viewProj);
+	out.leaves.clear();
+	out.spherePixels.clear();
+	out.impostors.clear();
+	for (size_t i = 0; i < clusters.size(); ++i) {
+		const PointCluster& cluster = clusters[i];
+		if (!frustum.intersectsTransformedAABB(cluster.boundsMin, cluster.boundsMax, transform)) continue;
+		out.leaves.push_back(i);
+		out.spherePixels.push_back(leafSpherePixels(cluster, transform, radius, frameState));
+		out.impostors.push_back(impostorLodCount(cluster, transform, radius, frameState));
+	}
+	out.valid = true;
+}
+
+const LeafVisibility& Scene::visibleLeaves(const FrameState& frameState, const LeafVisibility* leaves) {
+	if (leaves && leaves->valid) return *leaves;
+	cullLeaves(*model, modelMatrix, sphereRadius, frameState, mLeafScratch);
+	return mLeafScratch;
+}
+
+void Scene::drawPointClusters(const FrameState& frameState, bool occlusion, bool cpuOcclusion, bool impostors, const LeafVisibility* leaves, ProfilingData* profData) {
+	const std::vector<PointCluster>& clusters = model->pointClusters();
+	// The occlusion culler walks the leaves front to back itself; otherwise the frame's frustum list is used
+	const LeafVisibility* visible = occlusion ? nullptr : &visibleLeaves(frameState, leaves);
+	const std::vector<size_t>& nodes = occlusion ? mOcclusionCuller.beginFrame(modelMatrix, frameState) : visible->leaves;
+	for (size_t k = 0; k < nodes.size(); ++k) {
+		size_t node = nodes[k];
+		const PointCluster& cluster = clusters[node];
+		if (cpuOcclusion && cpuOccluded(node)) { recordNode(node, CullingNode::Occluded); continue; }
+		unsigned int count = cluster.indexCount;
+		if (impostors) count = visible ? visible->impostors[k] : impostorLodCount(cluster, modelMatrix, sphereRadius, frameState);
+		recordNode(node, occlusion && !mOcclusionCuller.isVisible(node) ? CullingNode::Hidden : CullingNode::Drawn, halvings(count, cluster.indexCount));
+		if (occlusion) mOcclusionCuller.beginNode(node);
+		if (impostors) { model->drawImpostorCluster(node, count); mImpostorsDrawn[node] = count; }
+		else model->drawPointCluster(node, pointSize);
+		if (occlusion) mOcclusionCuller.endNode(node);
+		if (profData) { profData->drawCalls++; profData->points += count; }
+	}
+}
+
+void Scene::drawInstancedSphereLods(const FrameState& frameState, bool cpuOcclusion, const LeafVisibility* leaves, ProfilingData* profData) {
+	const LeafVisibility& visible = visibleLeaves(frameState, leaves);
+	mSphereLeaves.clear();
+	for (size_t k = 0; k < visible.leaves.size(); ++k) {
+		if (cpuOcclusion && cpuOccluded(visible.leaves[k])) { recordNode(visible.leaves[k], CullingNode::Occluded); continue; }
+		mSphereLeaves.emplace_back(visible.leaves[k], fullDetail ? Model::kSphereLodCount - 1 : sphereLevel(visible.spherePixels[k]));
+		recordNode(visible.leaves[k], CullingNode::Drawn, static_cast<unsigned int>(Model::kSphereLodCount - 1 - mSphereLeaves.back().second));
+	}
+	unsigned int triangles = model->drawInstancedSphereLods(mSphereLeaves, mSphereLodSpheres);
+	if (profData) {
+		for (unsigned int spheres : mSphereLodSpheres) {
+			if (spheres > 0) profData->drawCalls++;
+			profData->points += spheres;
+		}
+		profData->triangles += triangles;
+	}
+}
+
+void Scene::drawMixedPointModes(const FrameState& frameState, Shader& pointShader, Shader& impostorShader, Shader& sphereShader, bool cpuOcclusion, const LeafVisibility* leaves, ProfilingData* profData) {
+	// Sort the visible leaves into the three modes by how large their nearest spheres appear
+	const std::vector<PointCluster>& clusters = model->pointClusters();
+	const LeafVisibility& visible = visibleLeaves(frameState, leaves);
+	mFrustumNodes.clear();
+	mImpostorLeaves.clear();
+	mSphereLeaves.clear();
+	for (size_t k = 0; k < visible.leaves.size(); ++k) {
+		size_t i = visible.leaves[k];
+		const PointCluster& cluster = clusters[i];
+		if (cpuOcclusion && cpuOccluded(i)) { recordNode(i, CullingNode::Occluded); continue; }
+		float pixels = visible.spherePixels[k];
+		if (pixels >= Config::MixedModeSpherePixels) {
+			mSphereLeaves.emplace_back(i, fullDetail ? Model::kSphereLodCount - 1 : sphereLevel(pixels));
+			recordNode(i, CullingNode::Drawn, static_cast<unsigned int>(Model::kSphereLodCount - 1 - mSphereLeaves.back().second));
+		} else if (pixels >= Config::MixedModeImpostorPixels) {
+			mImpostorLeaves.emplace_back(i, visible.impostors[k]);
+			recordNode(i, CullingNode::Drawn, halvings(visible.impostors[k], cluster.indexCount));
+		} else {
+			mFrustumNodes.push_back(i);
+			recordNode(i, CullingNode::Drawn);
+		}
+	}
+	mMixedModeLeaves[0] = static_cast<unsigned int>(mFrustumNodes.size());
+	mMixedModeLeaves[1] = static_cast<unsigned int>(mImpostorLeaves.size());
+	mMixedModeLeaves[2] = static_cast<unsigned int>(mSphereLeaves.size());
+	std::fill(std::begin(mSphereLodSpheres), std::end(mSphereLodSpheres), 0u);
+
+	// One batched pass per mode
+	if (!mFrustumNodes.empty()) {
+		PHV_GPU_SCOPE("Points");
+		pointShader.use();
+		model->drawPointClusterBatch(mFrustumNodes, pointSize);
 		if (profData) {
 			profData->drawCalls++;
-			for (const auto& mesh : model.meshes()) profData->triangles += mesh.indexCount / 3;
+			for (size_t node : mFrustumNodes) profData->points += clusters[node].indexCount;
+		}
+	}
+	if (!mImpostorLeaves.empty()) {
+		PHV_GPU_SCOPE("Sphere Impostors");
+		impostorShader.use(); setupShaderUniforms(impostorShader); impostorShader.setFloat("uSphereRadius", sphereRadius);
+		unsigned int impostors = model->drawImpostorClusterBatch(mImpostorLeaves);
+		for (const auto& leaf : mImpostorLeaves) mImpostorsDrawn[leaf.first] = leaf.second;
+		if (profData) { profData->drawCalls++; profData->points += impostors; }
+	}
+	if (!mSphereLeaves.empty()) {
+		PHV_GPU_SCOPE("Instanced Spheres");
+		sphereShader.use(); setupShaderUniforms(sphereShader); sphereShader.setFloat("uSphereRadius", sphereRadius);
+		unsigned int triangles = model->drawInstancedSphereLods(mSphereLeaves, mSphereLodSpheres);
+		if (profData) {
+			for (unsigned int spheres : mSphereLodSpheres) {
+				if (spheres > 0) profData->drawCalls++;
+				profData->points += spheres;
+			}
+			profData->triangles += triangles;
 		}
 	}
 }
 
-void Scene::drawDepthOnly(Shader& depthShader, const FrameState& frameState, GLStateCache* /*stateCache*/) {
+float Scene::leafSpherePixels(const PointCluster& cluster, const glm::mat4& transform, float radius, const FrameState& frameState) {
+	// Projected sphere radius at the leaf's nearest possible distance (the largest in the leaf)
+	float scale = std::max(glm::length(glm::vec3(transform[0])),
+	              std::max(glm::length(glm::vec3(transform[1])), glm::length(glm::vec3(transform[2]))));
+	glm::vec3 center = glm::vec3(transform * glm::vec4(0.5f * (cluster.boundsMin + cluster.boundsMax), 1.0f));
+	float leafRadius = 0.5f * glm::length(cluster.boundsMax - cluster.boundsMin) * scale;
+	float distance = glm::length(center - frameState.camPos) - leafRadius;
+	float pixelsPerUnitAtOne = frameState.proj[1][1] * 0.5f * frameState.viewportSize.y;
+	if (distance <= 0.0f || pixelsPerUnitAtOne <= 0.0f) return std::numeric_limits<float>::max();
+	return radius * scale * pixelsPerUnitAtOne / distance;
+}
+
+int Scene::sphereLevel(float radiusPixels) {
+	int level = 0;
+	while (level < Model::kSphereLodCount - 1 && radiusPixels >= Config::InstancedSphereLodPixels[level]) ++level;
+	return level;
+}
+
+unsigned int Scene::impostorLodCount(const PointCluster& cluster, const glm::mat4& transform, float radius, const FrameState& frameState) {
+	if (frameState.viewportSize.y <= 0.0f) return cluster.indexCount;
+	float scale = std::max(glm::length(glm::vec3(transform[0])),
+	              std::max(glm::length(glm::vec3(transform[1])), glm::length(glm::vec3(transform[2]))));
+	glm::vec3 center = glm::vec3(transform * glm::vec4(0.5f * (cluster.boundsMin + cluster.boundsMax), 1.0f));
+	float leafRadius = 0.5f * glm::length(cluster.boundsMax - cluster.boundsMin) * scale;
+	float distance = glm::length(center - frameState.camPos);
+	if (distance <= leafRadius) return cluster.indexCount;
+
+	// Footprints as pixel areas (circles); a sphere counts as at least one pixel
+	float pixelsPerUnit = frameState.proj[1][1] * 0.5f * frameState.viewportSize.y / distance;
+	float leafPixels = leafRadius * pixelsPerUnit;
+	float spherePixels = radius * scale * pixelsPerUnit;
+	float budget = static_cast<float>(Config::ImpostorLodOverdraw) * (leafPixels * leafPixels) / std::max(spherePixels * spherePixels, 1.0f / 3.14159265f);
+	return static_cast<unsigned int>(std::min(static_cast<float>(cluster.indexCount), std::max(1.0f, std::ceil(budget))));
+}
+
+void Scene::beginOcclusionFrame(SoftwareOcclusionBuffer* buffer) {
+	mSoftwareOcclusion = enableSoftwareOcclusion && !fullDetail ? buffer : nullptr;  // Occluders are approximate: not for still frames
+	if (mSoftwareOcclusion) mCpuOccluded.assign(cullingNodeCount(), 0);
+}
+
+bool Scene::cpuOccluded(size_t node) {
+	if (!mSoftwareOcclusion || node >= mCpuOccluded.size()) return false;
+	if (mCpuOccluded[node] == 0) {
+		glm::vec3 lo, hi;
+		cullingNodeBounds(node, lo, hi);
+		mCpuOccluded[node] = mSoftwareOcclusion->isOccluded(lo, hi, modelMatrix) ? 2 : 1;
+	}
+	return mCpuOccluded[node] == 2;
+}
+
+bool Scene::prepareOcclusionNodes(OcclusionNodes nodes) {
+	if (!enableOcclusionCulling || !mOcclusionCuller.isSupported()) {
+		mOcclusionNodes = OcclusionNodes::None;  // Re-enabling starts from fresh visibility history
+		return false;
+	}
+	if (fullDetail) return false;  // Stale results could drop a node that just became visible: still frames draw everything
+	if (nodes == mOcclusionNodes) return true;
+
+	std::vector<OcclusionCuller::NodeBounds> bounds;
+	switch (nodes) {
+		case OcclusionNodes::PointClusters:
+			for (const PointCluster& cluster : model->pointClusters()) bounds.push_back({cluster.boundsMin, cluster.boundsMax});
+			break;
+		case OcclusionNodes::Meshes:
+			for (const Mesh& mesh : model->meshes()) bounds.push_back({mesh.boundsMin, mesh.boundsMax});
+			break;
+		case OcclusionNodes::Model:
+			bounds.push_back({model->min(), model->max()});
+			break;
+		case OcclusionNodes::None:
+			break;
+	}
+	mOcclusionCuller.setNodes(bounds);
+	mOcclusionNodes = nodes;
+	return true;
+}
+
+void Scene::drawDepthOnly(Shader& depthShader, Shader* impostorDepthShader, Shader* sphereDepthShader, const FrameState& frameState, const LeafVisibility* leaves) {
+	PHV_CPU_SCOPE("Scene::drawDepthOnly");
 	if (enableFrustumCulling) {
 		Frustum frustum; frustum.extractFromMatrix(frameState.viewProj);
-		if (!frustum.intersectsTransformedAABB(model.min(), model.max(), modelMatrix)) return;
+		if (!frustum.intersectsTransformedAABB(model->min(), model->max(), modelMatrix)) return;
+	}
+	bindUniforms();
+	// Same LOD selection (mesh levels, point modes, leaves and impostor counts) as the main pass so
+	// depth values match exactly
+	if (model->isPointCloud()) {
+		drawPointCloud({&depthShader, impostorDepthShader, sphereDepthShader}, frameState, true, leaves, nullptr);
+		return;
 	}
-	if (mMatricesUBO.valid()) updateUBOs(modelMatrix, frameState.view, frameState.proj, frameState.camPos);
 	depthShader.use();
-	if (!model.isPointCloud()) model.draw();
+	float maxErrorPixels = meshLodError();
+	if (!mSoftwareOcclusion) {
+		model->draw(modelMatrix, frameState, maxErrorPixels);
+		return;
+	}
+	// Skip the meshes the main pass will skip
+	for (size_t mesh = 0; mesh < model->meshes().size(); ++mesh) {
+		if (!cpuOccluded(mesh)) model->drawMesh(mesh, modelMatrix, frameState, maxErrorPixels);
+	}
+}
+
+unsigned int Scene::refine(ShaderVariants& impostorShaders, ProfilingData* profData) {
+	PHV_CPU_SCOPE("Scene::refine");
+	const std::vector<PointCluster>& clusters = model->pointClusters();
+	if (mImpostorsDrawn.size() != clusters.size()) return 0;
+	ShaderVariants::Key key;
+	key.colorMode = colorMode;
+	Shader* impostorShader = impostorShaders.get(key);
+	if (!impostorShader) return 0;
+
+	// Every unfinished leaf at most doubles its impostors; the points of a leaf are shuffled, so each
+	// step stays an even subsample until the last one completes it
+	mRefineRanges.clear();
+	unsigned int budget = Config::RefinementImpostorsPerFrame;
+	for (size_t i = 0; i < clusters.size() && budget > 0; ++i) {
+		unsigned int drawn = mImpostorsDrawn[i];
+		if (drawn == 0 || drawn >= clusters[i].indexCount) continue;
+		unsigned int count = std::min({drawn, clusters[i].indexCount - drawn, budget});
+		mRefineRanges.push_back({i, drawn, count});
+		mImpostorsDrawn[i] += count;
+		budget -= count;
+	}
+	if (mRefineRanges.empty()) return 0;
+
+	PHV_GPU_SCOPE("Refine Impostors");
+	bindUniforms();
+	impostorShader->use(); setupShaderUniforms(*impostorShader); impostorShader->setFloat("uSphereRadius", sphereRadius);
+	unsigned int impostors = model->drawImpostorClusterRanges(mRefineRanges);
+	if (profData) { profData->drawCalls++; profData->points += impostors; }
+	return impostors;
 }
 
-bool Scene::testOcclusion(const FrameState& frameState, Shader& depthShader, GLStateCache* stateCache) {
-	if (!enableOcclusionCulling) return true;
-	return mOcclusionCuller.testOcclusion(modelMatrix, model.min(), model.max(), frameState, depthShader, mMatricesUBO, stateCache);
+void Scene::testOcclusion(Shader& depthShader, GLStateCache* stateCache) {
+	if (!enableOcclusionCulling || mOcclusionNodes == OcclusionNodes::None) return;
+	// The proxies are in this model's space: its block of the matrices ring
+	bindUniforms();
+	mOcclusionCuller.queryHiddenNodes(depthShader, stateCache ? *stateCache : GLStateCache::instance());
 }
 
 } // namespace Graphics
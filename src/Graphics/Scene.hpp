@@ -4,12 +4,18 @@
 #include <glad/glad.h>
 #include <glm/gtc/matrix_transform.hpp>
 #include <cstdio>  // For sscanf
+#include <algorithm>
+#include <iterator>
+#include <memory>
 #include "Graphics/Model.h"
 #include "Graphics/Shader.h"
+#include "Graphics/ShaderVariants.hpp"
 #include "Graphics/RenderUtils.hpp"
 #include "Graphics/UBO.hpp"
 #include "Graphics/Utils.hpp"
 #include "Graphics/Culling/OcclusionCuller.hpp"
+#include "Graphics/Culling/SoftwareOcclusion.hpp"
+#include "Graphics/Profiling/ProfilingData.hpp"
 
 namespace Graphics {
 
@@ -27,6 +33,37 @@ struct Light {
 	glm::vec3 color = glm::vec3(5.0f);
 };
 
+/// Octree leaves of one object inside the frustum of one view, with what the point LODs need per leaf.
+/// Built by Scene::cullLeaves() from plain values, so the frame pipeline can build it off the GL thread.
+struct LeafVisibility {
+	std::vector<size_t> leaves;            // Leaves inside the frustum (cluster indices)
+	std::vector<float> spherePixels;       // Per entry: largest projected sphere radius (pixels)
+	std::vector<unsigned int> impostors;   // Per entry: impostors worth drawing
+	bool valid = false;                    // False: draw() culls the leaves itself
+};
+
+/// Culling outcome of one node in the last draw(), for the culling debug overlay. A node is an octree
+/// leaf of a point cloud (the whole cloud without leaves) or a mesh of a mesh model.
+struct CullingNode {
+	enum State : uint8_t {
+		FrustumCulled,  // Outside the frustum (or the object was culled)
+		Occluded,       // Rejected by the CPU Hi-Z buffer
+		Hidden,         // Submitted under conditional rendering: its last occlusion query found it hidden
+		Drawn
+	};
+	uint8_t state = FrustumCulled;
+	uint8_t lod = 0;  // Drawn / Hidden: detail steps below full (mesh LOD level, impostor halvings, coarser icosphere)
+};
+
+/// One instanced draw of a same-model run: one mesh at one LOD level for up to
+/// InstancesUBO::kMaxInstances objects, whose model matrices fill one block of the World's instances ring.
+struct MeshInstances {
+	uint32_t mesh = 0;        // Index into the model's meshes
+	int lod = -1;             // LOD level (-1 = full detail)
+	unsigned int block = 0;   // Block of the instances ring
+	unsigned int count = 0;   // Instances in the block
+};
+
 class Scene {
 public:
 	Scene() = default;
@@ -42,11 +79,31 @@ public:
 		  showBoundingBox(other.showBoundingBox), enableFrustumCulling(other.enableFrustumCulling),
 		  enableEarlyZPrepass(other.enableEarlyZPrepass), enableSpatialIndexing(other.enableSpatialIndexing),
 		  enableOcclusionCulling(other.enableOcclusionCulling),
+		  enableSoftwareOcclusion(other.enableSoftwareOcclusion), showSoftwareOcclusionBuffer(other.showSoftwareOcclusionBuffer),
+		  enableMeshLOD(other.enableMeshLOD), meshLODErrorPixels(other.meshLODErrorPixels),
+		  fullDetail(other.fullDetail), recordCullingNodes(other.recordCullingNodes),
 		  bboxRenderer(std::move(other.bboxRenderer)),
 		  mOcclusionCuller(std::move(other.mOcclusionCuller)),
-          mMatricesUBO(std::move(other.mMatricesUBO)),
-          mMaterialUBO(std::move(other.mMaterialUBO)),
-          mLightingUBO(std::move(other.mLightingUBO)) {}
+		  mOcclusionNodes(other.mOcclusionNodes),
+		  mSoftwareOcclusion(other.mSoftwareOcclusion),
+		  mCpuOccluded(std::move(other.mCpuOccluded)),
+		  mFrustumNodes(std::move(other.mFrustumNodes)),
+		  mSphereLeaves(std::move(other.mSphereLeaves)),
+		  mImpostorLeaves(std::move(other.mImpostorLeaves)),
+		  mImpostorsDrawn(std::move(other.mImpostorsDrawn)),
+		  mRefineRanges(std::move(other.mRefineRanges)),
+		  mLeafScratch(std::move(other.mLeafScratch)),
+		  mCullingNodes(std::move(other.mCullingNodes)),
+		  mMatricesRing(other.mMatricesRing),
+		  mMaterialUBO(std::move(other.mMaterialUBO)),
+		  mLightingUBO(std::move(other.mLightingUBO)),
+		  mMatricesBlock(other.mMatricesBlock),
+		  mUploadedMaterial(other.mUploadedMaterial),
+		  mUploadedLighting(other.mUploadedLighting),
+		  mBlocksUploaded(other.mBlocksUploaded) {
+		std::copy(std::begin(other.mSphereLodSpheres), std::end(other.mSphereLodSpheres), mSphereLodSpheres);
+		std::copy(std::begin(other.mMixedModeLeaves), std::end(other.mMixedModeLeaves), mMixedModeLeaves);
+	}
 	
 	Scene& operator=(Scene&& other) noexcept {
 		if (this != &other) {
@@ -64,33 +121,78 @@ public:
 			enableEarlyZPrepass = other.enableEarlyZPrepass;
 			enableSpatialIndexing = other.enableSpatialIndexing;
 			enableOcclusionCulling = other.enableOcclusionCulling;
+			enableSoftwareOcclusion = other.enableSoftwareOcclusion;
+			showSoftwareOcclusionBuffer = other.showSoftwareOcclusionBuffer;
+			enableMeshLOD = other.enableMeshLOD;
+			meshLODErrorPixels = other.meshLODErrorPixels;
+			fullDetail = other.fullDetail;
+			recordCullingNodes = other.recordCullingNodes;
 			bboxRenderer = std::move(other.bboxRenderer);
 			mOcclusionCuller = std::move(other.mOcclusionCuller);
-            mMatricesUBO = std::move(other.mMatricesUBO);
-            mMaterialUBO = std::move(other.mMaterialUBO);
-            mLightingUBO = std::move(other.mLightingUBO);
+			mOcclusionNodes = other.mOcclusionNodes;
+			mSoftwareOcclusion = other.mSoftwareOcclusion;
+			mCpuOccluded = std::move(other.mCpuOccluded);
+			mFrustumNodes = std::move(other.mFrustumNodes);
+			mSphereLeaves = std::move(other.mSphereLeaves);
+			mImpostorLeaves = std::move(other.mImpostorLeaves);
+			mImpostorsDrawn = std::move(other.mImpostorsDrawn);
+			mRefineRanges = std::move(other.mRefineRanges);
+			mLeafScratch = std::move(other.mLeafScratch);
+			mCullingNodes = std::move(other.mCullingNodes);
+			std::copy(std::begin(other.mSphereLodSpheres), std::end(other.mSphereLodSpheres), mSphereLodSpheres);
+			std::copy(std::begin(other.mMixedModeLeaves), std::end(other.mMixedModeLeaves), mMixedModeLeaves);
+			mMatricesRing = other.mMatricesRing;
+			mMaterialUBO = std::move(other.mMaterialUBO);
+			mLightingUBO = std::move(other.mLightingUBO);
+			mMatricesBlock = other.mMatricesBlock;
+			mUploadedMaterial = other.mUploadedMaterial;
+			mUploadedLighting = other.mUploadedLighting;
+			mBlocksUploaded = other.mBlocksUploaded;
 		}
 		return *this;
 	}
 
-	Model model;
+	std::shared_ptr<Model> model = std::make_shared<Model>();  // Shared by every object of the World that shows the same file
 	Material material;
 	Light light;
 	glm::mat4 modelMatrix = glm::mat4(1.0f);
 	float pointSize = 2.0f;  // Point size for point cloud rendering (in pixels)
 	ColorMode colorMode = ColorMode::Uniform;  // Color rendering mode
 	PointCloudRenderMode pointCloudMode = PointCloudRenderMode::Points;  // Point cloud rendering mode (can be overridden by auto-LOD)
-	bool autoLOD = false;  // Auto-select rendering mode based on camera distance (default: manual selection)
-	float sphereRadius = 0.01f;  // Radius for instanced spheres
+	bool autoLOD = false;  // Auto-select rendering mode per octree leaf from projected size (whole model by distance without an octree)
+	float sphereRadius = 0.01f;  // Radius for instanced spheres and sphere impostors (object space)
 	bool showBoundingBox = false;  // Show AABB and axes
 	bool enableFrustumCulling = true;  // Enable frustum culling (skip rendering outside view)
 	bool enableEarlyZPrepass = false;  // Enable Early-Z depth prepass (two-pass rendering for better Early-Z efficiency)
 	bool enableSpatialIndexing = true;  // Enable spatial indexing (octree) for point cloud culling and LOD
 	bool enableOcclusionCulling = false;  // Enable occlusion culling using hardware queries (skip fully occluded objects)
+	bool enableSoftwareOcclusion = false;  // Test nodes against a CPU-rasterized Hi-Z buffer of the largest occluders (same frame)
+	bool showSoftwareOcclusionBuffer = false;  // Debug view of that buffer in the UI
+	bool enableMeshLOD = true;  // Use simplified mesh levels when their projected error is small enough
+	float meshLODErrorPixels = 1.0f;  // Max screen-space error (pixels) allowed when picking a mesh LOD
+	bool fullDetail = false;  // Set by the renderer for still frames: no mesh LOD, finest icospheres, no approximate culling
+	bool recordCullingNodes = false;  // Set by the renderer while the culling overlay is on: keep draw()'s per-node results
 	BoundingBoxRenderer bboxRenderer;  // Renderer for bounding box visualization
 	
-	// Occlusion culling helper (manages hardware occlusion queries and proxy geometry)
+	// Occlusion culling helper (per-node hardware occlusion queries and proxy geometry)
 	OcclusionCuller mOcclusionCuller;
+
+	// What the occlusion culler's nodes currently are (rebuilt when the draw path changes)
+	enum class OcclusionNodes { None, PointClusters, Meshes, Model };
+	OcclusionNodes mOcclusionNodes = OcclusionNodes::None;
+
+	// The World's CPU occluder buffer for this frame (nullptr: CPU occlusion off or nothing rasterized)
+	SoftwareOcclusionBuffer* mSoftwareOcclusion = nullptr;
+	std::vector<uint8_t> mCpuOccluded;  // Per culling node: 0 untested, 1 visible, 2 occluded (one buffer test per frame)
+	std::vector<size_t> mFrustumNodes;  // Scratch: leaves auto LOD draws as GL_POINTS
+	std::vector<std::pair<size_t, int>> mSphereLeaves;  // Scratch: visible clusters and their icosphere level
+	std::vector<std::pair<size_t, unsigned int>> mImpostorLeaves;  // Scratch: clusters drawn as impostors and their LOD count
+	std::vector<unsigned int> mImpostorsDrawn;  // Per cluster: impostors in the current image (0 = leaf not drawn as impostors)
+	std::vector<PointClusterRange> mRefineRanges;  // Scratch: ranges added by refine()
+	LeafVisibility mLeafScratch;  // Leaves culled by draw() when no frame packet supplies them
+	std::vector<CullingNode> mCullingNodes;  // Per node, last draw() (empty unless recordCullingNodes)
+	unsigned int mSphereLodSpheres[Model::kSphereLodCount] = {};  // Instanced spheres drawn per level last frame
+	unsigned int mMixedModeLeaves[3] = {};  // Auto LOD: leaves drawn as points / impostors / spheres last frame
 	
 	// LOD distance thresholds (auto-LOD uses these to select rendering mode)
 	static constexpr float LOD_FAR_THRESHOLD = 50.0f;   // >50 units: use GL_POINTS
@@ -98,21 +200,26 @@ public:
 	
 
 	/// Main rendering method. Draws the scene with full shading.
-	/// @param shader Main PBR shader for regular meshes
-	/// @param sphereImpostorShader Optional shader for sphere impostor rendering (point clouds)
-	/// @param instancedSphereShader Optional shader for instanced sphere rendering (point clouds)
+	/// The permutation of each shader is picked from colorMode, wireframe and the model type.
+	/// @param shaders Main PBR shader variants (meshes and GL_POINTS)
+	/// @param sphereImpostorShaders Optional shader variants for sphere impostor rendering (point clouds)
+	/// @param instancedSphereShaders Optional shader variants for instanced sphere rendering (point clouds)
 	/// @param frameState Pre-computed frame state (view, proj, viewProj, camPos)
 	/// @param wireframe Enable wireframe rendering (for regular meshes only)
-	/// @param profilingData Optional pointer to ProfilingData struct for performance metrics
-	/// @param stateCache Optional OpenGL state cache to minimize redundant state changes
-    void draw(Shader& shader, Shader* sphereImpostorShader, Shader* instancedSphereShader, const FrameState& frameState, bool wireframe = false, void* profilingData = nullptr, [[maybe_unused]] GLStateCache* stateCache = nullptr);
+	/// @param profilingData Optional profiling counters (draw calls, triangles, points)
+	/// @param leaves Optional octree leaves culled ahead for this frameState (else culled here)
+	void draw(ShaderVariants& shaders, ShaderVariants* sphereImpostorShaders, ShaderVariants* instancedSphereShaders, const FrameState& frameState, bool wireframe = false, ProfilingData* profilingData = nullptr, const LeafVisibility* leaves = nullptr);
 	
 	/// Depth-only pass for Early-Z prepass. Renders only depth buffer, no color.
 	/// This populates the depth buffer first, so the main pass can skip expensive fragment shader work on occluded fragments.
-	/// @param depthShader Minimal depth-only shader
+	/// Point clouds draw the same points, impostors and spheres as draw() with depth-only programs,
+	/// so the impostor and sphere shading runs once per visible pixel instead of once per splat.
+	/// @param depthShader Minimal depth-only shader (meshes and GL_POINTS)
+	/// @param impostorDepthShader Ray-cast-only sphere impostor shader (point clouds)
+	/// @param sphereDepthShader Depth-only instanced sphere shader (point clouds)
 	/// @param frameState Pre-computed frame state (view, proj, viewProj, camPos)
-	/// @param stateCache Optional OpenGL state cache to minimize redundant state changes
-    void drawDepthOnly(Shader& depthShader, const FrameState& frameState, [[maybe_unused]] GLStateCache* stateCache = nullptr);
+	/// @param leaves Optional octree leaves culled ahead for this frameState (the ones draw() gets)
+	void drawDepthOnly(Shader& depthShader, Shader* impostorDepthShader, Shader* sphereDepthShader, const FrameState& frameState, const LeafVisibility* leaves = nullptr);
 	
 	void drawBoundingBox(unsigned int lineShaderId, const glm::mat4& view, const glm::mat4& proj) const {
 		if (showBoundingBox && bboxRenderer.valid()) {
@@ -121,8 +228,8 @@ public:
 	}
 	
 	void updateBoundingBox() {
-		if (!model.meshes().empty()) {
-			bboxRenderer.create(model.min(), model.max());
+		if (!model->meshes().empty()) {
+			bboxRenderer.create(model->min(), model->max());
 		}
 	}
 
@@ -130,32 +237,136 @@ public:
 		mOcclusionCuller.initialize();
 	}
 	
-	/// Test if the scene's bounding box is occluded using hardware occlusion queries.
-	/// @param frameState Pre-computed frame state (view, proj, viewProj, camPos)
+	/// Issue bounding-box occlusion queries for the nodes draw() submitted as hidden this frame.
+	/// Call after the main pass; draw() consumes the results in later frames without waiting for them.
 	/// @param depthShader Depth shader for occlusion proxy rendering
 	/// @param stateCache Optional OpenGL state cache to minimize redundant state changes
-	/// @return true if visible (not occluded), false if occluded
-	bool testOcclusion(const FrameState& frameState, Shader& depthShader, [[maybe_unused]] GLStateCache* stateCache = nullptr);
+	void testOcclusion(Shader& depthShader, GLStateCache* stateCache = nullptr);
+
+	/// True if this object's meshes may be drawn instanced with other objects of the same model:
+	/// nothing of the draw is per object but the model matrix, the mesh LODs and CPU occlusion
+	/// (no hardware occlusion queries, no culling overlay records).
+	bool instanceable() const { return !model->isPointCloud() && !enableOcclusionCulling && !recordCullingNodes; }
+
+	/// Returned by instanceLod() for a mesh the CPU occlusion buffer hides.
+	static constexpr int kMeshOccluded = -2;
+
+	/// LOD level draw() would pick for a mesh this frame (-1 = full detail), or kMeshOccluded.
+	/// Call after beginOcclusionFrame().
+	int instanceLod(size_t mesh, const FrameState& frameState);
+
+	/// Draw the meshes of an instanced run with this object's view, material and lighting blocks.
+	/// @param shader INSTANCED permutation (shading or depth-only)
+	/// @param instances The ring the draws' blocks were pushed to (bound to binding = 3)
+	/// @param draws Instanced draws of the run
+	/// @param count Entries in draws
+	/// @param wireframe Feed the wireframe overlay (shader must be a WIREFRAME permutation)
+	/// @param profilingData Optional profiling counters
+	void drawInstances(Shader& shader, const UniformRing& instances, const MeshInstances* draws, size_t count, bool wireframe, ProfilingData* profilingData = nullptr);
+
+	/// Progressive refinement: draw the next slice of the impostors the LOD left out of the last draw(),
+	/// on top of its image (same view, after updateUBOs()). Each call at most doubles what a leaf shows, within
+	/// Config::RefinementImpostorsPerFrame, so the full cloud is reached in a few frames.
+	/// @param impostorShaders Sphere impostor shader variants
+	/// @param profilingData Optional profiling counters
+	/// @return Impostors added; 0 once every leaf is complete
+	unsigned int refine(ShaderVariants& impostorShaders, ProfilingData* profilingData = nullptr);
+
+	const OcclusionCuller& occlusionCuller() const { return mOcclusionCuller; }
+	/// Test this frame's nodes against the given CPU occlusion buffer (shared by every object, already
+	/// rasterized), or nullptr to skip CPU occlusion. Call once per frame before any pass.
+	void beginOcclusionFrame(SoftwareOcclusionBuffer* buffer);
+	/// Instanced spheres drawn per icosphere level in the last frame (Model::kSphereLodCount entries).
+	const unsigned int* sphereLodStats() const { return mSphereLodSpheres; }
+	/// Auto LOD: visible octree leaves drawn as points, impostors and instanced spheres in the last frame.
+	const unsigned int* mixedModeStats() const { return mMixedModeLeaves; }
+
+	/// Per-node culling results of the last draw() (empty unless recordCullingNodes).
+	const std::vector<CullingNode>& cullingNodes() const { return mCullingNodes; }
+	/// Object-space bounds of a node of cullingNodes().
+	void cullingNodeBounds(size_t node, glm::vec3& outMin, glm::vec3& outMax) const;
 
 	void initializeUBOs() {
-		mMatricesUBO.create();
 		mMaterialUBO.create();
 		mLightingUBO.create();
 		
 		// Allocate UBO buffers
-		mMatricesUBO.setData(GL_UNIFORM_BUFFER, sizeof(MatricesUBO), nullptr, GL_DYNAMIC_DRAW);
 		mMaterialUBO.setData(GL_UNIFORM_BUFFER, sizeof(MaterialUBO), nullptr, GL_DYNAMIC_DRAW);
 		mLightingUBO.setData(GL_UNIFORM_BUFFER, sizeof(LightingUBO), nullptr, GL_DYNAMIC_DRAW);
-		
-		// Bind to binding points (persistent binding - shaders can reference these)
-		// Note: UBOs are ready to use, but current shaders still use individual uniforms
-		// Shaders can be updated to use UBOs for better performance
-		mMatricesUBO.bindBase(0);   // binding = 0
-		mMaterialUBO.bindBase(1);   // binding = 1
-		mLightingUBO.bindBase(2);   // binding = 2
+		mBlocksUploaded = false;
 	}
 
+	/// Stage this frame's uniforms once, before any pass: the object's matrices go into the next block
+	/// of the World's matrices ring (uploaded once for all objects); material and lighting are only
+	/// sent when they differ from what the buffers already hold.
+	/// @param frameState Frame state shared by every pass of the frame
+	/// @param matricesRing Ring the caller uploads after every object pushed its block
+	void updateUBOs(const FrameState& frameState, UniformRing& matricesRing);
+
+	/// Copy the render settings (material, light, modes and culling switches) of another object.
+	/// Transform, model and per-object culling state are kept.
+	void copySettingsFrom(const Scene& other);
+
+	/// Program family this object is drawn with this frame (render queue key field):
+	/// 0 meshes, 1 GL_POINTS, 2 sphere impostors, 3 instanced spheres, 4 auto LOD (mixed).
+	unsigned int programKey() const;
+
+	/// Hash of the material block last staged by updateUBOs() (render queue key field).
+	uint32_t materialKey() const;
+
+	/// Cull the octree leaves of a point cloud for one view. Touches no Scene or GL state (thread-safe).
+	/// @param geometry Model whose leaves are culled
+	/// @param transform Model matrix of the object
+	/// @param radius Sphere radius (object space) for the LOD metrics
+	/// @param frameState View to cull for
+	/// @param out Leaves inside the frustum and their LOD inputs
+	static void cullLeaves(const Model& geometry, const glm::mat4& transform, float radius, const FrameState& frameState, LeafVisibility& out);
+
 private:
+	// Point the occlusion culler at the given node set; false if per-node culling is off or unsupported
+	bool prepareOcclusionNodes(OcclusionNodes nodes);
+	// Set the wireframe overlay uniforms on a bound WIREFRAME permutation and feed it the mesh lookups
+	void beginWireframe(Shader& shader) const;
+	// True if a culling node is hidden in the CPU occlusion buffer; tested once per frame, the prepass
+	// and the main pass share the result
+	bool cpuOccluded(size_t node);
+	// Programs of one point-cloud pass: shading (main pass) or depth-only (Early-Z prepass)
+	struct PointPrograms {
+		Shader* points = nullptr;
+		Shader* impostors = nullptr;
+		Shader* spheres = nullptr;
+	};
+	// Draw the point cloud in its render mode. A depth-only pass makes the same LOD and culling
+	// choices but skips hardware occlusion (whose queries belong to the main pass) and profiling.
+	void drawPointCloud(const PointPrograms& programs, const FrameState& frameState, bool depthOnly, const LeafVisibility* leaves, ProfilingData* profData);
+	// Culling debug overlay: node results of the current draw(), all no-ops unless recordCullingNodes
+	size_t cullingNodeCount() const;
+	void resetCullingNodes();
+	void recordNode(size_t node, CullingNode::State state, unsigned int lod = 0);
+	void recordWholeCloud(bool occlusion);  // One draw submitted every node
+	void hideDrawnCullingNodes();           // The whole-model occlusion node was drawn conditionally
+	unsigned int meshLodStep(size_t mesh, const FrameState& frameState, float maxErrorPixels) const;
+	// Times count can be doubled without exceeding full (impostor LOD steps)
+	static unsigned int halvings(unsigned int count, unsigned int full);
+	// Leaves inside the frustum: the precomputed set if valid, else culled into mLeafScratch
+	const LeafVisibility& visibleLeaves(const FrameState& frameState, const LeafVisibility* leaves);
+	// Draw the octree leaves one by one (frustum, CPU and hardware occlusion culled as enabled)
+	// as GL_POINTS or, with impostors set, as LOD-subsampled sphere impostors
+	void drawPointClusters(const FrameState& frameState, bool occlusion, bool cpuOcclusion, bool impostors, const LeafVisibility* leaves, ProfilingData* profData);
+	// Frustum/CPU-occlusion cull the octree leaves and draw them as instanced spheres bucketed by projected radius
+	void drawInstancedSphereLods(const FrameState& frameState, bool cpuOcclusion, const LeafVisibility* leaves, ProfilingData* profData);
+	// Auto LOD over the octree: GL_POINTS, impostors or instanced spheres per visible leaf, one batch per mode
+	void drawMixedPointModes(const FrameState& frameState, Shader& pointShader, Shader& impostorShader, Shader& sphereShader, bool cpuOcclusion, const LeafVisibility* leaves, ProfilingData* profData);
+	// Largest projected sphere radius (pixels) inside a leaf, measured at its nearest possible distance
+	static float leafSpherePixels(const PointCluster& cluster, const glm::mat4& transform, float radius, const FrameState& frameState);
+	// Icosphere level for a projected sphere radius (Config::InstancedSphereLodPixels)
+	static int sphereLevel(float radiusPixels);
+	// Impostors worth drawing for one leaf: enough to cover its screen footprint ImpostorLodOverdraw times
+	static unsigned int impostorLodCount(const PointCluster& cluster, const glm::mat4& transform, float radius, const FrameState& frameState);
+
+	// Mesh LOD error bound for this frame (0 = full detail)
+	float meshLodError() const { return enableMeshLOD && !fullDetail ? meshLODErrorPixels : 0.0f; }
+
 	// Helper function to set up shader-specific uniforms (UBOs handle most uniforms)
 	void setupShaderUniforms(Shader& shader, float pointSizeOrRadius = 0.0f) const {
 		// UBOs handle matrices, material, and lighting
@@ -165,44 +376,21 @@ private:
 		}
 	}
 	
-	void updateUBOs(const glm::mat4& modelMat, const glm::mat4& view, const glm::mat4& proj, const glm::vec3& camPos) {
-		// Update matrices UBO
-		MatricesUBO matricesData;
-		matricesData.model = modelMat;
-		matricesData.view = view;
-		matricesData.proj = proj;
-		matricesData.viewProj = proj * view;
-		matricesData.camPos = glm::vec4(camPos, 1.0f);
-		mMatricesUBO.updateData(0, sizeof(MatricesUBO), &matricesData);
-		
-		// Update material UBO
-		MaterialUBO materialData;
-		materialData.albedo = glm::vec4(material.albedo, material.metallic);
-		// Pack params: roughness, ao, colorMode (as float bits), scalarMin
-		materialData.params.x = material.roughness;
-		materialData.params.y = material.ao;
-		materialData.params.z = static_cast<float>(static_cast<int>(colorMode));
-		materialData.params.w = model.scalarMin();
-		materialData.scalars.x = model.scalarMax();
-		materialData.scalars.y = 0.0f;
-		materialData.scalars.z = 0.0f;
-		materialData.scalars.w = 0.0f;
-		materialData.skyColor = glm::vec4(material.skyColor, 0.0f);
-		materialData.groundColor = glm::vec4(material.groundColor, 0.0f);
-		mMaterialUBO.updateData(0, sizeof(MaterialUBO), &materialData);
-		
-		// Update lighting UBO
-		LightingUBO lightingData;
-		lightingData.lightDir = glm::vec4(light.dir, 0.0f);
-		lightingData.lightColor = glm::vec4(light.color, 0.0f);
-		mLightingUBO.updateData(0, sizeof(LightingUBO), &lightingData);
+	// Bind this object's uniform blocks: its range of the matrices ring (binding = 0),
+	// material (1) and lighting (2). The state cache skips what is already bound.
+	void bindUniforms() const {
+		if (mMatricesRing && mMatricesRing->valid()) mMatricesRing->bind(0, mMatricesBlock);
+		mMaterialUBO.bindBase(1);
+		mLightingUBO.bindBase(2);
 	}
 
-private:
-	// Uniform Buffer Objects
-	UniformBuffer mMatricesUBO;   // binding = 0
+	const UniformRing* mMatricesRing = nullptr;  // binding = 0, the World's ring (set by updateUBOs)
 	UniformBuffer mMaterialUBO;  // binding = 1
 	UniformBuffer mLightingUBO;   // binding = 2
+	unsigned int mMatricesBlock = 0;  // This frame's block in mMatricesRing
+	MaterialUBO mUploadedMaterial{};  // Contents of mMaterialUBO (dirty check)
+	LightingUBO mUploadedLighting{};  // Contents of mLightingUBO (dirty check)
+	bool mBlocksUploaded = false;     // False until material and lighting were sent once
 };
 
 } // namespace Graphics
@@ -3,8 +3,13 @@
 #include <glad/glad.h>
 #include <glm/gtc/type_ptr.hpp>
 
+#include "Graphics/Utils.hpp"
+
 namespace Graphics {
 
+// KHR_parallel_shader_compile / ARB_parallel_shader_compile (same value); not in the GLAD profile
+static constexpr GLenum kCompletionStatusKHR = 0x91B1;
+
 static bool compileShaderStage(GLenum type, const char* src, unsigned int& outId, std::string& outErr) {
 	outId = glCreateShader(type);
 	glShaderSource(outId, 1, &src, nullptr);
@@ -23,52 +28,91 @@ static bool compileShaderStage(GLenum type, const char* src, unsigned int& outId
 }
 
 Shader::~Shader() {
+	release();
+}
+
+void Shader::release() {
+	for (unsigned int& stage : mPendingStages) {
+		if (stage != 0) { glDeleteShader(stage); stage = 0; }
+	}
 	if (mProgram != 0) {
+		GLStateCache::instance().onProgramDeleted(mProgram);
 		glDeleteProgram(mProgram);
+		mProgram = 0;
 	}
+	mUniformLocationCache.clear();
 }
 
 Shader::Shader(Shader&& other) noexcept {
 	mProgram = other.mProgram;
 	other.mProgram = 0;
+	for (int i = 0; i < 2; ++i) { mPendingStages[i] = other.mPendingStages[i]; other.mPendingStages[i] = 0; }
 	mUniformLocationCache = std::move(other.mUniformLocationCache);
 }
 
 Shader& Shader::operator=(Shader&& other) noexcept {
 	if (this != &other) {
-		if (mProgram) glDeleteProgram(mProgram);
+		release();
 		mProgram = other.mProgram;
 		other.mProgram = 0;
+		for (int i = 0; i < 2; ++i) { mPendingStages[i] = other.mPendingStages[i]; other.mPendingStages[i] = 0; }
 		mUniformLocationCache = std::move(other.mUniformLocationCache);
 	}
 	return *this;
 }
 
 bool Shader::compileFromSource(const char* vertexSrc, const char* fragmentSrc, std::string& outError) {
-	unsigned int vs = 0, fs = 0;
-	if (!compileShaderStage(GL_VERTEX_SHADER, vertexSrc, vs, outError)) return false;
-	if (!compileShaderStage(GL_FRAGMENT_SHADER, fragmentSrc, fs, outError)) {
-		glDeleteShader(vs);
-		return false;
-	}
+	compileAsync(vertexSrc, fragmentSrc);
+	return finishLink(outError);
+}
 
+void Shader::compileAsync(const char* vertexSrc, const char* fragmentSrc) {
+	release();
+	const GLenum types[2] = {GL_VERTEX_SHADER, GL_FRAGMENT_SHADER};
+	const char* sources[2] = {vertexSrc, fragmentSrc};
 	mProgram = glCreateProgram();
-	glAttachShader(mProgram, vs);
-	glAttachShader(mProgram, fs);
+	if (glProgramParameteri) glProgramParameteri(mProgram, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);  // Keep it cacheable
+	for (int i = 0; i < 2; ++i) {
+		mPendingStages[i] = glCreateShader(types[i]);
+		glShaderSource(mPendingStages[i], 1, &sources[i], nullptr);
+		glCompileShader(mPendingStages[i]);
+		glAttachShader(mProgram, mPendingStages[i]);
+	}
+	// No status query here: that is what would wait for the compiler
 	glLinkProgram(mProgram);
+}
 
+bool Shader::linkReady() const {
+	if (mProgram == 0 || mPendingStages[0] == 0 || !parallelCompileSupported()) return true;
+	GLint done = GL_TRUE;
+	glGetProgramiv(mProgram, kCompletionStatusKHR, &done);
+	return done == GL_TRUE;
+}
+
+bool Shader::finishLink(std::string& outError) {
+	if (mProgram == 0 || mPendingStages[0] == 0) { outError = "No program is being linked"; return false; }
 	int linked = 0;
 	glGetProgramiv(mProgram, GL_LINK_STATUS, &linked);
-	glDeleteShader(vs);
-	glDeleteShader(fs);
 	if (!linked) {
+		// A stage that failed to compile explains more than the link log
 		char log[2048];
-		glGetProgramInfoLog(mProgram, sizeof(log), nullptr, log);
-		outError.assign(log);
-		glDeleteProgram(mProgram);
-		mProgram = 0;
+		outError.clear();
+		for (unsigned int stage : mPendingStages) {
+			int compiled = 0;
+			glGetShaderiv(stage, GL_COMPILE_STATUS, &compiled);
+			if (compiled) continue;
+			glGetShaderInfoLog(stage, sizeof(log), nullptr, log);
+			outError.assign(log);
+			break;
+		}
+		if (outError.empty()) {
+			glGetProgramInfoLog(mProgram, sizeof(log), nullptr, log);
+			outError.assign(log);
+		}
+		release();
 		return false;
 	}
+	for (unsigned int& stage : mPendingStages) { glDeleteShader(stage); stage = 0; }
 
 	// Bind UBOs for OpenGL 3.3 compatibility (no layout binding qualifier)
 	bindUBOs();
@@ -77,6 +121,11 @@ bool Shader::compileFromSource(const char* vertexSrc, const char* fragmentSrc, s
 	return true;
 }
 
+bool Shader::parallelCompileSupported() {
+	static const bool supported = hasGLExtension("GL_KHR_parallel_shader_compile") || hasGLExtension("GL_ARB_parallel_shader_compile");
+	return supported;
+}
+
 bool Shader::compileFromSource(const char* vertexSrc, const char* geometrySrc, const char* fragmentSrc, std::string& outError) {
 	unsigned int vs = 0, gs = 0, fs = 0;
 	if (!compileShaderStage(GL_VERTEX_SHADER, vertexSrc, vs, outError)) return false;
@@ -90,7 +139,9 @@ bool Shader::compileFromSource(const char* vertexSrc, const char* geometrySrc, c
 		return false;
 	}
 
+	release();
 	mProgram = glCreateProgram();
+	if (glProgramParameteri) glProgramParameteri(mProgram, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);  // Keep it cacheable
 	glAttachShader(mProgram, vs);
 	glAttachShader(mProgram, gs);
 	glAttachShader(mProgram, fs);
@@ -117,12 +168,46 @@ bool Shader::compileFromSource(const char* vertexSrc, const char* geometrySrc, c
 	return true;
 }
 
-void Shader::use() const {
-	static unsigned int sActiveProgram = 0;
-	if (sActiveProgram != mProgram) {
-		glUseProgram(mProgram);
-		sActiveProgram = mProgram;
+bool Shader::loadBinary(unsigned int format, const void* data, size_t size) {
+	release();
+	if (!glProgramBinary || !data || size == 0) return false;
+	mProgram = glCreateProgram();
+	glProgramBinary(mProgram, format, data, static_cast<GLsizei>(size));
+	int linked = 0;
+	glGetProgramiv(mProgram, GL_LINK_STATUS, &linked);
+	if (!linked) {
+		// Driver update or different GPU: the caller falls back to source
+		release();
+		return false;
 	}
+	bindUBOs();
+	return true;
+}
+
+bool Shader::getBinary(unsigned int& outFormat, std::vector<unsigned char>& outData) const {
+	if (mProgram == 0 || !glGetProgramBinary) return false;
+	int length = 0;
+	glGetProgramiv(mProgram, GL_PROGRAM_BINARY_LENGTH, &length);
+	if (length <= 0) return false;
+	outData.resize(static_cast<size_t>(length));
+	GLenum format = 0;
+	GLsizei written = 0;
+	glGetProgramBinary(mProgram, length, &written, &format, outData.data());
+	if (written <= 0) return false;
+	outData.resize(static_cast<size_t>(written));
+	outFormat = format;
+	return true;
+}
+
+bool Shader::binariesSupported() {
+	if (!glGetProgramBinary || !glProgramBinary || !glProgramParameteri) return false;
+	GLint formats = 0;
+	glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+	return formats > 0;
+}
+
+void Shader::use() const {
+	GLStateCache::instance().useProgram(mProgram);
 }
 
 int Shader::getUniformLocation(const std::string& name) const {
@@ -188,6 +273,12 @@ void Shader::bindUBOs() {
 	if (lightingIndex != GL_INVALID_INDEX) {
 		glUniformBlockBinding(mProgram, lightingIndex, 2);
 	}
+
+	// InstancesUBO -> binding 3 (INSTANCED permutations)
+	unsigned int instancesIndex = glGetUniformBlockIndex(mProgram, "InstancesUBO");
+	if (instancesIndex != GL_INVALID_INDEX) {
+		glUniformBlockBinding(mProgram, instancesIndex, 3);
+	}
 }
 
 } // namespace Graphics
@@ -2,6 +2,7 @@
 
 #include <string>
 #include <unordered_map>
+#include <vector>
 #include <glm/glm.hpp>
 
 namespace Graphics {
@@ -26,6 +27,24 @@ public:
 	/// @return true if successful, false on error
 	bool compileFromSource(const char* vertexSrc, const char* fragmentSrc, std::string& outError);
 	
+	/// Start compiling and linking a vertex/fragment program without waiting for the driver.
+	/// With KHR_parallel_shader_compile the work runs on driver threads; poll linkReady() and call
+	/// finishLink() before using the program.
+	/// @param vertexSrc Vertex shader source code
+	/// @param fragmentSrc Fragment shader source code
+	void compileAsync(const char* vertexSrc, const char* fragmentSrc);
+
+	/// Whether finishLink() returns without blocking (always true without KHR_parallel_shader_compile).
+	bool linkReady() const;
+
+	/// Complete a compileAsync() program: check its status and bind its UBOs.
+	/// @param outError Compile log of the first failing stage, else the link log
+	/// @return false on error (the program is released)
+	bool finishLink(std::string& outError);
+
+	/// Whether the driver compiles and links on its own threads (KHR/ARB_parallel_shader_compile).
+	static bool parallelCompileSupported();
+
 	/// Compile shader from source strings. Creates and links a vertex/geometry/fragment shader program.
 	/// @param vertexSrc Vertex shader source code
 	/// @param geometrySrc Geometry shader source code
@@ -34,6 +53,23 @@ public:
 	/// @return true if successful, false on error
 	bool compileFromSource(const char* vertexSrc, const char* geometrySrc, const char* fragmentSrc, std::string& outError);
 	
+	/// Create the program from a binary previously returned by getBinary() (same driver).
+	/// @param format Binary format reported by getBinary()
+	/// @param data Binary contents
+	/// @param size Size in bytes
+	/// @return false if the driver rejected the binary (the program stays empty)
+	bool loadBinary(unsigned int format, const void* data, size_t size);
+
+	/// Retrieve the linked program as a driver-specific binary.
+	/// @param outFormat Binary format to pass back to loadBinary()
+	/// @param outData Binary contents
+	/// @return false if the program is empty or the driver cannot provide a binary
+	bool getBinary(unsigned int& outFormat, std::vector<unsigned char>& outData) const;
+
+	/// Whether the context can save and load program binaries (GL 4.1 / ARB_get_program_binary with
+	/// at least one binary format).
+	static bool binariesSupported();
+
 	/// Make this shader active (equivalent to glUseProgram).
 	/// Also binds UBOs to their binding points.
 	void use() const;
@@ -74,7 +110,9 @@ public:
 
 private:
 	void bindUBOs();  // Bind UBO blocks to binding points (OpenGL 3.3 compatibility)
+	void release();   // Delete the program (if any)
 	unsigned int mProgram = 0;
+	unsigned int mPendingStages[2] = {0, 0};  // Stages of a compileAsync() program until finishLink()
 	mutable std::unordered_map<std::string, int> mUniformLocationCache;
 	int getUniformLocation(const std::string& name) const;
 };
@@ -0,0 +1,81 @@
+#include "Graphics/ShaderHotReload.hpp"
+#include "Graphics/ProgramCache.hpp"
+#include "Graphics/Utils.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+
+namespace Graphics {
+
+bool ShaderHotReload::start(const std::string& directory, std::string& outError) {
+	return mWatcher.start(directory, outError);
+}
+
+void ShaderHotReload::startJob(const std::vector<Program>& programs, size_t program) {
+	const Program& target = programs[program];
+	Job job;
+	job.program = program;
+	if (!readTextFile(target.vert, job.vert) || !readTextFile(target.frag, job.frag)) {
+		std::cerr << "Shader reload: cannot read " << target.vert << " / " << target.frag << "\n";
+		return;
+	}
+	if (target.variants) {
+		job.keys = target.variants->builtKeys();
+		if (job.keys.empty()) job.keys.push_back(ShaderVariants::Key{});
+		job.shaders.resize(job.keys.size());
+		for (size_t i = 0; i < job.keys.size(); ++i) {
+			std::string defines = ShaderVariants::defines(job.keys[i]);
+			std::string vs = ProgramCache::injectDefines(job.vert, defines);
+			std::string fs = ProgramCache::injectDefines(job.frag, defines);
+			job.shaders[i].compileAsync(vs.c_str(), fs.c_str());
+		}
+	} else {
+		job.shaders.resize(1);
+		std::string vs = ProgramCache::injectDefines(job.vert, target.defines);
+		std::string fs = ProgramCache::injectDefines(job.frag, target.defines);
+		job.shaders[0].compileAsync(vs.c_str(), fs.c_str());
+	}
+
+	// A newer save supersedes a rebuild still in flight
+	auto it = std::find_if(mJobs.begin(), mJobs.end(), [program](const Job& j) { return j.program == program; });
+	if (it != mJobs.end()) *it = std::move(job);
+	else mJobs.push_back(std::move(job));
+}
+
+unsigned int ShaderHotReload::update(const std::vector<Program>& programs, double now, bool reloadAll) {
+	std::vector<std::string> changed = mWatcher.poll(now);
+	for (size_t i = 0; i < programs.size(); ++i) {
+		bool affected = reloadAll;
+		for (const std::string& name : changed) {
+			if (std::filesystem::path(programs[i].vert).filename() == name || std::filesystem::path(programs[i].frag).filename() == name) affected = true;
+		}
+		if (affected) startJob(programs, i);
+	}
+
+	unsigned int swapped = 0;
+	for (auto it = mJobs.begin(); it != mJobs.end();) {
+		bool ready = std::all_of(it->shaders.begin(), it->shaders.end(), [](const Shader& s) { return s.linkReady(); });
+		if (!ready) { ++it; continue; }
+
+		const Program& target = programs[it->program];
+		std::string err;
+		bool linked = true;
+		for (Shader& shader : it->shaders) {
+			if (!shader.finishLink(err)) { linked = false; break; }
+		}
+		if (!linked) {
+			std::cerr << "Shader reload error (" << target.name << "): " << err << "\n";
+		} else if (target.variants) {
+			target.variants->adopt(it->vert, it->frag, it->keys, it->shaders);
+			swapped++;
+		} else {
+			*target.shader = std::move(it->shaders[0]);
+			swapped++;
+		}
+		it = mJobs.erase(it);
+	}
+	return swapped;
+}
+
+} // namespace Graphics
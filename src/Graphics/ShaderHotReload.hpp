@@ -0,0 +1,59 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Graphics/Shader.h"
+#include "Graphics/ShaderVariants.hpp"
+#include "Graphics/ShaderWatcher.hpp"
+
+namespace Graphics {
+
+/// Shader hot reload for every program of the renderer.
+/// A saved file under the watched directory starts a rebuild of each program that reads it, through
+/// Shader::compileAsync(); update() swaps a rebuild in only once all of its programs linked (for a
+/// variant set, every permutation in use), so a bad edit leaves the running programs untouched.
+/// With KHR_parallel_shader_compile the render thread never waits on the compiler; without it the
+/// status query of the finished rebuild blocks once, on the frame after the save.
+class ShaderHotReload {
+public:
+	/// A program and the files it is built from. Exactly one of shader / variants is set.
+	struct Program {
+		Shader* shader = nullptr;
+		ShaderVariants* variants = nullptr;
+		const char* vert = nullptr;
+		const char* frag = nullptr;
+		const char* name = nullptr;
+		const char* defines = "";  // Injected after #version (single programs; variants bring their own)
+	};
+
+	/// Start watching the shader directory.
+	/// @return false if it cannot be watched (hot reload stays off)
+	bool start(const std::string& directory, std::string& outError);
+
+	/// Start rebuilds for changed files (every program if reloadAll) and swap in finished ones.
+	/// @param programs The programs to keep current (the same list every call)
+	/// @param now Current time in seconds
+	/// @param reloadAll Rebuild everything (F5)
+	/// @return Programs swapped in by this call
+	unsigned int update(const std::vector<Program>& programs, double now, bool reloadAll);
+
+	/// Rebuilds still compiling.
+	size_t pending() const { return mJobs.size(); }
+
+private:
+	struct Job {
+		size_t program = 0;
+		std::string vert;
+		std::string frag;
+		std::vector<ShaderVariants::Key> keys;  // Variant sets: the permutations being rebuilt
+		std::vector<Shader> shaders;
+	};
+
+	void startJob(const std::vector<Program>& programs, size_t program);
+
+	ShaderWatcher mWatcher;
+	std::vector<Job> mJobs;
+};
+
+} // namespace Graphics
@@ -0,0 +1,79 @@
+#include "Graphics/ShaderVariants.hpp"
+#include "Graphics/ProgramCache.hpp"
+
+#include <iostream>
+
+namespace Graphics {
+
+size_t ShaderVariants::index(const Key& key) {
+	return ((static_cast<size_t>(key.colorMode) * 2 + (key.wireframe ? 1 : 0)) * 2 + (key.points ? 1 : 0)) * 2 + (key.instanced ? 1 : 0);
+}
+
+std::string ShaderVariants::defines(const Key& key) {
+	return "#define COLOR_MODE " + std::to_string(static_cast<int>(key.colorMode)) + "\n"
+	       "#define WIREFRAME " + (key.wireframe ? "1" : "0") + "\n"
+	       "#define POINTS " + (key.points ? "1" : "0") + "\n"
+	       "#define INSTANCED " + (key.instanced ? "1" : "0") + "\n";
+}
+
+bool ShaderVariants::setSources(const std::string& vertexSrc, const std::string& fragmentSrc, std::string& outError) {
+	Shader base;
+	if (!ProgramCache::instance().build(base, vertexSrc, fragmentSrc, defines(Key{}), outError)) return false;
+	mVertexSrc = vertexSrc;
+	mFragmentSrc = fragmentSrc;
+	for (Shader& variant : mVariants) variant = Shader();
+	mFailed.fill(false);
+	mVariants[index(Key{})] = std::move(base);
+	return true;
+}
+
+Shader* ShaderVariants::get(const Key& key) {
+	size_t i = index(key);
+	if (mVariants[i].id() != 0) return &mVariants[i];
+	if (mFailed[i] || mVertexSrc.empty()) return nullptr;
+
+	std::string err;
+	if (!ProgramCache::instance().build(mVariants[i], mVertexSrc, mFragmentSrc, defines(key), err)) {
+		std::cerr << "Shader variant error (" << defines(key) << "): " << err << std::endl;
+		mFailed[i] = true;
+		return nullptr;
+	}
+	return &mVariants[i];
+}
+
+void ShaderVariants::adopt(const std::string& vertexSrc, const std::string& fragmentSrc, const std::vector<Key>& keys, std::vector<Shader>& shaders) {
+	mVertexSrc = vertexSrc;
+	mFragmentSrc = fragmentSrc;
+	for (Shader& variant : mVariants) variant = Shader();
+	mFailed.fill(false);
+	for (size_t i = 0; i < keys.size() && i < shaders.size(); ++i) mVariants[index(keys[i])] = std::move(shaders[i]);
+}
+
+std::vector<ShaderVariants::Key> ShaderVariants::builtKeys() const {
+	std::vector<Key> keys;
+	for (int colorMode = 0; colorMode < 3; ++colorMode) {
+		for (bool wireframe : {false, true}) {
+			for (bool points : {false, true}) {
+				for (bool instanced : {false, true}) {
+					Key key;
+					key.colorMode = static_cast<ColorMode>(colorMode);
+					key.wireframe = wireframe;
+					key.points = points;
+					key.instanced = instanced;
+					if (mVariants[index(key)].id() != 0) keys.push_back(key);
+				}
+			}
+		}
+	}
+	return keys;
+}
+
+unsigned int ShaderVariants::builtCount() const {
+	unsigned int count = 0;
+	for (const Shader& variant : mVariants) {
+		if (variant.id() != 0) count++;
+	}
+	return count;
+}
+
+} // namespace Graphics
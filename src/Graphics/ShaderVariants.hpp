@@ -0,0 +1,69 @@
+#pragma once
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include "Graphics/Shader.h"
+#include "Graphics/RenderUtils.hpp"
+
+namespace Graphics {
+
+/// Compile-time permutations of one vertex/fragment program.
+/// Features the shaders used to branch on at runtime are baked in as #defines instead (COLOR_MODE,
+/// WIREFRAME, POINTS, INSTANCED), so every permutation only carries the path it runs. Permutations are built on
+/// first use through the ProgramCache (so later launches load them as binaries) and kept until the
+/// sources change.
+class ShaderVariants {
+public:
+	struct Key {
+		ColorMode colorMode = ColorMode::Uniform;
+		bool wireframe = false;  // Barycentric wire overlay on the shaded mesh (pbr.frag only)
+		bool points = false;     // GL_POINTS: normals may be missing
+		bool instanced = false;  // Model matrix per gl_InstanceID from InstancesUBO (instanced mesh runs)
+	};
+
+	static constexpr size_t kCount = 3 * 2 * 2 * 2;
+
+	ShaderVariants() = default;
+	ShaderVariants(const ShaderVariants&) = delete;
+	ShaderVariants& operator=(const ShaderVariants&) = delete;
+	ShaderVariants(ShaderVariants&&) noexcept = default;
+	ShaderVariants& operator=(ShaderVariants&&) noexcept = default;
+
+	/// Replace the sources and drop every built permutation. The default permutation is built right
+	/// away, so a broken source is reported here and the previous sources stay in use.
+	/// @param vertexSrc Vertex shader source
+	/// @param fragmentSrc Fragment shader source
+	/// @param outError Compile/link log of the default permutation
+	/// @return false if the default permutation failed (nothing was replaced)
+	bool setSources(const std::string& vertexSrc, const std::string& fragmentSrc, std::string& outError);
+
+	/// Permutation for a key, built on first use.
+	/// @return nullptr if it failed to build (reported once)
+	Shader* get(const Key& key);
+
+	/// Install sources whose permutations were built elsewhere (hot reload), dropping all others.
+	/// @param keys Permutations that were rebuilt
+	/// @param shaders Linked programs, one per key
+	void adopt(const std::string& vertexSrc, const std::string& fragmentSrc, const std::vector<Key>& keys, std::vector<Shader>& shaders);
+
+	/// Keys of the permutations built since the last setSources() / adopt().
+	std::vector<Key> builtKeys() const;
+
+	/// The #define block for a key, as injected after #version.
+	static std::string defines(const Key& key);
+
+	/// Permutations built since the last setSources() / adopt().
+	unsigned int builtCount() const;
+
+private:
+	static size_t index(const Key& key);
+
+	std::string mVertexSrc;
+	std::string mFragmentSrc;
+	std::array<Shader, kCount> mVariants;
+	std::array<bool, kCount> mFailed = {};
+};
+
+} // namespace Graphics
@@ -0,0 +1,83 @@
+#include "Graphics/ShaderWatcher.hpp"
+#include "Graphics/Utils.hpp"
+
+#include <algorithm>
+#include <filesystem>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace Graphics {
+
+bool ShaderWatcher::start(const std::string& directory, std::string& outError) {
+	stop();
+	std::error_code ec;
+	if (!std::filesystem::is_directory(directory, ec)) {
+		outError = "Not a directory: " + directory;
+		return false;
+	}
+	mDirectory = directory;
+#ifdef __linux__
+	mFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (mFd >= 0 && inotify_add_watch(mFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) >= 0) return true;
+	if (mFd >= 0) { close(mFd); mFd = -1; }
+#endif
+	// Polling fallback: remember the current write times
+	scan(mStamps);
+	return true;
+}
+
+void ShaderWatcher::stop() {
+#ifdef __linux__
+	if (mFd >= 0) close(mFd);
+#endif
+	mFd = -1;
+	mDirectory.clear();
+	mStamps.clear();
+}
+
+std::vector<std::string> ShaderWatcher::poll(double now) {
+	std::vector<std::string> changed;
+	auto add = [&changed](const std::string& name) {
+		if (std::find(changed.begin(), changed.end(), name) == changed.end()) changed.push_back(name);
+	};
+#ifdef __linux__
+	if (mFd >= 0) {
+		alignas(inotify_event) char buffer[4096];
+		for (;;) {
+			ssize_t bytes = read(mFd, buffer, sizeof(buffer));
+			if (bytes <= 0) break;  // EAGAIN: nothing left
+			for (char* p = buffer; p < buffer + bytes;) {
+				const inotify_event* event = reinterpret_cast<const inotify_event*>(p);
+				if (event->len > 0) add(event->name);
+				p += sizeof(inotify_event) + event->len;
+			}
+		}
+		return changed;
+	}
+#endif
+	if (mDirectory.empty() || now - mLastScan < Config::ShaderPollSeconds) return changed;
+	mLastScan = now;
+	std::unordered_map<std::string, long long> stamps;
+	scan(stamps);
+	for (const auto& [name, stamp] : stamps) {
+		auto it = mStamps.find(name);
+		if (it == mStamps.end() || it->second != stamp) add(name);
+	}
+	mStamps = std::move(stamps);
+	return changed;
+}
+
+void ShaderWatcher::scan(std::unordered_map<std::string, long long>& outStamps) const {
+	std::error_code ec;
+	for (std::filesystem::directory_iterator it(mDirectory, ec), end; !ec && it != end; it.increment(ec)) {
+		if (!it->is_regular_file(ec)) continue;
+		auto stamp = it->last_write_time(ec);
+		if (ec) continue;
+		outStamps[it->path().filename().string()] = static_cast<long long>(stamp.time_since_epoch().count());
+	}
+}
+
+} // namespace Graphics
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Graphics {
+
+/// Reports the files of one directory that were written since the last poll.
+/// On Linux this is an inotify watch (IN_CLOSE_WRITE, IN_MOVED_TO for editors that save by rename),
+/// so an idle frame costs one non-blocking read instead of a stat per file. Elsewhere, or if inotify
+/// is unavailable, the directory is rescanned every Config::ShaderPollSeconds.
+class ShaderWatcher {
+public:
+	ShaderWatcher() = default;
+	~ShaderWatcher() { stop(); }
+	ShaderWatcher(const ShaderWatcher&) = delete;
+	ShaderWatcher& operator=(const ShaderWatcher&) = delete;
+
+	/// Watch a directory (not recursive).
+	/// @param directory Directory to watch
+	/// @param outError Reason if it cannot be watched at all
+	/// @return false if the directory does not exist
+	bool start(const std::string& directory, std::string& outError);
+
+	void stop();
+
+	/// File names (without directory) changed since the last call, each once. Never blocks.
+	/// @param now Current time in seconds (paces the polling fallback)
+	std::vector<std::string> poll(double now);
+
+	bool usesInotify() const { return mFd >= 0; }
+
+private:
+	void scan(std::unordered_map<std::string, long long>& outStamps) const;
+
+	std::string mDirectory;
+	int mFd = -1;  // inotify instance
+	std::unordered_map<std::string, long long> mStamps;  // Polling fallback: write time per file
+	double mLastScan = 0.0;
+};
+
+} // namespace Graphics
@@ -1,5 +1,6 @@
 #include "SpatialIndex.hpp"
 #include "RenderUtils.hpp"  // For Frustum class
+#include "Graphics/Profiling/CpuProfiler.hpp"
 #include <cmath>
 
 namespace Graphics {
@@ -8,6 +9,7 @@ void Octree::build(const std::vector<Point>& points, const glm::vec3& min, const
                    unsigned int maxPointsPerNode, unsigned int maxDepth) {
 	mNodeCount = 0;
 	mMaxDepth = 0;
+	mIndexBytes = 0;
 	mRoot = std::make_unique<Node>();
 	mRoot->min = min;
 	mRoot->max = max;
@@ -22,6 +24,7 @@ void Octree::build(const std::vector<Point>& points, const glm::vec3& min, const
 	}
 	
 	buildRecursive(mRoot.get(), points, allIndices, maxPointsPerNode, maxDepth);
+	mCpuBytes.set(static_cast<size_t>(mNodeCount) * sizeof(Node) + mIndexBytes);
 }
 
 void Octree::buildRecursive(Node* node, const std::vector<Point>& points,
@@ -33,6 +36,7 @@ void Octree::buildRecursive(Node* node, const std::vector<Point>& points,
 		node->pointIndices = indices;
 		node->isLeaf = true;
 		mMaxDepth = std::max(mMaxDepth, node->level);
+		mIndexBytes += node->pointIndices.capacity() * sizeof(unsigned int);
 		return;
 	}
 	
@@ -88,11 +92,13 @@ void Octree::buildRecursive(Node* node, const std::vector<Point>& points,
 	if (!hasChildren) {
 		node->isLeaf = true;
 		node->pointIndices = indices;  // Keep original indices if no children were created
+		mIndexBytes += node->pointIndices.capacity() * sizeof(unsigned int);
 	}
 }
 
 std::vector<unsigned int> Octree::getVisiblePoints(const glm::mat4& viewProj, const glm::vec3& camPos,
                                                     float maxDistance) const {
+	PHV_CPU_SCOPE("Octree::getVisiblePoints");
 	if (!mRoot) return {};
 	
 	std::vector<unsigned int> result;
@@ -6,6 +6,8 @@
 #include <limits>
 #include <algorithm>
 
+#include "Graphics/Profiling/MemoryTracker.hpp"
+
 namespace Graphics {
 
 // Simple octree for point cloud spatial indexing
@@ -64,11 +66,14 @@ public:
 	// Get statistics
 	unsigned int nodeCount() const { return mNodeCount; }
 	unsigned int maxDepth() const { return mMaxDepth; }
+	size_t cpuMemoryBytes() const { return mCpuBytes.bytes(); }
 	
 private:
 	std::unique_ptr<Node> mRoot;
 	unsigned int mNodeCount = 0;
 	unsigned int mMaxDepth = 0;
+	size_t mIndexBytes = 0;  // Bytes held by leaf point index lists (accumulated during build)
+	TrackedCpuBytes mCpuBytes{CpuMemoryCategory::Octree};
 	
 	void buildRecursive(Node* node, const std::vector<Point>& points, 
 	                    const std::vector<unsigned int>& indices,
@@ -1,8 +1,14 @@
 #pragma once
 
+#include <algorithm>
+#include <cstring>
+#include <vector>
 #include <glm/glm.hpp>
 #include <glad/glad.h>
 
+#include "Graphics/Profiling/MemoryTracker.hpp"
+#include "Graphics/Utils.hpp"
+
 namespace Graphics {
 
 // UBO structure layouts (std140 alignment - each member must be 16-byte aligned)
@@ -33,6 +39,13 @@ struct LightingUBO {
 };
 static_assert(sizeof(LightingUBO) == 16 + 16, "LightingUBO size mismatch");
 
+// Instances UBO (binding = 3): model matrices of one instanced mesh draw, indexed by gl_InstanceID
+struct InstancesUBO {
+	static constexpr unsigned int kMaxInstances = 64;  // MAX_INSTANCES in pbr.vert, pbr.frag and depth_only.vert
+	glm::mat4 models[kMaxInstances];
+};
+static_assert(sizeof(InstancesUBO) == 64 * InstancesUBO::kMaxInstances, "InstancesUBO size mismatch");
+
 // UBO wrapper class
 class UniformBuffer {
 public:
@@ -42,15 +55,18 @@ public:
 	UniformBuffer(const UniformBuffer&) = delete;
 	UniformBuffer& operator=(const UniformBuffer&) = delete;
 	
-	UniformBuffer(UniformBuffer&& other) noexcept : mBuffer(other.mBuffer) {
+	UniformBuffer(UniformBuffer&& other) noexcept : mBuffer(other.mBuffer), mSize(other.mSize) {
 		other.mBuffer = 0;
+		other.mSize = 0;
 	}
 	
 	UniformBuffer& operator=(UniformBuffer&& other) noexcept {
 		if (this != &other) {
 			destroy();
 			mBuffer = other.mBuffer;
+			mSize = other.mSize;
 			other.mBuffer = 0;
+			other.mSize = 0;
 		}
 		return *this;
 	}
@@ -63,42 +79,123 @@ public:
 	
 	void destroy() {
 		if (mBuffer != 0) {
+			GLStateCache::instance().onBufferDeleted(mBuffer);
 			glDeleteBuffers(1, &mBuffer);
 			mBuffer = 0;
 		}
+		MemoryTracker::instance().release(MemoryCategory::UBO, mSize);
+		mSize = 0;
 	}
 	
 	void bind(GLenum target) const {
 		if (mBuffer != 0) {
-			glBindBuffer(target, mBuffer);
+			GLStateCache::instance().bindBuffer(target, mBuffer);
 		}
 	}
 	
-	void setData(GLenum target, GLsizeiptr size, const void* data, GLenum usage) const {
+	void setData(GLenum target, GLsizeiptr size, const void* data, GLenum usage) {
 		if (mBuffer != 0) {
-			glBindBuffer(target, mBuffer);
+			GLStateCache::instance().bindBuffer(target, mBuffer);
 			glBufferData(target, size, data, usage);
+			MemoryTracker::instance().resize(MemoryCategory::UBO, mSize, static_cast<size_t>(size));
+			mSize = static_cast<size_t>(size);
 		}
 	}
 	
 	void updateData(GLintptr offset, GLsizeiptr size, const void* data) const {
 		if (mBuffer != 0) {
-			glBindBuffer(GL_UNIFORM_BUFFER, mBuffer);
+			GLStateCache::instance().bindBuffer(GL_UNIFORM_BUFFER, mBuffer);
 			glBufferSubData(GL_UNIFORM_BUFFER, offset, size, data);
 		}
 	}
 	
 	void bindBase(GLuint bindingPoint) const {
 		if (mBuffer != 0) {
-			glBindBufferBase(GL_UNIFORM_BUFFER, bindingPoint, mBuffer);
+			GLStateCache::instance().bindBufferBase(GL_UNIFORM_BUFFER, bindingPoint, mBuffer);
+		}
+	}
+
+	void bindRange(GLuint bindingPoint, GLintptr offset, GLsizeiptr size) const {
+		if (mBuffer != 0) {
+			GLStateCache::instance().bindBufferRange(GL_UNIFORM_BUFFER, bindingPoint, mBuffer, offset, size);
 		}
 	}
 	
 	unsigned int id() const { return mBuffer; }
 	bool valid() const { return mBuffer != 0; }
+	size_t sizeBytes() const { return mSize; }
 
 private:
 	unsigned int mBuffer = 0;
+	size_t mSize = 0;  // Allocated size (bytes), reported to MemoryTracker
+};
+
+/// Per-frame ring of equally sized uniform blocks, one per drawn object, selected with glBindBufferRange.
+/// The blocks of a frame are collected on the CPU with push() and sent with a single upload(); the buffer
+/// holds kFrames such regions used in turn, so blocks the GPU may still read from an earlier frame are
+/// not overwritten. A frame that pushes more blocks than fit grows the buffer.
+class UniformRing {
+public:
+	static constexpr unsigned int kFrames = 3;
+
+	/// Allocate the ring.
+	/// @param blockSize Size of one block (e.g. sizeof(MatricesUBO))
+	/// @param blocksPerFrame Initial capacity of a frame region
+	void create(size_t blockSize, unsigned int blocksPerFrame = 16) {
+		GLint alignment = 0;
+		glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+		size_t align = alignment > 0 ? static_cast<size_t>(alignment) : 256;
+		mBlockSize = blockSize;
+		mStride = (blockSize + align - 1) / align * align;
+		mBlocksPerFrame = std::max(blocksPerFrame, 1u);
+		mBuffer.create();
+		mBuffer.setData(GL_UNIFORM_BUFFER, static_cast<GLsizeiptr>(kFrames * mBlocksPerFrame * mStride), nullptr, GL_DYNAMIC_DRAW);
+	}
+
+	/// Move to the next frame region and start collecting blocks.
+	void beginFrame() {
+		mFrame = (mFrame + 1) % kFrames;
+		mCount = 0;
+	}
+
+	/// Append a block (blockSize bytes) to this frame.
+	/// @return Index to pass to bind()
+	unsigned int push(const void* data) {
+		mStaging.resize((mCount + 1) * mStride);
+		std::memcpy(mStaging.data() + mCount * mStride, data, mBlockSize);
+		return mCount++;
+	}
+
+	/// Send this frame's blocks in one call.
+	void upload() {
+		if (mCount == 0 || !mBuffer.valid()) return;
+		if (mCount > mBlocksPerFrame) {
+			// Orphan and regrow; earlier regions are not needed any more
+			mBlocksPerFrame = std::max(mCount, mBlocksPerFrame * 2);
+			mBuffer.setData(GL_UNIFORM_BUFFER, static_cast<GLsizeiptr>(kFrames * mBlocksPerFrame * mStride), nullptr, GL_DYNAMIC_DRAW);
+		}
+		mBuffer.updateData(frameOffset(), static_cast<GLsizeiptr>(mCount * mStride), mStaging.data());
+	}
+
+	/// Bind one of this frame's blocks to a binding point.
+	void bind(GLuint bindingPoint, unsigned int block) const {
+		mBuffer.bindRange(bindingPoint, frameOffset() + static_cast<GLintptr>(block * mStride), static_cast<GLsizeiptr>(mBlockSize));
+	}
+
+	bool valid() const { return mBuffer.valid(); }
+	/// Blocks pushed this frame.
+	unsigned int count() const { return mCount; }
+
+private:
+	GLintptr frameOffset() const { return static_cast<GLintptr>(mFrame * mBlocksPerFrame * mStride); }
+
+	UniformBuffer mBuffer;
+	std::vector<unsigned char> mStaging;  // This frame's blocks, at mStride
+	size_t mBlockSize = 0;
+	size_t mStride = 0;  // Block size rounded up to GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT
+	unsigned int mBlocksPerFrame = 0;
+	unsigned int mFrame = 0;
+	unsigned int mCount = 0;
 };
 
 } // namespace Graphics
@@ -4,15 +4,14 @@ namespace Graphics::UI {
 
 void drawSceneUI(Renderer& r) {
 	Scene& scene = r.scene();
-	bool isPointCloud = scene.model.isPointCloud();
+	bool isPointCloud = r.world().hasPointClouds();  // Point cloud controls: any object is one
+	bool hasMeshes = r.world().hasMeshes();
 	ImGui::SetNextWindowSizeConstraints(ImVec2(280, -1), ImVec2(FLT_MAX, FLT_MAX));
 	ImGui::SetNextWindowPos(ImVec2(10, 10), ImGuiCond_FirstUseEver);
 	ImGui::Begin("PH_Viz", nullptr, ImGuiWindowFlags_AlwaysAutoResize);
 	bool& wireframe = r.wireframe();
-	if (ImGui::Checkbox("Wireframe", &wireframe)) {
-		if (!scene.model.isPointCloud()) glPolygonMode(GL_FRONT_AND_BACK, wireframe ? GL_LINE : GL_FILL);
-	}
-	if (isPointCloud) { ImGui::SameLine(); ImGui::TextDisabled("(disabled for point clouds)"); }
+	ImGui::Checkbox("Wireframe", &wireframe);  // Solid + wire overlay on meshes, no polygon mode
+	if (!hasMeshes) { ImGui::SameLine(); ImGui::TextDisabled("(disabled for point clouds)"); }
 	ImGui::Spacing();
 	const char* colorModeNames[] = { "Uniform", "Vertex RGB", "Scalar" };
 	int currentMode = static_cast<int>(scene.colorMode);
@@ -28,19 +27,97 @@ void drawSceneUI(Renderer& r) {
 		if (ImGui::IsItemHovered()) ImGui::SetTooltip("Use octree for view-dependent culling and LOD.\nOnly works for point clouds with >= threshold.\nBig speedups for large clouds.");
 		ImGui::Spacing();
 		if (ImGui::Checkbox("Auto LOD", &scene.autoLOD)) {}
+		ImGui::SameLine(); ImGui::TextDisabled("(?)");
+		if (ImGui::IsItemHovered()) ImGui::SetTooltip("Pick the point mode per octree leaf from its projected size:\nspheres up close, impostors mid-range, GL_POINTS far away.");
+		if (scene.autoLOD && scene.enableSpatialIndexing && !scene.model->pointClusters().empty()) {
+			const unsigned int* mixed = scene.mixedModeStats();
+			ImGui::TextDisabled("Leaves: %u points, %u impostors, %u spheres", mixed[0], mixed[1], mixed[2]);
+		}
 		ImGui::Spacing();
 		const char* renderModeNames[] = { "GL_POINTS (Fast)", "Sphere Impostors", "Instanced Spheres" };
 		int currentRenderMode = static_cast<int>(scene.pointCloudMode);
-		if (!scene.autoLOD) ImGui::Combo("Point Mode", &currentRenderMode, renderModeNames, 3);
-	}
-	if (!isPointCloud) {
+		if (!scene.autoLOD && ImGui::Combo("Point Mode", &currentRenderMode, renderModeNames, 3)) {
+			scene.pointCloudMode = static_cast<PointCloudRenderMode>(currentRenderMode);
+		}
+		if (scene.autoLOD || scene.pointCloudMode != PointCloudRenderMode::Points) {
+			ImGui::SliderFloat("Sphere Radius", &scene.sphereRadius, 0.0005f, 0.05f, "%.4f", ImGuiSliderFlags_Logarithmic);
+		}
+		if (scene.autoLOD || scene.pointCloudMode == PointCloudRenderMode::InstancedSpheres) {
+			const unsigned int* lod = scene.sphereLodStats();
+			ImGui::TextDisabled("Spheres by LOD (20/80/320/1280 tris): %u / %u / %u / %u", lod[0], lod[1], lod[2], lod[3]);
+		}
 		ImGui::Spacing();
-		ImGui::Checkbox("Occlusion Culling", &scene.enableOcclusionCulling); ImGui::SameLine(); ImGui::TextDisabled("(?)");
-		if (ImGui::IsItemHovered()) ImGui::SetTooltip("Use hardware occlusion queries to skip fully occluded objects.");
+		EyeDomeLighting::Settings& edl = r.eyeDomeLighting().settings;
+		ImGui::Checkbox("Eye-Dome Lighting", &edl.enabled); ImGui::SameLine(); ImGui::TextDisabled("(?)");
+		if (ImGui::IsItemHovered()) ImGui::SetTooltip("Screen-space depth shading: outlines silhouettes and depth steps\nin one fullscreen pass. Depth cues for GL_POINTS at almost no cost.");
+		if (edl.enabled) {
+			ImGui::SliderFloat("EDL Strength", &edl.strength, 0.1f, 5.0f, "%.2f");
+			ImGui::SliderFloat("EDL Radius (px)", &edl.radius, 1.0f, 4.0f, "%.1f");
+		}
+	}
+	ImGui::Spacing();
+	ImGui::Checkbox("Occlusion Culling", &scene.enableOcclusionCulling); ImGui::SameLine(); ImGui::TextDisabled("(?)");
+	if (ImGui::IsItemHovered()) ImGui::SetTooltip("Per-node hardware occlusion queries (octree leaves / meshes).\nResults arrive a few frames late; hidden nodes use\nconditional rendering so the CPU never waits.");
+	if (scene.enableOcclusionCulling) {
+		const OcclusionCuller::Stats& occ = scene.occlusionCuller().stats();
+		ImGui::TextDisabled("Nodes: %u in view / %u, %u hidden", occ.inFrustum, occ.nodes, occ.hidden);
+		ImGui::TextDisabled("Queries: %u issued, latency %.1f frames", occ.queriesIssued, occ.avgLatencyFrames);
+	}
+	ImGui::Checkbox("CPU Occlusion (Hi-Z)", &scene.enableSoftwareOcclusion); ImGui::SameLine(); ImGui::TextDisabled("(?)");
+	if (ImGui::IsItemHovered()) ImGui::SetTooltip("Rasterize the largest meshes into a small CPU depth buffer\nand skip nodes hidden behind them in the same frame.");
+	if (scene.enableSoftwareOcclusion && r.world().softwareOcclusion()) {
+		SoftwareOcclusionBuffer& sw = *r.world().softwareOcclusion();
+		const SoftwareOcclusionBuffer::Stats& st = sw.stats();
+		ImGui::TextDisabled("%u occluders, %u tris, %.2f ms (%s)", st.occluders, st.triangles, st.rasterMs, SoftwareOcclusionBuffer::simdPathName());
+		ImGui::TextDisabled("Culled: %u / %u tested", st.culled, st.tested);
+		ImGui::Checkbox("Show Hi-Z Buffer", &scene.showSoftwareOcclusionBuffer);
+		if (scene.showSoftwareOcclusionBuffer) {
+			// Row 0 is the bottom of the screen, so flip V
+			ImGui::Image((ImTextureID)(intptr_t)sw.debugTexture(),
+			             ImVec2(SoftwareOcclusionBuffer::kWidth, SoftwareOcclusionBuffer::kHeight), ImVec2(0, 1), ImVec2(1, 0));
+		}
+	}
+	ImGui::Spacing();
+	ImGui::Checkbox("Early-Z Prepass", &scene.enableEarlyZPrepass); ImGui::SameLine(); ImGui::TextDisabled("(?)");
+	if (ImGui::IsItemHovered()) ImGui::SetTooltip("Two-pass rendering: depth-only then full shading.\nPoint clouds: impostors and spheres are shaded once per\nvisible pixel.\nSkipped while occlusion culling is on.");
+	if (hasMeshes) {
 		ImGui::Spacing();
-		ImGui::Checkbox("Early-Z Prepass", &scene.enableEarlyZPrepass); ImGui::SameLine(); ImGui::TextDisabled("(?)");
-		if (ImGui::IsItemHovered()) ImGui::SetTooltip("Two-pass rendering: depth-only then full shading.");
+		ImGui::Checkbox("Mesh LOD", &scene.enableMeshLOD); ImGui::SameLine();
+		if (scene.model->lodBuildPending()) ImGui::TextDisabled("(building...)");
+		else ImGui::TextDisabled("(%zu levels)", scene.model->lodLevelCount());
+		if (scene.enableMeshLOD) ImGui::SliderFloat("LOD Error (px)", &scene.meshLODErrorPixels, 0.25f, 8.0f, "%.2f");
+	}
+	ImGui::Spacing();
+	CullingOverlay& overlay = r.cullingOverlay();
+	ImGui::Checkbox("Culling Overlay", &overlay.settings.enabled); ImGui::SameLine(); ImGui::TextDisabled("(?)");
+	if (ImGui::IsItemHovered()) ImGui::SetTooltip("Box of every octree leaf / mesh: dark red outside the frustum,\norange CPU-occluded, magenta query-hidden, drawn green to blue by LOD.");
+	if (overlay.settings.enabled) {
+		ImGui::Checkbox("Show Frustum-Culled", &overlay.settings.showFrustumCulled);
+		const CullingOverlay::Stats& cs = overlay.stats();
+		ImGui::TextDisabled("Nodes: %u visited, %u drawn", cs.visited, cs.drawn);
+		ImGui::TextDisabled("Rejected: %u frustum, %u occluded, %u hidden", cs.frustumCulled, cs.occluded, cs.hidden);
+		if (cs.leaves > 0) {
+			ImGui::TextDisabled("Leaves: %u, avg %.0f / max %u points (target %u)", cs.leaves, cs.avgLeafPoints, cs.maxLeafPoints, Config::OctreePointsPerNode);
+			ImGui::TextDisabled("Octree depth: %u (limit %u)", cs.octreeDepth, Config::OctreeMaxDepth);
+		}
 	}
+	ImGui::Spacing();
+	ImGui::Checkbox("Pipelined Culling", &r.framePipeline().settings.enabled); ImGui::SameLine(); ImGui::TextDisabled("(?)");
+	if (ImGui::IsItemHovered()) ImGui::SetTooltip("Cull objects and octree leaves and sort the draws for the next\nframe on a worker thread while this one is submitted.\nThe image trails the camera by one frame; still frames are exact.");
+	ImGui::Spacing();
+	DynamicResolution::Settings& dynRes = r.dynamicResolution().settings;
+	ImGui::Checkbox("Dynamic Resolution", &dynRes.enabled); ImGui::SameLine(); ImGui::TextDisabled("(?)");
+	if (ImGui::IsItemHovered()) ImGui::SetTooltip("Render the scene at a reduced resolution that follows\nthe GPU frame time, then upscale to the window.");
+	if (dynRes.enabled) {
+		ImGui::SliderFloat("Frame Target (ms)", &dynRes.targetMs, 4.0f, 50.0f, "%.1f");
+		ImGui::SliderFloat("Min Scale", &dynRes.minScale, 0.25f, 1.0f, "%.2f");
+	}
+	ImGui::Spacing();
+	ProgressiveRefinement::Settings& refine = r.refinement().settings;
+	ImGui::Checkbox("On-Demand Rendering", &refine.onDemand); ImGui::SameLine(); ImGui::TextDisabled("(?)");
+	if (ImGui::IsItemHovered()) ImGui::SetTooltip("Only redraw when the camera, scene or UI changes.\nStatistics freeze while nothing is drawn.");
+	ImGui::Checkbox("Progressive Refinement", &refine.refine); ImGui::SameLine(); ImGui::TextDisabled("(?)");
+	if (ImGui::IsItemHovered()) ImGui::SetTooltip("Once the view holds still, redraw it at full resolution and detail,\nthen add the impostors the LOD left out over the next frames.");
 	ImGui::End();
 }
 
@@ -57,17 +134,85 @@ void drawProfilingUI(Renderer& r) {
 		ImGui::Text("GPU: %.2f ms", prof.gpuFrameTime);
 		ImGui::Text("GPU/CPU Ratio: %.2f%%", (prof.gpuFrameTime / prof.cpuFrameTime) * 100.0f);
 	} else ImGui::TextDisabled("GPU: N/A");
+	if (prof.dynamicResolution) {
+		ImGui::Text("Render Scale: %.0f%% (%dx%d)", prof.renderScale * 100.0f, prof.renderWidth, prof.renderHeight);
+		ImGui::TextDisabled("Target %.1f ms, GPU %.2f ms", r.dynamicResolution().settings.targetMs, prof.gpuFrameTime);
+	}
+	if (r.refinement().refining()) {
+		ImGui::Text("Refining: pass %u, +%llu points", r.refinement().passes(), r.refinement().refinedPoints());
+	} else if (r.refinement().complete() && r.refinement().settings.refine) {
+		ImGui::TextDisabled("Refined (%u passes, +%llu points)", r.refinement().passes(), r.refinement().refinedPoints());
+	}
+	const GpuProfiler& gpuProfiler = GpuProfiler::instance();
+	const auto& passes = gpuProfiler.lastResults();
+	if (!passes.empty() && ImGui::CollapsingHeader("GPU Passes", ImGuiTreeNodeFlags_DefaultOpen)) {
+		// Resolved kFrameLatency frames late; entry 0 is the whole frame
+		const double frameMs = passes[0].ms();
+		if (ImGui::BeginTable("GpuPasses", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit)) {
+			ImGui::TableSetupColumn("Pass");
+			ImGui::TableSetupColumn("ms");
+			ImGui::TableSetupColumn("avg ms");
+			ImGui::TableSetupColumn("% frame");
+			ImGui::TableHeadersRow();
+			for (const auto& pass : passes) {
+				ImGui::TableNextRow();
+				ImGui::TableNextColumn(); ImGui::Text("%*s%s", pass.depth * 2, "", pass.name);
+				ImGui::TableNextColumn(); ImGui::Text("%.3f", pass.ms());
+				ImGui::TableNextColumn(); ImGui::Text("%.3f", gpuProfiler.smoothedMs(pass.name));
+				ImGui::TableNextColumn(); ImGui::Text("%.1f", frameMs > 0.0 ? 100.0 * pass.ms() / frameMs : 0.0);
+			}
+			ImGui::EndTable();
+		}
+		if (gpuProfiler.droppedFrames() > 0) ImGui::TextDisabled("Dropped (not ready in time): %llu", static_cast<unsigned long long>(gpuProfiler.droppedFrames()));
+	}
+	CpuProfiler& cpuProfiler = CpuProfiler::instance();
+	bool cpuScopes = cpuProfiler.enabled();
+	if (ImGui::Checkbox("CPU Scopes", &cpuScopes)) cpuProfiler.setEnabled(cpuScopes);
+	ImGui::SameLine();
+	if (ImGui::Button("Export Trace (F8)")) r.exportTrace();
 	ImGui::Separator();
 	ImGui::Text("Rendering:");
 	ImGui::Text("Draw Calls: %u", prof.drawCalls);
+	ImGui::Text("Objects: %u (%u in view), %u batches, %u instanced", prof.objects, prof.objectsVisible, prof.renderBatches, prof.instancedObjects);
+	ImGui::Text("Culling: %.2f ms (%s)", prof.cullMs, prof.framePipelined ? "worker, one frame ahead" : "render thread");
 	if (prof.triangles > 0) ImGui::Text("Triangles: %u", prof.triangles);
 	if (prof.points > 0) ImGui::Text("Points: %u", prof.points);
+	ImGui::Text("GL State Calls: %llu (%llu redundant skipped)", prof.stateCallsRequested - prof.stateCallsSkipped, prof.stateCallsSkipped);
 	ImGui::Separator();
 	ImGui::Text("Memory:");
-	if (prof.gpuMemoryUsed > 0) {
-		float mb = static_cast<float>(prof.gpuMemoryUsed) / (1024.0f * 1024.0f);
-		ImGui::Text("GPU: %.2f MB", mb);
-	} else ImGui::TextDisabled("GPU: N/A");
+	const float toMB = 1.0f / (1024.0f * 1024.0f);
+	ImGui::Text("GPU (tracked): %.2f MB (peak %.2f MB)", static_cast<float>(prof.gpuMemoryUsed) * toMB, static_cast<float>(prof.gpuMemoryPeak) * toMB);
+	const MemoryTracker& tracker = MemoryTracker::instance();
+	if (ImGui::BeginTable("MemoryCategories", 3, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit)) {
+		ImGui::TableSetupColumn("Category");
+		ImGui::TableSetupColumn("Live (MB)");
+		ImGui::TableSetupColumn("Peak (MB)");
+		ImGui::TableHeadersRow();
+		for (int c = 0; c < static_cast<int>(MemoryCategory::Count); ++c) {
+			MemoryCategory category = static_cast<MemoryCategory>(c);
+			ImGui::TableNextRow();
+			ImGui::TableNextColumn(); ImGui::Text("%s", MemoryTracker::categoryName(category));
+			ImGui::TableNextColumn(); ImGui::Text("%.2f", static_cast<float>(tracker.liveBytes(category)) * toMB);
+			ImGui::TableNextColumn(); ImGui::Text("%.2f", static_cast<float>(tracker.peakBytes(category)) * toMB);
+		}
+		for (int c = 0; c < static_cast<int>(CpuMemoryCategory::Count); ++c) {
+			CpuMemoryCategory category = static_cast<CpuMemoryCategory>(c);
+			ImGui::TableNextRow();
+			ImGui::TableNextColumn(); ImGui::Text("CPU %s", MemoryTracker::categoryName(category));
+			ImGui::TableNextColumn(); ImGui::Text("%.2f", static_cast<float>(tracker.cpuBytes(category)) * toMB);
+			ImGui::TableNextColumn(); ImGui::Text("%.2f", static_cast<float>(tracker.cpuPeakBytes(category)) * toMB);
+		}
+		ImGui::EndTable();
+	}
+	ImGui::Text("Vertex Arrays: %d", tracker.vertexArrayCount());
+	if (prof.driverMemoryAvailable) {
+		if (prof.driverMemoryTotal > 0) {
+			ImGui::Text("Driver: %.0f / %.0f MB free", static_cast<float>(prof.driverMemoryFree) * toMB, static_cast<float>(prof.driverMemoryTotal) * toMB);
+		} else {
+			ImGui::Text("Driver: %.0f MB free", static_cast<float>(prof.driverMemoryFree) * toMB);
+		}
+		if (ImGui::IsItemHovered()) ImGui::SetTooltip("Reported by %s", prof.driverMemorySource);
+	} else ImGui::TextDisabled("Driver: N/A");
 	ImGui::End();
 }
 
@@ -2,6 +2,9 @@
 
 #include <imgui.h>
 #include "Graphics/Renderer.h"
+#include "Graphics/Profiling/MemoryTracker.hpp"
+#include "Graphics/Profiling/GpuProfiler.hpp"
+#include "Graphics/Profiling/CpuProfiler.hpp"
 
 namespace Graphics::UI {
 
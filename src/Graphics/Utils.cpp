@@ -1,52 +1,219 @@
 #include "Graphics/Utils.hpp"
 #include <glad/glad.h>
+#include <cstring>
+#include <fstream>
+#include <sstream>
 
 namespace Graphics {
 
+bool hasGLExtension(const char* name) {
+	GLint count = 0;
+	glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+	for (GLint i = 0; i < count; ++i) {
+		const char* ext = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i)));
+		if (ext && std::strcmp(ext, name) == 0) return true;
+	}
+	return false;
+}
+
+bool readTextFile(const std::string& path, std::string& out) {
+	std::ifstream f(path);
+	if (!f.is_open()) return false;
+	std::ostringstream ss; ss << f.rdbuf();
+	out = ss.str();
+	return true;
+}
+
+GLStateCache& GLStateCache::instance() {
+	static GLStateCache sCache;
+	return sCache;
+}
+
 void GLStateCache::initialize() {
-	glGetIntegerv(0x8B8D /*GL_CURRENT_PROGRAM*/, &mCurrentProgram);
-	glGetIntegerv(0x0B74 /*GL_DEPTH_FUNC*/, &mDepthFunc);
-	GLboolean dw; glGetBooleanv(0x0B72 /*GL_DEPTH_WRITEMASK*/, &dw); mDepthWrite = static_cast<unsigned char>(dw);
-	GLboolean cw[4]; glGetBooleanv(0x0C23 /*GL_COLOR_WRITEMASK*/, cw);
+	GLint value = 0;
+	glGetIntegerv(GL_CURRENT_PROGRAM, &value); mProgram = static_cast<unsigned int>(value);
+	glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &value); mVertexArray = static_cast<unsigned int>(value);
+	glGetIntegerv(GL_ELEMENT_ARRAY_BUFFER_BINDING, &value); mElementBuffer = static_cast<unsigned int>(value);
+	glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &value); mBuffers[ArraySlot] = static_cast<unsigned int>(value);
+	glGetIntegerv(GL_UNIFORM_BUFFER_BINDING, &value); mBuffers[UniformSlot] = static_cast<unsigned int>(value);
+	glGetIntegerv(GL_COPY_READ_BUFFER_BINDING, &value); mBuffers[CopyReadSlot] = static_cast<unsigned int>(value);
+	glGetIntegerv(GL_COPY_WRITE_BUFFER_BINDING, &value); mBuffers[CopyWriteSlot] = static_cast<unsigned int>(value);
+	glGetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &value); mBuffers[PixelPackSlot] = static_cast<unsigned int>(value);
+	glGetIntegerv(GL_PIXEL_UNPACK_BUFFER_BINDING, &value); mBuffers[PixelUnpackSlot] = static_cast<unsigned int>(value);
+	for (unsigned int& slot : mUniformSlots) slot = kUnknown;
+	glGetIntegerv(GL_ACTIVE_TEXTURE, &value); mActiveTexture = static_cast<unsigned int>(value) - GL_TEXTURE0;
+	for (unsigned int& texture : mTextures) texture = kUnknown;
+	glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &value); mDrawFramebuffer = static_cast<unsigned int>(value);
+	glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &value); mReadFramebuffer = static_cast<unsigned int>(value);
+	glGetIntegerv(GL_DEPTH_FUNC, &mDepthFunc);
+	GLboolean dw; glGetBooleanv(GL_DEPTH_WRITEMASK, &dw); mDepthWrite = static_cast<unsigned char>(dw);
+	GLboolean cw[4]; glGetBooleanv(GL_COLOR_WRITEMASK, cw);
 	mColorWrite[0] = cw[0]; mColorWrite[1] = cw[1]; mColorWrite[2] = cw[2]; mColorWrite[3] = cw[3];
-	mBlendEnabled = glIsEnabled(0x0BE2 /*GL_BLEND*/);
-	mCullFaceEnabled = glIsEnabled(0x0B44 /*GL_CULL_FACE*/);
-	mDepthTestEnabled = glIsEnabled(0x0B71 /*GL_DEPTH_TEST*/);
+	mBlendEnabled = glIsEnabled(GL_BLEND);
+	mCullFaceEnabled = glIsEnabled(GL_CULL_FACE);
+	mDepthTestEnabled = glIsEnabled(GL_DEPTH_TEST);
+	GLint modes[2] = {0, 0};
+	glGetIntegerv(GL_POLYGON_MODE, modes); mPolygonMode = static_cast<unsigned int>(modes[0]);
+	glGetFloatv(GL_POINT_SIZE, &mPointSize);
+	glGetIntegerv(GL_VIEWPORT, mViewport);
+	resetCounters();
+}
+
+void GLStateCache::invalidate() {
+	mProgram = mVertexArray = mElementBuffer = kUnknown;
+	for (unsigned int& buffer : mBuffers) buffer = kUnknown;
+	for (unsigned int& slot : mUniformSlots) slot = kUnknown;
+	mActiveTexture = kUnknown;
+	for (unsigned int& texture : mTextures) texture = kUnknown;
+	mDrawFramebuffer = mReadFramebuffer = kUnknown;
+	mDepthFunc = -1;
+	mDepthWrite = 0xFF;
+	mColorWrite[0] = mColorWrite[1] = mColorWrite[2] = mColorWrite[3] = 0xFF;
+	mBlendEnabled = mCullFaceEnabled = mDepthTestEnabled = -1;
+	mPolygonMode = kUnknown;
+	mPointSize = -1.0f;
+	mViewport[0] = mViewport[1] = mViewport[2] = mViewport[3] = -1;
+}
+
+int GLStateCache::bufferSlot(unsigned int target) {
+	switch (target) {
+		case GL_ARRAY_BUFFER: return ArraySlot;
+		case GL_UNIFORM_BUFFER: return UniformSlot;
+		case GL_COPY_READ_BUFFER: return CopyReadSlot;
+		case GL_COPY_WRITE_BUFFER: return CopyWriteSlot;
+		case GL_PIXEL_PACK_BUFFER: return PixelPackSlot;
+		case GL_PIXEL_UNPACK_BUFFER: return PixelUnpackSlot;
+		default: return -1;
+	}
 }
 
-void GLStateCache::reset() {
-	mCurrentProgram = -1;
-	mDepthFunc = 0x0201; // GL_LESS
-	mDepthWrite = 1;
-	mColorWrite[0]=mColorWrite[1]=mColorWrite[2]=mColorWrite[3]=1;
-	mBlendEnabled = mCullFaceEnabled = mDepthTestEnabled = false;
+void GLStateCache::useProgram(unsigned int program) {
+	if (changed(mProgram != program)) { glUseProgram(program); mProgram = program; }
+}
+
+void GLStateCache::bindVertexArray(unsigned int vao) {
+	if (changed(mVertexArray != vao)) {
+		glBindVertexArray(vao);
+		mVertexArray = vao;
+		mElementBuffer = kUnknown;  // Per-VAO state
+	}
+}
+
+void GLStateCache::bindBuffer(unsigned int target, unsigned int buffer) {
+	if (target == GL_ELEMENT_ARRAY_BUFFER) {
+		if (changed(mElementBuffer != buffer)) { glBindBuffer(target, buffer); mElementBuffer = buffer; }
+		return;
+	}
+	int slot = bufferSlot(target);
+	if (slot < 0) { changed(true); glBindBuffer(target, buffer); return; }  // Untracked target
+	if (changed(mBuffers[slot] != buffer)) { glBindBuffer(target, buffer); mBuffers[slot] = buffer; }
+}
+
+void GLStateCache::bindBufferBase(unsigned int target, unsigned int index, unsigned int buffer) {
+	if (target != GL_UNIFORM_BUFFER || index >= kMaxUniformSlots) { changed(true); glBindBufferBase(target, index, buffer); return; }
+	if (changed(mUniformSlots[index] != buffer || mUniformRanges[index][0] != -1)) {
+		glBindBufferBase(target, index, buffer);
+		mUniformSlots[index] = buffer;
+		mUniformRanges[index][0] = mUniformRanges[index][1] = -1;
+		mBuffers[UniformSlot] = buffer;  // BindBufferBase also sets the generic binding
+	}
+}
+
+void GLStateCache::bindBufferRange(unsigned int target, unsigned int index, unsigned int buffer, std::ptrdiff_t offset, std::ptrdiff_t size) {
+	if (target != GL_UNIFORM_BUFFER || index >= kMaxUniformSlots) { changed(true); glBindBufferRange(target, index, buffer, offset, size); return; }
+	if (changed(mUniformSlots[index] != buffer || mUniformRanges[index][0] != offset || mUniformRanges[index][1] != size)) {
+		glBindBufferRange(target, index, buffer, offset, size);
+		mUniformSlots[index] = buffer;
+		mUniformRanges[index][0] = offset;
+		mUniformRanges[index][1] = size;
+		mBuffers[UniformSlot] = buffer;  // BindBufferRange also sets the generic binding
+	}
+}
+
+void GLStateCache::bindTexture(unsigned int unit, unsigned int target, unsigned int texture) {
+	if (mActiveTexture != unit) { glActiveTexture(GL_TEXTURE0 + unit); mActiveTexture = unit; }
+	if (unit >= kMaxTextureUnits) { changed(true); glBindTexture(target, texture); return; }  // Untracked unit
+	if (changed(mTextures[unit] != texture || mTextureTargets[unit] != target)) {
+		glBindTexture(target, texture);
+		mTextures[unit] = texture;
+		mTextureTargets[unit] = target;
+	}
+}
+
+void GLStateCache::bindFramebuffer(unsigned int target, unsigned int fbo) {
+	bool draw = target != GL_READ_FRAMEBUFFER;
+	bool read = target != GL_DRAW_FRAMEBUFFER;
+	if (changed((draw && mDrawFramebuffer != fbo) || (read && mReadFramebuffer != fbo))) {
+		glBindFramebuffer(target, fbo);
+		if (draw) mDrawFramebuffer = fbo;
+		if (read) mReadFramebuffer = fbo;
+	}
+}
+
+void GLStateCache::onProgramDeleted(unsigned int program) {
+	if (mProgram == program) mProgram = kUnknown;
+}
+
+void GLStateCache::onVertexArrayDeleted(unsigned int vao) {
+	if (mVertexArray == vao) { mVertexArray = kUnknown; mElementBuffer = kUnknown; }
+}
+
+void GLStateCache::onBufferDeleted(unsigned int buffer) {
+	if (mElementBuffer == buffer) mElementBuffer = kUnknown;
+	for (unsigned int& b : mBuffers) if (b == buffer) b = kUnknown;
+	for (unsigned int& b : mUniformSlots) if (b == buffer) b = kUnknown;
+}
+
+void GLStateCache::onTextureDeleted(unsigned int texture) {
+	for (unsigned int& t : mTextures) if (t == texture) t = kUnknown;
+}
+
+void GLStateCache::onFramebufferDeleted(unsigned int fbo) {
+	// Deleting a bound framebuffer reverts its targets to the default framebuffer
+	if (mDrawFramebuffer == fbo) mDrawFramebuffer = 0;
+	if (mReadFramebuffer == fbo) mReadFramebuffer = 0;
 }
 
 void GLStateCache::depthFunc(unsigned int func) {
-	if (mDepthFunc != static_cast<int>(func)) { glDepthFunc(func); mDepthFunc = static_cast<int>(func); }
+	if (changed(mDepthFunc != static_cast<int>(func))) { glDepthFunc(func); mDepthFunc = static_cast<int>(func); }
 }
 
 void GLStateCache::depthMask(unsigned char enabled) {
-	if (mDepthWrite != enabled) { glDepthMask(enabled); mDepthWrite = enabled; }
+	if (changed(mDepthWrite != enabled)) { glDepthMask(enabled); mDepthWrite = enabled; }
 }
 
 void GLStateCache::enableDepthTest(bool enable) {
-	if (mDepthTestEnabled != enable) { if (enable) glEnable(0x0B71 /*GL_DEPTH_TEST*/); else glDisable(0x0B71); mDepthTestEnabled = enable; }
+	if (changed(mDepthTestEnabled != static_cast<int>(enable))) { if (enable) glEnable(GL_DEPTH_TEST); else glDisable(GL_DEPTH_TEST); mDepthTestEnabled = enable; }
 }
 
 void GLStateCache::colorMask(unsigned char r, unsigned char g, unsigned char b, unsigned char a) {
-	if (mColorWrite[0]!=r || mColorWrite[1]!=g || mColorWrite[2]!=b || mColorWrite[3]!=a) {
+	if (changed(mColorWrite[0]!=r || mColorWrite[1]!=g || mColorWrite[2]!=b || mColorWrite[3]!=a)) {
 		glColorMask(r,g,b,a);
 		mColorWrite[0]=r; mColorWrite[1]=g; mColorWrite[2]=b; mColorWrite[3]=a;
 	}
 }
 
 void GLStateCache::enableCullFace(bool enable) {
-	if (mCullFaceEnabled != enable) { if (enable) glEnable(0x0B44 /*GL_CULL_FACE*/); else glDisable(0x0B44); mCullFaceEnabled = enable; }
+	if (changed(mCullFaceEnabled != static_cast<int>(enable))) { if (enable) glEnable(GL_CULL_FACE); else glDisable(GL_CULL_FACE); mCullFaceEnabled = enable; }
 }
 
 void GLStateCache::enableBlend(bool enable) {
-	if (mBlendEnabled != enable) { if (enable) glEnable(0x0BE2 /*GL_BLEND*/); else glDisable(0x0BE2); mBlendEnabled = enable; }
+	if (changed(mBlendEnabled != static_cast<int>(enable))) { if (enable) glEnable(GL_BLEND); else glDisable(GL_BLEND); mBlendEnabled = enable; }
+}
+
+void GLStateCache::polygonMode(unsigned int mode) {
+	if (changed(mPolygonMode != mode)) { glPolygonMode(GL_FRONT_AND_BACK, mode); mPolygonMode = mode; }
+}
+
+void GLStateCache::pointSize(float size) {
+	if (changed(mPointSize != size)) { glPointSize(size); mPointSize = size; }
+}
+
+void GLStateCache::viewport(int x, int y, int width, int height) {
+	if (changed(mViewport[0] != x || mViewport[1] != y || mViewport[2] != width || mViewport[3] != height)) {
+		glViewport(x, y, width, height);
+		mViewport[0] = x; mViewport[1] = y; mViewport[2] = width; mViewport[3] = height;
+	}
 }
 
 } // namespace Graphics
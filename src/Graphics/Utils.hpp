@@ -1,12 +1,127 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <cstring>
+#include <string>
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 
+#include "Graphics/Profiling/MemoryTracker.hpp"
+
 namespace Graphics {
 
+// ============================================================================
+// OpenGL State Cache
+// ============================================================================
+
+/// Shadow copy of the GL state the renderer touches, so redundant calls never reach the driver.
+/// There is one GL context, so there is one cache (instance()); the GL wrappers below, Shader and
+/// UniformBuffer all bind through it. Code that changes state behind its back (e.g. a third-party
+/// backend that does not restore state) must call invalidate() afterwards.
+/// Element array bindings belong to the bound VAO and are forgotten whenever the VAO changes.
+class GLStateCache {
+public:
+	static constexpr unsigned int kUnknown = 0xFFFFFFFFu;  // Binding not known: next call always goes through
+	static constexpr unsigned int kMaxUniformSlots = 16;   // glBindBufferBase(GL_UNIFORM_BUFFER) slots tracked
+	static constexpr unsigned int kMaxTextureUnits = 8;    // Texture units tracked
+
+	GLStateCache() = default;
+	~GLStateCache() = default;
+	GLStateCache(const GLStateCache&) = delete;
+	GLStateCache& operator=(const GLStateCache&) = delete;
+
+	static GLStateCache& instance();
+
+	/// Read the current state back from the context (call once after context creation).
+	void initialize();
+	/// Forget all cached state; the next call of every kind is issued.
+	void invalidate();
+
+	// Programs, vertex arrays, buffers
+	void useProgram(unsigned int program);
+	void bindVertexArray(unsigned int vao);
+	void bindBuffer(unsigned int target, unsigned int buffer);
+	void bindBufferBase(unsigned int target, unsigned int index, unsigned int buffer);
+	void bindBufferRange(unsigned int target, unsigned int index, unsigned int buffer, std::ptrdiff_t offset, std::ptrdiff_t size);
+
+	// Textures: makes the unit active (so glTex* calls that follow act on it), then binds if needed
+	void bindTexture(unsigned int unit, unsigned int target, unsigned int texture);
+
+	// Framebuffers: GL_FRAMEBUFFER binds both the draw and the read target
+	void bindFramebuffer(unsigned int target, unsigned int fbo);
+
+	// Deletion hooks: GL silently unbinds deleted objects and may recycle their names
+	void onProgramDeleted(unsigned int program);
+	void onVertexArrayDeleted(unsigned int vao);
+	void onBufferDeleted(unsigned int buffer);
+	void onTextureDeleted(unsigned int texture);
+	void onFramebufferDeleted(unsigned int fbo);
+
+	// Depth testing
+	void depthFunc(unsigned int func);
+	void depthMask(unsigned char enabled);
+	void enableDepthTest(bool enable = true);
+
+	// Color writes
+	void colorMask(unsigned char r, unsigned char g, unsigned char b, unsigned char a);
+
+	// Face culling
+	void enableCullFace(bool enable = true);
+
+	// Blending
+	void enableBlend(bool enable = true);
+
+	// Rasterization
+	void polygonMode(unsigned int mode);  // GL_FRONT_AND_BACK
+	void pointSize(float size);
+	void viewport(int x, int y, int width, int height);
+
+	unsigned int currentProgram() const { return mProgram; }
+	unsigned int currentVertexArray() const { return mVertexArray; }
+	unsigned int currentPolygonMode() const { return mPolygonMode; }
+	unsigned int currentDrawFramebuffer() const { return mDrawFramebuffer; }  // kUnknown after invalidate() until bound
+	const int* currentViewport() const { return mViewport; }  // x, y, width, height; -1 after invalidate() until set
+	bool cullFaceEnabled() const { return mCullFaceEnabled != 0; }  // Unknown reads as enabled (the device default)
+
+	/// State calls requested / skipped as redundant since the last resetCounters().
+	unsigned long long requestedCalls() const { return mRequested; }
+	unsigned long long skippedCalls() const { return mSkipped; }
+	void resetCounters() { mRequested = 0; mSkipped = 0; }
+
+private:
+	enum BufferSlot { ArraySlot, UniformSlot, CopyReadSlot, CopyWriteSlot, PixelPackSlot, PixelUnpackSlot, BufferSlotCount };
+	static int bufferSlot(unsigned int target);
+
+	// Count a request; returns true if it must be issued
+	bool changed(bool differs) { ++mRequested; if (!differs) ++mSkipped; return differs; }
+
+	unsigned int mProgram = kUnknown;
+	unsigned int mVertexArray = kUnknown;
+	unsigned int mElementBuffer = kUnknown;  // Of the bound VAO
+	unsigned int mBuffers[BufferSlotCount] = {kUnknown, kUnknown, kUnknown, kUnknown, kUnknown, kUnknown};
+	unsigned int mUniformSlots[kMaxUniformSlots] = {kUnknown, kUnknown, kUnknown, kUnknown, kUnknown, kUnknown, kUnknown, kUnknown,
+	                                               kUnknown, kUnknown, kUnknown, kUnknown, kUnknown, kUnknown, kUnknown, kUnknown};
+	std::ptrdiff_t mUniformRanges[kMaxUniformSlots][2] = {};  // Offset and size of glBindBufferRange slots; {-1, -1} for a whole buffer
+	unsigned int mActiveTexture = kUnknown;  // Unit index (not GL_TEXTUREi)
+	unsigned int mTextures[kMaxTextureUnits] = {kUnknown, kUnknown, kUnknown, kUnknown, kUnknown, kUnknown, kUnknown, kUnknown};
+	unsigned int mTextureTargets[kMaxTextureUnits] = {};  // Target of mTextures (a unit has one binding per target)
+	unsigned int mDrawFramebuffer = kUnknown;
+	unsigned int mReadFramebuffer = kUnknown;
+	int mDepthFunc = -1;  // Unknown values (-1 / 0xFF) never match a request
+	unsigned char mDepthWrite = 0xFF;
+	unsigned char mColorWrite[4] = {0xFF, 0xFF, 0xFF, 0xFF};
+	int mBlendEnabled = -1;      // Capabilities: 0/1, or -1 when unknown
+	int mCullFaceEnabled = -1;
+	int mDepthTestEnabled = -1;
+	unsigned int mPolygonMode = kUnknown;
+	float mPointSize = -1.0f;
+	int mViewport[4] = {-1, -1, -1, -1};
+
+	unsigned long long mRequested = 0;
+	unsigned long long mSkipped = 0;
+};
+
 // ============================================================================
 // GL Resource Wrappers (RAII for OpenGL objects)
 // ============================================================================
@@ -19,21 +134,42 @@ public:
 	~GlBuffer() { destroy(); }
 	GlBuffer(const GlBuffer&) = delete;
 	GlBuffer& operator=(const GlBuffer&) = delete;
-	GlBuffer(GlBuffer&& other) noexcept { mId = other.mId; other.mId = 0; }
-	GlBuffer& operator=(GlBuffer&& other) noexcept { if (this != &other) { destroy(); mId = other.mId; other.mId = 0; } return *this; }
+	GlBuffer(GlBuffer&& other) noexcept { steal(other); }
+	GlBuffer& operator=(GlBuffer&& other) noexcept { if (this != &other) { destroy(); steal(other); } return *this; }
 
-	void create() { if (mId == 0) glGenBuffers(1, &mId); }
-	void destroy() { if (mId) { glDeleteBuffers(1, &mId); mId = 0; } }
+	// Category is used for memory accounting only (see MemoryTracker). Re-creating an existing buffer
+	// under another category moves its tracked bytes along.
+	void create(MemoryCategory category = MemoryCategory::Other) {
+		if (mId == 0) glGenBuffers(1, &mId);
+		if (category != mCategory) {
+			MemoryTracker::instance().release(mCategory, mSize);
+			MemoryTracker::instance().allocate(category, mSize);
+			mCategory = category;
+		}
+	}
+	void destroy() { if (mId) { GLStateCache::instance().onBufferDeleted(mId); glDeleteBuffers(1, &mId); mId = 0; } track(0); }
 	bool valid() const { return mId != 0; }
 	GlId id() const { return mId; }
+	std::size_t sizeBytes() const { return mSize; }
 
-	void bind(unsigned int target) const { glBindBuffer(target, mId); }
-	void setData(unsigned int target, std::intptr_t size, const void* data, unsigned int usage) const { glBufferData(target, size, data, usage); }
+	void bind(unsigned int target) const { GLStateCache::instance().bindBuffer(target, mId); }
+	void setData(unsigned int target, std::intptr_t size, const void* data, unsigned int usage) { glBufferData(target, size, data, usage); track(static_cast<std::size_t>(size)); }
 	void updateData(unsigned int target, std::intptr_t offset, std::intptr_t size, const void* data) const { glBufferSubData(target, offset, size, data); }
-	void bindBase(unsigned int target, unsigned int index) const { glBindBufferBase(target, index, mId); }
+	void bindBase(unsigned int target, unsigned int index) const { GLStateCache::instance().bindBufferBase(target, index, mId); }
 
 private:
+	void track(std::size_t newSize) {
+		if (newSize != mSize) { MemoryTracker::instance().resize(mCategory, mSize, newSize); mSize = newSize; }
+	}
+	void steal(GlBuffer& other) {
+		mId = other.mId; other.mId = 0;
+		mSize = other.mSize; other.mSize = 0;
+		mCategory = other.mCategory;
+	}
+
 	GlId mId = 0;
+	std::size_t mSize = 0;
+	MemoryCategory mCategory = MemoryCategory::Other;
 };
 
 class GlVertexArray {
@@ -45,17 +181,31 @@ public:
 	GlVertexArray(GlVertexArray&& other) noexcept { mId = other.mId; other.mId = 0; }
 	GlVertexArray& operator=(GlVertexArray&& other) noexcept { if (this != &other) { destroy(); mId = other.mId; other.mId = 0; } return *this; }
 
-	void create() { if (mId == 0) glGenVertexArrays(1, &mId); }
-	void destroy() { if (mId) { glDeleteVertexArrays(1, &mId); mId = 0; } }
+	void create() { if (mId == 0) { glGenVertexArrays(1, &mId); MemoryTracker::instance().trackVertexArray(+1); } }
+	void destroy() { if (mId) { GLStateCache::instance().onVertexArrayDeleted(mId); glDeleteVertexArrays(1, &mId); mId = 0; MemoryTracker::instance().trackVertexArray(-1); } }
 	bool valid() const { return mId != 0; }
 	GlId id() const { return mId; }
 
-	void bind() const { glBindVertexArray(mId); }
+	void bind() const { GLStateCache::instance().bindVertexArray(mId); }
 
 private:
 	GlId mId = 0;
 };
 
+/// Check whether the current context exposes an extension (uses glGetStringi, valid in core profiles).
+bool hasGLExtension(const char* name);
+
+/// Read a whole text file (shader sources).
+/// @return false if the file cannot be opened
+bool readTextFile(const std::string& path, std::string& out);
+
+/// FNV-1a hash of a byte range. Chain calls through seed to hash several values (frame signatures, cache keys).
+inline uint64_t hashBytes(const void* data, std::size_t size, uint64_t seed = 14695981039346656037ULL) {
+	const unsigned char* bytes = static_cast<const unsigned char*>(data);
+	for (std::size_t i = 0; i < size; ++i) { seed ^= bytes[i]; seed *= 1099511628211ULL; }
+	return seed;
+}
+
 // ============================================================================
 // Configuration Constants
 // ============================================================================
@@ -67,24 +217,54 @@ static constexpr unsigned int PointCloudMinPointsForOctree = 100000;
 static constexpr unsigned int OctreeMaxDepth               = 12;
 static constexpr unsigned int OctreePointsPerNode          = 1000;
 static constexpr unsigned int VertexOptimizationMinVerts   = 10000;
+static constexpr unsigned int MeshLodMinTriangles          = 20000;  // Smaller meshes draw at full detail only
+static constexpr unsigned int OcclusionMaxLatencyFrames    = 4;  // Occlusion results later than this are dropped (node drawn)
+static constexpr unsigned int OcclusionVisibleQueryInterval = 4; // Visible nodes re-test every N frames (staggered per node)
+static constexpr unsigned int SoftwareOcclusionMaxTriangles = 65536;  // Occluder triangle budget per frame (CPU Hi-Z)
+static constexpr unsigned int SoftwareOcclusionMinOccluderArea = 64;   // Min projected area (CPU buffer pixels) to be an occluder
+static constexpr float InstancedSphereLodPixels[3] = {2.0f, 6.0f, 16.0f};  // Projected sphere radius (px) where the next icosphere level starts
+static constexpr float MixedModeSpherePixels = 8.0f;    // Auto LOD: leaves whose spheres reach this radius (px) use instanced spheres
+static constexpr float MixedModeImpostorPixels = 1.5f;  // ...and this radius impostors; smaller ones GL_POINTS
+static constexpr unsigned int ImpostorLodOverdraw = 4;  // Impostors drawn per octree leaf: at most this many layers of the leaf's footprint
+static constexpr unsigned int RefinementImpostorsPerFrame = 2000000;  // Impostors a still frame may add to the refined image
+static constexpr unsigned int InputRedrawFrames = 3;  // On-demand rendering: frames drawn after an input event (lets ImGui settle)
+static constexpr double IdleWaitSeconds = 0.25;       // Longest sleep while idle (hot reload and background LOD builds are polled)
+static constexpr double ShaderPollSeconds = 0.5;      // Hot reload without inotify: interval between shader directory scans
+static constexpr float WorldGridSpacing = 1.25f;      // Distance between neighbouring objects of a multi-model world (unit-box models)
+static constexpr unsigned int CullMinObjectsPerThread = 4096;  // World culling: objects per worker below which it stays on one thread
+static constexpr float WireframeWidthPixels = 1.0f;   // Edge width of the wireframe overlay
 } // namespace Config
 
 namespace Half {
+/// IEEE 754 binary16 conversion matching the hardware paths bit for bit (F16C / NEON):
+/// round to nearest even, subnormal results kept, overflow to infinity, NaN quieted with its payload truncated.
 inline uint16_t floatToHalf(float f) {
 	uint32_t bits;
 	std::memcpy(&bits, &f, sizeof(float));
-	uint32_t sign = ((bits >> 31) << 15) & 0x8000;
-	uint32_t exp = ((bits >> 23) & 0xFF);
-	uint32_t mantissa = (bits >> 13) & 0x3FF;
-	if (exp == 0xFF) {
-		if (mantissa == 0) return static_cast<uint16_t>(sign | 0x7C00);
-		return static_cast<uint16_t>(sign | 0x7E00);
+	uint32_t sign = (bits >> 16) & 0x8000;
+	uint32_t abs = bits & 0x7FFFFFFF;
+	if (abs >= 0x7F800000) {
+		if (abs == 0x7F800000) return static_cast<uint16_t>(sign | 0x7C00);
+		return static_cast<uint16_t>(sign | 0x7E00 | ((abs >> 13) & 0x3FF));
+	}
+	if (abs >= 0x47800000) return static_cast<uint16_t>(sign | 0x7C00);  // >= 65536 (65520 and up round there below)
+	if (abs < 0x38800000) {
+		// Below the smallest normal half (2^-14): subnormal, or zero under 2^-25
+		uint32_t exp = abs >> 23;
+		if (exp < 102) return static_cast<uint16_t>(sign);
+		uint32_t mantissa = (abs & 0x7FFFFF) | 0x800000;
+		uint32_t shift = 126 - exp;
+		uint32_t half = mantissa >> shift;
+		uint32_t rest = mantissa & ((1u << shift) - 1);
+		uint32_t tie = 1u << (shift - 1);
+		if (rest > tie || (rest == tie && (half & 1))) half++;  // May carry into the smallest normal
+		return static_cast<uint16_t>(sign | half);
 	}
-	if (exp == 0) return static_cast<uint16_t>(sign);
-	int32_t exp32 = static_cast<int32_t>(exp) - 127 + 15;
-	if (exp32 > 31) return static_cast<uint16_t>(sign | 0x7C00);
-	if (exp32 < 0)  return static_cast<uint16_t>(sign);
-	return static_cast<uint16_t>(sign | (static_cast<uint32_t>(exp32) << 10) | mantissa);
+	// Normal: rebias the exponent (127 -> 15) and round the dropped 13 mantissa bits
+	uint32_t half = (abs - 0x38000000) >> 13;
+	uint32_t rest = abs & 0x1FFF;
+	if (rest > 0x1000 || (rest == 0x1000 && (half & 1))) half++;  // May carry into the exponent, up to infinity
+	return static_cast<uint16_t>(sign | half);
 }
 } // namespace Half
 
@@ -96,41 +276,6 @@ struct OptimizedVertex {
 	float    scalar;
 };
 
-// OpenGL state cache to avoid redundant state changes
-class GLStateCache {
-public:
-	GLStateCache() = default;
-	~GLStateCache() = default;
-	GLStateCache(const GLStateCache&) = delete;
-	GLStateCache& operator=(const GLStateCache&) = delete;
-
-	void initialize();
-	void reset();
-
-	// Depth testing
-	void depthFunc(unsigned int func);
-	void depthMask(unsigned char enabled);
-	void enableDepthTest(bool enable = true);
-
-	// Color writes
-	void colorMask(unsigned char r, unsigned char g, unsigned char b, unsigned char a);
-
-	// Face culling
-	void enableCullFace(bool enable = true);
-
-	// Blending
-	void enableBlend(bool enable = true);
-
-private:
-	int mCurrentProgram = -1;
-	int mDepthFunc = 0x0201; // GL_LESS
-	unsigned char mDepthWrite = 1; // GL_TRUE
-	unsigned char mColorWrite[4] = {1,1,1,1};
-	bool mBlendEnabled = false;
-	bool mCullFaceEnabled = false;
-	bool mDepthTestEnabled = false;
-};
-
 // ============================================================================
 // Frame State (per-frame computed state passed through rendering pipeline)
 // ============================================================================
@@ -140,9 +285,10 @@ struct FrameState {
 	glm::mat4 proj;       // Projection matrix
 	glm::mat4 viewProj;   // Pre-computed view * projection (for efficiency)
 	glm::vec3 camPos;     // Camera position in world space
+	glm::vec2 viewportSize;  // Framebuffer size in pixels (for screen-space LOD error)
 	
-	FrameState(const glm::mat4& v, const glm::mat4& p, const glm::vec3& pos)
-		: view(v), proj(p), viewProj(p * v), camPos(pos) {}
+	FrameState(const glm::mat4& v, const glm::mat4& p, const glm::vec3& pos, const glm::vec2& viewport = glm::vec2(0.0f))
+		: view(v), proj(p), viewProj(p * v), camPos(pos), viewportSize(viewport) {}
 };
 
 } // namespace Graphics
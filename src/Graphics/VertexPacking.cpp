@@ -0,0 +1,254 @@
+#include "Graphics/VertexPacking.hpp"
+#include "Graphics/WorkerPool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>  // For offsetof
+#include <vector>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define PHV_X86_DISPATCH 1
+#include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#define PHV_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace Graphics {
+namespace VertexPacking {
+
+// The SIMD paths load position, normal and texcoord as one run of 8 floats
+static_assert(offsetof(Vertex, normal) == 3 * sizeof(float), "Vertex layout changed");
+static_assert(offsetof(Vertex, texcoord) == 6 * sizeof(float), "Vertex layout changed");
+
+// Elements per worker below which threading costs more than it saves
+static constexpr size_t kMinElementsPerThread = 1 << 16;
+
+// Split [0, count) into chunks on the shared worker pool
+template <typename Fn>
+static void parallelFor(size_t count, Fn&& fn) {
+	WorkerPool::instance().parallelFor(count, kMinElementsPerThread, fn);
+}
+
+static inline void copyFloatAttributes(const Vertex& v, OptimizedVertex& o) {
+	o.normal[0] = v.normal.x;
+	o.normal[1] = v.normal.y;
+	o.normal[2] = v.normal.z;
+	o.color[0] = v.color.x;
+	o.color[1] = v.color.y;
+	o.color[2] = v.color.z;
+	o.scalar = v.scalar;
+}
+
+// ----------------------------------------------------------------------------
+// Scalar fallbacks
+// ----------------------------------------------------------------------------
+
+static void packScalar(const Vertex* src, size_t count, OptimizedVertex* dst) {
+	for (size_t i = 0; i < count; ++i) {
+		const Vertex& v = src[i];
+		OptimizedVertex& o = dst[i];
+		o.pos[0] = Half::floatToHalf(v.position.x);
+		o.pos[1] = Half::floatToHalf(v.position.y);
+		o.pos[2] = Half::floatToHalf(v.position.z);
+		o.uv[0] = Half::floatToHalf(v.texcoord.x);
+		o.uv[1] = Half::floatToHalf(v.texcoord.y);
+		copyFloatAttributes(v, o);
+	}
+}
+
+static unsigned int maxIndexScalar(const unsigned int* p, size_t n) {
+	unsigned int m = 0;
+	for (size_t i = 0; i < n; ++i) m = std::max(m, p[i]);
+	return m;
+}
+
+static void narrowScalar(const unsigned int* src, size_t n, uint16_t* dst) {
+	for (size_t i = 0; i < n; ++i) dst[i] = static_cast<uint16_t>(src[i]);
+}
+
+// ----------------------------------------------------------------------------
+// x86: F16C / AVX2 / SSE4.1, selected with __builtin_cpu_supports
+// ----------------------------------------------------------------------------
+
+#if defined(PHV_X86_DISPATCH)
+
+__attribute__((target("avx,f16c")))
+static void packF16C(const Vertex* src, size_t count, OptimizedVertex* dst) {
+	alignas(16) uint16_t h[8];
+	for (size_t i = 0; i < count; ++i) {
+		const Vertex& v = src[i];
+		// position.xyz, normal.xyz, texcoord.xy -> 8 halves (round to nearest); normals stay float
+		__m128i halves = _mm256_cvtps_ph(_mm256_loadu_ps(&v.position.x), _MM_FROUND_TO_NEAREST_INT);
+		_mm_store_si128(reinterpret_cast<__m128i*>(h), halves);
+		OptimizedVertex& o = dst[i];
+		o.pos[0] = h[0];
+		o.pos[1] = h[1];
+		o.pos[2] = h[2];
+		o.uv[0] = h[6];
+		o.uv[1] = h[7];
+		copyFloatAttributes(v, o);
+	}
+}
+
+__attribute__((target("avx2")))
+static unsigned int maxIndexAVX2(const unsigned int* p, size_t n) {
+	__m256i m = _mm256_setzero_si256();
+	size_t i = 0;
+	for (; i + 8 <= n; i += 8) m = _mm256_max_epu32(m, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i)));
+	alignas(32) unsigned int lanes[8];
+	_mm256_store_si256(reinterpret_cast<__m256i*>(lanes), m);
+	unsigned int r = maxIndexScalar(p + i, n - i);
+	for (unsigned int lane : lanes) r = std::max(r, lane);
+	return r;
+}
+
+__attribute__((target("sse4.1")))
+static unsigned int maxIndexSSE41(const unsigned int* p, size_t n) {
+	__m128i m = _mm_setzero_si128();
+	size_t i = 0;
+	for (; i + 4 <= n; i += 4) m = _mm_max_epu32(m, _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i)));
+	alignas(16) unsigned int lanes[4];
+	_mm_store_si128(reinterpret_cast<__m128i*>(lanes), m);
+	unsigned int r = maxIndexScalar(p + i, n - i);
+	for (unsigned int lane : lanes) r = std::max(r, lane);
+	return r;
+}
+
+__attribute__((target("sse4.1")))
+static void narrowSSE41(const unsigned int* src, size_t n, uint16_t* dst) {
+	size_t i = 0;
+	// packus saturates signed int32 to [0, 65535]; exact since every index < 65536
+	for (; i + 8 <= n; i += 8) {
+		__m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+		__m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 4));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi32(a, b));
+	}
+	narrowScalar(src + i, n - i, dst + i);
+}
+
+struct CpuFeatures {
+	bool f16c = false;
+	bool avx2 = false;
+	bool sse41 = false;
+	CpuFeatures() {
+		__builtin_cpu_init();
+		f16c = __builtin_cpu_supports("avx") && __builtin_cpu_supports("f16c");
+		avx2 = __builtin_cpu_supports("avx2");
+		sse41 = __builtin_cpu_supports("sse4.1");
+	}
+};
+
+static const CpuFeatures& cpuFeatures() {
+	static const CpuFeatures features;
+	return features;
+}
+
+#endif // PHV_X86_DISPATCH
+
+// ----------------------------------------------------------------------------
+// ARM64: NEON is always available
+// ----------------------------------------------------------------------------
+
+#if defined(PHV_NEON)
+
+static void packNEON(const Vertex* src, size_t count, OptimizedVertex* dst) {
+	uint16_t h[4];
+	for (size_t i = 0; i < count; ++i) {
+		const Vertex& v = src[i];
+		OptimizedVertex& o = dst[i];
+		vst1_u16(h, vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(&v.position.x))));  // pos.xyz, normal.x
+		o.pos[0] = h[0];
+		o.pos[1] = h[1];
+		o.pos[2] = h[2];
+		vst1_u16(h, vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(&v.texcoord.x))));  // uv.xy, color.xy
+		o.uv[0] = h[0];
+		o.uv[1] = h[1];
+		copyFloatAttributes(v, o);
+	}
+}
+
+static unsigned int maxIndexNEON(const unsigned int* p, size_t n) {
+	uint32x4_t m = vdupq_n_u32(0);
+	size_t i = 0;
+	for (; i + 4 <= n; i += 4) m = vmaxq_u32(m, vld1q_u32(p + i));
+	return std::max(vmaxvq_u32(m), maxIndexScalar(p + i, n - i));
+}
+
+static void narrowNEON(const unsigned int* src, size_t n, uint16_t* dst) {
+	size_t i = 0;
+	for (; i + 8 <= n; i += 8) {
+		uint16x8_t packed = vcombine_u16(vmovn_u32(vld1q_u32(src + i)), vmovn_u32(vld1q_u32(src + i + 4)));
+		vst1q_u16(dst + i, packed);
+	}
+	narrowScalar(src + i, n - i, dst + i);
+}
+
+#endif // PHV_NEON
+
+// ----------------------------------------------------------------------------
+// Dispatch
+// ----------------------------------------------------------------------------
+
+static void packRange(const Vertex* src, size_t count, OptimizedVertex* dst) {
+#if defined(PHV_X86_DISPATCH)
+	if (cpuFeatures().f16c) { packF16C(src, count, dst); return; }
+#elif defined(PHV_NEON)
+	packNEON(src, count, dst); return;
+#endif
+	packScalar(src, count, dst);
+}
+
+static unsigned int maxIndexRange(const unsigned int* p, size_t n) {
+#if defined(PHV_X86_DISPATCH)
+	if (cpuFeatures().avx2) return maxIndexAVX2(p, n);
+	if (cpuFeatures().sse41) return maxIndexSSE41(p, n);
+#elif defined(PHV_NEON)
+	return maxIndexNEON(p, n);
+#endif
+	return maxIndexScalar(p, n);
+}
+
+static void narrowRange(const unsigned int* src, size_t n, uint16_t* dst) {
+#if defined(PHV_X86_DISPATCH)
+	if (cpuFeatures().sse41) { narrowSSE41(src, n, dst); return; }
+#elif defined(PHV_NEON)
+	narrowNEON(src, n, dst); return;
+#endif
+	narrowScalar(src, n, dst);
+}
+
+void packOptimizedVertices(const Vertex* src, size_t count, OptimizedVertex* dst) {
+	parallelFor(count, [&](size_t begin, size_t end) { packRange(src + begin, end - begin, dst + begin); });
+}
+
+void packOptimizedVerticesScalar(const Vertex* src, size_t count, OptimizedVertex* dst) {
+	packScalar(src, count, dst);
+}
+
+unsigned int maxIndex(const unsigned int* indices, size_t count) {
+	std::vector<unsigned int> partial(WorkerPool::instance().workerCount() + 1, 0);
+	std::atomic<size_t> slot{0};
+	parallelFor(count, [&](size_t begin, size_t end) {
+		partial[slot.fetch_add(1)] = maxIndexRange(indices + begin, end - begin);
+	});
+	return *std::max_element(partial.begin(), partial.end());
+}
+
+void narrowIndices(const unsigned int* src, size_t count, uint16_t* dst) {
+	parallelFor(count, [&](size_t begin, size_t end) { narrowRange(src + begin, end - begin, dst + begin); });
+}
+
+const char* simdPathName() {
+#if defined(PHV_X86_DISPATCH)
+	if (cpuFeatures().f16c) return cpuFeatures().avx2 ? "F16C/AVX2" : "F16C";
+	return cpuFeatures().sse41 ? "SSE4.1" : "scalar";
+#elif defined(PHV_NEON)
+	return "NEON";
+#else
+	return "scalar";
+#endif
+}
+
+} // namespace VertexPacking
+} // namespace Graphics
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "Graphics/Model.h"
+#include "Graphics/Utils.hpp"
+
+namespace Graphics {
+
+// Vectorized, multithreaded conversion stages used by Model::uploadToGPU().
+// The instruction set is picked at runtime (F16C/AVX2/SSE4.1 on x86, NEON on ARM64)
+// with a scalar fallback; large inputs are split across worker threads.
+namespace VertexPacking {
+
+/// Convert full-float vertices to the half-float OptimizedVertex layout.
+/// @param src Source vertices
+/// @param count Number of vertices
+/// @param dst Destination (may be a mapped GL buffer); must hold count elements
+void packOptimizedVertices(const Vertex* src, size_t count, OptimizedVertex* dst);
+
+/// Same conversion through the scalar path on the calling thread (Half::floatToHalf).
+/// Reference for the SIMD paths, which must produce identical bits.
+void packOptimizedVerticesScalar(const Vertex* src, size_t count, OptimizedVertex* dst);
+
+/// Largest value in an index array (0 for an empty array).
+unsigned int maxIndex(const unsigned int* indices, size_t count);
+
+/// Narrow 32-bit indices to 16-bit. Every index must be < 65536 (check with maxIndex()).
+void narrowIndices(const unsigned int* src, size_t count, uint16_t* dst);
+
+/// Name of the conversion path selected for this CPU (for logging).
+const char* simdPathName();
+
+} // namespace VertexPacking
+} // namespace Graphics
@@ -0,0 +1,81 @@
+#include "Graphics/WorkerPool.hpp"
+#include "Graphics/Profiling/CpuProfiler.hpp"
+
+#include <algorithm>
+
+namespace Graphics {
+
+WorkerPool& WorkerPool::instance() {
+	static WorkerPool pool;
+	return pool;
+}
+
+WorkerPool::WorkerPool() {
+	// The calling thread takes chunks too, so one worker fewer than there are cores
+	unsigned int cores = std::max(1u, std::thread::hardware_concurrency());
+	for (unsigned int i = 1; i < cores; ++i) mWorkers.emplace_back([this]() { workerLoop(); });
+}
+
+WorkerPool::~WorkerPool() {
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mQuit = true;
+	}
+	mWake.notify_all();
+	for (std::thread& worker : mWorkers) worker.join();
+}
+
+void WorkerPool::parallelFor(size_t count, size_t minPerThread, const std::function<void(size_t, size_t)>& fn) {
+	size_t chunks = std::min(mWorkers.size() + 1, count / std::max<size_t>(1, minPerThread));
+	bool idle = false;
+	if (chunks <= 1 || !mInFlight.compare_exchange_strong(idle, true)) {
+		if (count > 0) fn(size_t(0), count);
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mFn = &fn;
+		mCount = count;
+		mChunkSize = (count + chunks - 1) / chunks;
+		mChunkCount = chunks;
+		mNextChunk.store(0);
+		mBusyWorkers = static_cast<unsigned int>(mWorkers.size());
+		++mGeneration;
+	}
+	mWake.notify_all();
+	runChunks();
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		mDone.wait(lock, [this]() { return mBusyWorkers == 0; });
+		mFn = nullptr;
+	}
+	mInFlight.store(false);
+}
+
+void WorkerPool::runChunks() {
+	for (size_t chunk; (chunk = mNextChunk.fetch_add(1)) < mChunkCount;) {
+		size_t begin = std::min(mCount, chunk * mChunkSize);
+		size_t end = std::min(mCount, begin + mChunkSize);
+		if (begin == end) continue;
+		PHV_CPU_SCOPE("WorkerPool chunk");
+		(*mFn)(begin, end);
+	}
+}
+
+void WorkerPool::workerLoop() {
+	CpuProfiler::instance().setThreadName("Worker Pool");
+	unsigned int seen = 0;
+	for (;;) {
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			mWake.wait(lock, [&]() { return mQuit || mGeneration != seen; });
+			if (mQuit) return;
+			seen = mGeneration;
+		}
+		runChunks();
+		std::lock_guard<std::mutex> lock(mMutex);
+		if (--mBusyWorkers == 0) mDone.notify_one();
+	}
+}
+
+} // namespace Graphics
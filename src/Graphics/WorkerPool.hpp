@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Graphics {
+
+/// Persistent worker threads shared by the data-parallel loops (vertex packing, world culling, occlusion rasterization).
+/// The threads start with the first loop and live until exit, so per-frame loops never pay for
+/// thread creation. One loop runs on the pool at a time: a loop started while another is in flight
+/// (from another thread, or nested inside it) runs on its caller alone.
+class WorkerPool {
+public:
+	/// The process-wide pool (created on first use).
+	static WorkerPool& instance();
+
+	~WorkerPool();
+	WorkerPool(const WorkerPool&) = delete;
+	WorkerPool& operator=(const WorkerPool&) = delete;
+
+	/// Split [0, count) into contiguous chunks of at least minPerThread elements and run fn(begin, end)
+	/// on each, the calling thread included. Returns once every chunk is done.
+	/// @param count Elements to process
+	/// @param minPerThread Elements per chunk below which threading costs more than it saves
+	/// @param fn Called once per chunk, possibly concurrently; must not throw
+	void parallelFor(size_t count, size_t minPerThread, const std::function<void(size_t, size_t)>& fn);
+
+	/// Worker threads (the caller of parallelFor() comes on top).
+	size_t workerCount() const { return mWorkers.size(); }
+
+private:
+	WorkerPool();
+	void workerLoop();
+	void runChunks();
+
+	// parallelFor() publishes its loop and bumps mGeneration; every thread (including the caller)
+	// pulls chunks from mNextChunk until none are left
+	std::vector<std::thread> mWorkers;
+	std::atomic<bool> mInFlight{false};
+	std::mutex mMutex;
+	std::condition_variable mWake;
+	std::condition_variable mDone;
+	const std::function<void(size_t, size_t)>* mFn = nullptr;
+	size_t mCount = 0;
+	size_t mChunkSize = 0;
+	size_t mChunkCount = 0;
+	std::atomic<size_t> mNextChunk{0};
+	unsigned int mGeneration = 0;
+	unsigned int mBusyWorkers = 0;
+	bool mQuit = false;
+};
+
+} // namespace Graphics
@@ -0,0 +1,282 @@
+#include "Graphics/World.hpp"
+#include "Graphics/Utils.hpp"
+#include "Graphics/Profiling/CpuProfiler.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <limits>
+#include <unordered_map>
+
+namespace Graphics {
+
+bool World::parsePlacement(const std::string& arg, std::string& outPath, Placement& outPlacement) {
+	outPath = arg;
+	outPlacement = Placement();
+	size_t at = arg.rfind('@');
+	if (at == std::string::npos || std::filesystem::exists(arg)) return true;  // A file whose name has an '@'
+	// Up to five numbers, nothing after them; anything else is an error
+	const char* spec = arg.c_str() + at + 1;
+	float v[5] = {0.0f, 0.0f, 0.0f, 1.0f, 0.0f};
+	int used = 0;
+	int count = std::sscanf(spec, "%f,%f,%f%n", &v[0], &v[1], &v[2], &used);
+	if (count != 3) return false;
+	for (int i = 3; i < 5 && spec[used] == ','; ++i) {
+		int more = 0;
+		if (std::sscanf(spec + used, ",%f%n", &v[i], &more) != 1) return false;
+		used += more;
+	}
+	if (spec[used] != '\0' || !(v[3] > 0.0f)) return false;
+	outPath = arg.substr(0, at);
+	outPlacement.given = true;
+	outPlacement.position = glm::vec3(v[0], v[1], v[2]);
+	outPlacement.scale = v[3];
+	outPlacement.yawDegrees = v[4];
+	return true;
+}
+
+bool World::load(const std::vector<std::string>& paths, std::string& outError) {
+	mObjects.clear();
+	mModels.clear();
+	mModelIndex.clear();
+	mPlacements.clear();
+	std::unordered_map<std::string, unsigned int> loaded;  // Canonical path -> entry in mModels
+	for (const std::string& arg : paths) {
+		std::string path;
+		Placement placement;
+		if (!parsePlacement(arg, path, placement)) {
+			outError = arg + ": placement must be @x,y,z[,scale[,yaw]] with a positive scale";
+			return false;
+		}
+		std::error_code ec;
+		std::string key = std::filesystem::weakly_canonical(path, ec).string();
+		if (ec) key = path;
+		auto it = loaded.find(key);
+		if (it == loaded.end()) {
+			auto model = std::make_shared<Model>();
+			std::string err;
+			if (!model->loadFromFile(path, err)) { outError = path + ": " + err; return false; }
+			it = loaded.emplace(key, static_cast<unsigned int>(mModels.size())).first;
+			mModels.push_back(std::move(model));
+		}
+		Scene object;
+		object.model = mModels[it->second];
+		mObjects.push_back(std::move(object));
+		mModelIndex.push_back(it->second);
+		mPlacements.push_back(placement);
+	}
+	if (mObjects.empty()) { outError = "No model given"; return false; }
+	return true;
+}
+
+void World::uploadToGPU() {
+	for (const std::shared_ptr<Model>& model : mModels) model->uploadToGPU();
+}
+
+void World::initializeGL() {
+	mMatricesRing.create(sizeof(MatricesUBO), std::max<unsigned int>(16, static_cast<unsigned int>(mObjects.size())));
+	mInstancesRing.create(sizeof(InstancesUBO), 16);
+	for (Scene& object : mObjects) {
+		object.initializeUBOs();
+		object.initializeOcclusionQuery();
+	}
+	layout();
+}
+
+void World::destroyGPU() {
+	for (const std::shared_ptr<Model>& model : mModels) model->destroyGPU();
+}
+
+void World::layout() {
+	// Rows and columns as close to square as possible, row 0 at the top (placed objects keep their cell empty)
+	size_t count = mObjects.size();
+	size_t columns = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(count))));
+	size_t rows = columns > 0 ? (count + columns - 1) / columns : 0;
+	for (size_t i = 0; i < count; ++i) {
+		Scene& object = mObjects[i];
+		// Center and scale each model into a unit box, keeping its original orientation
+		glm::vec3 c = object.model->center();
+		glm::vec3 size = object.model->max() - object.model->min();
+		float maxAxis = std::max(size.x, std::max(size.y, size.z));
+		float s = (maxAxis > 0.0f) ? (1.0f / maxAxis) : 1.0f;
+		glm::vec3 offset(
+			(static_cast<float>(i % columns) - 0.5f * static_cast<float>(columns - 1)) * Config::WorldGridSpacing,
+			(0.5f * static_cast<float>(rows - 1) - static_cast<float>(i / columns)) * Config::WorldGridSpacing,
+			0.0f);
+		glm::mat4 T = glm::translate(glm::mat4(1.0f), -c);
+		glm::mat4 S = glm::scale(glm::mat4(1.0f), glm::vec3(s));
+		const Placement& placement = mPlacements[i];
+		if (placement.given) {
+			glm::mat4 place = glm::translate(glm::mat4(1.0f), placement.position);
+			place = glm::rotate(place, glm::radians(placement.yawDegrees), glm::vec3(0.0f, 1.0f, 0.0f));
+			place = glm::scale(place, glm::vec3(placement.scale));
+			object.modelMatrix = place * S * T;
+		} else {
+			object.modelMatrix = glm::translate(glm::mat4(1.0f), offset) * S * T;
+		}
+		object.updateBoundingBox();
+	}
+	updateBounds();
+}
+
+void World::updateBounds() {
+	size_t count = mObjects.size();
+	mBounds.resize(count);
+	mMin = glm::vec3(std::numeric_limits<float>::max());
+	mMax = glm::vec3(std::numeric_limits<float>::lowest());
+	for (size_t i = 0; i < count; ++i) {
+		const Scene& object = mObjects[i];
+		const glm::vec3& lo = object.model->min();
+		const glm::vec3& hi = object.model->max();
+		glm::vec3 bmin(std::numeric_limits<float>::max()), bmax(std::numeric_limits<float>::lowest());
+		for (int corner = 0; corner < 8; ++corner) {
+			glm::vec3 p((corner & 1) ? hi.x : lo.x, (corner & 2) ? hi.y : lo.y, (corner & 4) ? hi.z : lo.z);
+			glm::vec3 w = glm::vec3(object.modelMatrix * glm::vec4(p, 1.0f));
+			bmin = glm::min(bmin, w);
+			bmax = glm::max(bmax, w);
+		}
+		mBounds.set(i, bmin, bmax);
+		mMin = glm::min(mMin, bmin);
+		mMax = glm::max(mMax, bmax);
+	}
+	if (count == 0) mMin = mMax = glm::vec3(0.0f);
+}
+
+void World::update() {
+	for (const std::shared_ptr<Model>& model : mModels) model->update();
+}
+
+bool World::lodBuildPending() const {
+	return std::any_of(mModels.begin(), mModels.end(), [](const std::shared_ptr<Model>& m) { return m->lodBuildPending(); });
+}
+
+bool World::hasPointClouds() const {
+	return std::any_of(mModels.begin(), mModels.end(), [](const std::shared_ptr<Model>& m) { return m->isPointCloud(); });
+}
+
+bool World::hasMeshes() const {
+	return std::any_of(mModels.begin(), mModels.end(), [](const std::shared_ptr<Model>& m) { return !m->isPointCloud(); });
+}
+
+void World::syncSettings() {
+	for (size_t i = 1; i < mObjects.size(); ++i) mObjects[i].copySettingsFrom(mObjects[0]);
+}
+
+void World::beginFrame(const FrameState& frameState, const std::vector<uint32_t>& visible, const RenderQueue& queue) {
+	PHV_CPU_SCOPE("World::beginFrame");
+	mVisible = visible;
+
+	// Occluders of every visible object, tested by every object's nodes in the prepass and the main pass
+	SoftwareOcclusionBuffer* occlusion = prepareSoftwareOcclusion(frameState);
+	for (uint32_t i : mVisible) mObjects[i].beginOcclusionFrame(occlusion);
+
+	// Matrices of every visible object in one upload
+	if (mMatricesRing.valid()) {
+		mMatricesRing.beginFrame();
+		for (uint32_t i : mVisible) mObjects[i].updateUBOs(frameState, mMatricesRing);
+		mMatricesRing.upload();
+	}
+	stageInstances(frameState, queue);
+}
+
+void World::stageInstances(const FrameState& frameState, const RenderQueue& queue) {
+	const std::vector<RenderQueue::Item>& items = queue.items();
+	mRunAt.assign(items.size(), -1);
+	mInstancedRuns.clear();
+	mInstanceDraws.clear();
+	mInstancedObjects = 0;
+	if (!mInstancesRing.valid() || !mMatricesRing.valid()) return;
+	PHV_CPU_SCOPE("World::stageInstances");
+	mInstancesRing.beginFrame();
+	queue.batches(mBatches);
+	for (const RenderQueue::Batch& batch : mBatches) {
+		// The key's vertex format is the model index cut to its bits: runs also break where the Model changes
+		for (size_t first = batch.first; first < batch.end;) {
+			const Scene& head = mObjects[items[first].object];
+			size_t end = first + 1;
+			while (end < batch.end && mObjects[items[end].object].model == head.model) end++;
+			if (end - first >= 2 && head.instanceable()) stageRun(frameState, items, first, end);
+			first = end;
+		}
+	}
+	mInstancesRing.upload();
+}
+
+void World::stageRun(const FrameState& frameState, const std::vector<RenderQueue::Item>& items, size_t first, size_t end) {
+	InstancedRun run;
+	run.object = items[first].object;
+	run.end = end;
+	run.firstDraw = mInstanceDraws.size();
+	size_t meshCount = mObjects[run.object].model->meshes().size();
+	for (size_t mesh = 0; mesh < meshCount; ++mesh) {
+		// Objects grouped by the LOD level they pick for this mesh, front to back within a level
+		mRunLods.clear();
+		for (size_t i = first; i < end; ++i) {
+			int lod = mObjects[items[i].object].instanceLod(mesh, frameState);
+			if (lod != Scene::kMeshOccluded) mRunLods.push_back({lod, items[i].object});
+		}
+		std::stable_sort(mRunLods.begin(), mRunLods.end(), [](const std::pair<int, uint32_t>& a, const std::pair<int, uint32_t>& b) { return a.first < b.first; });
+		for (size_t i = 0; i < mRunLods.size();) {
+			InstancesUBO block{};
+			MeshInstances draw;
+			draw.mesh = static_cast<uint32_t>(mesh);
+			draw.lod = mRunLods[i].first;
+			while (i < mRunLods.size() && mRunLods[i].first == draw.lod && draw.count < InstancesUBO::kMaxInstances) {
+				block.models[draw.count++] = mObjects[mRunLods[i++].second].modelMatrix;
+			}
+			draw.block = mInstancesRing.push(&block);
+			mInstanceDraws.push_back(draw);
+		}
+	}
+	run.drawCount = mInstanceDraws.size() - run.firstDraw;
+	mRunAt[first] = static_cast<int>(mInstancedRuns.size());
+	mInstancedRuns.push_back(run);
+	// The prepass and the main pass form separate runs of the same objects
+	if (RenderQueue::pass(items[first].key) == RenderQueue::Pass::Opaque) mInstancedObjects += static_cast<unsigned int>(end - first);
+}
+
+size_t World::instancedRunEnd(size_t item) const {
+	if (item >= mRunAt.size() || mRunAt[item] < 0) return item;
+	return mInstancedRuns[static_cast<size_t>(mRunAt[item])].end;
+}
+
+void World::drawInstancedRun(size_t item, Shader& shader, bool wireframe, ProfilingData* profData) {
+	if (item >= mRunAt.size() || mRunAt[item] < 0) return;
+	const InstancedRun& run = mInstancedRuns[static_cast<size_t>(mRunAt[item])];
+	mObjects[run.object].drawInstances(shader, mInstancesRing, mInstanceDraws.data() + run.firstDraw, run.drawCount, wireframe, profData);
+}
+
+SoftwareOcclusionBuffer* World::prepareSoftwareOcclusion(const FrameState& frameState) {
+	const Scene& settings = primary();  // Settings are synced from the primary object
+	if (!settings.enableSoftwareOcclusion || settings.fullDetail) return nullptr;  // Occluders are approximate: not for still frames
+	PHV_CPU_SCOPE("World::softwareOcclusion");
+	if (!mSoftwareOcclusion) mSoftwareOcclusion = std::make_unique<SoftwareOcclusionBuffer>();
+	SoftwareOcclusionBuffer& buffer = *mSoftwareOcclusion;
+	buffer.beginFrame(frameState.viewProj);
+
+	// Largest on-screen occluders of the whole world first, until the triangle budget is spent.
+	// Point clouds have no surfaces: they are only tested against the meshes.
+	struct Occluder { float area; uint32_t object; size_t mesh; };
+	std::vector<Occluder> occluders;
+	for (uint32_t i : mVisible) {
+		const Scene& object = mObjects[i];
+		if (object.model->isPointCloud()) continue;
+		const std::vector<Mesh>& meshes = object.model->meshes();
+		for (size_t m = 0; m < meshes.size(); ++m) {
+			if (meshes[m].occluder.empty()) continue;
+			float area = buffer.projectedArea(meshes[m].boundsMin, meshes[m].boundsMax, object.modelMatrix);
+			if (area >= static_cast<float>(Config::SoftwareOcclusionMinOccluderArea)) occluders.push_back({area, i, m});
+		}
+	}
+	std::sort(occluders.begin(), occluders.end(), [](const Occluder& a, const Occluder& b) { return a.area > b.area; });
+	for (const Occluder& occluder : occluders) {
+		const Scene& object = mObjects[occluder.object];
+		const OccluderMesh& mesh = object.model->meshes()[occluder.mesh].occluder;
+		if (!buffer.addOccluder(mesh.positions, mesh.indices, object.modelMatrix)) break;
+	}
+	buffer.rasterize();
+	return buffer.hasOccluders() ? &buffer : nullptr;
+}
+
+} // namespace Graphics
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "Graphics/Model.h"
+#include "Graphics/RenderQueue.hpp"
+#include "Graphics/RenderUtils.hpp"
+#include "Graphics/Scene.hpp"
+#include "Graphics/UBO.hpp"
+#include "Graphics/Culling/ObjectBounds.hpp"
+
+namespace Graphics {
+
+/// Every object the renderer draws.
+/// An object is a Scene: a model, its transform and its own culling / LOD state. A file named more
+/// than once is loaded and uploaded once; its objects share the Model (geometry, octree, mesh LODs).
+/// Objects are normalized to a unit box and laid out side by side on a grid in the XY plane, unless
+/// their path carries a placement (see load()). The render settings are edited on the primary object and copied to the others each frame.
+class World {
+public:
+	World() = default;
+	World(const World&) = delete;
+	World& operator=(const World&) = delete;
+	World(World&&) noexcept = default;
+	World& operator=(World&&) noexcept = default;
+
+	/// Load the models (CPU side). Identical paths share one Model.
+	/// A path may end in "@x,y,z[,scale[,yaw]]": that object's unit box is scaled, turned by yaw degrees
+	/// about +Y and centered at (x, y, z) instead of taking a grid cell.
+	/// @param paths Model files, one object each (.obj, .ply, .off)
+	/// @param outError Error message naming the file that failed
+	/// @return false if any file fails to load
+	bool load(const std::vector<std::string>& paths, std::string& outError);
+
+	/// Upload every distinct model to the GPU.
+	void uploadToGPU();
+
+	/// Create the per-object GL state (uniform buffers, occlusion queries, bounding boxes) and the
+	/// shared matrices ring. Call after uploadToGPU().
+	void initializeGL();
+
+	void destroyGPU();
+
+	/// Place the objects (given placements, else the grid) and refresh their world bounds.
+	void layout();
+
+	/// Refresh the world-space bounds after an object's modelMatrix changed.
+	void updateBounds();
+
+	/// Poll every distinct model for finished background work (mesh LOD levels).
+	void update();
+
+	/// True while any model still builds mesh LOD levels in the background.
+	bool lodBuildPending() const;
+
+	/// Copy the primary object's settings (edited in the UI) to the others.
+	void syncSettings();
+
+	/// World-space bounds of every object (refreshed by layout() and updateBounds()).
+	/// The frame pipeline culls a copy, so the World may be laid out while a frame is culled.
+	const ObjectBounds& bounds() const { return mBounds; }
+
+	/// Start drawing a frame: rasterize the occluders of the given objects into the shared CPU
+	/// occlusion buffer (if enabled), stage their uniforms with one upload of the matrices ring and
+	/// pack the instanced runs of the queue with one upload of the instances ring.
+	/// @param frameState Frame state shared by every pass of the frame
+	/// @param visible Objects to draw (from cull())
+	/// @param queue Sorted draws of the visible objects
+	void beginFrame(const FrameState& frameState, const std::vector<uint32_t>& visible, const RenderQueue& queue);
+
+	/// End of the instanced run starting at a queue item: items [item, end) are objects of one model
+	/// in one batch, drawn together by drawInstancedRun(). Returns item when it starts no run.
+	size_t instancedRunEnd(size_t item) const;
+
+	/// Draw the instanced run starting at a queue item: one instanced draw per mesh and LOD level.
+	/// @param item First item of the run (instancedRunEnd(item) > item)
+	/// @param shader INSTANCED permutation (shading or depth-only)
+	/// @param wireframe Feed the wireframe overlay (shader must be a WIREFRAME permutation)
+	/// @param profilingData Optional profiling counters
+	void drawInstancedRun(size_t item, Shader& shader, bool wireframe, ProfilingData* profilingData = nullptr);
+
+	/// Objects drawn in instanced runs this frame (both passes count once).
+	unsigned int instancedObjects() const { return mInstancedObjects; }
+
+	/// Objects drawn this frame (as given to beginFrame()), in index order.
+	const std::vector<uint32_t>& visible() const { return mVisible; }
+
+	/// CPU occlusion buffer shared by every object, or nullptr until software occlusion has been enabled once.
+	SoftwareOcclusionBuffer* softwareOcclusion() { return mSoftwareOcclusion.get(); }
+
+	Scene& primary() { return mObjects.front(); }
+	const Scene& primary() const { return mObjects.front(); }
+	Scene& object(size_t i) { return mObjects[i]; }
+	const Scene& object(size_t i) const { return mObjects[i]; }
+	size_t size() const { return mObjects.size(); }
+	bool empty() const { return mObjects.empty(); }
+
+	/// Distinct models (files) loaded.
+	size_t modelCount() const { return mModels.size(); }
+
+	/// Index of an object's model among the distinct ones (render queue vertex format field).
+	unsigned int modelIndex(size_t object) const { return mModelIndex[object]; }
+
+	/// True if any object is a point cloud.
+	bool hasPointClouds() const;
+	/// True if any object is a mesh.
+	bool hasMeshes() const;
+
+	/// World-space box around every object.
+	const glm::vec3& min() const { return mMin; }
+	const glm::vec3& max() const { return mMax; }
+
+private:
+	// Rasterize the largest mesh occluders of the visible objects once for every pass of the frame;
+	// nullptr if CPU occlusion is off or nothing was rasterized
+	SoftwareOcclusionBuffer* prepareSoftwareOcclusion(const FrameState& frameState);
+	// Split the queue's batches into runs of instanceable objects sharing a Model and push their
+	// model matrices, grouped per mesh and LOD level, to the instances ring
+	void stageInstances(const FrameState& frameState, const RenderQueue& queue);
+	void stageRun(const FrameState& frameState, const std::vector<RenderQueue::Item>& items, size_t first, size_t end);
+
+	std::vector<Scene> mObjects;
+	std::vector<std::shared_ptr<Model>> mModels;  // Distinct models
+	std::vector<unsigned int> mModelIndex;        // Per object: its entry in mModels
+
+	// Transform of an object's unit box given with its path
+	struct Placement {
+		bool given = false;  // False: the object takes its grid cell
+		glm::vec3 position = glm::vec3(0.0f);
+		float scale = 1.0f;
+		float yawDegrees = 0.0f;
+	};
+	static bool parsePlacement(const std::string& arg, std::string& outPath, Placement& outPlacement);
+	std::vector<Placement> mPlacements;           // Per object
+
+	ObjectBounds mBounds;  // World-space bounds of every object
+	std::vector<uint32_t> mVisible;
+	glm::vec3 mMin = glm::vec3(0.0f);
+	glm::vec3 mMax = glm::vec3(0.0f);
+
+	UniformRing mMatricesRing;  // Matrices of every object, one block each per frame
+
+	// Instanced runs of this frame's queue
+	struct InstancedRun {
+		uint32_t object = 0;    // First object (view, material and lighting blocks of the run)
+		size_t end = 0;         // Queue item after the run
+		size_t firstDraw = 0;   // Draws in mInstanceDraws
+		size_t drawCount = 0;
+	};
+	UniformRing mInstancesRing;                    // Model matrices of the runs, one InstancesUBO per draw
+	std::vector<int> mRunAt;                       // Per queue item: its run in mInstancedRuns, -1 if none starts there
+	std::vector<InstancedRun> mInstancedRuns;
+	std::vector<MeshInstances> mInstanceDraws;
+	std::vector<RenderQueue::Batch> mBatches;       // Scratch: the queue's batches
+	std::vector<std::pair<int, uint32_t>> mRunLods; // Scratch: LOD level and object per instance of one mesh
+	unsigned int mInstancedObjects = 0;
+
+	// CPU occluder buffer (created on first use)
+	std::unique_ptr<SoftwareOcclusionBuffer> mSoftwareOcclusion;
+};
+
+} // namespace Graphics
@@ -1,12 +1,186 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
 #include <iostream>
 #include <string>
+#include <vector>
 
 #include "Graphics/RenderDevice.hpp"
 #include "Graphics/Renderer.h"
+#include "Graphics/Offscreen/FrameReadback.hpp"
+#include "Graphics/Profiling/Benchmark.hpp"
+#include "Graphics/Profiling/CpuProfiler.hpp"
 
-int main(int argc, char** argv) {
+struct Options {
 	// Supports both meshes (.obj, .ply, .off with faces) and point clouds (.ply, .off without faces)
-	std::string modelPath = (argc >= 2) ? std::string(argv[1]) : std::string("../assets/bunny/data/bun315.ply");
+	// Several models are laid out side by side; a file named twice is loaded once and drawn twice
+	std::vector<std::string> modelPaths = {"../assets/bunny/data/bun315.ply"};
+	bool headless = false;
+	int width = 1280;
+	int height = 720;
+	int frames = 1;
+	std::string outputDir = "frames";
+	std::string benchmarkPath;  // --benchmark script (JSON)
+	std::string reportPrefix;   // --report overrides the script's "report"
+	bool sizeGiven = false;
+};
+
+static void printUsage(const char* exe) {
+	std::cerr << "Usage: " << exe << " [model...] [--headless] [--size WxH] [--frames N] [--output DIR]\n"
+	          << "       " << exe << " [model...] --benchmark script.json [--report PREFIX] [--headless] [--size WxH]\n"
+	          << "  model[@x,y,z[,scale[,yaw]]]  Place the model's unit box (default: side by side on a grid)\n"
+	          << "  --headless    Render offscreen without a window (EGL surfaceless when available)\n"
+	          << "  --size WxH    Render size in headless mode (default 1280x720)\n"
+	          << "  --frames N    Number of frames to render on an orbit around the model (default 1)\n"
+	          << "  --output DIR  Directory for frame_NNNNN.ppm images (default ./frames)\n"
+	          << "  --benchmark   Replay the script's camera path with vsync off and write a JSON/CSV report\n"
+	          << "  --report P    Report path prefix (writes P.json and P.csv)\n";
+}
+
+static bool parseArgs(int argc, char** argv, Options& opts, std::string& outError) {
+	bool haveModel = false;  // The first model given replaces the default
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		auto next = [&](const char* name) -> const char* {
+			if (i + 1 >= argc) { outError = std::string(name) + " expects a value"; return nullptr; }
+			return argv[++i];
+		};
+		if (arg == "--headless") {
+			opts.headless = true;
+		} else if (arg == "--size") {
+			const char* v = next("--size");
+			if (!v) return false;
+			if (std::sscanf(v, "%dx%d", &opts.width, &opts.height) != 2 || opts.width <= 0 || opts.height <= 0) {
+				outError = "--size expects WxH, got '" + std::string(v) + "'"; return false;
+			}
+			opts.sizeGiven = true;
+		} else if (arg == "--frames") {
+			const char* v = next("--frames");
+			if (!v) return false;
+			opts.frames = std::atoi(v);
+			if (opts.frames <= 0) { outError = "--frames expects a positive count"; return false; }
+		} else if (arg == "--output") {
+			const char* v = next("--output");
+			if (!v) return false;
+			opts.outputDir = v;
+		} else if (arg == "--benchmark") {
+			const char* v = next("--benchmark");
+			if (!v) return false;
+			opts.benchmarkPath = v;
+		} else if (arg == "--report") {
+			const char* v = next("--report");
+			if (!v) return false;
+			opts.reportPrefix = v;
+		} else if (arg == "--help" || arg == "-h") {
+			outError.clear();
+			return false;
+		} else if (arg.rfind("--", 0) == 0) {
+			outError = "Unknown option " + arg; return false;
+		} else {
+			if (!haveModel) opts.modelPaths.clear();
+			opts.modelPaths.push_back(arg);
+			haveModel = true;
+		}
+	}
+	return true;
+}
+
+// Batch mode: orbit the camera around the (unit-box normalized) models and write every frame to disk.
+// Readback is asynchronous, so rendering of frame N overlaps the transfer and encoding of earlier frames.
+static int runHeadless(const Options& opts) {
+	Graphics::RenderDevice device;
+	Graphics::Renderer renderer;
+	Graphics::FrameReadback readback;
+	std::string err;
+	if (!device.initializeHeadless(opts.width, opts.height, err)) { std::cerr << err << "\n"; return 1; }
+	if (!renderer.initializeHeadless(opts.width, opts.height, opts.modelPaths, err)) { std::cerr << err << "\n"; return 1; }
+	if (!readback.initialize(opts.width, opts.height, opts.outputDir, err)) { std::cerr << err << "\n"; return 1; }
+
+	auto start = std::chrono::steady_clock::now();
+	glm::vec3 extent = renderer.world().max() - renderer.world().min();  // Several models: wide enough for the grid
+	const float radius = std::max(2.0f, 1.2f * std::max(extent.x, extent.y));
+	const float elevation = 0.4f;
+	for (int i = 0; i < opts.frames; ++i) {
+		float angle = 6.2831853f * static_cast<float>(i) / static_cast<float>(opts.frames);
+		renderer.setCamera(glm::vec3(radius * std::sin(angle), elevation, radius * std::cos(angle)), glm::vec3(0.0f));
+		renderer.render();
+		char name[32];
+		std::snprintf(name, sizeof(name), "frame_%05d.ppm", i);
+		readback.capture(name);
+	}
+	readback.finish();
+
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	std::cout << "Headless: wrote " << readback.framesWritten() << " frames (" << opts.width << "x" << opts.height
+	          << ") to " << opts.outputDir << " in " << seconds << " s ("
+	          << (seconds > 0.0 ? 60.0 * static_cast<double>(readback.framesWritten()) / seconds : 0.0) << " frames/min)\n";
+
+	readback.shutdown();
+	renderer.shutdown();
+	device.shutdown();
+	return 0;
+}
+
+// Benchmark mode: deterministic camera replay with vsync off, in a window or headless.
+static int runBenchmark(Options opts) {
+	Graphics::Benchmark benchmark;
+	std::string err;
+	if (!benchmark.loadConfig(opts.benchmarkPath, err)) { std::cerr << err << "\n"; return 1; }
+	const Graphics::BenchmarkConfig& config = benchmark.config();
+	if (!config.modelPath.empty()) opts.modelPaths = {config.modelPath};
+	if (!opts.sizeGiven && config.width > 0 && config.height > 0) { opts.width = config.width; opts.height = config.height; }
+
+	Graphics::RenderDevice device;
+	Graphics::Renderer renderer;
+	if (opts.headless) {
+		if (!device.initializeHeadless(opts.width, opts.height, err)) { std::cerr << err << "\n"; return 1; }
+		if (!renderer.initializeHeadless(opts.width, opts.height, opts.modelPaths, err)) { std::cerr << err << "\n"; return 1; }
+	} else {
+		if (!device.initialize(err)) { std::cerr << err << "\n"; return 1; }
+		device.setVsync(false);
+		if (opts.sizeGiven || (config.width > 0 && config.height > 0)) {
+			device.setWindowSize(opts.width, opts.height);
+			device.poll();
+		}
+		if (!renderer.initializeWithContext(device.window(), opts.modelPaths, err)) { std::cerr << err << "\n"; return 1; }
+	}
+
+	std::cout << "Benchmark '" << config.name << "': " << config.warmupFrames << " warmup + " << config.frames
+	          << " frames, " << config.cameraPath.size() << " camera keyframes\n";
+	benchmark.run(renderer,
+		[&device]() { device.swap(); device.poll(); },
+		[&device]() { return device.shouldClose(); });
+	benchmark.printSummary();
+
+	std::string prefix = opts.reportPrefix.empty() ? config.reportPrefix : opts.reportPrefix;
+	int rc = 0;
+	if (benchmark.writeReport(prefix, err)) {
+		std::cout << "Report: " << prefix << ".json, " << prefix << ".csv\n";
+	} else {
+		std::cerr << err << "\n";
+		rc = 1;
+	}
+
+	renderer.shutdown();
+	device.shutdown();
+	return rc;
+}
+
+int main(int argc, char** argv) {
+	Graphics::CpuProfiler::instance().setThreadName("Main");
+	Options opts;
+	{
+		std::string err;
+		if (!parseArgs(argc, argv, opts, err)) {
+			if (!err.empty()) std::cerr << err << "\n";
+			printUsage(argv[0]);
+			return err.empty() ? 0 : 1;
+		}
+	}
+	if (!opts.benchmarkPath.empty()) return runBenchmark(opts);
+	if (opts.headless) return runHeadless(opts);
 
 	Graphics::RenderDevice device;
 	{
@@ -17,7 +191,7 @@ int main(int argc, char** argv) {
 	Graphics::Renderer renderer;
 	{
 		std::string err;
-		if (!renderer.initializeWithContext(device.window(), modelPath, err)) {
+		if (!renderer.initializeWithContext(device.window(), opts.modelPaths, err)) {
 			std::cerr << err << "\n";
 			return 1;
 		}
@@ -25,14 +199,28 @@ int main(int argc, char** argv) {
 
 	double last = glfwGetTime();
 	while (!device.shouldClose()) {
+		PHV_CPU_SCOPE("Frame");
 		double now = glfwGetTime();
 		float dt = static_cast<float>(now - last);
 		last = now;
 
-		renderer.handleInput(dt);
+		{
+			PHV_CPU_SCOPE("Input");
+			renderer.handleInput(dt);
+		}
+		if (!renderer.needsRedraw()) {
+			// Nothing on screen would change: sleep until input (or the timeout) instead of redrawing
+			PHV_CPU_SCOPE("Idle");
+			device.waitEvents(Graphics::Config::IdleWaitSeconds);
+			last = glfwGetTime();  // Time spent asleep is not camera motion
+			continue;
+		}
 		renderer.render();
-		device.swap();
-		device.poll();
+		{
+			PHV_CPU_SCOPE("Swap");
+			device.swap();
+			device.poll();
+		}
 	}
 
 	renderer.shutdown();
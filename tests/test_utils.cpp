@@ -3,6 +3,18 @@
 #include <limits>
 #include <cmath>
 #include <iostream>
+#include <map>
+#include <random>
+#include <vector>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "Graphics/MeshSimplifier.hpp"
+#include "Graphics/RenderQueue.hpp"
+#include "Graphics/VertexPacking.hpp"
+#include "Graphics/Culling/ObjectBounds.hpp"
+#include "Graphics/Culling/SoftwareOcclusion.hpp"
+#include "Graphics/Profiling/Json.hpp"
+#include "Graphics/Profiling/SampleStats.hpp"
 
 // Test Config namespace directly (defined in Utils.hpp but doesn't require GL)
 namespace Config {
@@ -14,26 +26,6 @@ namespace Config {
 	static constexpr unsigned int VertexOptimizationMinVerts   = 10000;
 }
 
-// Test Half namespace directly (doesn't require GL)
-namespace Half {
-	inline uint16_t floatToHalf(float f) {
-		uint32_t bits;
-		std::memcpy(&bits, &f, sizeof(float));
-		uint32_t sign = ((bits >> 31) << 15) & 0x8000;
-		uint32_t exp = ((bits >> 23) & 0xFF);
-		uint32_t mantissa = (bits >> 13) & 0x3FF;
-		if (exp == 0xFF) {
-			if (mantissa == 0) return static_cast<uint16_t>(sign | 0x7C00);
-			return static_cast<uint16_t>(sign | 0x7E00);
-		}
-		if (exp == 0) return static_cast<uint16_t>(sign);
-		int32_t exp32 = static_cast<int32_t>(exp) - 127 + 15;
-		if (exp32 > 31) return static_cast<uint16_t>(sign | 0x7C00);
-		if (exp32 < 0)  return static_cast<uint16_t>(sign);
-		return static_cast<uint16_t>(sign | (static_cast<uint32_t>(exp32) << 10) | mantissa);
-	}
-}
-
 // Simple test framework
 #define TEST_ASSERT(cond, msg) \
 	if (!(cond)) { \
@@ -51,7 +43,7 @@ bool testHalfFloatRoundTrip() {
 	};
 	
 	for (float original : testValues) {
-		uint16_t half = Half::floatToHalf(original);
+		uint16_t half = Graphics::Half::floatToHalf(original);
 		
 		// Convert back to float (simplified conversion - just extract sign, exp, mantissa)
 		uint32_t sign = (half >> 15) & 0x1;
@@ -84,6 +76,137 @@ bool testHalfFloatRoundTrip() {
 	return true;
 }
 
+static float bitsToFloat(uint32_t bits) {
+	float f;
+	std::memcpy(&f, &bits, sizeof(float));
+	return f;
+}
+
+// Test the scalar half conversion rounds like the hardware and the SIMD packing path matches it bit for bit
+bool testHalfFloatPackingParity() {
+	struct Case { float value; uint16_t half; };
+	const Case cases[] = {
+		{0.0f, 0x0000}, {-0.0f, 0x8000}, {1.0f, 0x3C00}, {-2.0f, 0xC000},
+		{0x1.002p0f, 0x3C00},      // Tie between 1 and the next half: to even (down)
+		{0x1.006p0f, 0x3C02},      // Tie: to even (up)
+		{0x1.0021p0f, 0x3C01},     // Above the tie
+		{0x1p-14f, 0x0400},        // Smallest normal half
+		{0x1.ffcp-15f, 0x0400},    // Tie between the largest subnormal and the smallest normal
+		{0x1p-24f, 0x0001},        // Smallest subnormal
+		{0x1.8p-24f, 0x0002},      // Subnormal tie: to even (up)
+		{0x1p-25f, 0x0000},        // Subnormal tie: to even (zero)
+		{0x1.8p-25f, 0x0001},
+		{-0x1p-20f, 0x8010},
+		{std::numeric_limits<float>::denorm_min(), 0x0000},
+		{65504.0f, 0x7BFF},        // Largest half
+		{65519.0f, 0x7BFF},
+		{65520.0f, 0x7C00},        // Rounds to infinity
+		{1.0e6f, 0x7C00}, {-1.0e6f, 0xFC00},
+		{std::numeric_limits<float>::max(), 0x7C00},
+		{std::numeric_limits<float>::infinity(), 0x7C00},
+		{-std::numeric_limits<float>::infinity(), 0xFC00},
+		{bitsToFloat(0x7FC00000u), 0x7E00},  // Quiet NaN
+		{bitsToFloat(0x7FA00000u), 0x7F00},  // Signaling NaN: quieted, payload truncated
+		{bitsToFloat(0xFFC00001u), 0xFE00},  // Negative NaN, payload below half precision
+	};
+	const size_t count = sizeof(cases) / sizeof(cases[0]);
+	for (const Case& c : cases) {
+		uint16_t half = Graphics::Half::floatToHalf(c.value);
+		TEST_ASSERT(half == c.half, "floatToHalf(" << c.value << ") = 0x" << std::hex << half << ", expected 0x" << c.half << std::dec);
+	}
+
+	// Every case in every converted slot (position xyz, texcoord xy)
+	std::vector<Graphics::Vertex> vertices(count);
+	for (size_t i = 0; i < count; ++i) {
+		vertices[i].position = glm::vec3(cases[i].value, cases[(i + 1) % count].value, cases[(i + 2) % count].value);
+		vertices[i].texcoord = glm::vec2(cases[(i + 3) % count].value, cases[(i + 4) % count].value);
+	}
+	std::vector<Graphics::OptimizedVertex> simd(count), scalar(count);
+	Graphics::VertexPacking::packOptimizedVertices(vertices.data(), count, simd.data());
+	Graphics::VertexPacking::packOptimizedVerticesScalar(vertices.data(), count, scalar.data());
+	for (size_t i = 0; i < count; ++i) {
+		TEST_ASSERT(std::memcmp(&simd[i], &scalar[i], sizeof(Graphics::OptimizedVertex)) == 0,
+			"Packed vertex " << i << " differs between " << Graphics::VertexPacking::simdPathName() << " and scalar");
+	}
+	return true;
+}
+
+// Test JSON parsing of numbers, escapes and structure
+bool testJsonParse() {
+	using Graphics::JsonValue;
+	JsonValue v;
+	std::string error;
+	const char* doc = "{ \"int\": -12, \"frac\": 0.25, \"exp\": 1.5e3, \"negExp\": -2E-2, \"zero\": 0,"
+	                  "  \"text\": \"a\\\"b\\\\c\\/d\\n\\t\\u0041\\u00e9\\u20AC\","
+	                  "  \"list\": [true, false, null, [], {}], \"int\": 7 }";
+	TEST_ASSERT(Graphics::parseJson(doc, v, error), "Valid document rejected: " << error);
+	TEST_ASSERT(v.isObject() && v.object.size() == 8, "Object members not kept in order");
+	TEST_ASSERT(v.numberOr("int", 0.0) == -12.0, "First duplicate member should win");
+	TEST_ASSERT(v.numberOr("frac", 0.0) == 0.25, "Fraction parsed wrong");
+	TEST_ASSERT(v.numberOr("exp", 0.0) == 1500.0, "Exponent parsed wrong");
+	TEST_ASSERT(v.numberOr("negExp", 0.0) == -0.02, "Negative exponent parsed wrong");
+	TEST_ASSERT(v.numberOr("zero", 1.0) == 0.0, "Zero parsed wrong");
+	TEST_ASSERT(v.stringOr("text", "") == "a\"b\\c/d\n\tA\xC3\xA9\xE2\x82\xAC", "String escapes decoded wrong: " << v.stringOr("text", ""));
+	const JsonValue* list = v.find("list");
+	TEST_ASSERT(list && list->isArray() && list->array.size() == 5, "Array parsed wrong");
+	TEST_ASSERT(list->array[0].boolean && !list->array[1].boolean && list->array[2].isNull(), "Literals parsed wrong");
+	TEST_ASSERT(list->array[3].isArray() && list->array[4].isObject(), "Empty containers parsed wrong");
+	TEST_ASSERT(v.numberOr("missing", 3.0) == 3.0 && v.boolOr("frac", true), "Fallbacks not used for missing / mistyped members");
+
+	// Round trip through jsonEscape
+	std::string raw = "quote\" slash\\ line\n tab\t bell\x07";
+	TEST_ASSERT(Graphics::parseJson("\"" + Graphics::jsonEscape(raw) + "\"", v, error) && v.string == raw, "jsonEscape output does not parse back");
+	return true;
+}
+
+// Test malformed JSON is rejected with an error
+bool testJsonRejectsMalformed() {
+	const char* malformed[] = {
+		"", "   ", "{", "[1, 2", "{\"a\" 1}", "{\"a\": }", "{a: 1}", "[1,]", "[1 2]", "{\"a\": 1,}",
+		"01", "1.", ".5", "-", "+1", "1e", "1e+", "0x10", "-inf", "nan", "1e999",
+		"\"unterminated", "\"bad \\q escape\"", "\"\\u12G4\"", "\"\\u12\"", "\"raw\nnewline\"",
+		"tru", "nul", "[true false]", "{} {}", "1 2",
+	};
+	for (const char* text : malformed) {
+		Graphics::JsonValue v;
+		std::string error;
+		TEST_ASSERT(!Graphics::parseJson(text, v, error), "Malformed JSON accepted: " << text);
+		TEST_ASSERT(!error.empty(), "No error message for: " << text);
+	}
+	std::string deep(100, '[');
+	Graphics::JsonValue v;
+	std::string error;
+	TEST_ASSERT(!Graphics::parseJson(deep + std::string(100, ']'), v, error), "Nesting limit not enforced");
+	return true;
+}
+
+// Test nearest-rank percentiles on small and even-length samples
+bool testSamplePercentiles() {
+	Graphics::SampleStats empty = Graphics::computeSampleStats({});
+	TEST_ASSERT(empty.count == 0 && empty.p50 == 0.0 && empty.p99 == 0.0, "Empty samples should give zeros");
+
+	Graphics::SampleStats one = Graphics::computeSampleStats({4.0});
+	TEST_ASSERT(one.p50 == 4.0 && one.p95 == 4.0 && one.p99 == 4.0 && one.mean == 4.0, "Single sample percentiles wrong");
+
+	// Even length, unsorted: p50 is the lower middle sample (no interpolation)
+	Graphics::SampleStats four = Graphics::computeSampleStats({4.0, 1.0, 3.0, 2.0});
+	TEST_ASSERT(four.count == 4 && four.min == 1.0 && four.max == 4.0 && four.mean == 2.5, "Range / mean wrong");
+	TEST_ASSERT(four.p50 == 2.0 && four.p95 == 4.0 && four.p99 == 4.0, "Percentiles of 4 samples wrong: " << four.p50 << " " << four.p95);
+
+	// 1..20: p50 = 10, p95 = 19, p99 = 20
+	std::vector<double> twenty;
+	for (int i = 20; i >= 1; --i) twenty.push_back(static_cast<double>(i));
+	Graphics::SampleStats s20 = Graphics::computeSampleStats(twenty);
+	TEST_ASSERT(s20.p50 == 10.0 && s20.p95 == 19.0 && s20.p99 == 20.0, "Percentiles of 20 samples wrong: " << s20.p50 << " " << s20.p95 << " " << s20.p99);
+
+	// 1..100: every percentile is its own rank
+	std::vector<double> hundred;
+	for (int i = 1; i <= 100; ++i) hundred.push_back(static_cast<double>(i));
+	TEST_ASSERT(Graphics::nearestRankPercentile(hundred, 0.95) == 95.0 && Graphics::nearestRankPercentile(hundred, 0.99) == 99.0, "Percentiles of 100 samples wrong");
+	TEST_ASSERT(Graphics::nearestRankPercentile(hundred, 0.0) == 1.0 && Graphics::nearestRankPercentile(hundred, 1.0) == 100.0, "Percentile bounds wrong");
+	return true;
+}
+
 // Test config constants are reasonable
 bool testConfigConstants() {
 	TEST_ASSERT(Config::MinVerticesForThreading > 0, "MinVerticesForThreading must be > 0");
@@ -97,6 +220,221 @@ bool testConfigConstants() {
 	return true;
 }
 
+// Unit icosphere subdivided 'levels' times (closed, shared vertices)
+static void buildIcosphere(int levels, std::vector<glm::vec3>& positions, std::vector<unsigned int>& indices) {
+	const float t = 1.6180340f;
+	positions = {{-1, t, 0}, {1, t, 0}, {-1, -t, 0}, {1, -t, 0}, {0, -1, t}, {0, 1, t},
+	             {0, -1, -t}, {0, 1, -t}, {t, 0, -1}, {t, 0, 1}, {-t, 0, -1}, {-t, 0, 1}};
+	for (glm::vec3& p : positions) p = glm::normalize(p);
+	indices = {0, 11, 5, 0, 5, 1, 0, 1, 7, 0, 7, 10, 0, 10, 11, 1, 5, 9, 5, 11, 4, 11, 10, 2, 10, 7, 6, 7, 1, 8,
+	           3, 9, 4, 3, 4, 2, 3, 2, 6, 3, 6, 8, 3, 8, 9, 4, 9, 5, 2, 4, 11, 6, 2, 10, 8, 6, 7, 9, 8, 1};
+	for (int level = 0; level < levels; ++level) {
+		std::map<std::pair<unsigned int, unsigned int>, unsigned int> midpoints;
+		auto midpoint = [&](unsigned int a, unsigned int b) {
+			auto key = std::make_pair(std::min(a, b), std::max(a, b));
+			auto it = midpoints.find(key);
+			if (it != midpoints.end()) return it->second;
+			positions.push_back(glm::normalize((positions[a] + positions[b]) * 0.5f));
+			unsigned int index = static_cast<unsigned int>(positions.size() - 1);
+			midpoints.emplace(key, index);
+			return index;
+		};
+		std::vector<unsigned int> next;
+		next.reserve(indices.size() * 4);
+		for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+			unsigned int a = indices[i], b = indices[i + 1], c = indices[i + 2];
+			unsigned int ab = midpoint(a, b), bc = midpoint(b, c), ca = midpoint(c, a);
+			next.insert(next.end(), {a, ab, ca, b, bc, ab, c, ca, bc, ab, bc, ca});
+		}
+		indices.swap(next);
+	}
+}
+
+// Test the mesh LOD chain: every level reaches its target, indexes the original vertices and has no degenerates
+bool testMeshSimplifierLodChain() {
+	std::vector<glm::vec3> positions;
+	std::vector<unsigned int> base;
+	buildIcosphere(4, positions, base);  // 5120 triangles
+
+	const std::vector<unsigned int>* source = &base;
+	std::vector<std::vector<unsigned int>> levels;
+	levels.reserve(sizeof(Graphics::kMeshLodRatios) / sizeof(Graphics::kMeshLodRatios[0]));
+	float coarsestError = 0.0f;
+	for (float ratio : Graphics::kMeshLodRatios) {
+		size_t target = static_cast<size_t>(static_cast<float>(base.size()) * ratio) / 3 * 3;
+		float error = 0.0f;
+		levels.push_back(Graphics::simplifyMesh(positions, *source, target, &error));
+		const std::vector<unsigned int>& level = levels.back();
+
+		TEST_ASSERT(level.size() % 3 == 0, "Simplified index count is not a triangle list");
+		TEST_ASSERT(level.size() <= target, "Level of ratio " << ratio << " has " << level.size() / 3 << " triangles, target " << target / 3);
+		TEST_ASSERT(level.size() * 10 >= target * 9, "Level of ratio " << ratio << " overshot its target: " << level.size() / 3 << " triangles");
+		for (size_t i = 0; i < level.size(); i += 3) {
+			unsigned int a = level[i], b = level[i + 1], c = level[i + 2];
+			TEST_ASSERT(a < positions.size() && b < positions.size() && c < positions.size(), "Index out of range at triangle " << i / 3);
+			TEST_ASSERT(a != b && b != c && a != c, "Degenerate triangle at " << i / 3);
+			glm::vec3 n = glm::cross(positions[b] - positions[a], positions[c] - positions[a]);
+			TEST_ASSERT(glm::length(n) > 0.0f, "Zero-area triangle at " << i / 3);
+		}
+		TEST_ASSERT(error >= 0.0f && std::isfinite(error), "Invalid collapse error " << error);
+		coarsestError = error;
+		source = &level;
+	}
+	TEST_ASSERT(coarsestError > 0.0f, "Coarsest level reports no error");
+
+	// Already at or below the target: returned unchanged
+	std::vector<unsigned int> same = Graphics::simplifyMesh(positions, base, base.size());
+	TEST_ASSERT(same == base, "Mesh below the target was modified");
+	return true;
+}
+
+// The SIMD rasterizer must write exactly what the scalar one writes: the same occluders give the same
+// depth buffer bit for bit, and so the same occlusion answers
+bool testSoftwareOcclusionParity() {
+	using Graphics::SoftwareOcclusionBuffer;
+	glm::mat4 viewProj = glm::perspective(glm::radians(60.0f), 2.0f, 0.1f, 100.0f) *
+	                     glm::lookAt(glm::vec3(0.0f, 0.0f, 5.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	const glm::mat4 identity(1.0f);
+
+	// Random triangles of both windings, mostly in view, some far off screen
+	std::mt19937 rng(1234);
+	std::uniform_real_distribution<float> xy(-6.0f, 6.0f), z(-3.0f, 2.0f);
+	std::vector<glm::vec3> positions;
+	std::vector<unsigned int> indices;
+	for (unsigned int i = 0; i < 600; ++i) {
+		positions.emplace_back(xy(rng), xy(rng) * 0.5f, z(rng));
+		indices.push_back(i);
+	}
+	// Edge cases: a screen-filling quad behind the rest, a sliver, a triangle crossing the near plane
+	// and one clipped by the buffer's right edge
+	unsigned int base = static_cast<unsigned int>(positions.size());
+	positions.insert(positions.end(), {
+		{-40.0f, -20.0f, -4.0f}, {40.0f, -20.0f, -4.0f}, {40.0f, 20.0f, -4.0f}, {-40.0f, 20.0f, -4.0f},
+		{-2.0f, 0.0f, 1.0f}, {2.0f, 0.001f, 1.0f}, {2.0f, 0.002f, 1.0f},
+		{-0.5f, -0.5f, 4.0f}, {0.5f, -0.5f, 4.0f}, {0.0f, 0.5f, 6.0f},
+		{4.0f, -1.0f, 0.5f}, {12.0f, -1.0f, 0.5f}, {4.0f, 1.0f, 0.5f},
+	});
+	indices.insert(indices.end(), {base, base + 1, base + 2, base, base + 2, base + 3,
+	                               base + 4, base + 5, base + 6, base + 7, base + 8, base + 9, base + 10, base + 11, base + 12});
+
+	SoftwareOcclusionBuffer simd;
+	SoftwareOcclusionBuffer scalar(true);
+	for (SoftwareOcclusionBuffer* buffer : {&simd, &scalar}) {
+		buffer->beginFrame(viewProj);
+		TEST_ASSERT(buffer->addOccluder(positions, indices, identity), "occluder rejected");
+		buffer->rasterize();
+	}
+	TEST_ASSERT(simd.stats().triangles == scalar.stats().triangles, "triangle setup differs");
+	const std::vector<float>& a = simd.depth();
+	const std::vector<float>& b = scalar.depth();
+	TEST_ASSERT(a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(float)) == 0,
+	            SoftwareOcclusionBuffer::simdPathName() << " depth differs from scalar");
+	size_t covered = 0;
+	for (float d : b) covered += d < 1.0f ? 1 : 0;
+	TEST_ASSERT(covered == b.size(), "background quad should cover the buffer, covered " << covered);
+
+	// Boxes in front of, among and behind the occluders
+	unsigned int hidden = 0, shown = 0;
+	for (int i = 0; i < 200; ++i) {
+		glm::vec3 lo(xy(rng), xy(rng) * 0.5f, z(rng) * 2.0f - 2.0f);
+		glm::vec3 hi = lo + glm::vec3(0.2f, 0.2f, 0.2f);
+		bool occluded = scalar.isOccluded(lo, hi, identity);
+		TEST_ASSERT(simd.isOccluded(lo, hi, identity) == occluded, "box " << i << " answered differently");
+		(occluded ? hidden : shown)++;
+	}
+	TEST_ASSERT(hidden > 0 && shown > 0, "boxes should be both hidden and visible: " << hidden << " / " << shown);
+	return true;
+}
+
+// Sort keys order by pass, then program, vertex format, material and depth: a higher field wins over
+// every lower field at its maximum. Depth is clamped at the far plane.
+bool testRenderQueueKeys() {
+	using Graphics::RenderQueue;
+	using Pass = RenderQueue::Pass;
+	const float farPlane = 100.0f;
+	const uint32_t maxMaterial = (1u << 20) - 1;
+	auto key = [&](Pass pass, unsigned int program, unsigned int format, uint32_t material, float depth) {
+		return RenderQueue::makeKey(pass, program, format, material, depth, farPlane);
+	};
+	TEST_ASSERT(key(Pass::DepthPrepass, 255, 255, maxMaterial, farPlane) < key(Pass::Opaque, 0, 0, 0, 0.0f), "pass must come first");
+	TEST_ASSERT(key(Pass::Opaque, 1, 255, maxMaterial, farPlane) < key(Pass::Opaque, 2, 0, 0, 0.0f), "program must beat format");
+	TEST_ASSERT(key(Pass::Opaque, 1, 1, maxMaterial, farPlane) < key(Pass::Opaque, 1, 2, 0, 0.0f), "format must beat material");
+	TEST_ASSERT(key(Pass::Opaque, 1, 1, 1, farPlane) < key(Pass::Opaque, 1, 1, 2, 0.0f), "material must beat depth");
+	TEST_ASSERT(key(Pass::Opaque, 1, 1, 1, 10.0f) < key(Pass::Opaque, 1, 1, 1, 20.0f), "nearer must sort first");
+	TEST_ASSERT(RenderQueue::pass(key(Pass::Opaque, 255, 255, maxMaterial, farPlane)) == Pass::Opaque, "pass must round-trip");
+	TEST_ASSERT(RenderQueue::pass(key(Pass::DepthPrepass, 255, 255, maxMaterial, farPlane)) == Pass::DepthPrepass, "pass must round-trip");
+
+	// Depth clamped to [0, farPlane]; fields wider than their bits do not spill into the next one
+	TEST_ASSERT(key(Pass::Opaque, 1, 1, 1, 150.0f) == key(Pass::Opaque, 1, 1, 1, farPlane), "depth beyond the far plane must clamp");
+	TEST_ASSERT(key(Pass::Opaque, 1, 1, 1, 1.0e9f) == key(Pass::Opaque, 1, 1, 1, farPlane), "huge depth must clamp");
+	TEST_ASSERT(key(Pass::Opaque, 1, 1, 1, -5.0f) == key(Pass::Opaque, 1, 1, 1, 0.0f), "negative depth must clamp to 0");
+	TEST_ASSERT(key(Pass::Opaque, 1, 1, 1, farPlane * 0.999f) < key(Pass::Opaque, 1, 1, 1, farPlane), "depth must not saturate early");
+	TEST_ASSERT(key(Pass::Opaque, 1, 1, maxMaterial + 2, 0.0f) == key(Pass::Opaque, 1, 1, 1, 0.0f), "material must be truncated to its bits");
+	TEST_ASSERT(key(Pass::Opaque, 257, 1, 1, 0.0f) == key(Pass::Opaque, 1, 1, 1, 0.0f), "program must be truncated to its bits");
+	TEST_ASSERT(RenderQueue::makeKey(Pass::Opaque, 1, 1, 1, 50.0f, 0.0f) == key(Pass::Opaque, 1, 1, 1, 0.0f), "no far plane: depth must be 0");
+
+	// Sorted queue: prepass first, groups by state, front to back inside a group; equal keys keep push order
+	RenderQueue queue;
+	queue.push(key(Pass::Opaque, 2, 0, 7, 5.0f), 0);
+	queue.push(key(Pass::Opaque, 1, 0, 7, 30.0f), 1);
+	queue.push(key(Pass::DepthPrepass, 0, 0, 0, 30.0f), 2);
+	queue.push(key(Pass::Opaque, 1, 0, 7, 10.0f), 3);
+	queue.push(key(Pass::Opaque, 1, 0, 7, 10.0f), 4);
+	queue.sort();
+	const uint32_t expected[] = {2, 3, 4, 1, 0};
+	for (size_t i = 0; i < queue.size(); ++i) {
+		TEST_ASSERT(queue.items()[i].object == expected[i], "item " << i << " is object " << queue.items()[i].object << ", expected " << expected[i]);
+	}
+	TEST_ASSERT(queue.batchCount() == 3, "expected 3 batches, got " << queue.batchCount());
+	std::vector<RenderQueue::Batch> batches;
+	queue.batches(batches);
+	TEST_ASSERT(batches.size() == 3, "expected 3 batch ranges, got " << batches.size());
+	const size_t expectedEnds[] = {1, 4, 5};
+	for (size_t i = 0; i < batches.size(); ++i) {
+		size_t first = i == 0 ? 0 : expectedEnds[i - 1];
+		TEST_ASSERT(batches[i].first == first && batches[i].end == expectedEnds[i],
+		            "batch " << i << " is [" << batches[i].first << ", " << batches[i].end << "), expected [" << first << ", " << expectedEnds[i] << ")");
+	}
+	return true;
+}
+
+// World culling over hand-built world-space boxes: inside, straddling and outside every plane
+bool testWorldCullBounds() {
+	glm::mat4 viewProj = glm::perspective(glm::radians(60.0f), 1.0f, 0.1f, 100.0f) *
+	                     glm::lookAt(glm::vec3(0.0f, 0.0f, 5.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	Graphics::ObjectBounds bounds;
+	const glm::vec3 boxes[][2] = {
+		{{-0.5f, -0.5f, -0.5f}, {0.5f, 0.5f, 0.5f}},          // 0: in front of the camera
+		{{-0.5f, -0.5f, 8.0f}, {0.5f, 0.5f, 9.0f}},           // 1: behind it
+		{{-60.0f, -0.5f, -0.5f}, {-50.0f, 0.5f, 0.5f}},       // 2: far to the left
+		{{-0.5f, -0.5f, -300.0f}, {0.5f, 0.5f, -200.0f}},     // 3: beyond the far plane
+		{{-10.0f, -0.5f, -0.5f}, {-2.0f, 0.5f, 0.5f}},        // 4: across the left plane
+		{{-1000.0f, -1000.0f, -1000.0f}, {1000.0f, 1000.0f, 1000.0f}},  // 5: around the camera
+		{{-0.5f, 20.0f, -0.5f}, {0.5f, 21.0f, 0.5f}},         // 6: above
+	};
+	bounds.resize(7);
+	for (size_t i = 0; i < 7; ++i) bounds.set(i, boxes[i][0], boxes[i][1]);
+	std::vector<uint32_t> visible;
+	bounds.cull(viewProj, true, visible);
+	TEST_ASSERT((visible == std::vector<uint32_t>{0, 4, 5}), "expected objects 0, 4, 5 visible, got " << visible.size() << " objects");
+	bounds.cull(viewProj, false, visible);
+	TEST_ASSERT(visible.size() == 7, "frustum culling off must keep every object");
+
+	// Enough objects to be split into chunks: every other one is out of view, order is kept
+	const size_t count = 50000;  // Several chunks of Config::CullMinObjectsPerThread
+	bounds.resize(count);
+	for (size_t i = 0; i < count; ++i) {
+		glm::vec3 offset((i % 2) ? 50.0f : 0.0f, 0.0f, -static_cast<float>(i % 50));
+		bounds.set(i, offset - glm::vec3(0.25f), offset + glm::vec3(0.25f));
+	}
+	bounds.cull(viewProj, true, visible);
+	TEST_ASSERT(visible.size() == count / 2, "expected " << count / 2 << " visible, got " << visible.size());
+	for (size_t k = 0; k < visible.size(); ++k) {
+		TEST_ASSERT(visible[k] == 2 * k, "visible[" << k << "] = " << visible[k]);
+	}
+	return true;
+}
+
 int main() {
 	std::cout << "Running Utils unit tests...\n";
 	
@@ -116,6 +454,62 @@ int main() {
 		std::cout << "PASS: testConfigConstants\n";
 	}
 	
+	if (!testHalfFloatPackingParity()) {
+		std::cerr << "testHalfFloatPackingParity failed\n";
+		allPassed = false;
+	} else {
+		std::cout << "PASS: testHalfFloatPackingParity\n";
+	}
+	
+	if (!testMeshSimplifierLodChain()) {
+		std::cerr << "testMeshSimplifierLodChain failed\n";
+		allPassed = false;
+	} else {
+		std::cout << "PASS: testMeshSimplifierLodChain\n";
+	}
+	
+	if (!testJsonParse()) {
+		std::cerr << "testJsonParse failed\n";
+		allPassed = false;
+	} else {
+		std::cout << "PASS: testJsonParse\n";
+	}
+	
+	if (!testJsonRejectsMalformed()) {
+		std::cerr << "testJsonRejectsMalformed failed\n";
+		allPassed = false;
+	} else {
+		std::cout << "PASS: testJsonRejectsMalformed\n";
+	}
+	
+	if (!testSamplePercentiles()) {
+		std::cerr << "testSamplePercentiles failed\n";
+		allPassed = false;
+	} else {
+		std::cout << "PASS: testSamplePercentiles\n";
+	}
+	
+	if (!testSoftwareOcclusionParity()) {
+		std::cerr << "testSoftwareOcclusionParity failed\n";
+		allPassed = false;
+	} else {
+		std::cout << "PASS: testSoftwareOcclusionParity\n";
+	}
+	
+	if (!testRenderQueueKeys()) {
+		std::cerr << "testRenderQueueKeys failed\n";
+		allPassed = false;
+	} else {
+		std::cout << "PASS: testRenderQueueKeys\n";
+	}
+	
+	if (!testWorldCullBounds()) {
+		std::cerr << "testWorldCullBounds failed\n";
+		allPassed = false;
+	} else {
+		std::cout << "PASS: testWorldCullBounds\n";
+	}
+	
 	if (allPassed) {
 		std::cout << "All tests passed!\n";
 		return 0;